@@ -28,6 +28,10 @@ class MurmurDesktopConan(ConanFile):
         # LibTorrent options
         "libtorrent/*:shared": False,
         "libtorrent/*:with_deprecated_functions": False,
+        # Cache codec options
+        "lz4/*:shared": False,
+        "zstd/*:shared": False,
+        "xxhash/*:shared": False,
         # SQLite options
         "sqlite3/*:shared": False,
         # OpenSSL options
@@ -59,6 +63,9 @@ class MurmurDesktopConan(ConanFile):
         self.requires("zlib/1.3.1")
         self.requires("bzip2/1.0.8")
         self.requires("xz_utils/5.4.5")
+        self.requires("lz4/1.9.4")
+        self.requires("zstd/1.5.6")
+        self.requires("xxhash/0.8.2")
 
     def system_requirements(self):
         """Install system dependencies for each platform"""
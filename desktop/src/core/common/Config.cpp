@@ -76,6 +76,7 @@ Config::TorrentSettings Config::getTorrentSettings() const {
         "wss://tracker.btorrent.xyz"
     };
     settings.trackers = getValue("torrent/trackers", defaultTrackers).toStringList();
+    settings.performanceProfile = getString("torrent/performanceProfile", "balanced");
     
     return settings;
 }
@@ -115,6 +116,7 @@ void Config::setTorrentSettings(const TorrentSettings& settings) {
     setValue("torrent/downloadRateLimit", settings.downloadRateLimit);
     setValue("torrent/enableDHT", settings.enableDHT);
     setValue("torrent/trackers", settings.trackers);
+    setValue("torrent/performanceProfile", settings.performanceProfile);
 }
 
 void Config::setMediaSettings(const MediaSettings& settings) {
@@ -38,6 +38,7 @@ public:
         int downloadRateLimit = -1;
         bool enableDHT = true;
         QStringList trackers;
+        QString performanceProfile = "balanced";  // See TorrentProfiles
     };
     
     struct MediaSettings {
@@ -1,13 +1,18 @@
 #include "FFmpegWrapper.hpp"
+#include "MediaBufferPool.hpp"
 #include "../common/Logger.hpp"
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QUuid>
+#include <QtCore/QWaitCondition>
 #include <QElapsedTimer>
 
+#include <algorithm>
+
 // FFmpeg C API includes
 extern "C" {
 #include <libavformat/avformat.h>
@@ -66,6 +71,101 @@ struct OperationContext {
     FFmpegProgressCallback progressCallback = nullptr;
 };
 
+namespace {
+
+// Assumed keyframe spacing when neither the index nor a probe reveals it
+constexpr double DEFAULT_KEYFRAME_INTERVAL = 10.0;
+// Packets read while probing for keyframe spacing before giving up
+constexpr int KEYFRAME_PROBE_PACKETS = 1000;
+constexpr size_t KEYFRAME_PROBE_SAMPLES = 16;
+
+/**
+ * Single-entry scaler cache. sws_getCachedContext() hands back the existing
+ * context as long as (src format, size, dst format, size) stay the same.
+ */
+struct ScalerCache {
+    SwsContext* context = nullptr;
+    
+    ~ScalerCache() {
+        sws_freeContext(context);
+    }
+    
+    SwsContext* get(int srcWidth, int srcHeight, AVPixelFormat srcFormat,
+                    int dstWidth, int dstHeight, AVPixelFormat dstFormat) {
+        context = sws_getCachedContext(context,
+                                       srcWidth, srcHeight, srcFormat,
+                                       dstWidth, dstHeight, dstFormat,
+                                       SWS_BILINEAR, nullptr, nullptr, nullptr);
+        return context;
+    }
+};
+
+/**
+ * Bounded pool of output frames shared between the decoding thread and the
+ * image encoders. acquire() blocks once every frame is in flight, which also
+ * keeps decoding from running arbitrarily far ahead of encoding.
+ */
+class ScaledFramePool {
+public:
+    ScaledFramePool(int capacity, AVPixelFormat format, int width, int height)
+        : capacity_(std::max(1, capacity)), format_(format), width_(width), height_(height) {}
+    
+    ~ScaledFramePool() {
+        for (AVFrame* frame : frames_) {
+            av_frame_free(&frame);
+        }
+    }
+    
+    AVFrame* acquire() {
+        QMutexLocker locker(&mutex_);
+        while (free_.empty() && static_cast<int>(frames_.size()) >= capacity_) {
+            available_.wait(&mutex_);
+        }
+        
+        if (!free_.empty()) {
+            AVFrame* frame = free_.back();
+            free_.pop_back();
+            if (av_frame_make_writable(frame) < 0) {
+                free_.push_back(frame);
+                return nullptr;
+            }
+            return frame;
+        }
+        
+        AVFrame* frame = av_frame_alloc();
+        if (!frame) {
+            return nullptr;
+        }
+        frame->format = format_;
+        frame->width = width_;
+        frame->height = height_;
+        if (av_frame_get_buffer(frame, 32) < 0) {
+            av_frame_free(&frame);
+            return nullptr;
+        }
+        frames_.push_back(frame);
+        return frame;
+    }
+    
+    void release(AVFrame* frame) {
+        QMutexLocker locker(&mutex_);
+        free_.push_back(frame);
+        available_.wakeOne();
+    }
+    
+private:
+    const int capacity_;
+    const AVPixelFormat format_;
+    const int width_;
+    const int height_;
+    QMutex mutex_;
+    QWaitCondition available_;
+    std::vector<AVFrame*> frames_;
+    std::vector<AVFrame*> free_;
+};
+
+} // namespace
+
 struct FFmpegWrapper::FFmpegWrapperPrivate {
     mutable QMutex operationsMutex;
     QHash<QString, OperationContext*> activeOperations;
@@ -80,6 +180,9 @@ struct FFmpegWrapper::FFmpegWrapperPrivate {
     // Configuration
     QString tempDirectory;
     int maxConcurrentOperations = 4;
+
+    // Frame, packet and decoder buffers shared by all operations
+    MediaBufferPool bufferPool;
 };
 
 FFmpegWrapper::FFmpegWrapper(QObject* parent)
@@ -118,6 +221,10 @@ Expected<bool, FFmpegError> FFmpegWrapper::initialize() {
     return true;
 }
 
+void FFmpegWrapper::setMemoryManager(MemoryManager* manager) {
+    d->bufferPool.setMemoryManager(manager);
+}
+
 QFuture<Expected<MediaFileInfo, FFmpegError>> FFmpegWrapper::analyzeFile(const QString& filePath) {
     return QtConcurrent::run([this, filePath]() -> Expected<MediaFileInfo, FFmpegError> {
         try {
@@ -320,6 +427,168 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::extractAudio(
     });
 }
 
+Expected<std::vector<float>, FFmpegError> FFmpegWrapper::decodeAudioSamples(
+    const QString& inputPath,
+    int sampleRate,
+    const std::atomic<bool>* cancelFlag) {
+    
+    auto validateResult = validateFilePath(inputPath, true);
+    if (validateResult.hasError()) {
+        return makeUnexpected(validateResult.error());
+    }
+    
+    if (sampleRate <= 0) {
+        return makeUnexpected(FFmpegError::InvalidParameters);
+    }
+    
+    // Open input file
+    auto openResult = openInputFile(inputPath);
+    if (openResult.hasError()) {
+        return makeUnexpected(openResult.error());
+    }
+    AVFormatContext* inputFormat = openResult.value();
+    
+    // Find audio stream
+    auto audioStreamResult = findBestAudioStream(inputFormat);
+    if (audioStreamResult.hasError()) {
+        closeFormatContext(inputFormat);
+        return makeUnexpected(audioStreamResult.error());
+    }
+    int audioStreamIndex = audioStreamResult.value();
+    AVStream* audioStream = inputFormat->streams[audioStreamIndex];
+    
+    // Let the demuxer drop video/subtitle packets instead of handing them to us
+    for (unsigned int i = 0; i < inputFormat->nb_streams; ++i) {
+        if (static_cast<int>(i) != audioStreamIndex) {
+            inputFormat->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+    
+    // Create decoder
+    auto decoderResult = createAudioDecoder(audioStream);
+    if (decoderResult.hasError()) {
+        closeFormatContext(inputFormat);
+        return makeUnexpected(decoderResult.error());
+    }
+    AVCodecContext* decoder = decoderResult.value();
+    
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    if (!packet || !frame) {
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&decoder);
+        closeFormatContext(inputFormat);
+        return makeUnexpected(FFmpegError::AllocationFailed);
+    }
+    
+    // Size the output once from the container duration to avoid regrowth on long files
+    std::vector<float> samples;
+    if (inputFormat->duration > 0) {
+        double duration = static_cast<double>(inputFormat->duration) / AV_TIME_BASE;
+        samples.reserve(static_cast<size_t>(duration * sampleRate) + static_cast<size_t>(sampleRate));
+    }
+    
+    AVChannelLayout monoLayout = AV_CHANNEL_LAYOUT_MONO;
+    SwrContext* swrContext = nullptr;
+    
+    // Resample straight into the tail of the output buffer
+    auto appendSamples = [&](const uint8_t** input, int inputSamples) -> bool {
+        int capacity = swr_get_out_samples(swrContext, inputSamples);
+        if (capacity < 0) {
+            return false;
+        }
+        
+        size_t offset = samples.size();
+        samples.resize(offset + static_cast<size_t>(capacity));
+        uint8_t* output = reinterpret_cast<uint8_t*>(samples.data() + offset);
+        
+        int converted = swr_convert(swrContext, &output, capacity, input, inputSamples);
+        if (converted < 0) {
+            samples.resize(offset);
+            return false;
+        }
+        
+        samples.resize(offset + static_cast<size_t>(converted));
+        return true;
+    };
+    
+    auto drainDecoder = [&]() -> bool {
+        while (avcodec_receive_frame(decoder, frame) >= 0) {
+            if (!swrContext) {
+                int ret = swr_alloc_set_opts2(&swrContext,
+                                              &monoLayout, AV_SAMPLE_FMT_FLT, sampleRate,
+                                              &frame->ch_layout, static_cast<AVSampleFormat>(frame->format), frame->sample_rate,
+                                              0, nullptr);
+                if (ret < 0 || swr_init(swrContext) < 0) {
+                    Logger::instance().error("Failed to initialize audio resampler for {}", inputPath.toStdString());
+                    av_frame_unref(frame);
+                    return false;
+                }
+            }
+            
+            bool appended = appendSamples(const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+            av_frame_unref(frame);
+            if (!appended) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    bool failed = false;
+    bool cancelled = false;
+    
+    while (av_read_frame(inputFormat, packet) >= 0) {
+        if (cancelFlag && cancelFlag->load()) {
+            cancelled = true;
+            av_packet_unref(packet);
+            break;
+        }
+        
+        if (packet->stream_index == audioStreamIndex) {
+            if (avcodec_send_packet(decoder, packet) < 0) {
+                Logger::instance().warn("Failed to send packet to audio decoder, skipping");
+            } else if (!drainDecoder()) {
+                failed = true;
+                av_packet_unref(packet);
+                break;
+            }
+        }
+        
+        av_packet_unref(packet);
+    }
+    
+    if (!failed && !cancelled) {
+        // Flush the decoder, then the resampler's delayed samples
+        avcodec_send_packet(decoder, nullptr);
+        failed = !drainDecoder();
+        if (!failed && swrContext) {
+            failed = !appendSamples(nullptr, 0);
+        }
+    }
+    
+    // Cleanup
+    swr_free(&swrContext);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&decoder);
+    closeFormatContext(inputFormat);
+    
+    if (cancelled) {
+        return makeUnexpected(FFmpegError::CancellationRequested);
+    }
+    
+    if (failed || samples.empty()) {
+        Logger::instance().error("Failed to decode audio from {}", inputPath.toStdString());
+        return makeUnexpected(FFmpegError::DecodingFailed);
+    }
+    
+    Logger::instance().info("Decoded {} audio samples at {}Hz from {}",
+                            samples.size(), sampleRate, inputPath.toStdString());
+    return samples;
+}
+
 QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::generateThumbnail(
     const QString& inputPath,
     const QString& outputPath,
@@ -365,8 +634,8 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::generateThumbnail(
         }
         
         // Read and decode frames until we find the right one
-        AVPacket* packet = av_packet_alloc();
-        AVFrame* frame = av_frame_alloc();
+        AVPacket* packet = d->bufferPool.acquirePacket();
+        AVFrame* frame = d->bufferPool.acquireFrame();
         
         bool foundFrame = false;
         while (av_read_frame(inputFormat, packet) >= 0) {
@@ -387,32 +656,26 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::generateThumbnail(
             QString format = QFileInfo(outputPath).suffix().toLower();
             if (format.isEmpty()) format = "jpg";
 
-            AVFrame* outputFrame = av_frame_alloc();
             int outputWidth = (width > 0) ? width : frame->width;
             int outputHeight = (height > 0) ? height : frame->height;
             bool conversionSuccess = false;
 
+            // Use YUV format for JPEG output, RGB for PNG
+            AVPixelFormat outputPixFmt = (format.toLower() == "png") ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_YUVJ420P;
+            AVFrame* outputFrame = d->bufferPool.acquireVideoFrame(outputPixFmt, outputWidth, outputHeight);
+
             if (outputFrame) {
-                outputFrame->width = outputWidth;
-                outputFrame->height = outputHeight;
+                SwsContext* swsContext = sws_getContext(
+                    frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                    outputWidth, outputHeight, outputPixFmt,
+                    SWS_BILINEAR, nullptr, nullptr, nullptr
+                );
                 
-                // Use YUV format for JPEG output, RGB for PNG
-                AVPixelFormat outputPixFmt = (format.toLower() == "png") ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_YUVJ420P;
-                outputFrame->format = outputPixFmt;
-
-                if (av_frame_get_buffer(outputFrame, 32) >= 0) {
-                    SwsContext* swsContext = sws_getContext(
-                        frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
-                        outputWidth, outputHeight, outputPixFmt,
-                        SWS_BILINEAR, nullptr, nullptr, nullptr
-                    );
-                    
-                    if (swsContext) {
-                        sws_scale(swsContext, frame->data, frame->linesize, 0, frame->height,
-                                  outputFrame->data, outputFrame->linesize);
-                        sws_freeContext(swsContext);
-                        conversionSuccess = true;
-                    }
+                if (swsContext) {
+                    sws_scale(swsContext, frame->data, frame->linesize, 0, frame->height,
+                              outputFrame->data, outputFrame->linesize);
+                    sws_freeContext(swsContext);
+                    conversionSuccess = true;
                 }
 
                 if (conversionSuccess) {
@@ -424,15 +687,15 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::generateThumbnail(
                 } else {
                     result = makeUnexpected(FFmpegError::AllocationFailed);
                 }
-                av_frame_free(&outputFrame);
+                d->bufferPool.releaseFrame(outputFrame);
             } else {
                 result = makeUnexpected(FFmpegError::AllocationFailed);
             }
         }
         
         // Cleanup
-        av_frame_free(&frame);
-        av_packet_free(&packet);
+        d->bufferPool.releaseFrame(frame);
+        d->bufferPool.releasePacket(packet);
         avcodec_free_context(&decoder);
         closeFormatContext(inputFormat);
         
@@ -490,8 +753,8 @@ QFuture<Expected<QStringList, FFmpegError>> FFmpegWrapper::extractFrames(
         }
         
         QStringList extractedFrames;
-        AVPacket* packet = av_packet_alloc();
-        AVFrame* frame = av_frame_alloc();
+        AVPacket* packet = d->bufferPool.acquirePacket();
+        AVFrame* frame = d->bufferPool.acquireFrame();
         
         // Extract frames at regular intervals
         double currentTime = 0.0;
@@ -528,12 +791,9 @@ QFuture<Expected<QStringList, FFmpegError>> FFmpegWrapper::extractFrames(
                     .arg(format);
                 
                 // Convert frame to RGB24 for saving
-                AVFrame* rgbFrame = av_frame_alloc();
-                rgbFrame->width = frame->width;
-                rgbFrame->height = frame->height;
-                rgbFrame->format = AV_PIX_FMT_RGB24;
+                AVFrame* rgbFrame = d->bufferPool.acquireVideoFrame(AV_PIX_FMT_RGB24, frame->width, frame->height);
                 
-                if (av_frame_get_buffer(rgbFrame, 32) >= 0) {
+                if (rgbFrame) {
                     SwsContext* swsContext = sws_getContext(
                         frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
                         frame->width, frame->height, AV_PIX_FMT_RGB24,
@@ -555,13 +815,272 @@ QFuture<Expected<QStringList, FFmpegError>> FFmpegWrapper::extractFrames(
                     }
                 }
                 
-                av_frame_free(&rgbFrame);
+                d->bufferPool.releaseFrame(rgbFrame);
                 av_packet_unref(packet);
             }
             
             currentTime += intervalSeconds;
         }
         
+        // Cleanup
+        d->bufferPool.releaseFrame(frame);
+        d->bufferPool.releasePacket(packet);
+        avcodec_free_context(&decoder);
+        closeFormatContext(inputFormat);
+        
+        return extractedFrames;
+    });
+}
+
+QFuture<Expected<QStringList, FFmpegError>> FFmpegWrapper::extractFrames(
+    const QString& inputPath,
+    const QString& outputDir,
+    const FrameExtractionOptions& options) {
+    
+    return QtConcurrent::run([this, inputPath, outputDir, options]() -> Expected<QStringList, FFmpegError> {
+        auto validateResult = validateFilePath(inputPath, true);
+        if (validateResult.hasError()) {
+            return makeUnexpected(validateResult.error());
+        }
+        
+        if (options.intervalSeconds <= 0.0) {
+            return makeUnexpected(FFmpegError::InvalidParameters);
+        }
+        
+        // Ensure output directory exists
+        QDir outDir(outputDir);
+        if (!outDir.exists() && !outDir.mkpath(".")) {
+            return makeUnexpected(FFmpegError::IOError);
+        }
+        
+        // Open input file
+        auto openResult = openInputFile(inputPath);
+        if (openResult.hasError()) {
+            return makeUnexpected(openResult.error());
+        }
+        AVFormatContext* inputFormat = openResult.value();
+        
+        // Find video stream
+        auto videoStreamResult = findBestVideoStream(inputFormat);
+        if (videoStreamResult.hasError()) {
+            closeFormatContext(inputFormat);
+            return makeUnexpected(videoStreamResult.error());
+        }
+        int videoStreamIndex = videoStreamResult.value();
+        AVStream* videoStream = inputFormat->streams[videoStreamIndex];
+        
+        for (unsigned int i = 0; i < inputFormat->nb_streams; ++i) {
+            if (static_cast<int>(i) != videoStreamIndex) {
+                inputFormat->streams[i]->discard = AVDISCARD_ALL;
+            }
+        }
+        
+        // Create decoder
+        auto decoderResult = createVideoDecoder(videoStream);
+        if (decoderResult.hasError()) {
+            closeFormatContext(inputFormat);
+            return makeUnexpected(decoderResult.error());
+        }
+        AVCodecContext* decoder = decoderResult.value();
+        
+        double duration = inputFormat->duration != AV_NOPTS_VALUE
+            ? static_cast<double>(inputFormat->duration) / AV_TIME_BASE : 0.0;
+        if (duration <= 0 && videoStream->duration != AV_NOPTS_VALUE) {
+            duration = static_cast<double>(videoStream->duration) * av_q2d(videoStream->time_base);
+        }
+        // Live TS captures, some MKVs and pipes report no duration at all
+        const bool durationKnown = duration > 0;
+        
+        // Linear decoding costs one interval of frames per output; seeking costs
+        // a demuxer seek plus on average half a GOP. Decode through while the
+        // interval is within one GOP, seek once it is longer. Seek targets need
+        // an end, so inputs without a duration are always decoded through.
+        double keyframeInterval = estimateKeyframeInterval(inputFormat, videoStreamIndex);
+        if (keyframeInterval <= 0.0) {
+            keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+        }
+        const bool linearDecode = !durationKnown || options.intervalSeconds <= keyframeInterval;
+        
+        // Snapping to keyframes is only acceptable when the GOP fits inside both
+        // the tolerance and the interval, so every target still gets its own frame
+        const bool keyframesOnly = keyframeInterval <= options.toleranceSeconds &&
+                                   keyframeInterval <= options.intervalSeconds;
+        if (keyframesOnly) {
+            decoder->skip_frame = AVDISCARD_NONKEY;
+        }
+        
+        Logger::instance().info("Extracting frames from {}: {} mode, GOP ~{:.2f}s, keyframes only: {}",
+                                inputPath.toStdString(), linearDecode ? "linear" : "seek",
+                                keyframeInterval, keyframesOnly);
+        
+        const QString format = options.format.toLower();
+        const AVPixelFormat outputPixFmt = (format == "png") ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_YUVJ420P;
+        const double timeBase = av_q2d(videoStream->time_base);
+        const int64_t streamStart = videoStream->start_time != AV_NOPTS_VALUE ? videoStream->start_time : 0;
+        
+        QThreadPool encoderPool;
+        encoderPool.setMaxThreadCount(options.encoderThreads > 0 ? options.encoderThreads : QThread::idealThreadCount());
+        QList<QFuture<QString>> encodeJobs;
+        
+        ScalerCache scaler;
+        std::unique_ptr<ScaledFramePool> framePool;
+        int outputWidth = 0;
+        int outputHeight = 0;
+        int frameNumber = 0;
+        
+        auto frameSeconds = [&](const AVFrame* frame) -> double {
+            int64_t timestamp = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+            return timestamp != AV_NOPTS_VALUE ? (timestamp - streamStart) * timeBase : -1.0;
+        };
+        
+        // Scale on the decoding thread, hand the pooled frame to an encoder worker
+        auto submitFrame = [&](AVFrame* source) {
+            if (!framePool) {
+                outputWidth = options.width > 0 ? options.width : source->width;
+                outputHeight = options.height > 0 ? options.height : source->height;
+                if (options.width > 0 && options.height <= 0) {
+                    outputHeight = static_cast<int>(static_cast<qint64>(source->height) * options.width / source->width) & ~1;
+                } else if (options.height > 0 && options.width <= 0) {
+                    outputWidth = static_cast<int>(static_cast<qint64>(source->width) * options.height / source->height) & ~1;
+                }
+                framePool = std::make_unique<ScaledFramePool>(options.framePoolSize, outputPixFmt, outputWidth, outputHeight);
+            }
+            
+            AVFrame* scaled = framePool->acquire();
+            if (!scaled) {
+                Logger::instance().warn("Failed to allocate output frame");
+                return;
+            }
+            
+            SwsContext* swsContext = scaler.get(source->width, source->height, static_cast<AVPixelFormat>(source->format),
+                                                outputWidth, outputHeight, outputPixFmt);
+            if (!swsContext) {
+                framePool->release(scaled);
+                Logger::instance().warn("Failed to create scaler for frame extraction");
+                return;
+            }
+            
+            sws_scale(swsContext, source->data, source->linesize, 0, source->height,
+                      scaled->data, scaled->linesize);
+            
+            QString outputPath = QString("%1/frame_%2.%3")
+                .arg(outputDir)
+                .arg(frameNumber++, 6, 10, QChar('0'))
+                .arg(format);
+            
+            ScaledFramePool* pool = framePool.get();
+            encodeJobs.append(QtConcurrent::run(&encoderPool, [this, pool, scaled, outputPath, format]() -> QString {
+                bool saved = saveFrameAsImage(scaled, outputPath, format);
+                pool->release(scaled);
+                if (!saved) {
+                    Logger::instance().warn("Failed to save frame as image: {}", outputPath.toStdString());
+                    return QString();
+                }
+                return outputPath;
+            }));
+        };
+        
+        AVPacket* packet = av_packet_alloc();
+        AVFrame* frame = av_frame_alloc();
+        if (!packet || !frame) {
+            av_frame_free(&frame);
+            av_packet_free(&packet);
+            avcodec_free_context(&decoder);
+            closeFormatContext(inputFormat);
+            return makeUnexpected(FFmpegError::AllocationFailed);
+        }
+        
+        auto isWantedPacket = [&](const AVPacket* pkt) {
+            return pkt->stream_index == videoStreamIndex &&
+                   (!keyframesOnly || (pkt->flags & AV_PKT_FLAG_KEY));
+        };
+        
+        if (linearDecode) {
+            double nextTarget = 0.0;
+            
+            // Returns false once every target has been served
+            auto drainDecoder = [&]() -> bool {
+                while (avcodec_receive_frame(decoder, frame) >= 0) {
+                    double t = frameSeconds(frame);
+                    if (t < 0.0 || t + options.toleranceSeconds >= nextTarget) {
+                        submitFrame(frame);
+                        double reached = std::max(t, nextTarget);
+                        while (nextTarget <= reached) {
+                            nextTarget += options.intervalSeconds;
+                        }
+                    }
+                    av_frame_unref(frame);
+                    if (durationKnown && nextTarget >= duration) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+            
+            bool more = true;
+            while (more && av_read_frame(inputFormat, packet) >= 0) {
+                if (isWantedPacket(packet) && avcodec_send_packet(decoder, packet) >= 0) {
+                    more = drainDecoder();
+                }
+                av_packet_unref(packet);
+            }
+            
+            if (more) {
+                avcodec_send_packet(decoder, nullptr);
+                drainDecoder();
+            }
+        } else {
+            for (double target = 0.0; target < duration; target += options.intervalSeconds) {
+                int64_t seekTarget = streamStart + static_cast<int64_t>(target / timeBase);
+                if (av_seek_frame(inputFormat, videoStreamIndex, seekTarget, AVSEEK_FLAG_BACKWARD) < 0) {
+                    Logger::instance().warn("Could not seek to time {}", target);
+                    continue;
+                }
+                avcodec_flush_buffers(decoder);
+                
+                // Decode forward from the keyframe until the target is reached
+                bool found = false;
+                auto receiveTarget = [&]() {
+                    while (!found && avcodec_receive_frame(decoder, frame) >= 0) {
+                        double t = frameSeconds(frame);
+                        if (keyframesOnly || t < 0.0 || t + options.toleranceSeconds >= target) {
+                            submitFrame(frame);
+                            found = true;
+                        }
+                        av_frame_unref(frame);
+                    }
+                };
+                
+                bool endOfFile = false;
+                while (!found) {
+                    if (av_read_frame(inputFormat, packet) < 0) {
+                        endOfFile = true;
+                        break;
+                    }
+                    if (isWantedPacket(packet) && avcodec_send_packet(decoder, packet) >= 0) {
+                        receiveTarget();
+                    }
+                    av_packet_unref(packet);
+                }
+                
+                // The last frames only leave the decoder once it is drained
+                if (!found && endOfFile) {
+                    avcodec_send_packet(decoder, nullptr);
+                    receiveTarget();
+                }
+            }
+        }
+        
+        // Wait for encoders before the frame pool goes away
+        QStringList extractedFrames;
+        for (auto& job : encodeJobs) {
+            QString path = job.result();
+            if (!path.isEmpty()) {
+                extractedFrames.append(path);
+            }
+        }
+        encoderPool.waitForDone();
+        
         // Cleanup
         av_frame_free(&frame);
         av_packet_free(&packet);
@@ -681,9 +1200,10 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::applyFilters(
         }
         
         // Process frames through filter graph
-        AVPacket* packet = av_packet_alloc();
-        AVFrame* inputFrame = av_frame_alloc();
-        AVFrame* filteredFrame = av_frame_alloc();
+        AVPacket* packet = d->bufferPool.acquirePacket();
+        AVPacket* encodedPacket = d->bufferPool.acquirePacket();
+        AVFrame* inputFrame = d->bufferPool.acquireFrame();
+        AVFrame* filteredFrame = d->bufferPool.acquireFrame();
         
         bool processingSuccess = true;
         
@@ -701,7 +1221,6 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::applyFilters(
                         
                         // Encode filtered frame
                         if (avcodec_send_frame(encoder, filteredFrame) >= 0) {
-                            AVPacket* encodedPacket = av_packet_alloc();
                             while (avcodec_receive_packet(encoder, encodedPacket) >= 0) {
                                 encodedPacket->stream_index = outputStream->index;
                                 av_packet_rescale_ts(encodedPacket, encoder->time_base, outputStream->time_base);
@@ -711,8 +1230,9 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::applyFilters(
                                     processingSuccess = false;
                                 }
                             }
-                            av_packet_free(&encodedPacket);
                         }
+                        // The sink needs an empty frame, and this returns the buffer to its pool
+                        av_frame_unref(filteredFrame);
                     }
                 }
             }
@@ -721,22 +1241,21 @@ QFuture<Expected<QString, FFmpegError>> FFmpegWrapper::applyFilters(
         
         // Flush encoder
         if (avcodec_send_frame(encoder, nullptr) >= 0) {
-            AVPacket* encodedPacket = av_packet_alloc();
             while (avcodec_receive_packet(encoder, encodedPacket) >= 0) {
                 encodedPacket->stream_index = outputStream->index;
                 av_packet_rescale_ts(encodedPacket, encoder->time_base, outputStream->time_base);
                 av_interleaved_write_frame(outputFormat, encodedPacket);
             }
-            av_packet_free(&encodedPacket);
         }
         
         // Write trailer
         av_write_trailer(outputFormat);
         
         // Cleanup
-        av_frame_free(&filteredFrame);
-        av_frame_free(&inputFrame);
-        av_packet_free(&packet);
+        d->bufferPool.releaseFrame(filteredFrame);
+        d->bufferPool.releaseFrame(inputFrame);
+        d->bufferPool.releasePacket(encodedPacket);
+        d->bufferPool.releasePacket(packet);
         avcodec_free_context(&encoder);
         avfilter_graph_free(&filterGraphPtr);
         closeFormatContext(outputFormat);
@@ -992,6 +1511,49 @@ Expected<int, FFmpegError> FFmpegWrapper::findBestAudioStream(AVFormatContext* f
     return ret;
 }
 
+double FFmpegWrapper::estimateKeyframeInterval(AVFormatContext* formatContext, int streamIndex) {
+    AVStream* stream = formatContext->streams[streamIndex];
+    std::vector<int64_t> keyframeTimestamps;
+    
+    // Indexed containers (MP4, MKV with cues) answer without reading packets
+    int entries = avformat_index_get_entries_count(stream);
+    for (int i = 0; i < entries && keyframeTimestamps.size() < KEYFRAME_PROBE_SAMPLES; ++i) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) {
+            keyframeTimestamps.push_back(entry->timestamp);
+        }
+    }
+    
+    // Otherwise probe the leading packets and rewind
+    if (keyframeTimestamps.size() < 2) {
+        keyframeTimestamps.clear();
+        AVPacket* packet = av_packet_alloc();
+        int packetsRead = 0;
+        while (packet && packetsRead < KEYFRAME_PROBE_PACKETS &&
+               keyframeTimestamps.size() < KEYFRAME_PROBE_SAMPLES &&
+               av_read_frame(formatContext, packet) >= 0) {
+            if (packet->stream_index == streamIndex) {
+                packetsRead++;
+                if ((packet->flags & AV_PKT_FLAG_KEY) && packet->pts != AV_NOPTS_VALUE) {
+                    keyframeTimestamps.push_back(packet->pts);
+                }
+            }
+            av_packet_unref(packet);
+        }
+        av_packet_free(&packet);
+        
+        int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        av_seek_frame(formatContext, streamIndex, start, AVSEEK_FLAG_BACKWARD);
+    }
+    
+    if (keyframeTimestamps.size() < 2) {
+        return 0.0;
+    }
+    
+    int64_t span = keyframeTimestamps.back() - keyframeTimestamps.front();
+    return static_cast<double>(span) * av_q2d(stream->time_base) / (keyframeTimestamps.size() - 1);
+}
+
 Expected<AVCodecContext*, FFmpegError> FFmpegWrapper::createVideoDecoder(AVStream* stream) {
     const AVCodec* decoder = avcodec_find_decoder(stream->codecpar->codec_id);
     if (!decoder) {
@@ -1009,6 +1571,9 @@ Expected<AVCodecContext*, FFmpegError> FFmpegWrapper::createVideoDecoder(AVStrea
         return makeUnexpected(mapAVError(ret));
     }
     
+    // Decoded pictures come from the shared pools instead of per-context ones
+    d->bufferPool.attachDecoder(codecContext);
+    
     ret = avcodec_open2(codecContext, decoder, nullptr);
     if (ret < 0) {
         avcodec_free_context(&codecContext);
@@ -1036,18 +1601,17 @@ std::vector<AVFrame*> FFmpegWrapper::bufferAudioFrame(OperationContext* context,
     
     // If the input frame size is different, we need to handle it
     // For now, create a frame with the correct size by truncating or padding
-    AVFrame* outputFrame = av_frame_alloc();
-    outputFrame->nb_samples = context->targetAudioFrameSize;
-    outputFrame->format = context->audioEncoder->sample_fmt;
-    outputFrame->sample_rate = context->audioEncoder->sample_rate;
-    outputFrame->ch_layout = context->audioEncoder->ch_layout;
-    
-    // CRITICAL: Copy timestamp information from input frame to avoid PTS issues
-    outputFrame->pts = inputFrame->pts;
-    outputFrame->pkt_dts = inputFrame->pkt_dts;
-    outputFrame->time_base = inputFrame->time_base;
-    
-    if (av_frame_get_buffer(outputFrame, 0) >= 0) {
+    // Callers hand the frame back with d->bufferPool.releaseFrame()
+    AVFrame* outputFrame = d->bufferPool.acquireAudioFrame(
+        context->audioEncoder->sample_fmt, &context->audioEncoder->ch_layout,
+        context->audioEncoder->sample_rate, context->targetAudioFrameSize);
+    
+    if (outputFrame) {
+        // CRITICAL: Copy timestamp information from input frame to avoid PTS issues
+        outputFrame->pts = inputFrame->pts;
+        outputFrame->pkt_dts = inputFrame->pkt_dts;
+        outputFrame->time_base = inputFrame->time_base;
+
         // Copy samples from input to output
         int samplesToCopy = std::min(inputFrame->nb_samples, context->targetAudioFrameSize);
         
@@ -1080,7 +1644,6 @@ std::vector<AVFrame*> FFmpegWrapper::bufferAudioFrame(OperationContext* context,
         
         outputFrames.push_back(outputFrame);
     } else {
-        av_frame_free(&outputFrame);
         // Fall back to original frame if buffer allocation fails
         outputFrames.push_back(inputFrame);
     }
@@ -1314,6 +1877,7 @@ Expected<QString, FFmpegError> FFmpegWrapper::performVideoConversion(const QStri
     AVFormatContext* inFmtCtx = nullptr;
     AVFormatContext* outFmtCtx = nullptr;
     AVPacket* packet = nullptr;
+    AVPacket* enc_pkt = nullptr;
     AVFrame* frame = nullptr;
     AVFrame* filt_frame = nullptr;
     AVFrame* resampled_frame = nullptr;
@@ -1826,12 +2390,13 @@ Expected<QString, FFmpegError> FFmpegWrapper::performVideoConversion(const QStri
     headerWritten = true;
 
     // 4. Transcoding Loop
-    packet = av_packet_alloc();
-    frame = av_frame_alloc();
-    filt_frame = av_frame_alloc();
-    resampled_frame = av_frame_alloc();
+    packet = d->bufferPool.acquirePacket();
+    enc_pkt = d->bufferPool.acquirePacket();
+    frame = d->bufferPool.acquireFrame();
+    filt_frame = d->bufferPool.acquireFrame();
+    resampled_frame = d->bufferPool.acquireFrame();
 
-    if (!packet || !frame || !filt_frame || !resampled_frame) {
+    if (!packet || !enc_pkt || !frame || !filt_frame || !resampled_frame) {
         ret = AVERROR(ENOMEM);
         goto end;
     }
@@ -1893,9 +2458,9 @@ Expected<QString, FFmpegError> FFmpegWrapper::performVideoConversion(const QStri
                         continue;
                     }
                     
-                    // Only free the frame if it's not the original input frame
+                    // Only release the frame if it's not the original input frame
                     if (bufferedFrame != resampled_frame && bufferedFrame != frame) {
-                        av_frame_free(&bufferedFrame);
+                        d->bufferPool.releaseFrame(bufferedFrame);
                     }
                 }
                 
@@ -1907,24 +2472,19 @@ Expected<QString, FFmpegError> FFmpegWrapper::performVideoConversion(const QStri
             }
 
             while (ret >= 0) {
-                AVPacket* enc_pkt = av_packet_alloc();
                 ret = avcodec_receive_packet(enc_ctx, enc_pkt);
                 if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                    av_packet_free(&enc_pkt);
                     break;
                 }
                 if (ret < 0) {
-                    av_packet_free(&enc_pkt);
                     goto end;
                 }
 
                 enc_pkt->stream_index = out_stream_idx;
                 av_packet_rescale_ts(enc_pkt, enc_ctx->time_base, out_stream->time_base);
                 if ((ret = av_interleaved_write_frame(outFmtCtx, enc_pkt)) < 0) {
-                    av_packet_free(&enc_pkt);
                     goto end;
                 }
-                av_packet_free(&enc_pkt);
             }
         }
         av_packet_unref(packet);
@@ -1937,26 +2497,26 @@ end:
     
     if (context->videoEncoder) {
         avcodec_send_frame(context->videoEncoder, nullptr); // Flush
-        AVPacket* flush_pkt = av_packet_alloc();
+        AVPacket* flush_pkt = d->bufferPool.acquirePacket();
         while (avcodec_receive_packet(context->videoEncoder, flush_pkt) == 0) {
             flush_pkt->stream_index = video_out_stream_idx;
             av_packet_rescale_ts(flush_pkt, context->videoEncoder->time_base, outFmtCtx->streams[video_out_stream_idx]->time_base);
             av_interleaved_write_frame(outFmtCtx, flush_pkt);
             av_packet_unref(flush_pkt);
         }
-        av_packet_free(&flush_pkt);
+        d->bufferPool.releasePacket(flush_pkt);
     }
     
     if (context->audioEncoder) {
         avcodec_send_frame(context->audioEncoder, nullptr); // Flush
-        AVPacket* flush_pkt = av_packet_alloc();
+        AVPacket* flush_pkt = d->bufferPool.acquirePacket();
         while (avcodec_receive_packet(context->audioEncoder, flush_pkt) == 0) {
             flush_pkt->stream_index = audio_out_stream_idx;
             av_packet_rescale_ts(flush_pkt, context->audioEncoder->time_base, outFmtCtx->streams[audio_out_stream_idx]->time_base);
             av_interleaved_write_frame(outFmtCtx, flush_pkt);
             av_packet_unref(flush_pkt);
         }
-        av_packet_free(&flush_pkt);
+        d->bufferPool.releasePacket(flush_pkt);
     }
 
     // Write trailer with error checking - only if header was successfully written
@@ -1989,10 +2549,11 @@ end:
         Logger::instance().debug("Skipping trailer write - header was not successfully written");
     }
 
-    av_packet_free(&packet);
-    av_frame_free(&frame);
-    av_frame_free(&filt_frame);
-    av_frame_free(&resampled_frame);
+    d->bufferPool.releasePacket(packet);
+    d->bufferPool.releasePacket(enc_pkt);
+    d->bufferPool.releaseFrame(frame);
+    d->bufferPool.releaseFrame(filt_frame);
+    d->bufferPool.releaseFrame(resampled_frame);
 
     if (ret < 0 && ret != AVERROR_EOF) {
         return makeUnexpected(mapAVError(ret));
@@ -2138,8 +2699,13 @@ Expected<QString, FFmpegError> FFmpegWrapper::performAudioExtraction(
     }
     
     // Process audio packets
-    AVPacket* packet = av_packet_alloc();
-    if (!packet) {
+    AVPacket* packet = d->bufferPool.acquirePacket();
+    AVPacket* encodedPacket = d->bufferPool.acquirePacket();
+    AVFrame* decodedFrame = d->bufferPool.acquireFrame();
+    if (!packet || !encodedPacket || !decodedFrame) {
+        d->bufferPool.releasePacket(packet);
+        d->bufferPool.releasePacket(encodedPacket);
+        d->bufferPool.releaseFrame(decodedFrame);
         avcodec_free_context(&encoderCtx);
         avformat_close_input(&inputFormatCtx);
         av_write_trailer(outputFormatCtx);
@@ -2150,87 +2716,96 @@ Expected<QString, FFmpegError> FFmpegWrapper::performAudioExtraction(
         return makeUnexpected(FFmpegError::AllocationFailed);
     }
     
+    // One decoder and resampler for the whole stream, so neither loses its
+    // state between packets
+    AVCodecContext* decoderCtx = nullptr;
+    auto decoderResult = createAudioDecoder(inputStream);
+    if (decoderResult.hasError()) {
+        Logger::instance().warn("Failed to open audio decoder");
+    } else {
+        decoderCtx = decoderResult.value();
+    }
+    
+    SwrContext* swrCtx = nullptr;
+    int swrInputRate = 0;
+    int swrInputFormat = -1;
+    int swrInputChannels = 0;
+    
+    auto releaseResources = [&]() {
+        swr_free(&swrCtx);
+        avcodec_free_context(&decoderCtx);
+        d->bufferPool.releaseFrame(decodedFrame);
+        d->bufferPool.releasePacket(encodedPacket);
+        d->bufferPool.releasePacket(packet);
+    };
+    
     while (av_read_frame(inputFormatCtx, packet) >= 0) {
-        if (packet->stream_index == audioStreamIndex) {
-            // Create decoder for audio stream
-            const AVCodec* decoder = avcodec_find_decoder(inputStream->codecpar->codec_id);
-            if (!decoder) {
-                Logger::instance().warn("Failed to find audio decoder");
-                av_packet_unref(packet);
-                continue;
-            }
-            
-            AVCodecContext* decoderCtx = avcodec_alloc_context3(decoder);
-            if (avcodec_parameters_to_context(decoderCtx, inputStream->codecpar) < 0 ||
-                avcodec_open2(decoderCtx, decoder, nullptr) < 0) {
-                Logger::instance().warn("Failed to open audio decoder");
-                avcodec_free_context(&decoderCtx);
-                av_packet_unref(packet);
-                continue;
-            }
-            
+        if (packet->stream_index == audioStreamIndex && decoderCtx) {
             // Decode audio frame
             if (avcodec_send_packet(decoderCtx, packet) < 0) {
                 Logger::instance().warn("Failed to send packet to audio decoder");
-                avcodec_free_context(&decoderCtx);
                 av_packet_unref(packet);
                 continue;
             }
             
-            AVFrame* decodedFrame = av_frame_alloc();
             while (avcodec_receive_frame(decoderCtx, decodedFrame) >= 0) {
                 // Resample audio if needed
                 AVFrame* resampledFrame = decodedFrame;
-                SwrContext* swrCtx = nullptr;
                 
                 if (decodedFrame->sample_rate != encoderCtx->sample_rate ||
                     decodedFrame->ch_layout.nb_channels != encoderCtx->ch_layout.nb_channels ||
                     decodedFrame->format != encoderCtx->sample_fmt) {
                     
-                    swrCtx = swr_alloc();
-                    av_opt_set_chlayout(swrCtx, "in_chlayout", &decodedFrame->ch_layout, 0);
-                    av_opt_set_int(swrCtx, "in_sample_rate", decodedFrame->sample_rate, 0);
-                    av_opt_set_sample_fmt(swrCtx, "in_sample_fmt", (AVSampleFormat)decodedFrame->format, 0);
-                    av_opt_set_chlayout(swrCtx, "out_chlayout", &encoderCtx->ch_layout, 0);
-                    av_opt_set_int(swrCtx, "out_sample_rate", encoderCtx->sample_rate, 0);
-                    av_opt_set_sample_fmt(swrCtx, "out_sample_fmt", encoderCtx->sample_fmt, 0);
-                    
-                    if (swr_init(swrCtx) < 0) {
-                        Logger::instance().warn("Failed to initialize audio resampler");
+                    // Rebuild the resampler only when the input layout changes
+                    if (swrCtx && (decodedFrame->sample_rate != swrInputRate ||
+                                   decodedFrame->format != swrInputFormat ||
+                                   decodedFrame->ch_layout.nb_channels != swrInputChannels)) {
                         swr_free(&swrCtx);
-                    } else {
-                        resampledFrame = av_frame_alloc();
-                        resampledFrame->sample_rate = encoderCtx->sample_rate;
-                        resampledFrame->ch_layout = encoderCtx->ch_layout;
-                        resampledFrame->format = encoderCtx->sample_fmt;
+                    }
+                    
+                    if (!swrCtx) {
+                        swrCtx = swr_alloc();
+                        av_opt_set_chlayout(swrCtx, "in_chlayout", &decodedFrame->ch_layout, 0);
+                        av_opt_set_int(swrCtx, "in_sample_rate", decodedFrame->sample_rate, 0);
+                        av_opt_set_sample_fmt(swrCtx, "in_sample_fmt", (AVSampleFormat)decodedFrame->format, 0);
+                        av_opt_set_chlayout(swrCtx, "out_chlayout", &encoderCtx->ch_layout, 0);
+                        av_opt_set_int(swrCtx, "out_sample_rate", encoderCtx->sample_rate, 0);
+                        av_opt_set_sample_fmt(swrCtx, "out_sample_fmt", encoderCtx->sample_fmt, 0);
                         
-                        // Calculate required output samples based on input
-                        int out_samples = av_rescale_rnd(decodedFrame->nb_samples,
+                        if (swr_init(swrCtx) < 0) {
+                            Logger::instance().warn("Failed to initialize audio resampler");
+                            swr_free(&swrCtx);
+                        } else {
+                            swrInputRate = decodedFrame->sample_rate;
+                            swrInputFormat = decodedFrame->format;
+                            swrInputChannels = decodedFrame->ch_layout.nb_channels;
+                        }
+                    }
+                    
+                    if (swrCtx) {
+                        // Room for this frame plus whatever the resampler still holds
+                        int out_samples = av_rescale_rnd(swr_get_delay(swrCtx, decodedFrame->sample_rate) + decodedFrame->nb_samples,
                                                         encoderCtx->sample_rate,
                                                         decodedFrame->sample_rate,
                                                         AV_ROUND_UP);
                         
-                        // Use calculated output samples for resampling
-                        resampledFrame->nb_samples = out_samples;
-                        
-                        if (av_frame_get_buffer(resampledFrame, 0) < 0) {
+                        AVFrame* outputFrame = d->bufferPool.acquireAudioFrame(
+                            encoderCtx->sample_fmt, &encoderCtx->ch_layout, encoderCtx->sample_rate, out_samples);
+                        if (!outputFrame) {
                             Logger::instance().warn("Failed to allocate audio frame buffer");
-                            av_frame_free(&resampledFrame);
-                            resampledFrame = decodedFrame;
                         } else {
                             // Convert audio samples, handling frame size constraints
-                            int converted_samples = swr_convert(swrCtx, resampledFrame->data, resampledFrame->nb_samples,
+                            int converted_samples = swr_convert(swrCtx, outputFrame->data, outputFrame->nb_samples,
                                                                (const uint8_t**)decodedFrame->data, decodedFrame->nb_samples);
                             if (converted_samples < 0) {
                                 Logger::instance().warn("Failed to resample audio frame");
-                                av_frame_free(&resampledFrame);
-                                resampledFrame = decodedFrame;
+                                d->bufferPool.releaseFrame(outputFrame);
                             } else {
                                 // Update the actual number of samples converted
-                                resampledFrame->nb_samples = converted_samples;
+                                outputFrame->nb_samples = converted_samples;
+                                resampledFrame = outputFrame;
                             }
                         }
-                        swr_free(&swrCtx);
                     }
                 }
                 
@@ -2248,24 +2823,21 @@ Expected<QString, FFmpegError> FFmpegWrapper::performAudioExtraction(
                         continue;
                     }
                     
-                    // Only free the frame if it's not the original input frame
+                    // Only release the frame if it's not the original input frame
                     if (bufferedFrame != resampledFrame && bufferedFrame != decodedFrame) {
-                        av_frame_free(&bufferedFrame);
+                        d->bufferPool.releaseFrame(bufferedFrame);
                     }
                 }
                 
-                AVPacket* encodedPacket = av_packet_alloc();
+                if (resampledFrame != decodedFrame) d->bufferPool.releaseFrame(resampledFrame);
+                
                 while (avcodec_receive_packet(encoderCtx, encodedPacket) >= 0) {
                     av_packet_rescale_ts(encodedPacket, encoderCtx->time_base, outputStream->time_base);
                     encodedPacket->stream_index = outputStream->index;
                     
                     if (av_interleaved_write_frame(outputFormatCtx, encodedPacket) < 0) {
                         Logger::instance().error("Failed to write encoded audio frame");
-                        av_packet_free(&encodedPacket);
-                        if (resampledFrame != decodedFrame) av_frame_free(&resampledFrame);
-                        av_frame_free(&decodedFrame);
-                        avcodec_free_context(&decoderCtx);
-                        av_packet_free(&packet);
+                        releaseResources();
                         avcodec_free_context(&encoderCtx);
                         avformat_close_input(&inputFormatCtx);
                         av_write_trailer(outputFormatCtx);
@@ -2277,12 +2849,7 @@ Expected<QString, FFmpegError> FFmpegWrapper::performAudioExtraction(
                     }
                     av_packet_unref(encodedPacket);
                 }
-                av_packet_free(&encodedPacket);
-                
-                if (resampledFrame != decodedFrame) av_frame_free(&resampledFrame);
             }
-            av_frame_free(&decodedFrame);
-            avcodec_free_context(&decoderCtx);
         }
         
         av_packet_unref(packet);
@@ -2290,7 +2857,7 @@ Expected<QString, FFmpegError> FFmpegWrapper::performAudioExtraction(
     
     // Write trailer and cleanup
     av_write_trailer(outputFormatCtx);
-    av_packet_free(&packet);
+    releaseResources();
     avcodec_free_context(&encoderCtx);
     avformat_close_input(&inputFormatCtx);
     if (!(outputFormatCtx->oformat->flags & AVFMT_NOFILE)) {
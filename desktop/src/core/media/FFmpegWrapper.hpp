@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <vector>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
@@ -32,6 +34,8 @@ extern "C" {
 
 namespace Murmur {
 
+class MemoryManager;
+
 enum class FFmpegError {
     InvalidFile,
     UnsupportedFormat,
@@ -138,6 +142,16 @@ struct ConversionOptions {
     bool enableQsv = true;          // Enable Intel Quick Sync if available
 };
 
+struct FrameExtractionOptions {
+    double intervalSeconds = 1.0;   // Time between extracted frames
+    QString format = "jpg";         // jpg or png
+    int width = 0;                  // 0 = keep original (aspect kept if only one side is set)
+    int height = 0;                 // 0 = keep original
+    double toleranceSeconds = 0.0;  // Allowed timestamp error; 0 = frame accurate
+    int encoderThreads = 0;         // Image encoding workers, 0 = auto-detect
+    int framePoolSize = 8;          // Scaled frames in flight between decoder and encoders
+};
+
 struct ProgressInfo {
     QString operationId;
     double progressPercent = 0.0;   // 0.0 to 100.0
@@ -182,6 +196,13 @@ public:
      */
     Expected<bool, FFmpegError> initialize();
 
+    /**
+     * @brief Allocate frame buffers from MemoryManager's media pools
+     * @param manager Manager to draw from, or nullptr for av_malloc; must
+     *        outlive this wrapper
+     */
+    void setMemoryManager(MemoryManager* manager);
+
     /**
      * @brief Analyze media file and extract metadata
      * @param filePath Path to media file
@@ -217,6 +238,23 @@ public:
         const ConversionOptions& options = ConversionOptions{}
     );
 
+    /**
+     * @brief Decode the best audio stream straight into mono float PCM
+     * 
+     * Packets are decoded and resampled incrementally into the returned
+     * buffer; no intermediate file is written and no process is spawned.
+     * Runs synchronously on the calling thread.
+     * @param inputPath Input audio or video file path
+     * @param sampleRate Output sample rate in Hz (whisper.cpp expects 16000)
+     * @param cancelFlag Optional flag polled between packets
+     * @return Samples in [-1.0, 1.0] or error
+     */
+    Expected<std::vector<float>, FFmpegError> decodeAudioSamples(
+        const QString& inputPath,
+        int sampleRate = 16000,
+        const std::atomic<bool>* cancelFlag = nullptr
+    );
+
     /**
      * @brief Generate thumbnail from video
      * @param inputPath Input video file path
@@ -249,6 +287,24 @@ public:
         const QString& format = "jpg"
     );
 
+    /**
+     * @brief Extract frames at regular intervals in a single decoding pass
+     * 
+     * Decodes linearly when the interval is shorter than the GOP and seeks
+     * otherwise, decodes keyframes only when the GOP fits within the allowed
+     * tolerance, reuses one scaler and a pool of output frames, and encodes
+     * images on a worker pool while decoding continues.
+     * @param inputPath Input video file path
+     * @param outputDir Output directory for frames
+     * @param options Extraction options
+     * @return Future with list of generated frame paths (in time order) or error
+     */
+    QFuture<Expected<QStringList, FFmpegError>> extractFrames(
+        const QString& inputPath,
+        const QString& outputDir,
+        const FrameExtractionOptions& options
+    );
+
     /**
      * @brief Apply video filters (resize, crop, rotate, etc.)
      * @param inputPath Input file path
@@ -421,6 +477,7 @@ private:
     AudioStreamInfo extractAudioStreamInfo(AVStream* stream, AVCodecContext* codecContext);
     Expected<int, FFmpegError> findBestVideoStream(AVFormatContext* formatContext);
     Expected<int, FFmpegError> findBestAudioStream(AVFormatContext* formatContext);
+    double estimateKeyframeInterval(AVFormatContext* formatContext, int streamIndex);
 
     // Validation
     Expected<bool, FFmpegError> validateConversionOptions(const ConversionOptions& options);
@@ -0,0 +1,324 @@
+#include "MediaBufferPool.hpp"
+#include "../storage/MemoryManager.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
+}
+
+#include <climits>
+
+namespace Murmur {
+
+namespace {
+
+// Slack after each plane for SIMD reads past the last pixel, as libavcodec's
+// own frame pools leave
+constexpr size_t PLANE_PADDING = 16 + MediaBufferPool::BUFFER_ALIGN - 1;
+
+// Rows of video frames are padded to this many lines, like av_frame_get_buffer()
+constexpr int FRAME_HEIGHT_ALIGN = 32;
+
+// Audio buffers are pooled by size class; frame lengths vary with codec and
+// resampler, so exact sample counts would keep creating pools
+constexpr int MIN_AUDIO_BUCKET = 4096;
+
+int audioBucketSize(int size) {
+    int bucket = MIN_AUDIO_BUCKET;
+    while (bucket < size && bucket <= INT_MAX / 2) {
+        bucket *= 2;
+    }
+    return bucket >= size ? bucket : size;
+}
+
+void releaseManagedBuffer(void* opaque, uint8_t* data) {
+    static_cast<MemoryManager*>(opaque)->deallocate(data);
+}
+
+} // namespace
+
+MediaBufferPool::MediaBufferPool() = default;
+
+MediaBufferPool::~MediaBufferPool() {
+    QMutexLocker locker(&mutex_);
+    for (AVFrame* frame : frames_) {
+        av_frame_free(&frame);
+    }
+    for (AVPacket* packet : packets_) {
+        av_packet_free(&packet);
+    }
+    // Buffers still referenced keep their pool alive until they are dropped
+    clearPools();
+}
+
+void MediaBufferPool::setMemoryManager(MemoryManager* manager) {
+    QMutexLocker locker(&mutex_);
+    memoryManager_.store(manager, std::memory_order_relaxed);
+    // Idle buffers with the old backing would otherwise be handed out again
+    clearPools();
+}
+
+AVFrame* MediaBufferPool::acquireFrame() {
+    {
+        QMutexLocker locker(&mutex_);
+        if (!frames_.empty()) {
+            AVFrame* frame = frames_.back();
+            frames_.pop_back();
+            return frame;
+        }
+    }
+    return av_frame_alloc();
+}
+
+AVPacket* MediaBufferPool::acquirePacket() {
+    {
+        QMutexLocker locker(&mutex_);
+        if (!packets_.empty()) {
+            AVPacket* packet = packets_.back();
+            packets_.pop_back();
+            return packet;
+        }
+    }
+    return av_packet_alloc();
+}
+
+AVFrame* MediaBufferPool::acquireVideoFrame(int pixelFormat, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    AVFrame* frame = acquireFrame();
+    if (!frame) {
+        return nullptr;
+    }
+
+    frame->format = pixelFormat;
+    frame->width = width;
+    frame->height = height;
+    if (!fillVideoFrame(frame, width, FFALIGN(height, FRAME_HEIGHT_ALIGN))) {
+        releaseFrame(frame);
+        return nullptr;
+    }
+    return frame;
+}
+
+AVFrame* MediaBufferPool::acquireAudioFrame(int sampleFormat, const AVChannelLayout* layout, int sampleRate, int sampleCount) {
+    if (!layout || layout->nb_channels <= 0 || sampleCount <= 0) {
+        return nullptr;
+    }
+
+    AVFrame* frame = acquireFrame();
+    if (!frame) {
+        return nullptr;
+    }
+
+    frame->format = sampleFormat;
+    frame->sample_rate = sampleRate;
+    frame->nb_samples = sampleCount;
+    if (av_channel_layout_copy(&frame->ch_layout, layout) < 0) {
+        releaseFrame(frame);
+        return nullptr;
+    }
+
+    const auto format = static_cast<AVSampleFormat>(sampleFormat);
+    const int channels = layout->nb_channels;
+
+    // Planes beyond data[] need extended_data, which only FFmpeg's own
+    // allocator sets up
+    if (av_sample_fmt_is_planar(format) && channels > AV_NUM_DATA_POINTERS) {
+        if (av_frame_get_buffer(frame, 0) < 0) {
+            releaseFrame(frame);
+            return nullptr;
+        }
+        return frame;
+    }
+
+    int linesize = 0;
+    const int size = av_samples_get_buffer_size(&linesize, channels, sampleCount, format, BUFFER_ALIGN);
+    const int bucket = size > 0 ? audioBucketSize(size) : 0;
+    AVBufferRef* buffer = bucket > 0 ? takeBuffer(BufferKey(true, 0, 0, bucket), bucket) : nullptr;
+    if (!buffer) {
+        releaseFrame(frame);
+        return nullptr;
+    }
+
+    frame->buf[0] = buffer;
+    av_samples_fill_arrays(frame->data, &frame->linesize[0], buffer->data, channels, sampleCount, format, BUFFER_ALIGN);
+    frame->extended_data = frame->data;
+    return frame;
+}
+
+void MediaBufferPool::releaseFrame(AVFrame* frame) {
+    if (!frame) {
+        return;
+    }
+
+    av_frame_unref(frame);
+    QMutexLocker locker(&mutex_);
+    if (frames_.size() < MAX_SHELLS) {
+        frames_.push_back(frame);
+        return;
+    }
+    locker.unlock();
+    av_frame_free(&frame);
+}
+
+void MediaBufferPool::releasePacket(AVPacket* packet) {
+    if (!packet) {
+        return;
+    }
+
+    av_packet_unref(packet);
+    QMutexLocker locker(&mutex_);
+    if (packets_.size() < MAX_SHELLS) {
+        packets_.push_back(packet);
+        return;
+    }
+    locker.unlock();
+    av_packet_free(&packet);
+}
+
+void MediaBufferPool::attachDecoder(AVCodecContext* decoder) {
+    if (!decoder || !decoder->codec || decoder->codec_type != AVMEDIA_TYPE_VIDEO) {
+        return;
+    }
+
+    // Without direct rendering the decoder must use the default allocator
+    if (!(decoder->codec->capabilities & AV_CODEC_CAP_DR1)) {
+        return;
+    }
+
+    decoder->opaque = this;
+    decoder->get_buffer2 = &MediaBufferPool::getBuffer2;
+}
+
+AVBufferRef* MediaBufferPool::takeBuffer(const BufferKey& key, size_t size) {
+    QMutexLocker locker(&mutex_);
+
+    auto it = pools_.find(key);
+    if (it == pools_.end()) {
+        // Geometry that keeps changing would otherwise grow the map forever
+        if (pools_.size() >= MAX_POOLS) {
+            clearPools();
+        }
+
+        auto entry = std::make_unique<BufferPool>();
+        entry->owner = this;
+        entry->audio = std::get<0>(key);
+        entry->size = size;
+        entry->pool = av_buffer_pool_init2(size, entry.get(), &MediaBufferPool::allocateBuffer, nullptr);
+        if (!entry->pool) {
+            return nullptr;
+        }
+        it = pools_.emplace(key, std::move(entry)).first;
+    }
+
+    return av_buffer_pool_get(it->second->pool);
+}
+
+bool MediaBufferPool::fillVideoFrame(AVFrame* frame, int width, int height) {
+    const auto format = static_cast<AVPixelFormat>(frame->format);
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // Widen until every row is aligned, as libavcodec's own pools do
+    int linesizes[4] = {};
+    int paddedWidth = width;
+    while (true) {
+        if (av_image_fill_linesizes(linesizes, format, paddedWidth) < 0) {
+            return false;
+        }
+        bool aligned = true;
+        for (int linesize : linesizes) {
+            aligned = aligned && linesize % BUFFER_ALIGN == 0;
+        }
+        if (aligned) {
+            break;
+        }
+        paddedWidth += paddedWidth & ~(paddedWidth - 1);
+    }
+
+    ptrdiff_t strides[4];
+    size_t planeSizes[4] = {};
+    for (int i = 0; i < 4; ++i) {
+        strides[i] = linesizes[i];
+    }
+    if (av_image_fill_plane_sizes(planeSizes, format, height, strides) < 0) {
+        return false;
+    }
+
+    // One buffer per frame, each plane starting aligned with slack behind it
+    size_t offsets[4] = {};
+    size_t total = 0;
+    for (int i = 0; i < 4 && planeSizes[i] > 0; ++i) {
+        offsets[i] = total;
+        total = FFALIGN(total + planeSizes[i] + PLANE_PADDING, static_cast<size_t>(BUFFER_ALIGN));
+    }
+
+    AVBufferRef* buffer = takeBuffer(BufferKey(false, frame->format, paddedWidth, height), total);
+    if (!buffer) {
+        return false;
+    }
+
+    frame->buf[0] = buffer;
+    for (int i = 0; i < 4 && planeSizes[i] > 0; ++i) {
+        frame->data[i] = buffer->data + offsets[i];
+        frame->linesize[i] = linesizes[i];
+    }
+    frame->extended_data = frame->data;
+    return true;
+}
+
+void MediaBufferPool::clearPools() {
+    for (auto& [key, entry] : pools_) {
+        av_buffer_pool_uninit(&entry->pool);
+    }
+    pools_.clear();
+}
+
+AVBufferRef* MediaBufferPool::allocateBuffer(void* opaque, size_t size) {
+    // Called by av_buffer_pool_get() under the owner's mutex
+    auto* entry = static_cast<BufferPool*>(opaque);
+    entry->owner->buffersAllocated_.fetch_add(1, std::memory_order_relaxed);
+
+    MemoryManager* manager = entry->owner->memoryManager_.load(std::memory_order_relaxed);
+    if (manager) {
+        auto block = manager->allocate(size, BUFFER_ALIGN,
+                                       entry->audio ? MemoryPoolType::Audio : MemoryPoolType::Video,
+                                       "MediaBufferPool");
+        if (block.hasValue()) {
+            AVBufferRef* buffer = av_buffer_create(static_cast<uint8_t*>(block.value()), size,
+                                                   &releaseManagedBuffer, manager, 0);
+            if (buffer) {
+                return buffer;
+            }
+            manager->deallocate(block.value());
+        }
+    }
+
+    return av_buffer_alloc(size);
+}
+
+int MediaBufferPool::getBuffer2(AVCodecContext* context, AVFrame* frame, int flags) {
+    auto* self = static_cast<MediaBufferPool*>(context->opaque);
+    const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+    if (!self || context->hw_frames_ctx || !descriptor || (descriptor->flags & AV_PIX_FMT_FLAG_HWACCEL)) {
+        return avcodec_default_get_buffer2(context, frame, flags);
+    }
+
+    // The codec may write past the visible picture up to its block size
+    int width = frame->width;
+    int height = frame->height;
+    int linesizeAlign[AV_NUM_DATA_POINTERS];
+    avcodec_align_dimensions2(context, &width, &height, linesizeAlign);
+
+    return self->fillVideoFrame(frame, width, height) ? 0 : AVERROR(ENOMEM);
+}
+
+} // namespace Murmur
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QtCore/QMutex>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+extern "C" {
+    struct AVFrame;
+    struct AVPacket;
+    struct AVCodecContext;
+    struct AVBufferPool;
+    struct AVBufferRef;
+    struct AVChannelLayout;
+}
+
+namespace Murmur {
+
+class MemoryManager;
+
+/**
+ * @brief Recycles AVFrame/AVPacket shells and frame data buffers
+ *
+ * Data buffers come from one AVBufferPool per (format, padded width, padded
+ * height) for video and per power-of-two byte size for audio. A frame's
+ * buffers return to their pool when the last reference is dropped, so frames
+ * handed to encoders or filters can be released as usual. Decoders attached
+ * with attachDecoder() draw their output frames from the same pools through
+ * get_buffer2, which lets successive operations on similar media reuse one
+ * another's buffers.
+ *
+ * With a MemoryManager set, new buffers are carved from its Video and
+ * Audio pools and fall back to av_malloc when those are full.
+ *
+ * All methods are thread-safe.
+ */
+class MediaBufferPool {
+public:
+    // Row and plane alignment of pooled buffers, enough for any SIMD path
+    static constexpr int BUFFER_ALIGN = 64;
+
+    MediaBufferPool();
+    ~MediaBufferPool();
+
+    MediaBufferPool(const MediaBufferPool&) = delete;
+    MediaBufferPool& operator=(const MediaBufferPool&) = delete;
+
+    /**
+     * @brief Back new buffers with MemoryManager pools
+     *
+     * Buffers already handed out keep their backing. The manager must
+     * outlive every frame allocated from this pool; pass nullptr to go back
+     * to av_malloc.
+     */
+    void setMemoryManager(MemoryManager* manager);
+
+    // Empty frame and packet shells, reused after release
+    AVFrame* acquireFrame();
+    AVPacket* acquirePacket();
+
+    // Frames with pooled, writable data buffers; nullptr on failure
+    AVFrame* acquireVideoFrame(int pixelFormat, int width, int height);
+    AVFrame* acquireAudioFrame(int sampleFormat, const AVChannelLayout* layout, int sampleRate, int sampleCount);
+
+    // Unref and keep the shell for reuse; null is ignored
+    void releaseFrame(AVFrame* frame);
+    void releasePacket(AVPacket* packet);
+
+    /**
+     * @brief Serve a decoder's video frames from the pools
+     *
+     * Call before avcodec_open2(). Decoders without direct rendering
+     * support, hardware frames and audio keep the default allocator.
+     */
+    void attachDecoder(AVCodecContext* decoder);
+
+    // Data buffers allocated so far; flat once a workload reaches steady state
+    qint64 buffersAllocated() const { return buffersAllocated_.load(std::memory_order_relaxed); }
+
+private:
+    // (audio, format, width, height) for video; (audio, 0, 0, bytes) for audio
+    using BufferKey = std::tuple<bool, int, int, int>;
+
+    struct BufferPool {
+        MediaBufferPool* owner = nullptr;
+        AVBufferPool* pool = nullptr;
+        size_t size = 0;
+        bool audio = false;
+    };
+
+    static constexpr size_t MAX_POOLS = 32;
+    static constexpr size_t MAX_SHELLS = 64;
+
+    mutable QMutex mutex_;
+    std::map<BufferKey, std::unique_ptr<BufferPool>> pools_;
+    std::vector<AVFrame*> frames_;
+    std::vector<AVPacket*> packets_;
+    std::atomic<MemoryManager*> memoryManager_{nullptr};
+    std::atomic<qint64> buffersAllocated_{0};
+
+    AVBufferRef* takeBuffer(const BufferKey& key, size_t size);
+    bool fillVideoFrame(AVFrame* frame, int width, int height);
+    void clearPools();
+
+    static AVBufferRef* allocateBuffer(void* opaque, size_t size);
+    static int getBuffer2(AVCodecContext* context, AVFrame* frame, int flags);
+};
+
+} // namespace Murmur
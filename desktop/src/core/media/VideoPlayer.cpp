@@ -1,6 +1,7 @@
 #include "VideoPlayer.hpp"
 #include "../common/Logger.hpp"
 #include "../security/InputValidator.hpp"
+#include "../torrent/TorrentStream.hpp"
 
 #include <QMediaFormat>
 #include <QMediaMetaData>
@@ -12,7 +13,6 @@
 #include <QUrlQuery>
 #include <QTimer>
 #include <QtConcurrent>
-#include <QThreadPool>
 #include <QVideoFrame>
 
 namespace Murmur {
@@ -119,7 +119,7 @@ QUrl VideoPlayer::source() const {
 void VideoPlayer::setSource(const QUrl& source) {
     QMutexLocker locker(&stateMutex_);
     
-    if (currentSource_ == source) {
+    if (currentSource_ == source && !sourceDevice_) {
         return;
     }
     
@@ -136,6 +136,7 @@ void VideoPlayer::setSource(const QUrl& source) {
     }
     
     currentSource_ = source;
+    sourceDevice_ = nullptr;
     mediaPlayer_->setSource(source);
     
     // Reset tracks and metadata
@@ -149,6 +150,36 @@ void VideoPlayer::setSource(const QUrl& source) {
     emit sourceChanged(source);
 }
 
+void VideoPlayer::setSourceDevice(QIODevice* device, const QUrl& sourceUrl) {
+    QMutexLocker locker(&stateMutex_);
+    
+    if (sourceDevice_ == device && currentSource_ == sourceUrl) {
+        return;
+    }
+    
+    if (autoSaveEnabled_ && storageManager_ && !mediaId_.isEmpty()) {
+        persistCurrentPosition();
+    }
+    
+    if (device && !device->isReadable()) {
+        handlePlaybackError(PlayerError::MediaLoadFailed, "Source device is not open for reading");
+        return;
+    }
+    
+    currentSource_ = sourceUrl;
+    sourceDevice_ = device;
+    mediaPlayer_->setSourceDevice(device, sourceUrl);
+    
+    audioTracks_.clear();
+    subtitleTracks_.clear();
+    currentAudioTrack_ = -1;
+    currentSubtitleTrack_ = -1;
+    currentMetadata_ = VideoMetadata{};
+    
+    Logger::instance().info("Source device set: {}", sourceUrl.toString().toStdString());
+    emit sourceChanged(sourceUrl);
+}
+
 PlaybackState VideoPlayer::playbackState() const {
     return currentPlaybackState_;
 }
@@ -224,7 +255,18 @@ QVideoSink* VideoPlayer::videoSink() const {
 }
 
 void VideoPlayer::setStorageManager(StorageManager* storage) {
+    disconnect(positionSavedConnection_);
     storageManager_ = storage;
+    
+    if (storageManager_) {
+        // Queued positions are only saved once the write-behind flush commits
+        positionSavedConnection_ = connect(storageManager_, &StorageManager::playbackPositionSaved, this,
+            [this](const QString& mediaId, qint64 position) {
+                if (mediaId == mediaId_) {
+                    emit positionSaved(position);
+                }
+            });
+    }
 }
 
 void VideoPlayer::setMediaId(const QString& mediaId) {
@@ -432,6 +474,11 @@ void VideoPlayer::setNetworkCacheSize(qint64 sizeBytes) {
 }
 
 qint64 VideoPlayer::bufferedBytes() const {
+    // A streaming device knows exactly how much is downloaded ahead
+    if (sourceDevice_) {
+        return sourceDevice_->bytesAvailable();
+    }
+    
     // Qt 6 MediaPlayer provides buffer progress, calculate approximate buffered bytes
     if (!mediaPlayer_ || duration() <= 0) {
         return 0;
@@ -610,6 +657,11 @@ void VideoPlayer::onMediaPlayerPositionChanged(qint64 position) {
 }
 
 void VideoPlayer::onMediaPlayerDurationChanged(qint64 duration) {
+    // Average bitrate sizes how far ahead a torrent stream fetches
+    if (auto* stream = qobject_cast<TorrentStream*>(sourceDevice_.data()); stream && duration > 0) {
+        stream->setBitrate(stream->size() * 8 * 1000 / duration);
+    }
+    
     emit durationChanged(duration);
 }
 
@@ -718,15 +770,8 @@ void VideoPlayer::persistCurrentPosition() {
     
     qint64 currentPos = position();
     if (currentPos > 0) {
-        // Use QThreadPool::start for fire-and-forget task
-        QThreadPool::globalInstance()->start([this, currentPos]() {
-            auto result = storageManager_->updatePlaybackPosition(mediaId_, currentPos);
-            if (result.hasValue()) {
-                QMetaObject::invokeMethod(this, [this, currentPos]() {
-                    emit positionSaved(currentPos);
-                }, Qt::QueuedConnection);
-            }
-        });
+        // Coalesced with other position updates; positionSaved follows the flush
+        storageManager_->queuePlaybackPosition(mediaId_, currentPos);
     }
 }
 
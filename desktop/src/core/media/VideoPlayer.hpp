@@ -11,6 +11,7 @@
 #include <QSize>
 #include <QEventLoop>
 #include <QImage>
+#include <QPointer>
 #include "../common/Expected.hpp"
 #include "../storage/StorageManager.hpp"
 
@@ -118,6 +119,10 @@ public:
     QUrl source() const;
     void setSource(const QUrl& source);
     
+    // Plays from an open device, such as a TorrentStream, which the caller
+    // keeps alive; sourceUrl only names the media for format detection
+    void setSourceDevice(QIODevice* device, const QUrl& sourceUrl = QUrl());
+    
     PlaybackState playbackState() const;
     MediaStatus mediaStatus() const;
     
@@ -232,7 +237,7 @@ signals:
     void metadataChanged(const VideoMetadata& metadata);
     void snapshotCaptured(const QString& filePath);
     void thumbnailsGenerated(const QList<QString>& filePaths);
-    void positionSaved(qint64 position);
+    void positionSaved(qint64 position);  // Once the position is committed to storage
     void positionRestored(qint64 position);
 
 private slots:
@@ -254,12 +259,14 @@ private:
     
     // Storage and persistence
     StorageManager* storageManager_ = nullptr;
+    QMetaObject::Connection positionSavedConnection_;
     QString mediaId_;
     QTimer* autoSaveTimer_;
     bool autoSaveEnabled_ = true;
     
     // Current state
     QUrl currentSource_;
+    QPointer<QIODevice> sourceDevice_;
     PlaybackState currentPlaybackState_ = PlaybackState::Stopped;
     MediaStatus currentMediaStatus_ = MediaStatus::NoMedia;
     VideoMetadata currentMetadata_;
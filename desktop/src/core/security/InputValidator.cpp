@@ -723,8 +723,9 @@ bool InputValidator::isValidCacheKey(const QString& key) {
         return false;
     }
     
-    // Cache keys can be more flexible than identifiers
-    QRegularExpression cacheKeyPattern("^[a-zA-Z0-9._-]+$");
+    // Cache keys can be more flexible than identifiers. Compiled once since
+    // every FileCache lookup validates its key.
+    static const QRegularExpression cacheKeyPattern("^[a-zA-Z0-9._-]+$");
     return cacheKeyPattern.match(key).hasMatch();
 }
 
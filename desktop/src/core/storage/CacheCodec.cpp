@@ -0,0 +1,257 @@
+#include "CacheCodec.hpp"
+
+#include <lz4.h>
+#include <zstd.h>
+#include <zdict.h>
+
+#include <cstring>
+#include <vector>
+
+namespace Murmur {
+
+struct CompressionDictionary::Tables {
+    ZSTD_CDict* compression = nullptr;
+    ZSTD_DDict* decompression = nullptr;
+
+    ~Tables() {
+        ZSTD_freeCDict(compression);
+        ZSTD_freeDDict(decompression);
+    }
+};
+
+CompressionDictionary::~CompressionDictionary() = default;
+
+Expected<std::shared_ptr<const CompressionDictionary>, CodecError> CompressionDictionary::fromBytes(const QByteArray& bytes,
+                                                                                                    int level) {
+    const quint32 dictionaryId = ZDICT_getDictID(bytes.constData(), static_cast<size_t>(bytes.size()));
+    if (bytes.isEmpty() || dictionaryId == 0) {
+        return makeUnexpected(CodecError::DictionaryInvalid);
+    }
+
+    std::shared_ptr<CompressionDictionary> dictionary(new CompressionDictionary());
+    dictionary->id_ = dictionaryId;
+    dictionary->bytes_ = bytes;
+    dictionary->tables_ = std::make_unique<Tables>();
+    dictionary->tables_->compression = ZSTD_createCDict(bytes.constData(), static_cast<size_t>(bytes.size()), level);
+    dictionary->tables_->decompression = ZSTD_createDDict(bytes.constData(), static_cast<size_t>(bytes.size()));
+    if (!dictionary->tables_->compression || !dictionary->tables_->decompression) {
+        return makeUnexpected(CodecError::DictionaryInvalid);
+    }
+
+    return std::shared_ptr<const CompressionDictionary>(std::move(dictionary));
+}
+
+Expected<std::shared_ptr<const CompressionDictionary>, CodecError> CompressionDictionary::train(const QList<QByteArray>& samples,
+                                                                                                int maxSize, int level) {
+    if (samples.isEmpty() || maxSize <= 0) {
+        return makeUnexpected(CodecError::DictionaryTrainingFailed);
+    }
+
+    // ZDICT wants every sample concatenated plus a table of their sizes
+    QByteArray concatenated;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(static_cast<size_t>(samples.size()));
+    for (const QByteArray& sample : samples) {
+        concatenated.append(sample);
+        sampleSizes.push_back(static_cast<size_t>(sample.size()));
+    }
+
+    QByteArray buffer(maxSize, Qt::Uninitialized);
+    const size_t dictionarySize = ZDICT_trainFromBuffer(buffer.data(), static_cast<size_t>(buffer.size()),
+                                                        concatenated.constData(), sampleSizes.data(),
+                                                        static_cast<unsigned>(sampleSizes.size()));
+    if (ZDICT_isError(dictionarySize)) {
+        return makeUnexpected(CodecError::DictionaryTrainingFailed);
+    }
+    buffer.truncate(static_cast<qsizetype>(dictionarySize));
+
+    return fromBytes(buffer, level);
+}
+
+namespace {
+
+struct ZstdContexts {
+    ZSTD_CCtx* compression = ZSTD_createCCtx();
+    ZSTD_DCtx* decompression = ZSTD_createDCtx();
+
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(compression);
+        ZSTD_freeDCtx(decompression);
+    }
+};
+
+// Contexts are expensive to create, so each thread keeps one of each
+ZstdContexts& zstdContexts() {
+    thread_local ZstdContexts contexts;
+    return contexts;
+}
+
+class NoneCodec : public CacheCodec {
+public:
+    CacheCodecId id() const override { return CacheCodecId::None; }
+    QString name() const override { return QStringLiteral("none"); }
+
+    Expected<QByteArray, CodecError> compress(const QByteArray& data, int, const CompressionDictionary*) const override {
+        return data;
+    }
+
+    Expected<QByteArray, CodecError> decompress(const QByteArray& data, qint64, const CompressionDictionary*) const override {
+        return data;
+    }
+};
+
+class ZlibCodec : public CacheCodec {
+public:
+    CacheCodecId id() const override { return CacheCodecId::Zlib; }
+    QString name() const override { return QStringLiteral("zlib"); }
+
+    Expected<QByteArray, CodecError> compress(const QByteArray& data, int level, const CompressionDictionary*) const override {
+        QByteArray compressed = qCompress(data, level);
+        if (compressed.isEmpty()) {
+            return makeUnexpected(CodecError::CompressionFailed);
+        }
+        return compressed;
+    }
+
+    Expected<QByteArray, CodecError> decompress(const QByteArray& data, qint64, const CompressionDictionary*) const override {
+        QByteArray decompressed = qUncompress(data);
+        if (decompressed.isEmpty()) {
+            return makeUnexpected(CodecError::DecompressionFailed);
+        }
+        return decompressed;
+    }
+};
+
+class Lz4Codec : public CacheCodec {
+public:
+    CacheCodecId id() const override { return CacheCodecId::Lz4; }
+    QString name() const override { return QStringLiteral("lz4"); }
+
+    Expected<QByteArray, CodecError> compress(const QByteArray& data, int, const CompressionDictionary*) const override {
+        if (data.size() > LZ4_MAX_INPUT_SIZE) {
+            return makeUnexpected(CodecError::CompressionFailed);
+        }
+
+        const int sourceSize = static_cast<int>(data.size());
+        QByteArray compressed(LZ4_compressBound(sourceSize), Qt::Uninitialized);
+        const int written = LZ4_compress_default(data.constData(), compressed.data(), sourceSize,
+                                                 static_cast<int>(compressed.size()));
+        if (written <= 0) {
+            return makeUnexpected(CodecError::CompressionFailed);
+        }
+        compressed.truncate(written);
+        return compressed;
+    }
+
+    Expected<QByteArray, CodecError> decompress(const QByteArray& data, qint64 originalSize,
+                                               const CompressionDictionary*) const override {
+        // LZ4 blocks carry no size header, so the recorded size bounds the output
+        if (originalSize < 0 || originalSize > LZ4_MAX_INPUT_SIZE) {
+            return makeUnexpected(CodecError::DecompressionFailed);
+        }
+
+        QByteArray decompressed(static_cast<qsizetype>(originalSize), Qt::Uninitialized);
+        const int written = LZ4_decompress_safe(data.constData(), decompressed.data(), static_cast<int>(data.size()),
+                                                static_cast<int>(originalSize));
+        if (written != originalSize) {
+            return makeUnexpected(CodecError::DecompressionFailed);
+        }
+        return decompressed;
+    }
+};
+
+} // namespace
+
+class ZstdCodec : public CacheCodec {
+public:
+    CacheCodecId id() const override { return CacheCodecId::Zstd; }
+    QString name() const override { return QStringLiteral("zstd"); }
+
+    Expected<QByteArray, CodecError> compress(const QByteArray& data, int level,
+                                             const CompressionDictionary* dictionary) const override {
+        ZstdContexts& contexts = zstdContexts();
+        QByteArray compressed(static_cast<qsizetype>(ZSTD_compressBound(static_cast<size_t>(data.size()))),
+                              Qt::Uninitialized);
+
+        // A prepared dictionary carries its own level
+        const size_t written = dictionary
+            ? ZSTD_compress_usingCDict(contexts.compression, compressed.data(), static_cast<size_t>(compressed.size()),
+                                       data.constData(), static_cast<size_t>(data.size()),
+                                       dictionary->tables_->compression)
+            : ZSTD_compressCCtx(contexts.compression, compressed.data(), static_cast<size_t>(compressed.size()),
+                                data.constData(), static_cast<size_t>(data.size()), level);
+        if (ZSTD_isError(written)) {
+            return makeUnexpected(CodecError::CompressionFailed);
+        }
+        compressed.truncate(static_cast<qsizetype>(written));
+        return compressed;
+    }
+
+    Expected<QByteArray, CodecError> decompress(const QByteArray& data, qint64 originalSize,
+                                               const CompressionDictionary* dictionary) const override {
+        const unsigned frameDictionary = ZSTD_getDictID_fromFrame(data.constData(), static_cast<size_t>(data.size()));
+        if (frameDictionary != 0 && (!dictionary || dictionary->id() != frameDictionary)) {
+            return makeUnexpected(CodecError::DictionaryMissing);
+        }
+        if (originalSize < 0) {
+            return makeUnexpected(CodecError::DecompressionFailed);
+        }
+
+        ZstdContexts& contexts = zstdContexts();
+        QByteArray decompressed(static_cast<qsizetype>(originalSize), Qt::Uninitialized);
+        const size_t written = frameDictionary != 0
+            ? ZSTD_decompress_usingDDict(contexts.decompression, decompressed.data(), static_cast<size_t>(originalSize),
+                                         data.constData(), static_cast<size_t>(data.size()),
+                                         dictionary->tables_->decompression)
+            : ZSTD_decompressDCtx(contexts.decompression, decompressed.data(), static_cast<size_t>(originalSize),
+                                  data.constData(), static_cast<size_t>(data.size()));
+        if (ZSTD_isError(written) || written != static_cast<size_t>(originalSize)) {
+            return makeUnexpected(CodecError::DecompressionFailed);
+        }
+        return decompressed;
+    }
+};
+
+const CacheCodec* CacheCodec::forId(CacheCodecId id) {
+    static const NoneCodec none;
+    static const ZlibCodec zlib;
+    static const Lz4Codec lz4;
+    static const ZstdCodec zstd;
+
+    switch (id) {
+        case CacheCodecId::None: return &none;
+        case CacheCodecId::Zlib: return &zlib;
+        case CacheCodecId::Lz4: return &lz4;
+        case CacheCodecId::Zstd: return &zstd;
+    }
+    return nullptr;
+}
+
+bool CacheCodec::isLikelyIncompressible(const QByteArray& data) {
+    if (data.size() < 12) {
+        return false;
+    }
+
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.constData());
+    auto startsWith = [bytes](const char* magic, size_t length, size_t offset = 0) {
+        return std::memcmp(bytes + offset, magic, length) == 0;
+    };
+
+    return startsWith("\xFF\xD8\xFF", 3)                               // JPEG
+        || startsWith("\x89PNG", 4)                                    // PNG
+        || startsWith("GIF8", 4)                                       // GIF
+        || (startsWith("RIFF", 4) && startsWith("WEBP", 4, 8))         // WebP
+        || startsWith("\x1F\x8B", 2)                                   // gzip
+        || startsWith("\x28\xB5\x2F\xFD", 4)                           // zstd
+        || startsWith("\xFD" "7zXZ", 5)                                // xz
+        || startsWith("BZh", 3)                                        // bzip2
+        || startsWith("PK\x03\x04", 4)                                 // zip
+        || startsWith("ftyp", 4, 4)                                    // MP4/MOV/M4A
+        || startsWith("\x1A\x45\xDF\xA3", 4)                           // Matroska/WebM
+        || startsWith("OggS", 4)                                       // Ogg
+        || startsWith("fLaC", 4)                                       // FLAC
+        || startsWith("ID3", 3)                                        // MP3
+        || (bytes[0] == 0xFF && (bytes[1] & 0xE0) == 0xE0);            // MPEG audio frame
+}
+
+} // namespace Murmur
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <memory>
+
+#include "core/common/Expected.hpp"
+
+namespace Murmur {
+
+enum class CacheCodecId : quint8 {
+    None = 0,   // Stored as-is
+    Zlib = 1,   // qCompress, kept to read entries written before codecs existed
+    Lz4 = 2,    // Fast codec for the hot put/get path
+    Zstd = 3    // High-ratio codec, optionally with a trained dictionary
+};
+
+enum class CodecError {
+    UnsupportedCodec,
+    CompressionFailed,
+    DecompressionFailed,
+    DictionaryMissing,
+    DictionaryInvalid,
+    DictionaryTrainingFailed
+};
+
+/**
+ * @brief Trained Zstd dictionary with its prepared compression/decompression tables
+ *
+ * Dictionaries pay off for many small, similar payloads such as JSON
+ * metadata. Instances are immutable and safe to share across threads.
+ */
+class CompressionDictionary {
+public:
+    ~CompressionDictionary();
+
+    CompressionDictionary(const CompressionDictionary&) = delete;
+    CompressionDictionary& operator=(const CompressionDictionary&) = delete;
+
+    static Expected<std::shared_ptr<const CompressionDictionary>, CodecError> fromBytes(const QByteArray& bytes, int level);
+    static Expected<std::shared_ptr<const CompressionDictionary>, CodecError> train(const QList<QByteArray>& samples,
+                                                                                     int maxSize, int level);
+
+    quint32 id() const { return id_; }
+    const QByteArray& bytes() const { return bytes_; }
+
+private:
+    CompressionDictionary() = default;
+
+    struct Tables;
+    friend class ZstdCodec;
+
+    quint32 id_ = 0;
+    QByteArray bytes_;
+    std::unique_ptr<Tables> tables_;
+};
+
+/**
+ * @brief Block codec used by FileCache to store entry payloads
+ *
+ * Codecs are stateless singletons; per-thread scratch contexts make every
+ * method safe to call concurrently.
+ */
+class CacheCodec {
+public:
+    virtual ~CacheCodec() = default;
+
+    virtual CacheCodecId id() const = 0;
+    virtual QString name() const = 0;
+
+    /**
+     * @brief Compress a payload
+     * @param level Codec-specific level; ignored by codecs without levels
+     * @param dictionary Optional dictionary; ignored by codecs without dictionary support
+     */
+    virtual Expected<QByteArray, CodecError> compress(const QByteArray& data, int level,
+                                                     const CompressionDictionary* dictionary = nullptr) const = 0;
+
+    /**
+     * @brief Decompress a payload produced by compress()
+     * @param originalSize Uncompressed size recorded at compression time
+     */
+    virtual Expected<QByteArray, CodecError> decompress(const QByteArray& data, qint64 originalSize,
+                                                       const CompressionDictionary* dictionary = nullptr) const = 0;
+
+    static const CacheCodec* forId(CacheCodecId id);
+
+    /**
+     * @brief Cheap magic-number check for formats that are already compressed
+     *
+     * JPEG/PNG/WebP thumbnails, audio and container formats gain nothing from
+     * another compression pass, so FileCache stores them without trying.
+     */
+    static bool isLikelyIncompressible(const QByteArray& data);
+};
+
+} // namespace Murmur
@@ -0,0 +1,645 @@
+#include "CacheIndex.hpp"
+#include "core/common/Logger.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+#include <xxhash.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Murmur {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'M', 'R', 'I', 'D', 'X', '0', '0', '1'};
+constexpr char JOURNAL_MAGIC[8] = {'M', 'R', 'J', 'N', 'L', '0', '0', '1'};
+constexpr quint32 SNAPSHOT_VERSION = 2;
+constexpr quint32 SNAPSHOT_VERSION_WHOLE_BODY_CHECKSUM = 1;
+constexpr quint32 JOURNAL_OP_MAGIC = 0x504F4A4D; // "MJOP"
+constexpr quint32 MAX_KEY_LENGTH = 64 * 1024;
+
+constexpr quint8 OP_PUT = 1;
+constexpr quint8 OP_REMOVE = 2;
+
+constexpr quint8 FLAG_COMPRESSED = 0x01;
+constexpr quint8 FLAG_CHECKSUM = 0x02;
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    quint64 generation;
+    quint64 recordCount;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+    quint64 payloadsOffset;
+    quint64 payloadsSize;
+    quint64 bodyChecksum; // XXH3 of the record table and key strings; version 1 covered payloads too
+    quint64 reserved;
+};
+static_assert(sizeof(SnapshotHeader) == 80, "SnapshotHeader is written to disk as-is");
+
+// Fixed-size entry record; keys and inline payloads live in their own regions.
+// Each inline payload is preceded by its own XXH3, checked when it is decoded.
+struct IndexRecord {
+    quint64 keyHash;
+    quint32 keyOffset;
+    quint32 keyLength;
+    qint64 createdAtMs;
+    qint64 lastAccessedMs;
+    qint64 lastModifiedMs;
+    qint64 size;
+    qint64 originalSize;
+    qint64 accessCount;
+    qint64 ttl;
+    qint64 segmentOffset;
+    qint64 payloadOffset; // into the payload region, -1 when none
+    quint64 checksum;
+    quint32 segmentId;
+    quint32 dictionaryId;
+    quint8 codec;
+    quint8 flags;
+    quint8 reserved[6];
+};
+static_assert(sizeof(IndexRecord) == 112, "IndexRecord is written to disk as-is");
+
+struct JournalHeader {
+    char magic[8];
+    quint64 generation;
+};
+static_assert(sizeof(JournalHeader) == 16, "JournalHeader is written to disk as-is");
+
+// Followed by an IndexRecord for puts, then the key
+struct JournalOp {
+    quint32 magic;
+    quint8 op;
+    quint8 reserved[3];
+    quint32 keyLength;
+    quint32 bodyLength;
+    quint64 checksum; // XXH3 of the body, seeded with the op
+};
+static_assert(sizeof(JournalOp) == 24, "JournalOp is written to disk as-is");
+
+quint64 hashKey(const QByteArray& key) {
+    return XXH3_64bits(key.constData(), static_cast<size_t>(key.size()));
+}
+
+qint64 toMs(const QDateTime& time) {
+    return time.isValid() ? time.toMSecsSinceEpoch() : -1;
+}
+
+QDateTime fromMs(qint64 ms) {
+    return ms >= 0 ? QDateTime::fromMSecsSinceEpoch(ms).toUTC() : QDateTime();
+}
+
+IndexRecord encode(const CacheEntry& entry) {
+    IndexRecord record{};
+    record.createdAtMs = toMs(entry.createdAt);
+    record.lastAccessedMs = toMs(entry.lastAccessed);
+    record.lastModifiedMs = toMs(entry.lastModified);
+    record.size = entry.size;
+    record.originalSize = entry.originalSize;
+    record.accessCount = entry.accessCount;
+    record.ttl = entry.ttl;
+    record.segmentId = entry.segmentId;
+    record.segmentOffset = entry.segmentOffset;
+    record.payloadOffset = -1;
+    record.dictionaryId = entry.dictionaryId;
+    record.codec = static_cast<quint8>(entry.codec);
+    record.flags = entry.compressed ? FLAG_COMPRESSED : 0;
+
+    // Only XXH3 digests fit the record; legacy MD5 digests are dropped
+    if (entry.checksum.size() == static_cast<qsizetype>(sizeof(quint64))) {
+        record.checksum = qFromBigEndian<quint64>(entry.checksum.constData());
+        record.flags |= FLAG_CHECKSUM;
+    }
+    return record;
+}
+
+CacheEntry decodeRecord(const IndexRecord& record, const QString& key) {
+    CacheEntry entry;
+    entry.key = key;
+    entry.createdAt = fromMs(record.createdAtMs);
+    entry.lastAccessed = fromMs(record.lastAccessedMs);
+    entry.lastModified = fromMs(record.lastModifiedMs);
+    entry.size = record.size;
+    entry.originalSize = record.originalSize;
+    entry.accessCount = record.accessCount;
+    entry.ttl = record.ttl;
+    entry.compressed = record.flags & FLAG_COMPRESSED;
+    entry.dirty = false;
+    entry.codec = static_cast<CacheCodecId>(record.codec);
+    entry.dictionaryId = record.dictionaryId;
+    entry.segmentId = record.segmentId;
+    entry.segmentOffset = record.segmentOffset;
+    if (record.flags & FLAG_CHECKSUM) {
+        entry.checksum.resize(sizeof(quint64));
+        qToBigEndian(record.checksum, entry.checksum.data());
+    }
+    return entry;
+}
+
+bool isKnownCodec(quint8 codec) {
+    return codec <= static_cast<quint8>(CacheCodecId::Zstd);
+}
+
+} // namespace
+
+CacheIndex::CacheIndex(const QString& directory)
+    : directory_(directory)
+{
+}
+
+CacheIndex::~CacheIndex() {
+    close();
+}
+
+Expected<IndexRecovery, CacheError> CacheIndex::open() {
+    IndexRecovery recovery;
+
+    const quint64 snapshotGeneration = mapSnapshot() ? generation_ : 0;
+
+    // Journals older than the snapshot are fully contained in it
+    QList<quint64> generations;
+    const QFileInfoList files = QDir(directory_).entryInfoList({"cache_index.journal.*"}, QDir::Files);
+    for (const QFileInfo& info : files) {
+        bool ok = false;
+        const quint64 generation = info.suffix().toULongLong(&ok);
+        if (!ok || generation < snapshotGeneration) {
+            QFile::remove(info.absoluteFilePath());
+            continue;
+        }
+        generations.append(generation);
+    }
+    std::sort(generations.begin(), generations.end());
+
+    qint64 replayed = 0;
+    for (quint64 generation : generations) {
+        const qint64 before = recovery.puts.size() + recovery.removals.size();
+        if (!replayJournal(journalPath(generation), recovery)) {
+            Logger::instance().warn("Cache index journal {} is unreadable, skipping it", generation);
+        }
+        replayed += recovery.puts.size() + recovery.removals.size() - before;
+    }
+
+    // Keep appending to the newest journal so its generation stays ordered
+    // after the snapshot it follows
+    const quint64 appendGeneration = generations.isEmpty() ? snapshotGeneration : generations.last();
+    {
+        QMutexLocker locker(&journalMutex_);
+        if (!openJournal(appendGeneration)) {
+            return makeUnexpected(CacheError::InitializationFailed);
+        }
+        journalOps_ = replayed;
+    }
+
+    Logger::instance().info("Cache index opened: {} snapshot entries (generation {}), {} journaled keys",
+                            snapshotRecords_, snapshotGeneration, replayed);
+    return recovery;
+}
+
+void CacheIndex::close() {
+    {
+        QMutexLocker locker(&journalMutex_);
+        if (journal_.isOpen()) {
+            journal_.close();
+        }
+    }
+    releaseSnapshot();
+}
+
+qint64 CacheIndex::snapshotEntryCount() const {
+    QReadLocker locker(&snapshotLock_);
+    return snapshot_ ? snapshotRecords_ : 0;
+}
+
+bool CacheIndex::hasSnapshot() const {
+    return QFile::exists(snapshotPath());
+}
+
+Expected<CacheEntry, CacheError> CacheIndex::lookup(const QString& key) const {
+    QReadLocker locker(&snapshotLock_);
+    if (!snapshot_) {
+        return makeUnexpected(CacheError::KeyNotFound);
+    }
+
+    const QByteArray keyBytes = key.toUtf8();
+    const quint64 hash = hashKey(keyBytes);
+    const uchar* records = snapshot_ + sizeof(SnapshotHeader);
+    auto hashAt = [records](qint64 index) {
+        quint64 value;
+        std::memcpy(&value, records + index * sizeof(IndexRecord), sizeof(value));
+        return value;
+    };
+
+    // Records are sorted by key hash
+    qint64 low = 0;
+    qint64 high = snapshotRecords_;
+    while (low < high) {
+        const qint64 middle = low + (high - low) / 2;
+        if (hashAt(middle) < hash) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, snapshot_, sizeof(header));
+    for (qint64 index = low; index < snapshotRecords_ && hashAt(index) == hash; ++index) {
+        IndexRecord record;
+        std::memcpy(&record, records + index * sizeof(IndexRecord), sizeof(record));
+        const char* storedKey = reinterpret_cast<const char*>(snapshot_ + header.stringsOffset + record.keyOffset);
+        if (record.keyLength == static_cast<quint32>(keyBytes.size()) &&
+            record.keyOffset + static_cast<quint64>(record.keyLength) <= header.stringsSize &&
+            std::memcmp(storedKey, keyBytes.constData(), record.keyLength) == 0) {
+            return decode(index);
+        }
+    }
+    return makeUnexpected(CacheError::KeyNotFound);
+}
+
+QList<CacheEntry> CacheIndex::snapshotEntries(qint64 first, qint64 count) const {
+    QReadLocker locker(&snapshotLock_);
+    QList<CacheEntry> entries;
+    if (!snapshot_) {
+        return entries;
+    }
+
+    const qint64 last = std::min(snapshotRecords_, first + count);
+    entries.reserve(std::max<qint64>(0, last - first));
+    for (qint64 index = first; index < last; ++index) {
+        entries.append(decode(index));
+    }
+    return entries;
+}
+
+void CacheIndex::releaseSnapshot() {
+    QWriteLocker locker(&snapshotLock_);
+    unmapSnapshot();
+}
+
+void CacheIndex::recordEntry(const CacheEntry& entry) {
+    // Anything not in a segment is either memory-only or in a per-key file
+    // that FileCache reads on demand, so the snapshot copy must not survive
+    if (entry.segmentOffset >= 0) {
+        appendJournal(OP_PUT, entry.key, &entry);
+    } else {
+        appendJournal(OP_REMOVE, entry.key, nullptr);
+    }
+}
+
+void CacheIndex::recordRemoval(const QString& key) {
+    appendJournal(OP_REMOVE, key, nullptr);
+}
+
+qint64 CacheIndex::journalLength() const {
+    QMutexLocker locker(&journalMutex_);
+    return journalOps_;
+}
+
+quint64 CacheIndex::beginSnapshot() {
+    QMutexLocker locker(&journalMutex_);
+    const quint64 generation = generation_ + 1;
+    if (!openJournal(generation)) {
+        // Keep journaling into the current generation
+        openJournal(generation_);
+        return 0;
+    }
+    journalOps_ = 0;
+    return generation;
+}
+
+Expected<void, CacheError> CacheIndex::commitSnapshot(quint64 generation, const QList<CacheEntry>& entries) {
+    struct Pending {
+        quint64 hash;
+        qsizetype entry;
+        QByteArray key;
+    };
+
+    std::vector<Pending> pending;
+    pending.reserve(static_cast<size_t>(entries.size()));
+    for (qsizetype i = 0; i < entries.size(); ++i) {
+        QByteArray key = entries[i].key.toUtf8();
+        const quint64 hash = hashKey(key);
+        pending.push_back({hash, i, std::move(key)});
+    }
+    std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) { return a.hash < b.hash; });
+
+    std::vector<IndexRecord> records;
+    records.reserve(pending.size());
+    QByteArray strings;
+    qint64 payloadsSize = 0;
+    for (const Pending& item : pending) {
+        const CacheEntry& entry = entries[item.entry];
+        IndexRecord record = encode(entry);
+        record.keyHash = item.hash;
+        record.keyOffset = static_cast<quint32>(strings.size());
+        record.keyLength = static_cast<quint32>(item.key.size());
+        strings.append(item.key);
+        if (entry.segmentOffset < 0) {
+            record.payloadOffset = payloadsSize;
+            payloadsSize += static_cast<qint64>(sizeof(quint64)) + entry.data.size();
+        }
+        records.push_back(record);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.recordSize = sizeof(IndexRecord);
+    header.generation = generation;
+    header.recordCount = records.size();
+    header.stringsOffset = sizeof(SnapshotHeader) + records.size() * sizeof(IndexRecord);
+    header.stringsSize = static_cast<quint64>(strings.size());
+    header.payloadsOffset = header.stringsOffset + header.stringsSize;
+    header.payloadsSize = static_cast<quint64>(payloadsSize);
+
+    // Only the records and keys are checked on open; payloads carry their
+    // own checksums so startup does not read them
+    const char* recordBytes = reinterpret_cast<const char*>(records.data());
+    const qint64 recordBytesSize = static_cast<qint64>(records.size() * sizeof(IndexRecord));
+    XXH3_state_t* state = XXH3_createState();
+    XXH3_64bits_reset(state);
+    XXH3_64bits_update(state, recordBytes, static_cast<size_t>(recordBytesSize));
+    XXH3_64bits_update(state, strings.constData(), static_cast<size_t>(strings.size()));
+    header.bodyChecksum = XXH3_64bits_digest(state);
+    XXH3_freeState(state);
+
+    // Written to a temporary file and renamed into place, so a crash leaves
+    // either the previous snapshot or this one
+    QSaveFile file(snapshotPath());
+    bool ok = file.open(QIODevice::WriteOnly);
+    ok = ok && file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+    ok = ok && file.write(recordBytes, recordBytesSize) == recordBytesSize;
+    ok = ok && file.write(strings) == strings.size();
+    for (const Pending& item : pending) {
+        const CacheEntry& entry = entries[item.entry];
+        if (ok && entry.segmentOffset < 0) {
+            const quint64 checksum = XXH3_64bits(entry.data.constData(), static_cast<size_t>(entry.data.size()));
+            ok = file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum)) == sizeof(checksum) &&
+                 file.write(entry.data) == entry.data.size();
+        }
+    }
+    if (!ok || !file.commit()) {
+        Logger::instance().error("Failed to write cache index snapshot: {}", file.errorString().toStdString());
+        return makeUnexpected(CacheError::WriteError);
+    }
+
+    {
+        QMutexLocker locker(&journalMutex_);
+        removeJournalsBefore(generation);
+    }
+
+    Logger::instance().info("Cache index snapshot {} written: {} entries", generation, records.size());
+    return Expected<void, CacheError>();
+}
+
+bool CacheIndex::mapSnapshot() {
+    QWriteLocker locker(&snapshotLock_);
+    unmapSnapshot();
+
+    snapshotFile_.setFileName(snapshotPath());
+    if (!snapshotFile_.exists()) {
+        return false;
+    }
+
+    auto discard = [this](const char* reason) {
+        Logger::instance().warn("Discarding cache index snapshot: {}", reason);
+        unmapSnapshot();
+        QFile::remove(snapshotPath());
+        return false;
+    };
+
+    if (!snapshotFile_.open(QIODevice::ReadOnly) ||
+        snapshotFile_.size() < static_cast<qint64>(sizeof(SnapshotHeader))) {
+        return discard("unreadable");
+    }
+
+    const qint64 fileSize = snapshotFile_.size();
+    snapshot_ = snapshotFile_.map(0, fileSize);
+    if (!snapshot_) {
+        return discard("cannot be mapped");
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, snapshot_, sizeof(header));
+    const quint64 recordsEnd = sizeof(SnapshotHeader) + header.recordCount * sizeof(IndexRecord);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        (header.version != SNAPSHOT_VERSION && header.version != SNAPSHOT_VERSION_WHOLE_BODY_CHECKSUM) ||
+        header.recordSize != sizeof(IndexRecord) ||
+        header.recordCount > static_cast<quint64>(fileSize) / sizeof(IndexRecord) ||
+        header.stringsOffset != recordsEnd ||
+        header.payloadsOffset != header.stringsOffset + header.stringsSize ||
+        header.payloadsOffset + header.payloadsSize != static_cast<quint64>(fileSize)) {
+        return discard("invalid header");
+    }
+
+    // Records and keys only, so the cost follows the entry count rather than
+    // the inline payload bytes
+    const uchar* body = snapshot_ + sizeof(SnapshotHeader);
+    const quint64 checkedSize = header.version == SNAPSHOT_VERSION_WHOLE_BODY_CHECKSUM
+        ? static_cast<quint64>(fileSize) - sizeof(SnapshotHeader)
+        : header.payloadsOffset - sizeof(SnapshotHeader);
+    if (XXH3_64bits(body, static_cast<size_t>(checkedSize)) != header.bodyChecksum) {
+        return discard("checksum mismatch");
+    }
+
+    snapshotVersion_ = header.version;
+    snapshotRecords_ = static_cast<qint64>(header.recordCount);
+    generation_ = header.generation;
+    return true;
+}
+
+void CacheIndex::unmapSnapshot() {
+    if (snapshot_) {
+        snapshotFile_.unmap(const_cast<uchar*>(snapshot_));
+        snapshot_ = nullptr;
+    }
+    if (snapshotFile_.isOpen()) {
+        snapshotFile_.close();
+    }
+    snapshotRecords_ = 0;
+    snapshotVersion_ = 0;
+}
+
+CacheEntry CacheIndex::decode(qint64 index) const {
+    SnapshotHeader header;
+    std::memcpy(&header, snapshot_, sizeof(header));
+    IndexRecord record;
+    std::memcpy(&record, snapshot_ + sizeof(SnapshotHeader) + index * sizeof(IndexRecord), sizeof(record));
+
+    // Offsets are bounds-checked so a damaged record decodes to an entry
+    // FileCache rejects instead of reading outside the mapping
+    CacheEntry entry;
+    if (record.keyOffset + static_cast<quint64>(record.keyLength) > header.stringsSize ||
+        !isKnownCodec(record.codec)) {
+        return entry;
+    }
+
+    const char* key = reinterpret_cast<const char*>(snapshot_ + header.stringsOffset + record.keyOffset);
+    entry = decodeRecord(record, QString::fromUtf8(key, record.keyLength));
+    if (record.payloadOffset < 0 || record.size < 0) {
+        return entry;
+    }
+
+    // Version 1 payloads were covered by the body checksum on open
+    const bool payloadChecksum = snapshotVersion_ != SNAPSHOT_VERSION_WHOLE_BODY_CHECKSUM;
+    const quint64 prefix = payloadChecksum ? sizeof(quint64) : 0;
+    if (static_cast<quint64>(record.payloadOffset) + prefix + static_cast<quint64>(record.size) > header.payloadsSize) {
+        return entry;
+    }
+
+    const uchar* payload = snapshot_ + header.payloadsOffset + record.payloadOffset;
+    if (payloadChecksum) {
+        quint64 expected;
+        std::memcpy(&expected, payload, sizeof(expected));
+        payload += prefix;
+        if (XXH3_64bits(payload, static_cast<size_t>(record.size)) != expected) {
+            Logger::instance().warn("Cache index snapshot payload for {} is corrupt, dropping it",
+                                    entry.key.toStdString());
+            return CacheEntry();
+        }
+    }
+    entry.data = QByteArray(reinterpret_cast<const char*>(payload), static_cast<qsizetype>(record.size));
+    return entry;
+}
+
+bool CacheIndex::replayJournal(const QString& path, IndexRecovery& recovery) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // Journals are bounded by the snapshot interval, so read them whole
+    const QByteArray data = file.readAll();
+    JournalHeader header;
+    if (data.size() < static_cast<qsizetype>(sizeof(header))) {
+        file.resize(0);
+        return false;
+    }
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        return false;
+    }
+
+    qint64 position = sizeof(header);
+    while (position + static_cast<qint64>(sizeof(JournalOp)) <= data.size()) {
+        JournalOp op;
+        std::memcpy(&op, data.constData() + position, sizeof(op));
+        const qint64 bodyStart = position + static_cast<qint64>(sizeof(op));
+        const quint32 expectedBody = op.keyLength + (op.op == OP_PUT ? sizeof(IndexRecord) : 0);
+        if (op.magic != JOURNAL_OP_MAGIC || (op.op != OP_PUT && op.op != OP_REMOVE) ||
+            op.keyLength > MAX_KEY_LENGTH || op.bodyLength != expectedBody ||
+            bodyStart + op.bodyLength > data.size()) {
+            break;
+        }
+        const char* body = data.constData() + bodyStart;
+        if (XXH3_64bits_withSeed(body, op.bodyLength, op.op) != op.checksum) {
+            break;
+        }
+
+        const char* keyBytes = body + (op.op == OP_PUT ? sizeof(IndexRecord) : 0);
+        const QString key = QString::fromUtf8(keyBytes, op.keyLength);
+        if (op.op == OP_PUT) {
+            IndexRecord record;
+            std::memcpy(&record, body, sizeof(record));
+            if (isKnownCodec(record.codec)) {
+                recovery.puts.insert(key, decodeRecord(record, key));
+                recovery.removals.remove(key);
+            }
+        } else {
+            recovery.puts.remove(key);
+            recovery.removals.insert(key);
+        }
+        position = bodyStart + op.bodyLength;
+    }
+
+    // Anything after the last complete operation is a torn write
+    if (position < data.size()) {
+        Logger::instance().warn("Truncating torn cache index journal tail: {} bytes", data.size() - position);
+        file.resize(position);
+    }
+    return true;
+}
+
+bool CacheIndex::openJournal(quint64 generation) {
+    if (journal_.isOpen()) {
+        journal_.close();
+    }
+
+    journal_.setFileName(journalPath(generation));
+    const bool exists = journal_.exists() && QFileInfo(journal_.fileName()).size() >= static_cast<qint64>(sizeof(JournalHeader));
+    if (!journal_.open(exists ? QIODevice::WriteOnly | QIODevice::Append : QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Logger::instance().error("Failed to open cache index journal: {}", journal_.fileName().toStdString());
+        return false;
+    }
+
+    if (!exists) {
+        JournalHeader header{};
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        header.generation = generation;
+        journal_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        journal_.flush();
+    }
+
+    generation_ = generation;
+    return true;
+}
+
+void CacheIndex::appendJournal(quint8 opCode, const QString& key, const CacheEntry* entry) {
+    const QByteArray keyBytes = key.toUtf8();
+
+    QByteArray body;
+    if (entry) {
+        const IndexRecord record = encode(*entry);
+        body.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    body.append(keyBytes);
+
+    JournalOp op{};
+    op.magic = JOURNAL_OP_MAGIC;
+    op.op = opCode;
+    op.keyLength = static_cast<quint32>(keyBytes.size());
+    op.bodyLength = static_cast<quint32>(body.size());
+    op.checksum = XXH3_64bits_withSeed(body.constData(), static_cast<size_t>(body.size()), opCode);
+    body.prepend(reinterpret_cast<const char*>(&op), sizeof(op));
+
+    // One write per operation; flushing hands it to the OS so it survives
+    // a crash of the process
+    QMutexLocker locker(&journalMutex_);
+    if (!journal_.isOpen()) {
+        return;
+    }
+    if (journal_.write(body) != body.size() || !journal_.flush()) {
+        Logger::instance().warn("Failed to append to cache index journal");
+        return;
+    }
+    ++journalOps_;
+}
+
+void CacheIndex::removeJournalsBefore(quint64 generation) {
+    const QFileInfoList files = QDir(directory_).entryInfoList({"cache_index.journal.*"}, QDir::Files);
+    for (const QFileInfo& info : files) {
+        bool ok = false;
+        const quint64 journalGeneration = info.suffix().toULongLong(&ok);
+        if (ok && journalGeneration < generation) {
+            QFile::remove(info.absoluteFilePath());
+        }
+    }
+}
+
+QString CacheIndex::snapshotPath() const {
+    return QDir(directory_).filePath("cache_index.snapshot");
+}
+
+QString CacheIndex::journalPath(quint64 generation) const {
+    return QDir(directory_).filePath(QString("cache_index.journal.%1").arg(generation));
+}
+
+} // namespace Murmur
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <memory>
+
+#include "core/common/Expected.hpp"
+#include "FileCache.hpp"
+
+namespace Murmur {
+
+// Journal state newer than the snapshot, folded to the last operation per key
+struct IndexRecovery {
+    QHash<QString, CacheEntry> puts;
+    QSet<QString> removals;
+};
+
+/**
+ * @brief Binary on-disk index for FileCache
+ *
+ * The index is a snapshot plus append-only journals. A snapshot holds
+ * fixed-size entry records sorted by key hash, a string table of keys and
+ * the payloads of entries that live only in memory. The snapshot is mapped,
+ * so single keys can be looked up before it is fully loaded. Opening checks
+ * only the records and keys; each inline payload has its own checksum,
+ * verified when the entry is first decoded.
+ *
+ * Every change after a snapshot is appended to a journal. Only entries
+ * whose payload is already durable in a cache segment are journaled as
+ * puts. Any other change is journaled as a removal, so a stale snapshot
+ * copy never comes back after a crash. Journals carry the snapshot
+ * generation they follow. A snapshot first rotates the journal, then
+ * commits atomically, then deletes the journals it covers. A crash at any
+ * point leaves a snapshot plus the journals still needed to replay on it.
+ */
+class CacheIndex {
+public:
+    // A snapshot is due once the journal holds this many operations or as
+    // many operations as the cache holds entries, whichever is larger
+    static constexpr qint64 SNAPSHOT_MIN_JOURNAL_OPS = 4096;
+
+    explicit CacheIndex(const QString& directory);
+    ~CacheIndex();
+
+    CacheIndex(const CacheIndex&) = delete;
+    CacheIndex& operator=(const CacheIndex&) = delete;
+
+    /**
+     * @brief Map the snapshot, replay newer journals and open the journal for appends
+     *
+     * A torn journal tail from a crash is truncated. A corrupt snapshot is
+     * discarded together with everything that depends on it.
+     */
+    Expected<IndexRecovery, CacheError> open();
+    void close();
+
+    // Number of entries in the mapped snapshot, 0 once it is released
+    qint64 snapshotEntryCount() const;
+
+    Expected<CacheEntry, CacheError> lookup(const QString& key) const;
+
+    // Decodes snapshot entries [first, first + count) in storage order
+    QList<CacheEntry> snapshotEntries(qint64 first, qint64 count) const;
+
+    // Unmaps the snapshot once everything in it has been loaded
+    void releaseSnapshot();
+
+    void recordEntry(const CacheEntry& entry);
+    void recordRemoval(const QString& key);
+    qint64 journalLength() const;
+
+    /**
+     * @brief Start a snapshot by redirecting new journal operations
+     * @return Generation to pass to commitSnapshot()
+     */
+    quint64 beginSnapshot();
+    Expected<void, CacheError> commitSnapshot(quint64 generation, const QList<CacheEntry>& entries);
+
+    bool hasSnapshot() const;
+
+private:
+    QString directory_;
+
+    // Guards the snapshot mapping
+    mutable QReadWriteLock snapshotLock_;
+    QFile snapshotFile_;
+    const uchar* snapshot_ = nullptr;
+    qint64 snapshotRecords_ = 0;
+    quint32 snapshotVersion_ = 0;
+
+    mutable QMutex journalMutex_;
+    QFile journal_;
+    quint64 generation_ = 0;
+    qint64 journalOps_ = 0;
+
+    bool mapSnapshot();
+    void unmapSnapshot();
+    CacheEntry decode(qint64 index) const;
+    bool replayJournal(const QString& path, IndexRecovery& recovery);
+    bool openJournal(quint64 generation);
+    void appendJournal(quint8 op, const QString& key, const CacheEntry* entry);
+    void removeJournalsBefore(quint64 generation);
+    QString snapshotPath() const;
+    QString journalPath(quint64 generation) const;
+};
+
+} // namespace Murmur
@@ -0,0 +1,348 @@
+#include "CacheSegmentStore.hpp"
+#include "core/common/Logger.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+#include <xxhash.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Murmur {
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[8] = {'M', 'R', 'S', 'E', 'G', '0', '0', '1'};
+constexpr qint64 SEGMENT_HEADER_SIZE = 16;
+constexpr quint32 RECORD_MAGIC = 0x4345524D; // "MREC"
+
+struct RecordHeader {
+    quint32 magic;
+    quint32 keyLength;
+    quint64 payloadLength;
+    quint64 checksum;
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader is written to disk as-is");
+
+// Records start on 8-byte boundaries so headers can be read in place
+constexpr qint64 alignRecord(qint64 size) {
+    return (size + 7) & ~qint64(7);
+}
+
+} // namespace
+
+struct CacheSegmentStore::Segment {
+    quint32 id = 0;
+    QFile file;
+    uchar* base = nullptr;
+    qint64 capacity = 0;
+    qint64 used = 0;       // guarded by the store mutex
+    qint64 liveBytes = 0;  // guarded by the store mutex
+    QSet<qint64> verified; // Checked record offsets of a sealed segment; guarded by the store mutex
+    bool writable = false; // Created by this process, so its records were never torn
+    std::atomic<bool> retired{false};
+
+    ~Segment() {
+        if (base) {
+            file.unmap(base);
+        }
+        if (retired) {
+            file.close();
+            QFile::remove(file.fileName());
+        } else if (writable) {
+            // Drop the unused tail of the preallocated file
+            file.resize(used);
+            file.close();
+        }
+    }
+};
+
+CacheSegmentStore::CacheSegmentStore(const QString& directory, qint64 segmentCapacity)
+    : directory_(directory)
+    , segmentCapacity_(std::max<qint64>(segmentCapacity, SEGMENT_HEADER_SIZE + 4096))
+{
+}
+
+CacheSegmentStore::~CacheSegmentStore() {
+    close();
+}
+
+Expected<void, CacheError> CacheSegmentStore::open(bool keepExisting) {
+    QMutexLocker locker(&mutex_);
+
+    QDir dir(directory_);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        Logger::instance().error("Failed to create cache segment directory: {}", directory_.toStdString());
+        return makeUnexpected(CacheError::InitializationFailed);
+    }
+
+    const QFileInfoList files = dir.entryInfoList({"segment_*.seg"}, QDir::Files, QDir::Name);
+    for (const QFileInfo& info : files) {
+        bool ok = false;
+        const quint32 id = info.baseName().mid(QStringLiteral("segment_").size()).toUInt(&ok);
+        if (!ok || !keepExisting) {
+            QFile::remove(info.absoluteFilePath());
+            continue;
+        }
+
+        // Existing segments are sealed; appends always go to a fresh segment
+        auto segment = std::make_shared<Segment>();
+        segment->id = id;
+        segment->file.setFileName(info.absoluteFilePath());
+        if (!segment->file.open(QIODevice::ReadOnly) || segment->file.size() < SEGMENT_HEADER_SIZE) {
+            Logger::instance().warn("Discarding unreadable cache segment {}", info.fileName().toStdString());
+            segment->retired = true;
+            continue;
+        }
+
+        segment->capacity = segment->used = segment->file.size();
+        segment->base = segment->file.map(0, segment->capacity);
+        if (!segment->base || std::memcmp(segment->base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) {
+            Logger::instance().warn("Discarding invalid cache segment {}", info.fileName().toStdString());
+            segment->retired = true;
+            continue;
+        }
+
+        segments_.insert(id, segment);
+        nextSegmentId_ = std::max(nextSegmentId_, id + 1);
+    }
+
+    Logger::instance().info("Cache segment store opened: {} segments in {}", segments_.size(), directory_.toStdString());
+    return Expected<void, CacheError>();
+}
+
+void CacheSegmentStore::close() {
+    QMutexLocker locker(&mutex_);
+    // Segments still referenced by views are unmapped when the last view goes
+    segments_.clear();
+    active_.reset();
+}
+
+void CacheSegmentStore::clear() {
+    QMutexLocker locker(&mutex_);
+    for (const auto& segment : segments_) {
+        segment->retired = true;
+    }
+    segments_.clear();
+    active_.reset();
+}
+
+Expected<SegmentLocation, CacheError> CacheSegmentStore::append(const QString& key, const QByteArray& payload) {
+    const QByteArray keyBytes = key.toUtf8();
+    const qint64 size = alignRecord(static_cast<qint64>(sizeof(RecordHeader)) + keyBytes.size() + payload.size());
+
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.keyLength = static_cast<quint32>(keyBytes.size());
+    header.payloadLength = static_cast<quint64>(payload.size());
+    header.checksum = checksum(payload.constData(), payload.size());
+
+    std::shared_ptr<Segment> target;
+    qint64 offset = 0;
+    {
+        // Only the space reservation is serialized
+        QMutexLocker locker(&mutex_);
+        if (!active_ || active_->used + size > active_->capacity) {
+            auto created = createSegment(std::max(segmentCapacity_, SEGMENT_HEADER_SIZE + size));
+            if (!created.hasValue()) {
+                return makeUnexpected(created.error());
+            }
+            active_ = created.value();
+        }
+        target = active_;
+        offset = target->used;
+        target->used += size;
+        target->liveBytes += size;
+    }
+
+    // The location is only handed out after the copy, so readers never see
+    // a partially written record
+    uchar* record = target->base + offset;
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), keyBytes.constData(), static_cast<size_t>(keyBytes.size()));
+    std::memcpy(record + sizeof(header) + keyBytes.size(), payload.constData(), static_cast<size_t>(payload.size()));
+
+    return SegmentLocation{target->id, offset};
+}
+
+Expected<CacheView, CacheError> CacheSegmentStore::read(const SegmentLocation& location) const {
+    std::shared_ptr<Segment> target;
+    const char* payload = nullptr;
+    qint64 payloadLength = 0;
+    quint64 expected = 0;
+    if (!locate(location, target, payload, payloadLength, expected)) {
+        return makeUnexpected(CacheError::ReadError);
+    }
+
+    // Records found on disk at open may be torn or rotten; each is checked
+    // the first time it is read, then trusted like the ones appended since
+    if (!target->writable) {
+        bool checked = false;
+        {
+            QMutexLocker locker(&mutex_);
+            checked = target->verified.contains(location.offset);
+        }
+        if (!checked) {
+            if (checksum(payload, payloadLength) != expected) {
+                Logger::instance().warn("Checksum mismatch in cache segment {} at offset {}", location.segment, location.offset);
+                return makeUnexpected(CacheError::ChecksumMismatch);
+            }
+            QMutexLocker locker(&mutex_);
+            target->verified.insert(location.offset);
+        }
+    }
+
+    return CacheView(target, payload, payloadLength, true);
+}
+
+bool CacheSegmentStore::contains(const SegmentLocation& location) const {
+    std::shared_ptr<Segment> target;
+    const char* payload = nullptr;
+    qint64 payloadLength = 0;
+    quint64 expected = 0;
+    return locate(location, target, payload, payloadLength, expected);
+}
+
+bool CacheSegmentStore::locate(const SegmentLocation& location, std::shared_ptr<Segment>& target,
+                               const char*& payload, qint64& payloadLength, quint64& expectedChecksum) const {
+    qint64 used = 0;
+    {
+        QMutexLocker locker(&mutex_);
+        target = segments_.value(location.segment);
+        used = target ? target->used : 0;
+    }
+    if (!target || location.offset < SEGMENT_HEADER_SIZE ||
+        location.offset + static_cast<qint64>(sizeof(RecordHeader)) > used) {
+        return false;
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, target->base + location.offset, sizeof(header));
+    const qint64 payloadOffset = location.offset + static_cast<qint64>(sizeof(header)) + header.keyLength;
+    if (header.magic != RECORD_MAGIC || payloadOffset + static_cast<qint64>(header.payloadLength) > used) {
+        return false;
+    }
+
+    payload = reinterpret_cast<const char*>(target->base + payloadOffset);
+    payloadLength = static_cast<qint64>(header.payloadLength);
+    expectedChecksum = header.checksum;
+    return true;
+}
+
+void CacheSegmentStore::markLive(const SegmentLocation& location) {
+    QMutexLocker locker(&mutex_);
+    if (auto target = segments_.value(location.segment)) {
+        target->liveBytes += recordSize(*target, location.offset);
+    }
+}
+
+bool CacheSegmentStore::release(const SegmentLocation& location) {
+    QMutexLocker locker(&mutex_);
+    auto target = segments_.value(location.segment);
+    if (!target) {
+        return false;
+    }
+
+    const bool wasCandidate = isCompactionCandidate(*target);
+    target->liveBytes = std::max<qint64>(0, target->liveBytes - recordSize(*target, location.offset));
+    return !wasCandidate && isCompactionCandidate(*target);
+}
+
+QList<quint32> CacheSegmentStore::compactionCandidates() const {
+    QMutexLocker locker(&mutex_);
+    QList<quint32> candidates;
+    for (const auto& segment : segments_) {
+        if (isCompactionCandidate(*segment)) {
+            candidates.append(segment->id);
+        }
+    }
+    return candidates;
+}
+
+void CacheSegmentStore::retire(quint32 segment) {
+    QMutexLocker locker(&mutex_);
+    auto target = segments_.take(segment);
+    if (!target) {
+        return;
+    }
+    target->retired = true;
+    if (active_ == target) {
+        active_.reset();
+    }
+}
+
+SegmentStoreStats CacheSegmentStore::stats() const {
+    QMutexLocker locker(&mutex_);
+    SegmentStoreStats stats;
+    stats.segmentCount = segments_.size();
+    for (const auto& segment : segments_) {
+        stats.usedBytes += segment->used;
+        stats.liveBytes += segment->liveBytes;
+    }
+    return stats;
+}
+
+quint64 CacheSegmentStore::checksum(const char* data, qint64 size) {
+    return XXH3_64bits(data, static_cast<size_t>(size));
+}
+
+Expected<std::shared_ptr<CacheSegmentStore::Segment>, CacheError> CacheSegmentStore::createSegment(qint64 capacity) {
+    auto segment = std::make_shared<Segment>();
+    segment->id = nextSegmentId_++;
+    segment->file.setFileName(segmentPath(segment->id));
+
+    // Preallocate and map once; the file is sparse until written and the
+    // mapping never moves, so views stay valid while the segment fills up
+    if (!segment->file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !segment->file.resize(capacity)) {
+        Logger::instance().error("Failed to create cache segment: {}", segment->file.fileName().toStdString());
+        segment->retired = true;
+        return makeUnexpected(CacheError::WriteError);
+    }
+
+    segment->base = segment->file.map(0, capacity);
+    if (!segment->base) {
+        Logger::instance().error("Failed to map cache segment: {}", segment->file.fileName().toStdString());
+        segment->retired = true;
+        return makeUnexpected(CacheError::WriteError);
+    }
+
+    std::memset(segment->base, 0, SEGMENT_HEADER_SIZE);
+    std::memcpy(segment->base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    segment->capacity = capacity;
+    segment->used = SEGMENT_HEADER_SIZE;
+    segment->writable = true;
+
+    segments_.insert(segment->id, segment);
+    return segment;
+}
+
+bool CacheSegmentStore::isCompactionCandidate(const Segment& segment) const {
+    if (active_.get() == &segment) {
+        return false;
+    }
+    const qint64 recordBytes = segment.used - SEGMENT_HEADER_SIZE;
+    return segment.liveBytes < recordBytes * COMPACTION_LIVE_RATIO || recordBytes == 0;
+}
+
+qint64 CacheSegmentStore::recordSize(const Segment& segment, qint64 offset) const {
+    if (offset < SEGMENT_HEADER_SIZE || offset + static_cast<qint64>(sizeof(RecordHeader)) > segment.used) {
+        return 0;
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, segment.base + offset, sizeof(header));
+    if (header.magic != RECORD_MAGIC) {
+        return 0;
+    }
+    return alignRecord(static_cast<qint64>(sizeof(header)) + header.keyLength + static_cast<qint64>(header.payloadLength));
+}
+
+QString CacheSegmentStore::segmentPath(quint32 id) const {
+    return QDir(directory_).filePath(QString("segment_%1.seg").arg(id, 8, 10, QChar('0')));
+}
+
+} // namespace Murmur
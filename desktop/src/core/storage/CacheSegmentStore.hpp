@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <memory>
+
+#include "core/common/Expected.hpp"
+#include "FileCache.hpp"
+
+namespace Murmur {
+
+// Position of a record inside a segment; offset is the record start
+struct SegmentLocation {
+    quint32 segment = 0;
+    qint64 offset = -1;
+
+    bool isValid() const { return offset >= 0; }
+};
+
+struct SegmentStoreStats {
+    qint64 segmentCount = 0;
+    qint64 usedBytes = 0;
+    qint64 liveBytes = 0;
+};
+
+/**
+ * @brief Append-only, memory-mapped payload storage for FileCache
+ *
+ * Payloads are appended as self-describing records (key, length, xxHash3
+ * checksum) to large segment files that are mapped once and never remapped.
+ * Appends only take the store lock to reserve space; the copy goes straight
+ * into the shared mapping. Reads return CacheViews into the mapping.
+ * Records that were already on disk when the store opened are checksummed
+ * on their first read, so a torn or damaged record is never served.
+ *
+ * Segments are never modified in place. Released records only lower a
+ * segment's live byte count; FileCache moves the remaining live records of
+ * sparse segments forward and then retires them. A retired segment file is
+ * deleted when the last view of it goes away.
+ */
+class CacheSegmentStore {
+public:
+    static constexpr qint64 DEFAULT_SEGMENT_CAPACITY = 64 * 1024 * 1024;
+    static constexpr double COMPACTION_LIVE_RATIO = 0.5;
+
+    explicit CacheSegmentStore(const QString& directory, qint64 segmentCapacity = DEFAULT_SEGMENT_CAPACITY);
+    ~CacheSegmentStore();
+
+    CacheSegmentStore(const CacheSegmentStore&) = delete;
+    CacheSegmentStore& operator=(const CacheSegmentStore&) = delete;
+
+    /**
+     * @brief Map existing segments read-only; new appends go to a new segment
+     * @param keepExisting When false, existing segment files are deleted
+     */
+    Expected<void, CacheError> open(bool keepExisting);
+    void close();
+    void clear();
+
+    Expected<SegmentLocation, CacheError> append(const QString& key, const QByteArray& payload);
+    // Records that were on disk at open are checksummed on their first read
+    Expected<CacheView, CacheError> read(const SegmentLocation& location) const;
+
+    // Whether a well-formed record header exists at the location; reads no payload
+    bool contains(const SegmentLocation& location) const;
+
+    // Count a record restored from the index as live
+    void markLive(const SegmentLocation& location);
+
+    /**
+     * @brief Mark a record as no longer referenced
+     * @return true when this made a sealed segment sparse enough to compact
+     */
+    bool release(const SegmentLocation& location);
+
+    // Sealed segments whose live bytes fell below COMPACTION_LIVE_RATIO of their size
+    QList<quint32> compactionCandidates() const;
+    void retire(quint32 segment);
+
+    SegmentStoreStats stats() const;
+    static quint64 checksum(const char* data, qint64 size);
+
+private:
+    struct Segment;
+
+    QString directory_;
+    qint64 segmentCapacity_;
+    mutable QMutex mutex_;
+    QHash<quint32, std::shared_ptr<Segment>> segments_;
+    std::shared_ptr<Segment> active_;
+    quint32 nextSegmentId_ = 1;
+
+    Expected<std::shared_ptr<Segment>, CacheError> createSegment(qint64 capacity);
+    bool isCompactionCandidate(const Segment& segment) const;
+    qint64 recordSize(const Segment& segment, qint64 offset) const;
+    bool locate(const SegmentLocation& location, std::shared_ptr<Segment>& target,
+                const char*& payload, qint64& payloadLength, quint64& expectedChecksum) const;
+    QString segmentPath(quint32 id) const;
+};
+
+} // namespace Murmur
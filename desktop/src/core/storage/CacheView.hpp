@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <memory>
+
+namespace Murmur {
+
+/**
+ * @brief Read-only, ref-counted view of a cached payload
+ *
+ * A view either points into a memory-mapped cache segment or shares a heap
+ * QByteArray. Copies are cheap and keep the underlying storage alive, so a
+ * segment stays mapped (and is not deleted by compaction) while any view of
+ * it exists.
+ */
+class CacheView {
+public:
+    CacheView() = default;
+    CacheView(std::shared_ptr<const void> owner, const char* data, qint64 size, bool mapped)
+        : owner_(std::move(owner)), data_(data), size_(size), mapped_(mapped) {}
+
+    static CacheView fromByteArray(const QByteArray& bytes) {
+        auto owner = std::make_shared<const QByteArray>(bytes);
+        return CacheView(owner, owner->constData(), owner->size(), false);
+    }
+
+    const char* constData() const { return data_; }
+    qint64 size() const { return size_; }
+    bool isEmpty() const { return size_ == 0; }
+    bool isMapped() const { return mapped_; }
+
+    /**
+     * @brief Wrap the payload without copying
+     *
+     * The returned array does not own its data and is only valid while this
+     * view, or a copy of it, is alive.
+     */
+    QByteArray bytes() const { return QByteArray::fromRawData(data_, static_cast<qsizetype>(size_)); }
+
+    // Deep copy that outlives the view
+    QByteArray toByteArray() const { return QByteArray(data_, static_cast<qsizetype>(size_)); }
+
+private:
+    std::shared_ptr<const void> owner_;
+    const char* data_ = nullptr;
+    qint64 size_ = 0;
+    bool mapped_ = false;
+};
+
+} // namespace Murmur
@@ -0,0 +1,698 @@
+#include "ContentStore.hpp"
+#include "core/common/Logger.hpp"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <xxhash.h>
+
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Murmur {
+
+namespace {
+
+constexpr int INDEX_VERSION = 2;
+constexpr qint64 HASH_BUFFER_SIZE = 4 * 1024 * 1024;
+
+const QString INDEX_FILE = QStringLiteral("index.json");
+const QString JOURNAL_FILE = QStringLiteral("index.journal");
+const QString OBJECTS_DIR = QStringLiteral("objects");
+
+qint64 modifiedMs(const QFileInfo& info) {
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+#ifdef Q_OS_LINUX
+// A reflink shares the data copy-on-write, so later writes through one
+// name never show up under the other
+bool reflinkFile(const QString& source, const QString& destination) {
+#ifdef FICLONE
+    const int sourceFd = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+
+    struct stat sourceStat;
+    const mode_t mode = ::fstat(sourceFd, &sourceStat) == 0 ? (sourceStat.st_mode & 0777) : 0644;
+    const QByteArray destinationName = QFile::encodeName(destination);
+    const int destFd = ::open(destinationName.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+    if (destFd < 0) {
+        ::close(sourceFd);
+        return false;
+    }
+
+    const bool cloned = ::ioctl(destFd, FICLONE, sourceFd) == 0;
+    ::close(destFd);
+    ::close(sourceFd);
+    if (!cloned) {
+        ::unlink(destinationName.constData());
+    }
+    return cloned;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(destination);
+    return false;
+#endif
+}
+#endif
+
+} // namespace
+
+ContentStore::ContentStore() = default;
+
+ContentStore::~ContentStore() {
+    saveIndex();
+}
+
+void ContentStore::setRoot(const QString& root) {
+    QMutexLocker locker(&mutex_);
+    root_ = root;
+    loaded_ = false;
+}
+
+Expected<quint64, ContentError> ContentStore::sampleFingerprint(const QString& path) {
+    QFile file(path);
+    if (!file.exists()) {
+        return makeUnexpected(ContentError::NotFound);
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return makeUnexpected(ContentError::ReadFailed);
+    }
+
+    const qint64 size = file.size();
+    std::unique_ptr<XXH3_state_t, decltype(&XXH3_freeState)> state(XXH3_createState(), &XXH3_freeState);
+    XXH3_64bits_reset(state.get());
+    XXH3_64bits_update(state.get(), &size, sizeof(size));
+
+    // Small files are read whole; otherwise the head, middle and tail
+    QList<qint64> offsets;
+    if (size <= 3 * SAMPLE_BLOCK_SIZE) {
+        offsets = {0};
+    } else {
+        offsets = {0, (size - SAMPLE_BLOCK_SIZE) / 2, size - SAMPLE_BLOCK_SIZE};
+    }
+
+    QByteArray block;
+    for (qint64 offset : offsets) {
+        if (!file.seek(offset)) {
+            return makeUnexpected(ContentError::ReadFailed);
+        }
+        block = file.read(size <= 3 * SAMPLE_BLOCK_SIZE ? size : SAMPLE_BLOCK_SIZE);
+        if (file.error() != QFileDevice::NoError) {
+            return makeUnexpected(ContentError::ReadFailed);
+        }
+        XXH3_64bits_update(state.get(), block.constData(), static_cast<size_t>(block.size()));
+    }
+
+    return static_cast<quint64>(XXH3_64bits_digest(state.get()));
+}
+
+Expected<QString, ContentError> ContentStore::contentHash(const QString& path) {
+    QFile file(path);
+    if (!file.exists()) {
+        return makeUnexpected(ContentError::NotFound);
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return makeUnexpected(ContentError::ReadFailed);
+    }
+
+#ifdef Q_OS_LINUX
+    ::posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    std::unique_ptr<XXH3_state_t, decltype(&XXH3_freeState)> state(XXH3_createState(), &XXH3_freeState);
+    XXH3_128bits_reset(state.get());
+
+    QByteArray buffer(HASH_BUFFER_SIZE, Qt::Uninitialized);
+    while (true) {
+        const qint64 bytesRead = file.read(buffer.data(), buffer.size());
+        if (bytesRead < 0) {
+            return makeUnexpected(ContentError::ReadFailed);
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        XXH3_128bits_update(state.get(), buffer.constData(), static_cast<size_t>(bytesRead));
+    }
+
+    XXH128_canonical_t canonical;
+    XXH128_canonicalFromHash(&canonical, XXH3_128bits_digest(state.get()));
+    return QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(canonical.digest),
+                                          sizeof(canonical.digest)).toHex());
+}
+
+Expected<ContentMatch, ContentError> ContentStore::findDuplicate(const QString& path) {
+    auto fingerprint = sampleFingerprint(path);
+    if (fingerprint.hasError()) {
+        return makeUnexpected(fingerprint.error());
+    }
+
+    bool hasCandidates = false;
+    {
+        QMutexLocker locker(&mutex_);
+        ensureLoaded();
+        hasCandidates = objectsByFingerprint_.contains(fingerprint.value());
+    }
+
+    ContentMatch match;
+    if (!hasCandidates) {
+        return match;
+    }
+
+    // Same size and samples; only the full hash can tell them apart
+    auto hash = contentHash(path);
+    if (hash.hasError()) {
+        return makeUnexpected(hash.error());
+    }
+    const QHash<QString, QString> candidates = candidateHashes(fingerprint.value());
+    match.hash = hash.value();
+    match.key = candidates.value(match.hash);
+    match.stored = !match.key.isEmpty();
+    return match;
+}
+
+Expected<bool, ContentError> ContentStore::linkTo(const QString& key, const QString& destination) {
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+
+    if (!verifyObject(key)) {
+        return makeUnexpected(ContentError::NotFound);
+    }
+    if (!linkFile(objectPath(key), destination)) {
+        return makeUnexpected(ContentError::LinkFailed);
+    }
+
+    track(destination, key);
+    return true;
+}
+
+Expected<QString, ContentError> ContentStore::add(const QString& path, const QString& knownHash) {
+    auto fingerprint = sampleFingerprint(path);
+    if (fingerprint.hasError()) {
+        return makeUnexpected(fingerprint.error());
+    }
+    const qint64 size = QFileInfo(path).size();
+
+    QString hash = knownHash;
+    bool hashed = !hash.isEmpty();
+    while (true) {
+        QString key = fingerprintKey(fingerprint.value(), size);
+        if (hashed) {
+            // Identical stored content is reused; different content sharing
+            // the fingerprint is told apart by its full hash
+            if (hash.isEmpty()) {
+                auto computed = contentHash(path);
+                if (computed.hasError()) {
+                    return makeUnexpected(computed.error());
+                }
+                hash = computed.value();
+            }
+            key = candidateHashes(fingerprint.value()).value(hash, hash);
+        }
+
+        QMutexLocker locker(&mutex_);
+        ensureLoaded();
+
+        // Content with these samples was stored meanwhile
+        if (!hashed && objectsByFingerprint_.contains(fingerprint.value())) {
+            hashed = true;
+            continue;
+        }
+
+        if (!objects_.contains(key) && !root_.isEmpty()) {
+            const QString object = objectPath(key);
+            QDir().mkpath(QFileInfo(object).absolutePath());
+            QFile::remove(object); // Left behind by an earlier run that lost its index
+
+            if (linkFile(path, object)) {
+                const QFileInfo info(object);
+                objects_.insert(key, StoredObject{fingerprint.value(), info.size(), modifiedMs(info), hash, 0});
+                objectsByFingerprint_.insert(fingerprint.value(), key);
+                journalObject(key);
+            } else {
+                // Most likely on another filesystem; the key is still recorded
+                Logger::instance().debug("ContentStore: could not link {} into the store", path.toStdString());
+            }
+        }
+
+        track(path, key);
+        return key;
+    }
+}
+
+void ContentStore::remove(const QString& path) {
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+
+    const QString cleanPath = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    auto it = paths_.find(cleanPath);
+    if (it == paths_.end()) {
+        return;
+    }
+
+    const QString key = it->key;
+    paths_.erase(it);
+    journalPath(cleanPath);
+    release(key);
+}
+
+void ContentStore::removeTree(const QString& root) {
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+
+    const QString rootPath = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+    const QString prefix = rootPath.endsWith(QLatin1Char('/')) ? rootPath : rootPath + QLatin1Char('/');
+    QStringList keys;
+    for (auto it = paths_.begin(); it != paths_.end();) {
+        if ((it.key() == rootPath || it.key().startsWith(prefix)) && !QFileInfo::exists(it.key())) {
+            keys.append(it->key);
+            const QString path = it.key();
+            it = paths_.erase(it);
+            journalPath(path);
+        } else {
+            ++it;
+        }
+    }
+    for (const QString& key : std::as_const(keys)) {
+        release(key);
+    }
+}
+
+void ContentStore::move(const QString& from, const QString& to) {
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+
+    const QString fromPath = QDir::cleanPath(QFileInfo(from).absoluteFilePath());
+    auto it = paths_.find(fromPath);
+    if (it == paths_.end()) {
+        return;
+    }
+
+    // The new path takes its reference before the old one gives it up, so
+    // the object is never briefly unreferenced
+    const QString key = it->key;
+    paths_.erase(it);
+    journalPath(fromPath);
+    track(to, key);
+    release(key);
+}
+
+QString ContentStore::keyForPath(const QString& path) {
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+
+    const QFileInfo info(path);
+    auto it = paths_.constFind(QDir::cleanPath(info.absoluteFilePath()));
+    if (it == paths_.constEnd() || !info.exists() ||
+        info.size() != it->size || modifiedMs(info) != it->modifiedMs) {
+        return QString();
+    }
+    return it->key;
+}
+
+bool ContentStore::saveIndex() {
+    QMutexLocker locker(&mutex_);
+    if (root_.isEmpty() || !loaded_) {
+        return true;
+    }
+    if (snapshotNeeded_ || journalRecords_ + pendingRecords_ > MAX_JOURNAL_RECORDS) {
+        return writeSnapshot();
+    }
+    if (pendingRecords_ == 0) {
+        return true;
+    }
+
+    QDir().mkpath(root_);
+    QFile journal(QDir(root_).filePath(JOURNAL_FILE));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append) ||
+        journal.write(pendingJournal_) != pendingJournal_.size() ||
+        !journal.flush()) {
+        Logger::instance().warn("ContentStore: failed to append to the index journal in {}", root_.toStdString());
+        return false;
+    }
+
+    journalRecords_ += pendingRecords_;
+    pendingJournal_.clear();
+    pendingRecords_ = 0;
+    return true;
+}
+
+bool ContentStore::writeSnapshot() {
+    QJsonObject objects;
+    for (auto it = objects_.cbegin(); it != objects_.cend(); ++it) {
+        QJsonObject entry{
+            {"fingerprint", QString::number(it->fingerprint, 16)},
+            {"size", it->size},
+            {"modified", it->modifiedMs}
+        };
+        if (!it->hash.isEmpty()) {
+            entry.insert("hash", it->hash);
+        }
+        objects.insert(it.key(), entry);
+    }
+
+    QJsonObject paths;
+    for (auto it = paths_.cbegin(); it != paths_.cend(); ++it) {
+        paths.insert(it.key(), QJsonObject{
+            {"key", it->key},
+            {"size", it->size},
+            {"modified", it->modifiedMs}
+        });
+    }
+
+    const QJsonObject root{
+        {"version", INDEX_VERSION},
+        {"objects", objects},
+        {"paths", paths}
+    };
+
+    QDir().mkpath(root_);
+    QSaveFile file(QDir(root_).filePath(INDEX_FILE));
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 ||
+        !file.commit()) {
+        Logger::instance().warn("ContentStore: failed to write index in {}", root_.toStdString());
+        return false;
+    }
+
+    // Everything in the journal is part of the new index
+    QFile::remove(QDir(root_).filePath(JOURNAL_FILE));
+    pendingJournal_.clear();
+    pendingRecords_ = 0;
+    journalRecords_ = 0;
+    snapshotNeeded_ = false;
+    return true;
+}
+
+QString ContentStore::objectPath(const QString& key) const {
+    return QDir(root_).filePath(OBJECTS_DIR + QLatin1Char('/') + key.left(2) + QLatin1Char('/') + key);
+}
+
+void ContentStore::ensureLoaded() {
+    if (!loaded_) {
+        loaded_ = true;
+        loadIndex();
+    }
+}
+
+void ContentStore::loadIndex() {
+    objects_.clear();
+    objectsByFingerprint_.clear();
+    paths_.clear();
+    pendingJournal_.clear();
+    pendingRecords_ = 0;
+    journalRecords_ = 0;
+    snapshotNeeded_ = false;
+
+    if (root_.isEmpty()) {
+        return;
+    }
+
+    QFile file(QDir(root_).filePath(INDEX_FILE));
+    if (file.open(QIODevice::ReadOnly)) {
+        const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+        const int version = root.value("version").toInt();
+        if (version == 1 || version == INDEX_VERSION) {
+            const QJsonObject objects = root.value("objects").toObject();
+            for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+                const QJsonObject entry = it.value().toObject();
+                StoredObject object;
+                object.fingerprint = entry.value("fingerprint").toString().toULongLong(nullptr, 16);
+                object.size = entry.value("size").toInteger();
+                object.modifiedMs = entry.value("modified").toInteger();
+                // Version 1 named every object by its full hash
+                object.hash = version == 1 ? it.key() : entry.value("hash").toString();
+                objects_.insert(it.key(), object);
+            }
+
+            const QJsonObject paths = root.value("paths").toObject();
+            const QString keyField = version == 1 ? QStringLiteral("hash") : QStringLiteral("key");
+            for (auto it = paths.constBegin(); it != paths.constEnd(); ++it) {
+                const QJsonObject entry = it.value().toObject();
+                paths_.insert(it.key(), TrackedPath{entry.value(keyField).toString(),
+                                                    entry.value("size").toInteger(),
+                                                    entry.value("modified").toInteger()});
+            }
+            snapshotNeeded_ = version != INDEX_VERSION;
+        } else {
+            Logger::instance().warn("ContentStore: ignoring unreadable index in {}", root_.toStdString());
+        }
+    }
+
+    QFile journal(QDir(root_).filePath(JOURNAL_FILE));
+    if (journal.open(QIODevice::ReadOnly)) {
+        replayJournal(journal.readAll());
+    }
+
+    // Objects edited in place no longer match their name
+    for (auto it = objects_.begin(); it != objects_.end();) {
+        if (!objectIntact(it.key(), it.value())) {
+            QFile::remove(objectPath(it.key()));
+            it = objects_.erase(it);
+            snapshotNeeded_ = true;
+            continue;
+        }
+        objectsByFingerprint_.insert(it->fingerprint, it.key());
+        ++it;
+    }
+
+    // Library files deleted or replaced while the app was not running
+    for (auto it = paths_.begin(); it != paths_.end();) {
+        const QFileInfo info(it.key());
+        if (!info.exists() || info.size() != it->size || modifiedMs(info) != it->modifiedMs) {
+            it = paths_.erase(it);
+            snapshotNeeded_ = true;
+            continue;
+        }
+        auto object = objects_.find(it->key);
+        if (object != objects_.end()) {
+            object->references++;
+        }
+        ++it;
+    }
+
+    const QStringList unused = [this]() {
+        QStringList keys;
+        for (auto it = objects_.cbegin(); it != objects_.cend(); ++it) {
+            if (it->references == 0) {
+                keys.append(it.key());
+            }
+        }
+        return keys;
+    }();
+    for (const QString& key : unused) {
+        release(key);
+    }
+
+    // The journal is folded into the index on the next save
+    snapshotNeeded_ = snapshotNeeded_ || journalRecords_ > 0 || !unused.isEmpty();
+    pendingJournal_.clear();
+    pendingRecords_ = 0;
+
+    Logger::instance().info("ContentStore: loaded {} objects for {} library files", objects_.size(), paths_.size());
+}
+
+void ContentStore::replayJournal(const QByteArray& journal) {
+    for (const QByteArray& line : journal.split('\n')) {
+        // A crash can leave the last record half written
+        const QJsonObject record = QJsonDocument::fromJson(line).object();
+        if (record.isEmpty()) {
+            continue;
+        }
+        journalRecords_++;
+
+        const QString op = record.value("op").toString();
+        if (op == QLatin1String("object")) {
+            StoredObject object;
+            object.fingerprint = record.value("fingerprint").toString().toULongLong(nullptr, 16);
+            object.size = record.value("size").toInteger();
+            object.modifiedMs = record.value("modified").toInteger();
+            object.hash = record.value("hash").toString();
+            objects_.insert(record.value("key").toString(), object);
+        } else if (op == QLatin1String("drop")) {
+            objects_.remove(record.value("key").toString());
+        } else if (op == QLatin1String("path")) {
+            paths_.insert(record.value("path").toString(), TrackedPath{record.value("key").toString(),
+                                                                       record.value("size").toInteger(),
+                                                                       record.value("modified").toInteger()});
+        } else if (op == QLatin1String("unpath")) {
+            paths_.remove(record.value("path").toString());
+        }
+    }
+}
+
+void ContentStore::track(const QString& path, const QString& key) {
+    const QFileInfo info(path);
+    const QString cleanPath = QDir::cleanPath(info.absoluteFilePath());
+
+    auto existing = paths_.find(cleanPath);
+    const QString previousKey = existing != paths_.end() ? existing->key : QString();
+    paths_.insert(cleanPath, TrackedPath{key, info.size(), modifiedMs(info)});
+    journalPath(cleanPath);
+
+    if (previousKey == key) {
+        return;
+    }
+    auto object = objects_.find(key);
+    if (object != objects_.end()) {
+        object->references++;
+    }
+    if (!previousKey.isEmpty()) {
+        release(previousKey);
+    }
+}
+
+void ContentStore::release(const QString& key) {
+    // Callers have already removed one reference's path
+    auto object = objects_.find(key);
+    if (object == objects_.end()) {
+        return;
+    }
+    if (object->references > 0 && --object->references > 0) {
+        return;
+    }
+    dropObject(key);
+}
+
+bool ContentStore::objectIntact(const QString& key, const StoredObject& object) const {
+    const QFileInfo info(objectPath(key));
+    return info.exists() && info.size() == object.size && modifiedMs(info) == object.modifiedMs;
+}
+
+bool ContentStore::verifyObject(const QString& key) {
+    auto object = objects_.constFind(key);
+    if (object == objects_.constEnd()) {
+        return false;
+    }
+    if (objectIntact(key, object.value())) {
+        return true;
+    }
+
+    Logger::instance().warn("ContentStore: object {} changed on disk, dropping it", key.toStdString());
+    dropObject(key);
+    return false;
+}
+
+void ContentStore::dropObject(const QString& key) {
+    auto object = objects_.find(key);
+    if (object == objects_.end()) {
+        return;
+    }
+
+    // Library paths still naming the key fail keyForPath() once their file
+    // changes, and releasing them later is a no-op
+    QFile::remove(objectPath(key));
+    objectsByFingerprint_.remove(object->fingerprint, key);
+    objects_.erase(object);
+    appendJournal(QJsonObject{{"op", "drop"}, {"key", key}});
+}
+
+void ContentStore::journalObject(const QString& key) {
+    const StoredObject& object = objects_[key];
+    QJsonObject record{
+        {"op", "object"},
+        {"key", key},
+        {"fingerprint", QString::number(object.fingerprint, 16)},
+        {"size", object.size},
+        {"modified", object.modifiedMs}
+    };
+    if (!object.hash.isEmpty()) {
+        record.insert("hash", object.hash);
+    }
+    appendJournal(record);
+}
+
+void ContentStore::journalPath(const QString& path) {
+    auto it = paths_.constFind(path);
+    if (it == paths_.constEnd()) {
+        appendJournal(QJsonObject{{"op", "unpath"}, {"path", path}});
+        return;
+    }
+    appendJournal(QJsonObject{
+        {"op", "path"},
+        {"path", path},
+        {"key", it->key},
+        {"size", it->size},
+        {"modified", it->modifiedMs}
+    });
+}
+
+void ContentStore::appendJournal(const QJsonObject& record) {
+    pendingJournal_ += QJsonDocument(record).toJson(QJsonDocument::Compact);
+    pendingJournal_ += '\n';
+    pendingRecords_++;
+}
+
+QHash<QString, QString> ContentStore::candidateHashes(quint64 fingerprint) {
+    QHash<QString, QString> keysByHash;
+    QHash<QString, QString> unhashed;  // Key to object path
+    {
+        QMutexLocker locker(&mutex_);
+        ensureLoaded();
+        const QStringList keys = objectsByFingerprint_.values(fingerprint);
+        for (const QString& key : keys) {
+            const StoredObject& object = objects_[key];
+            if (object.hash.isEmpty()) {
+                unhashed.insert(key, objectPath(key));
+            } else if (verifyObject(key)) {
+                // A recorded hash only holds while the file is unchanged
+                keysByHash.insert(object.hash, key);
+            }
+        }
+    }
+
+    // Each stored object is hashed at most once, and only on a collision
+    for (auto it = unhashed.cbegin(); it != unhashed.cend(); ++it) {
+        auto hash = contentHash(it.value());
+        if (hash.hasError()) {
+            continue;
+        }
+
+        QMutexLocker locker(&mutex_);
+        if (!verifyObject(it.key())) {
+            continue;
+        }
+        auto object = objects_.find(it.key());
+        if (object->hash.isEmpty()) {
+            object->hash = hash.value();
+            journalObject(it.key());
+        }
+        keysByHash.insert(object->hash, it.key());
+    }
+    return keysByHash;
+}
+
+QString ContentStore::fingerprintKey(quint64 fingerprint, qint64 size) {
+    return QStringLiteral("%1%2").arg(fingerprint, 16, 16, QLatin1Char('0'))
+                                 .arg(static_cast<quint64>(size), 16, 16, QLatin1Char('0'));
+}
+
+bool ContentStore::linkFile(const QString& source, const QString& destination) {
+#ifdef Q_OS_LINUX
+    if (reflinkFile(source, destination)) {
+        return true;
+    }
+#endif
+    std::error_code error;
+    std::filesystem::create_hard_link(QFile::encodeName(source).toStdString(),
+                                      QFile::encodeName(destination).toStdString(), error);
+    return !error;
+}
+
+} // namespace Murmur
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMultiHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+
+#include "core/common/Expected.hpp"
+
+namespace Murmur {
+
+enum class ContentError {
+    NotFound,
+    ReadFailed,
+    LinkFailed
+};
+
+struct ContentMatch {
+    QString hash;         // Full content hash; empty when no full hash was needed
+    QString key;          // Key of the identical stored object, when stored
+    bool stored = false;  // Identical content is already in the store
+};
+
+/**
+ * @brief Content-addressed store for imported media
+ *
+ * Each distinct file is kept once under objects/ and library files are
+ * reflinks or hard links to that object, so importing the same video again
+ * costs no space and no copy.
+ *
+ * Hashing a multi-gigabyte file is as slow as copying it, so files are
+ * compared by a sampled fingerprint: the size plus the first, middle and
+ * last 64 KiB. New content is keyed by its fingerprint and size. The full
+ * XXH3-128 hash is only computed when two files share a fingerprint, for
+ * the new file and, once, for each stored object it collides with; content
+ * that collided with a different object is keyed by its full hash. Keys are
+ * 32 hex digits either way.
+ *
+ * Changes are appended to a journal next to the index and folded into the
+ * index once the journal grows, so an import does not rewrite the whole
+ * index.
+ *
+ * Links only work within one filesystem; the store should live on the same
+ * filesystem as the library. Library paths are counted per object so that
+ * an object is removed once nothing links to it any more. All methods are
+ * thread-safe.
+ */
+class ContentStore {
+public:
+    static constexpr qint64 SAMPLE_BLOCK_SIZE = 64 * 1024;
+
+    ContentStore();
+    ~ContentStore();
+
+    ContentStore(const ContentStore&) = delete;
+    ContentStore& operator=(const ContentStore&) = delete;
+
+    // Directory holding objects/ and the index; call before first use
+    void setRoot(const QString& root);
+
+    static Expected<quint64, ContentError> sampleFingerprint(const QString& path);
+    static Expected<QString, ContentError> contentHash(const QString& path);
+
+    // Looks for stored content identical to the file
+    Expected<ContentMatch, ContentError> findDuplicate(const QString& path);
+
+    // Makes destination a link to stored content; destination must not exist
+    Expected<bool, ContentError> linkTo(const QString& key, const QString& destination);
+
+    // Records a library file, storing its content if it is new, and returns
+    // its key. `knownHash` skips rehashing when findDuplicate() already
+    // computed it.
+    Expected<QString, ContentError> add(const QString& path, const QString& knownHash = QString());
+
+    // Forgets a library file, dropping its object when nothing else uses it
+    void remove(const QString& path);
+
+    // Forgets the library files at or below a directory that are gone,
+    // such as after the directory was deleted
+    void removeTree(const QString& root);
+
+    // Follows a library file renamed from `from` to `to`
+    void move(const QString& from, const QString& to);
+
+    // Key recorded for a library file, or empty if unknown or changed since
+    QString keyForPath(const QString& path);
+
+    // Appends pending changes to the journal, or rewrites the index when
+    // the journal has grown
+    bool saveIndex();
+
+private:
+    struct StoredObject {
+        quint64 fingerprint = 0;
+        qint64 size = 0;
+        qint64 modifiedMs = 0;
+        QString hash;  // Full hash; empty until a fingerprint collision needs it
+        int references = 0;
+    };
+
+    struct TrackedPath {
+        QString key;
+        qint64 size = 0;
+        qint64 modifiedMs = 0;
+    };
+
+    static constexpr int MAX_JOURNAL_RECORDS = 1024;
+
+    mutable QMutex mutex_;
+    QString root_;
+    bool loaded_ = false;
+    bool snapshotNeeded_ = false;
+    QHash<QString, StoredObject> objects_;
+    QMultiHash<quint64, QString> objectsByFingerprint_;
+    QHash<QString, TrackedPath> paths_;
+    QByteArray pendingJournal_;
+    int pendingRecords_ = 0;
+    int journalRecords_ = 0;
+
+    QString objectPath(const QString& key) const;
+    void ensureLoaded();
+    void loadIndex();
+    void replayJournal(const QByteArray& journal);
+    bool writeSnapshot();
+    void track(const QString& path, const QString& key);
+    void release(const QString& key);
+
+    // Whether the object file still has the size and mtime it was stored
+    // with; hard links share it with library files, which can be edited
+    bool objectIntact(const QString& key, const StoredObject& object) const;
+
+    // Checks a stored object, dropping it whatever its references when its
+    // file changed
+    bool verifyObject(const QString& key);
+    void dropObject(const QString& key);
+    void journalObject(const QString& key);
+    void journalPath(const QString& path);
+    void appendJournal(const QJsonObject& record);
+
+    // Full hashes of the stored objects sharing a fingerprint, computed
+    // where still missing, mapped to their keys
+    QHash<QString, QString> candidateHashes(quint64 fingerprint);
+
+    static QString fingerprintKey(quint64 fingerprint, qint64 size);
+    static bool linkFile(const QString& source, const QString& destination);
+};
+
+} // namespace Murmur
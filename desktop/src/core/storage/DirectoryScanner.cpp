@@ -0,0 +1,627 @@
+#include "DirectoryScanner.hpp"
+#include "core/common/Logger.hpp"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
+#include <xxhash.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace Murmur {
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'M', 'R', 'L', 'I', 'B', '0', '0', '1'};
+constexpr quint32 INDEX_VERSION = 1;
+
+// Directory reads on a network mount are latency bound, so the pool runs
+// more workers than there are cores
+constexpr int MIN_SCAN_WORKERS = 4;
+constexpr int MAX_SCAN_WORKERS = 16;
+
+QString childPath(const QString& directory, const QString& name) {
+    return directory.endsWith(QLatin1Char('/')) ? directory + name : directory + QLatin1Char('/') + name;
+}
+
+bool isUnder(const QString& path, const QString& root) {
+    return path.size() > root.size() && path.startsWith(root) &&
+           (root.endsWith(QLatin1Char('/')) || path.at(root.size()) == QLatin1Char('/'));
+}
+
+#ifdef Q_OS_LINUX
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+qint64 toNanoseconds(const struct statx_timestamp& time) {
+    return qint64(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+#endif
+
+} // namespace
+
+class DirectoryScanner::ScanJob {
+public:
+    ScanJob(DirectoryScanner& scanner, bool recursive, int workerCount)
+        : scanner_(scanner)
+        , recursive_(recursive)
+    {
+        for (int i = 0; i < workerCount; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    bool run(const QString& root) {
+        root_ = root;
+        push(0, root);
+
+        // The calling thread is worker 0, so the scan makes progress even
+        // when other scans hold every pool thread
+        QList<QFuture<void>> helpers;
+        if (recursive_) {
+            for (int i = 1; i < static_cast<int>(workers_.size()); ++i) {
+                helpers.append(QtConcurrent::run(&scanner_.pool_, [this, i]() { work(i); }));
+            }
+        }
+        work(0);
+        for (auto& helper : helpers) {
+            helper.waitForFinished();
+        }
+
+        return !rootFailed_;
+    }
+
+    void collect(ScanResult& result, QHash<QString, IndexedDirectory>& updates) {
+        for (auto& worker : workers_) {
+            result.files.append(worker->files);
+            result.directories.append(worker->directories);
+            result.directoriesRead += worker->directoriesRead;
+            updates.insert(worker->updates);
+        }
+    }
+
+private:
+    struct Worker {
+        QMutex mutex;
+        std::deque<QString> queue;
+
+        // Only touched by the worker's own thread
+        QList<ScannedFile> files;
+        QStringList directories;
+        QHash<QString, IndexedDirectory> updates;
+        int directoriesRead = 0;
+    };
+
+    DirectoryScanner& scanner_;
+    const bool recursive_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<int> pending_{0};
+    QString root_;
+
+    // Idle workers sleep here until a directory is queued or the scan ends
+    QMutex idleMutex_;
+    QWaitCondition wakeWorkers_;
+    std::atomic<int> idle_{0};
+    bool rootFailed_ = false;
+
+    void push(int self, const QString& directory) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            QMutexLocker locker(&workers_[self]->mutex);
+            workers_[self]->queue.push_back(directory);
+        }
+
+        // Idle workers count themselves before their last look at the
+        // queues, so either they see this directory or we see them
+        if (idle_.load() > 0) {
+            QMutexLocker locker(&idleMutex_);
+            wakeWorkers_.wakeOne();
+        }
+    }
+
+    bool hasQueuedWork() {
+        for (auto& worker : workers_) {
+            QMutexLocker locker(&worker->mutex);
+            if (!worker->queue.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Newest first from our own queue, oldest first from anyone else's
+    bool take(int self, QString& directory) {
+        {
+            Worker& own = *workers_[self];
+            QMutexLocker locker(&own.mutex);
+            if (!own.queue.empty()) {
+                directory = std::move(own.queue.back());
+                own.queue.pop_back();
+                return true;
+            }
+        }
+
+        const int count = static_cast<int>(workers_.size());
+        for (int i = 1; i < count; ++i) {
+            Worker& victim = *workers_[(self + i) % count];
+            QMutexLocker locker(&victim.mutex);
+            if (!victim.queue.empty()) {
+                directory = std::move(victim.queue.front());
+                victim.queue.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(int self) {
+        QString directory;
+        while (true) {
+            if (take(self, directory)) {
+                process(self, directory);
+                // Children were queued first, so this only reaches zero
+                // once the whole tree is done
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    QMutexLocker locker(&idleMutex_);
+                    wakeWorkers_.wakeAll();
+                }
+                continue;
+            }
+            if (pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+
+            QMutexLocker locker(&idleMutex_);
+            idle_.fetch_add(1);
+            if (pending_.load(std::memory_order_acquire) != 0 && !hasQueuedWork()) {
+                wakeWorkers_.wait(&idleMutex_);
+            }
+            idle_.fetch_sub(1);
+        }
+    }
+
+    void process(int self, const QString& directory) {
+        Worker& worker = *workers_[self];
+
+        std::optional<IndexedDirectory> cached;
+        bool watched = false;
+        {
+            QReadLocker locker(&scanner_.indexLock_);
+            auto it = scanner_.index_.constFind(directory);
+            if (it != scanner_.index_.constEnd()) {
+                cached = it.value();
+            }
+            watched = scanner_.watched_.contains(directory);
+        }
+
+        IndexedDirectory listing;
+        ListingSource source = ListingSource::Read;
+        if (!listDirectory(directory, cached ? &*cached : nullptr, watched, listing, source)) {
+            if (directory == root_) {
+                rootFailed_ = true;
+            } else {
+                Logger::instance().debug("DirectoryScanner: skipping unreadable directory {}", directory.toStdString());
+            }
+            return;
+        }
+
+        worker.directories.append(directory);
+        if (source == ListingSource::Read) {
+            worker.directoriesRead++;
+        }
+        if (source != ListingSource::Reused) {
+            worker.updates.insert(directory, listing);
+        }
+
+        for (const IndexedFile& file : std::as_const(listing.files)) {
+            worker.files.append({childPath(directory, file.name), file.size, file.modifiedNs, file.inode});
+        }
+
+        if (recursive_) {
+            for (const QString& name : std::as_const(listing.subdirectories)) {
+                push(self, childPath(directory, name));
+            }
+        }
+    }
+};
+
+DirectoryScanner::DirectoryScanner() {
+    pool_.setMaxThreadCount(std::clamp(QThread::idealThreadCount() * 2, MIN_SCAN_WORKERS, MAX_SCAN_WORKERS));
+}
+
+DirectoryScanner::~DirectoryScanner() {
+    pool_.waitForDone();
+}
+
+void DirectoryScanner::setIndexPath(const QString& path) {
+    QWriteLocker locker(&indexLock_);
+    indexPath_ = path;
+    indexLoaded_ = false;
+}
+
+Expected<ScanResult, ScanError> DirectoryScanner::scan(const QString& root, bool recursive) {
+    const QString rootPath = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+    if (!QFileInfo(rootPath).isDir()) {
+        return makeUnexpected(ScanError::NotFound);
+    }
+
+    ensureIndexLoaded();
+
+    ScanJob job(*this, recursive, recursive ? pool_.maxThreadCount() + 1 : 1);
+    if (!job.run(rootPath)) {
+        return makeUnexpected(ScanError::ReadFailed);
+    }
+
+    ScanResult result;
+    QHash<QString, IndexedDirectory> updates;
+    job.collect(result, updates);
+
+    QWriteLocker locker(&indexLock_);
+    for (auto it = updates.cbegin(); it != updates.cend(); ++it) {
+        index_.insert(it.key(), it.value());
+    }
+    bool changed = !updates.isEmpty();
+
+    // A full walk also tells us which directories below the root are gone
+    if (recursive) {
+        const QSet<QString> visited(result.directories.cbegin(), result.directories.cend());
+        for (auto it = index_.begin(); it != index_.end();) {
+            if (isUnder(it.key(), rootPath) && !visited.contains(it.key())) {
+                it = index_.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+    indexDirty_ = indexDirty_ || changed;
+
+    return result;
+}
+
+void DirectoryScanner::invalidate(const QString& directory) {
+    QWriteLocker locker(&indexLock_);
+    if (index_.remove(QDir::cleanPath(directory)) > 0) {
+        indexDirty_ = true;
+    }
+}
+
+void DirectoryScanner::invalidateAll() {
+    QWriteLocker locker(&indexLock_);
+    indexDirty_ = indexDirty_ || !index_.isEmpty();
+    index_.clear();
+}
+
+void DirectoryScanner::setWatched(const QString& directory, bool watched) {
+    QWriteLocker locker(&indexLock_);
+    if (watched) {
+        watched_.insert(QDir::cleanPath(directory));
+    } else {
+        watched_.remove(QDir::cleanPath(directory));
+    }
+}
+
+void DirectoryScanner::clearWatchedTree(const QString& root) {
+    const QString rootPath = QDir::cleanPath(root);
+    QWriteLocker locker(&indexLock_);
+    for (auto it = watched_.begin(); it != watched_.end();) {
+        if (*it == rootPath || isUnder(*it, rootPath)) {
+            it = watched_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+qint64 DirectoryScanner::indexedDirectoryCount() const {
+    QReadLocker locker(&indexLock_);
+    return index_.size();
+}
+
+void DirectoryScanner::ensureIndexLoaded() {
+    {
+        QReadLocker locker(&indexLock_);
+        if (indexLoaded_ || indexPath_.isEmpty()) {
+            return;
+        }
+    }
+
+    QWriteLocker locker(&indexLock_);
+    if (!indexLoaded_ && !indexPath_.isEmpty()) {
+        indexLoaded_ = true;
+        if (!loadIndex()) {
+            index_.clear();
+        }
+    }
+}
+
+bool DirectoryScanner::loadIndex() {
+    QFile file(indexPath_);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray contents = file.readAll();
+    const qsizetype headerSize = sizeof(INDEX_MAGIC) + sizeof(quint32) + sizeof(quint64);
+    if (contents.size() < headerSize || std::memcmp(contents.constData(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        Logger::instance().warn("DirectoryScanner: ignoring unrecognised index {}", indexPath_.toStdString());
+        return false;
+    }
+
+    quint32 version = 0;
+    quint64 checksum = 0;
+    std::memcpy(&version, contents.constData() + sizeof(INDEX_MAGIC), sizeof(version));
+    std::memcpy(&checksum, contents.constData() + sizeof(INDEX_MAGIC) + sizeof(version), sizeof(checksum));
+    const char* body = contents.constData() + headerSize;
+    const size_t bodySize = static_cast<size_t>(contents.size() - headerSize);
+    if (version != INDEX_VERSION || XXH3_64bits(body, bodySize) != checksum) {
+        Logger::instance().warn("DirectoryScanner: discarding stale or corrupt index {}", indexPath_.toStdString());
+        return false;
+    }
+
+    QDataStream stream(QByteArray::fromRawData(body, static_cast<qsizetype>(bodySize)));
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 directoryCount = 0;
+    stream >> directoryCount;
+
+    QHash<QString, IndexedDirectory> loaded;
+    loaded.reserve(directoryCount);
+    for (quint32 i = 0; i < directoryCount && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        IndexedDirectory directory;
+        quint32 fileCount = 0;
+        stream >> path >> directory.inode >> directory.modifiedNs >> directory.subdirectories >> fileCount;
+
+        directory.files.reserve(fileCount);
+        for (quint32 j = 0; j < fileCount && stream.status() == QDataStream::Ok; ++j) {
+            IndexedFile indexed;
+            stream >> indexed.name >> indexed.size >> indexed.modifiedNs >> indexed.inode;
+            directory.files.append(indexed);
+        }
+        loaded.insert(path, directory);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        Logger::instance().warn("DirectoryScanner: truncated index {}", indexPath_.toStdString());
+        return false;
+    }
+
+    index_ = std::move(loaded);
+    indexDirty_ = false;
+    Logger::instance().info("DirectoryScanner: loaded index of {} directories", index_.size());
+    return true;
+}
+
+bool DirectoryScanner::saveIndex() {
+    QMutexLocker saveLocker(&saveMutex_);
+
+    QHash<QString, IndexedDirectory> snapshot;
+    QString path;
+    {
+        QWriteLocker locker(&indexLock_);
+        if (!indexDirty_ || indexPath_.isEmpty()) {
+            return true;
+        }
+        // Implicitly shared, so the copy is cheap and scans can go on
+        snapshot = index_;
+        path = indexPath_;
+        indexDirty_ = false;
+    }
+
+    QByteArray body;
+    {
+        QDataStream stream(&body, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << static_cast<quint32>(snapshot.size());
+        for (auto it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+            const IndexedDirectory& directory = it.value();
+            stream << it.key() << directory.inode << directory.modifiedNs << directory.subdirectories
+                   << static_cast<quint32>(directory.files.size());
+            for (const IndexedFile& file : directory.files) {
+                stream << file.name << file.size << file.modifiedNs << file.inode;
+            }
+        }
+    }
+
+    const quint32 version = INDEX_VERSION;
+    const quint64 checksum = XXH3_64bits(body.constData(), static_cast<size_t>(body.size()));
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    bool written = file.open(QIODevice::WriteOnly) &&
+                   file.write(INDEX_MAGIC, sizeof(INDEX_MAGIC)) == sizeof(INDEX_MAGIC) &&
+                   file.write(reinterpret_cast<const char*>(&version), sizeof(version)) == sizeof(version) &&
+                   file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum)) == sizeof(checksum) &&
+                   file.write(body) == body.size() &&
+                   file.commit();
+
+    if (!written) {
+        Logger::instance().warn("DirectoryScanner: failed to write index {}", path.toStdString());
+        QWriteLocker locker(&indexLock_);
+        indexDirty_ = true;
+    }
+    return written;
+}
+
+bool DirectoryScanner::listDirectory(const QString& path, const IndexedDirectory* cached, bool watched,
+                                     IndexedDirectory& listing, ListingSource& source) {
+    source = ListingSource::Read;
+
+#ifdef Q_OS_LINUX
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // DONT_SYNC takes cached attributes on NFS and SMB instead of asking the server
+    struct statx stat;
+    if (::statx(fd, "", AT_EMPTY_PATH | AT_STATX_DONT_SYNC, STATX_INO | STATX_MTIME, &stat) != 0) {
+        ::close(fd);
+        return false;
+    }
+    listing.inode = stat.stx_ino;
+    listing.modifiedNs = toNanoseconds(stat.stx_mtime);
+
+    if (cached && cached->inode == listing.inode && cached->modifiedNs == listing.modifiedNs) {
+        listing = *cached;
+        source = ListingSource::Reused;
+        if (watched) {
+            ::close(fd);
+            return true;
+        }
+
+        // The entries are the same but their contents may not be; links
+        // are followed, as they were when the directory was listed
+        const unsigned int mask = STATX_TYPE | STATX_INO | STATX_SIZE | STATX_MTIME;
+        for (auto it = listing.files.begin(); it != listing.files.end();) {
+            if (::statx(fd, QFile::encodeName(it->name).constData(), AT_STATX_DONT_SYNC, mask, &stat) != 0 ||
+                !S_ISREG(stat.stx_mode)) {
+                it = listing.files.erase(it);
+                source = ListingSource::Refreshed;
+                continue;
+            }
+            const qint64 size = static_cast<qint64>(stat.stx_size);
+            const qint64 modifiedNs = toNanoseconds(stat.stx_mtime);
+            if (it->size != size || it->modifiedNs != modifiedNs || it->inode != stat.stx_ino) {
+                it->size = size;
+                it->modifiedNs = modifiedNs;
+                it->inode = stat.stx_ino;
+                source = ListingSource::Refreshed;
+            }
+            ++it;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    alignas(LinuxDirent64) char buffer[64 * 1024];
+    while (true) {
+        const long count = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            ::close(fd);
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < count;) {
+            const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+
+            // Hidden entries, "." and ".."
+            if (entry->d_name[0] == '.') {
+                continue;
+            }
+
+            const unsigned char type = entry->d_type;
+            if (type == DT_DIR) {
+                listing.subdirectories.append(QFile::decodeName(entry->d_name));
+                continue;
+            }
+            if (type != DT_REG && type != DT_LNK && type != DT_UNKNOWN) {
+                continue;
+            }
+
+            // Links are stat'ed through to their target but never descended
+            const unsigned int mask = STATX_TYPE | STATX_INO | STATX_SIZE | STATX_MTIME;
+            const int flags = AT_STATX_DONT_SYNC | (type == DT_LNK ? 0 : AT_SYMLINK_NOFOLLOW);
+            if (::statx(fd, entry->d_name, flags, mask, &stat) != 0) {
+                continue;
+            }
+            if (S_ISLNK(stat.stx_mode) && ::statx(fd, entry->d_name, AT_STATX_DONT_SYNC, mask, &stat) != 0) {
+                continue;
+            }
+            if (S_ISDIR(stat.stx_mode) && type == DT_UNKNOWN) {
+                listing.subdirectories.append(QFile::decodeName(entry->d_name));
+                continue;
+            }
+            if (!S_ISREG(stat.stx_mode)) {
+                continue;
+            }
+
+            listing.files.append({QFile::decodeName(entry->d_name), static_cast<qint64>(stat.stx_size),
+                                  toNanoseconds(stat.stx_mtime), stat.stx_ino});
+        }
+    }
+
+    ::close(fd);
+    return true;
+#else
+    QFileInfo info(path);
+    if (!info.isDir()) {
+        return false;
+    }
+    listing.modifiedNs = info.lastModified().toMSecsSinceEpoch() * 1000000;
+
+    if (cached && cached->modifiedNs == listing.modifiedNs) {
+        // QFileSystemWatcher does not report files written in place, so
+        // watched directories are refreshed too
+        Q_UNUSED(watched);
+        listing = *cached;
+        source = ListingSource::Reused;
+
+        const QDir directory(path);
+        for (auto it = listing.files.begin(); it != listing.files.end();) {
+            const QFileInfo entry(directory.filePath(it->name));
+            if (!entry.isFile()) {
+                it = listing.files.erase(it);
+                source = ListingSource::Refreshed;
+                continue;
+            }
+            const qint64 modifiedNs = entry.lastModified().toMSecsSinceEpoch() * 1000000;
+            if (it->size != entry.size() || it->modifiedNs != modifiedNs) {
+                it->size = entry.size();
+                it->modifiedNs = modifiedNs;
+                source = ListingSource::Refreshed;
+            }
+            ++it;
+        }
+        return true;
+    }
+
+    const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo& entry : entries) {
+        if (entry.isDir()) {
+            if (!entry.isSymLink()) {
+                listing.subdirectories.append(entry.fileName());
+            }
+        } else if (entry.isFile()) {
+            listing.files.append({entry.fileName(), entry.size(), entry.lastModified().toMSecsSinceEpoch() * 1000000, 0});
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace Murmur
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
+#include <QtCore/QThreadPool>
+
+#include "core/common/Expected.hpp"
+
+namespace Murmur {
+
+enum class ScanError {
+    NotFound,
+    ReadFailed
+};
+
+struct ScannedFile {
+    QString path;
+    qint64 size = 0;
+    qint64 modifiedNs = 0;
+    quint64 inode = 0;
+};
+
+struct ScanResult {
+    QList<ScannedFile> files;
+    QStringList directories;     // Every directory visited, root included
+    int directoriesRead = 0;     // Directories listed from disk rather than the index
+};
+
+/**
+ * @brief Parallel, incremental directory tree scanner
+ *
+ * Directories are spread over a pool of workers, each with its own queue.
+ * A worker pushes the subdirectories it finds onto its own queue and takes
+ * from the back of it, so it walks depth-first; an idle worker steals from
+ * the front of another's queue. On Linux entries are read with getdents64
+ * and stat'ed with statx relative to the open directory, without forcing
+ * attribute revalidation on network filesystems.
+ *
+ * Every directory read is recorded in an index of (path, inode, mtime) with
+ * the (name, inode, mtime, size) of its files. A later scan stats each
+ * directory and, when its inode and mtime are unchanged, skips listing it
+ * and only stats the recorded file names again, since files rewritten or
+ * grown in place do not touch the directory's mtime. Directories marked
+ * with setWatched() are reused without stat'ing their files; their
+ * DirectoryWatcher events feed invalidate(), which forces a directory to be
+ * read again.
+ *
+ * Hidden entries are skipped and symbolic links to directories are not
+ * followed. All methods are thread-safe.
+ */
+class DirectoryScanner {
+public:
+    DirectoryScanner();
+    ~DirectoryScanner();
+
+    DirectoryScanner(const DirectoryScanner&) = delete;
+    DirectoryScanner& operator=(const DirectoryScanner&) = delete;
+
+    // Where the index is persisted; call before the first scan
+    void setIndexPath(const QString& path);
+
+    Expected<ScanResult, ScanError> scan(const QString& root, bool recursive = true);
+
+    // Forces the next scan to list this directory again
+    void invalidate(const QString& directory);
+    void invalidateAll();
+
+    // Marks a directory whose changes, including files written in place,
+    // are reported through invalidate()
+    void setWatched(const QString& directory, bool watched);
+    void clearWatchedTree(const QString& root);
+
+    // Writes the index if it changed since it was loaded or last saved
+    bool saveIndex();
+
+    qint64 indexedDirectoryCount() const;
+
+private:
+    struct IndexedFile {
+        QString name;
+        qint64 size = 0;
+        qint64 modifiedNs = 0;
+        quint64 inode = 0;
+    };
+
+    struct IndexedDirectory {
+        quint64 inode = 0;
+        qint64 modifiedNs = 0;
+        QList<IndexedFile> files;
+        QStringList subdirectories;
+    };
+
+    // How a directory's listing was obtained
+    enum class ListingSource {
+        Read,       // Listed from disk
+        Reused,     // Taken from the index unchanged
+        Refreshed   // Names from the index, file attributes stat'ed again
+    };
+
+    class ScanJob;
+
+    mutable QReadWriteLock indexLock_;
+    QHash<QString, IndexedDirectory> index_;
+    QSet<QString> watched_;
+    QString indexPath_;
+    bool indexLoaded_ = false;
+    bool indexDirty_ = false;
+
+    QMutex saveMutex_;
+    QThreadPool pool_;
+
+    void ensureIndexLoaded();
+    bool loadIndex();
+
+    // Lists a directory, or builds on `cached` when the directory is
+    // unchanged; a watched directory's cached listing is trusted as is
+    static bool listDirectory(const QString& path, const IndexedDirectory* cached, bool watched,
+                              IndexedDirectory& listing, ListingSource& source);
+};
+
+} // namespace Murmur
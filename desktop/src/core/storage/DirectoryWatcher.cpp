@@ -0,0 +1,211 @@
+#include "DirectoryWatcher.hpp"
+#include "core/common/Logger.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+#include <utility>
+
+#ifdef Q_OS_LINUX
+#include <QtCore/QSocketNotifier>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#include <climits>
+#else
+#include <QtCore/QFileSystemWatcher>
+#endif
+
+namespace Murmur {
+
+namespace {
+
+bool isSameOrUnder(const QString& path, const QString& root) {
+    return path == root || (path.startsWith(root) &&
+           (root.endsWith(QLatin1Char('/')) || path.at(root.size()) == QLatin1Char('/')));
+}
+
+#ifdef Q_OS_LINUX
+// Entry changes plus writes to files, which change sizes without touching
+// the directory. IN_MODIFY covers writers that keep the file open, such as
+// torrent downloads; the bursts it produces are coalesced below.
+constexpr quint32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                               IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+} // namespace
+
+struct DirectoryWatcher::DirectoryWatcherPrivate {
+#ifdef Q_OS_LINUX
+    int inotifyFd = -1;
+    QSocketNotifier* notifier = nullptr;
+    QHash<int, QString> pathsByWatch;
+    QHash<QString, int> watchesByPath;
+    bool watchLimitReported = false;
+#else
+    QFileSystemWatcher* watcher = nullptr;
+#endif
+    QSet<QString> pendingChanges;
+    QTimer* coalesceTimer = nullptr;
+};
+
+DirectoryWatcher::DirectoryWatcher(QObject* parent)
+    : QObject(parent)
+    , d(std::make_unique<DirectoryWatcherPrivate>())
+{
+    d->coalesceTimer = new QTimer(this);
+    d->coalesceTimer->setSingleShot(true);
+    d->coalesceTimer->setInterval(COALESCE_INTERVAL_MS);
+    connect(d->coalesceTimer, &QTimer::timeout, this, &DirectoryWatcher::flushChanges);
+
+#ifdef Q_OS_LINUX
+    d->inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (d->inotifyFd < 0) {
+        Logger::instance().warn("DirectoryWatcher: inotify unavailable (errno {})", errno);
+        return;
+    }
+    d->notifier = new QSocketNotifier(d->inotifyFd, QSocketNotifier::Read, this);
+    connect(d->notifier, &QSocketNotifier::activated, this, &DirectoryWatcher::readEvents);
+#else
+    d->watcher = new QFileSystemWatcher(this);
+    connect(d->watcher, &QFileSystemWatcher::directoryChanged, this, &DirectoryWatcher::queueChange);
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef Q_OS_LINUX
+    if (d->inotifyFd >= 0) {
+        delete d->notifier;
+        ::close(d->inotifyFd);
+    }
+#endif
+}
+
+bool DirectoryWatcher::addPath(const QString& directory) {
+    const QString path = QDir::cleanPath(directory);
+
+#ifdef Q_OS_LINUX
+    if (d->inotifyFd < 0) {
+        return false;
+    }
+    if (d->watchesByPath.contains(path)) {
+        return true;
+    }
+
+    const int watch = ::inotify_add_watch(d->inotifyFd, QFile::encodeName(path).constData(), WATCH_MASK);
+    if (watch < 0) {
+        if (errno == ENOSPC && !d->watchLimitReported) {
+            d->watchLimitReported = true;
+            Logger::instance().warn("DirectoryWatcher: inotify watch limit reached after {} directories; "
+                                    "raise fs.inotify.max_user_watches to watch more", d->watchesByPath.size());
+        }
+        return false;
+    }
+
+    d->pathsByWatch.insert(watch, path);
+    d->watchesByPath.insert(path, watch);
+    return true;
+#else
+    return d->watcher->addPath(path);
+#endif
+}
+
+void DirectoryWatcher::removePath(const QString& directory) {
+    const QString path = QDir::cleanPath(directory);
+
+#ifdef Q_OS_LINUX
+    const int watch = d->watchesByPath.take(path);
+    if (watch > 0) {
+        d->pathsByWatch.remove(watch);
+        ::inotify_rm_watch(d->inotifyFd, watch);
+    }
+#else
+    d->watcher->removePath(path);
+#endif
+}
+
+void DirectoryWatcher::removeTree(const QString& root) {
+    const QString rootPath = QDir::cleanPath(root);
+    for (const QString& path : directories()) {
+        if (isSameOrUnder(path, rootPath)) {
+            removePath(path);
+        }
+    }
+}
+
+QStringList DirectoryWatcher::directories() const {
+#ifdef Q_OS_LINUX
+    return d->watchesByPath.keys();
+#else
+    return d->watcher->directories();
+#endif
+}
+
+bool DirectoryWatcher::isWatching(const QString& directory) const {
+    const QString path = QDir::cleanPath(directory);
+#ifdef Q_OS_LINUX
+    return d->watchesByPath.contains(path);
+#else
+    return d->watcher->directories().contains(path);
+#endif
+}
+
+void DirectoryWatcher::readEvents() {
+#ifdef Q_OS_LINUX
+    alignas(struct inotify_event) char buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+
+    while (true) {
+        const ssize_t length = ::read(d->inotifyFd, buffer, sizeof(buffer));
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                d->pendingChanges.clear();
+                emit overflowed();
+                continue;
+            }
+
+            const QString path = d->pathsByWatch.value(event->wd);
+            if (path.isEmpty()) {
+                continue;
+            }
+
+            // The kernel already dropped the watch; forget it and report the
+            // change so the directory is rescanned
+            if (event->mask & IN_IGNORED) {
+                d->pathsByWatch.remove(event->wd);
+                d->watchesByPath.remove(path);
+            }
+
+            queueChange(path);
+        }
+    }
+#endif
+}
+
+void DirectoryWatcher::queueChange(const QString& directory) {
+    d->pendingChanges.insert(directory);
+    if (!d->coalesceTimer->isActive()) {
+        d->coalesceTimer->start();
+    }
+}
+
+void DirectoryWatcher::flushChanges() {
+    const QSet<QString> changes = std::exchange(d->pendingChanges, {});
+    for (const QString& directory : changes) {
+        emit directoryChanged(directory);
+    }
+}
+
+} // namespace Murmur
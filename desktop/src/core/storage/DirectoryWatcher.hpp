@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <memory>
+
+namespace Murmur {
+
+/**
+ * @brief Reports changes to a set of directories
+ *
+ * On Linux each directory gets one inotify watch for entries being created,
+ * removed, renamed or written to; elsewhere QFileSystemWatcher is used,
+ * which does not report files written in place. Watches are not recursive, so callers add every directory they
+ * care about. Bursts of events, such as a large copy into a directory, are
+ * coalesced into one directoryChanged() per directory.
+ *
+ * inotify only sees changes made through the local kernel; edits made on a
+ * NAS by other machines still need a rescan to be noticed.
+ *
+ * Lives in, and must be used from, the thread that created it.
+ */
+class DirectoryWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    // Window over which events for one directory are merged
+    static constexpr int COALESCE_INTERVAL_MS = 250;
+
+    explicit DirectoryWatcher(QObject* parent = nullptr);
+    ~DirectoryWatcher() override;
+
+    bool addPath(const QString& directory);
+    void removePath(const QString& directory);
+
+    // Removes the directory and everything watched below it
+    void removeTree(const QString& root);
+
+    QStringList directories() const;
+    bool isWatching(const QString& directory) const;
+
+signals:
+    void directoryChanged(const QString& directory);
+
+    // Events were dropped; anything watched may have changed
+    void overflowed();
+
+private:
+    struct DirectoryWatcherPrivate;
+    std::unique_ptr<DirectoryWatcherPrivate> d;
+
+    void readEvents();
+    void queueChange(const QString& directory);
+    void flushChanges();
+};
+
+} // namespace Murmur
@@ -1,4 +1,6 @@
 #include "FileCache.hpp"
+#include "CacheIndex.hpp"
+#include "CacheSegmentStore.hpp"
 #include "core/common/Logger.hpp"
 #include "core/security/InputValidator.hpp"
 
@@ -6,39 +8,630 @@
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QDataStream>
-#include <QtCore/QCryptographicHash>
+#include <QtCore/QtEndian>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSaveFile>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QRandomGenerator>
 #include <QtCore/QRegularExpression>
 #include <QCoreApplication>
+#include <QtConcurrent/QtConcurrent>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace Murmur {
 
+namespace {
+
+// Power of two so a key's shard is a mask of its hash
+constexpr int CACHE_SHARD_COUNT = 16;
+
+// Below this entry limit shards are too small for their local eviction order
+// to approximate the global one, so victims are always ranked across shards
+constexpr qint64 LOCAL_EVICTION_MIN_ENTRIES = CACHE_SHARD_COUNT * 64;
+
+// Payloads smaller than this are stored as-is; codec framing eats the gain
+constexpr qsizetype COMPRESSION_MIN_SIZE = 1024;
+
+// Original/compressed size ratio an entry must reach to be stored compressed
+constexpr double DEFAULT_MIN_COMPRESSION_RATIO = 1.1;
+
+// Checksums are big-endian XXH3-64 digests; older entries carry 16-byte MD5
+// digests, which are not verified
+constexpr qsizetype CHECKSUM_SIZE = sizeof(quint64);
+
+// Snapshot entries restored per batch by the background index loader
+constexpr qint64 INDEX_LOAD_BATCH = 4096;
+
+struct FrequencyBucket;
+
+struct CacheNode {
+    CacheEntry entry;
+    qint64 lastTouch = 0;   // steady clock, comparable across shards
+    qint64 insertedAt = 0;  // steady clock, for FIFO
+    qint64 expiresAtMs = 0; // wall clock, 0 when the entry has no TTL
+    int heapIndex = -1;
+
+    CacheNode* recentPrev = nullptr;
+    CacheNode* recentNext = nullptr;
+    CacheNode* insertPrev = nullptr;
+    CacheNode* insertNext = nullptr;
+    CacheNode* frequencyPrev = nullptr;
+    CacheNode* frequencyNext = nullptr;
+    FrequencyBucket* bucket = nullptr;
+};
+
+// Doubly linked list threaded through CacheNode members; head is the most
+// recent end, tail the eviction end
+template<CacheNode* CacheNode::*Prev, CacheNode* CacheNode::*Next>
+struct IntrusiveList {
+    CacheNode* head = nullptr;
+    CacheNode* tail = nullptr;
+
+    void pushFront(CacheNode* node) {
+        node->*Prev = nullptr;
+        node->*Next = head;
+        if (head) {
+            head->*Prev = node;
+        } else {
+            tail = node;
+        }
+        head = node;
+    }
+
+    void unlink(CacheNode* node) {
+        if (node->*Prev) {
+            (node->*Prev)->*Next = node->*Next;
+        } else {
+            head = node->*Next;
+        }
+        if (node->*Next) {
+            (node->*Next)->*Prev = node->*Prev;
+        } else {
+            tail = node->*Prev;
+        }
+        node->*Prev = nullptr;
+        node->*Next = nullptr;
+    }
+
+    void moveToFront(CacheNode* node) {
+        if (head != node) {
+            unlink(node);
+            pushFront(node);
+        }
+    }
+
+    // Oldest node that is not the excluded one
+    CacheNode* oldest(const CacheNode* excluded) const {
+        if (tail && tail == excluded) {
+            return tail->*Prev;
+        }
+        return tail;
+    }
+};
+
+using RecencyList = IntrusiveList<&CacheNode::recentPrev, &CacheNode::recentNext>;
+using InsertionList = IntrusiveList<&CacheNode::insertPrev, &CacheNode::insertNext>;
+using FrequencyList = IntrusiveList<&CacheNode::frequencyPrev, &CacheNode::frequencyNext>;
+
+// All nodes accessed exactly `frequency` times. Buckets form an ascending
+// list so the least frequently used node is always the first bucket's tail.
+struct FrequencyBucket {
+    qint64 frequency = 0;
+    FrequencyBucket* prev = nullptr;
+    FrequencyBucket* next = nullptr;
+    FrequencyList nodes;
+};
+
+// Eviction order key, lower is evicted first. Comparable across shards.
+using VictimRank = std::pair<qint64, qint64>;
+
+qint64 steadyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+qint64 expiryFor(const CacheEntry& entry) {
+    if (entry.ttl <= 0 || !entry.createdAt.isValid()) {
+        return 0;
+    }
+    return entry.createdAt.toMSecsSinceEpoch() + entry.ttl * 1000;
+}
+
+class CacheShard {
+public:
+    CacheShard() = default;
+    ~CacheShard() { reset(); }
+
+    CacheShard(const CacheShard&) = delete;
+    CacheShard& operator=(const CacheShard&) = delete;
+
+    mutable QMutex mutex;
+    std::unordered_map<QString, std::unique_ptr<CacheNode>> nodes;
+    qint64 totalSize = 0;
+
+    std::atomic<qint64> hitCount{0};
+    std::atomic<qint64> missCount{0};
+    std::atomic<qint64> evictionCount{0};
+
+    CacheNode* find(const QString& key) const {
+        auto it = nodes.find(key);
+        return it != nodes.end() ? it->second.get() : nullptr;
+    }
+
+    CacheNode* insert(CacheEntry entry) {
+        auto node = std::make_unique<CacheNode>();
+        CacheNode* raw = node.get();
+        const qint64 frequency = std::max<qint64>(1, entry.accessCount);
+        raw->entry = std::move(entry);
+        raw->lastTouch = raw->insertedAt = steadyNow();
+
+        recency_.pushFront(raw);
+        insertion_.pushFront(raw);
+        insertFrequency(raw, frequency);
+        setExpiry(raw, expiryFor(raw->entry));
+
+        totalSize += raw->entry.size;
+        nodes.emplace(raw->entry.key, std::move(node));
+        return raw;
+    }
+
+    // Overwrite counts as an access, so the node keeps its frequency history
+    void replace(CacheNode* node, CacheEntry entry) {
+        totalSize += entry.size - node->entry.size;
+        entry.accessCount = node->entry.accessCount;
+        node->entry = std::move(entry);
+        node->insertedAt = steadyNow();
+        insertion_.moveToFront(node);
+        touch(node);
+        setExpiry(node, expiryFor(node->entry));
+    }
+
+    void touch(CacheNode* node) {
+        node->lastTouch = steadyNow();
+        node->entry.accessCount++;
+        recency_.moveToFront(node);
+        promote(node);
+    }
+
+    std::unique_ptr<CacheNode> detach(CacheNode* node) {
+        recency_.unlink(node);
+        insertion_.unlink(node);
+        removeFrequency(node);
+        setExpiry(node, 0);
+        totalSize -= node->entry.size;
+
+        auto it = nodes.find(node->entry.key);
+        std::unique_ptr<CacheNode> owned = std::move(it->second);
+        nodes.erase(it);
+        return owned;
+    }
+
+    CacheNode* victim(CachePolicy policy, const QString& excludedKey) const {
+        const CacheNode* excluded = excludedKey.isEmpty() ? nullptr : find(excludedKey);
+
+        switch (policy) {
+            case CachePolicy::FirstInFirstOut:
+                return insertion_.oldest(excluded);
+            case CachePolicy::LeastFrequentlyUsed:
+                for (FrequencyBucket* bucket = lowestFrequency_; bucket; bucket = bucket->next) {
+                    if (CacheNode* node = bucket->nodes.oldest(excluded)) {
+                        return node;
+                    }
+                }
+                return nullptr;
+            case CachePolicy::TimeToLive:
+                if (CacheNode* node = soonestExpiry(excluded)) {
+                    return node;
+                }
+                return recency_.oldest(excluded);
+            default:
+                return recency_.oldest(excluded);
+        }
+    }
+
+    static VictimRank rank(CachePolicy policy, const CacheNode* node) {
+        switch (policy) {
+            case CachePolicy::FirstInFirstOut:
+                return {node->insertedAt, 0};
+            case CachePolicy::LeastFrequentlyUsed:
+                return {node->bucket->frequency, node->lastTouch};
+            case CachePolicy::TimeToLive:
+                return {node->expiresAtMs > 0 ? node->expiresAtMs : std::numeric_limits<qint64>::max(),
+                        node->lastTouch};
+            default:
+                return {node->lastTouch, 0};
+        }
+    }
+
+    std::vector<std::unique_ptr<CacheNode>> takeExpired(qint64 nowMs) {
+        std::vector<std::unique_ptr<CacheNode>> expired;
+        while (!expiryHeap_.empty() && expiryHeap_.front()->expiresAtMs < nowMs) {
+            expired.push_back(detach(expiryHeap_.front()));
+        }
+        return expired;
+    }
+
+    void reset() {
+        while (lowestFrequency_) {
+            FrequencyBucket* next = lowestFrequency_->next;
+            delete lowestFrequency_;
+            lowestFrequency_ = next;
+        }
+        recency_ = RecencyList();
+        insertion_ = InsertionList();
+        expiryHeap_.clear();
+        nodes.clear();
+        totalSize = 0;
+    }
+
+private:
+    RecencyList recency_;
+    InsertionList insertion_;
+    FrequencyBucket* lowestFrequency_ = nullptr;
+    std::vector<CacheNode*> expiryHeap_;
+
+    FrequencyBucket* insertBucketAfter(FrequencyBucket* prev, qint64 frequency) {
+        auto* bucket = new FrequencyBucket;
+        bucket->frequency = frequency;
+        bucket->prev = prev;
+        bucket->next = prev ? prev->next : lowestFrequency_;
+        if (bucket->next) {
+            bucket->next->prev = bucket;
+        }
+        if (prev) {
+            prev->next = bucket;
+        } else {
+            lowestFrequency_ = bucket;
+        }
+        return bucket;
+    }
+
+    void removeBucket(FrequencyBucket* bucket) {
+        if (bucket->prev) {
+            bucket->prev->next = bucket->next;
+        } else {
+            lowestFrequency_ = bucket->next;
+        }
+        if (bucket->next) {
+            bucket->next->prev = bucket->prev;
+        }
+        delete bucket;
+    }
+
+    // New entries start at frequency 1 and land in the first bucket; only
+    // entries restored from the index walk further
+    void insertFrequency(CacheNode* node, qint64 frequency) {
+        FrequencyBucket* prev = nullptr;
+        FrequencyBucket* bucket = lowestFrequency_;
+        while (bucket && bucket->frequency < frequency) {
+            prev = bucket;
+            bucket = bucket->next;
+        }
+        if (!bucket || bucket->frequency != frequency) {
+            bucket = insertBucketAfter(prev, frequency);
+        }
+        bucket->nodes.pushFront(node);
+        node->bucket = bucket;
+    }
+
+    void removeFrequency(CacheNode* node) {
+        FrequencyBucket* bucket = node->bucket;
+        bucket->nodes.unlink(node);
+        node->bucket = nullptr;
+        if (!bucket->nodes.head) {
+            removeBucket(bucket);
+        }
+    }
+
+    void promote(CacheNode* node) {
+        FrequencyBucket* current = node->bucket;
+        const qint64 frequency = current->frequency + 1;
+        FrequencyBucket* target = current->next;
+        if (!target || target->frequency != frequency) {
+            target = insertBucketAfter(current, frequency);
+        }
+        current->nodes.unlink(node);
+        if (!current->nodes.head) {
+            removeBucket(current);
+        }
+        target->nodes.pushFront(node);
+        node->bucket = target;
+    }
+
+    CacheNode* soonestExpiry(const CacheNode* excluded) const {
+        if (expiryHeap_.empty()) {
+            return nullptr;
+        }
+        if (expiryHeap_.front() != excluded) {
+            return expiryHeap_.front();
+        }
+        // Next smallest is one of the root's children
+        CacheNode* best = nullptr;
+        for (size_t child = 1; child <= 2 && child < expiryHeap_.size(); ++child) {
+            if (!best || expiryHeap_[child]->expiresAtMs < best->expiresAtMs) {
+                best = expiryHeap_[child];
+            }
+        }
+        return best;
+    }
+
+    void setExpiry(CacheNode* node, qint64 expiresAtMs) {
+        if (node->heapIndex >= 0) {
+            heapErase(node);
+        }
+        node->expiresAtMs = expiresAtMs;
+        if (expiresAtMs > 0) {
+            node->heapIndex = static_cast<int>(expiryHeap_.size());
+            expiryHeap_.push_back(node);
+            siftUp(node->heapIndex);
+        }
+    }
+
+    void heapSwap(size_t a, size_t b) {
+        std::swap(expiryHeap_[a], expiryHeap_[b]);
+        expiryHeap_[a]->heapIndex = static_cast<int>(a);
+        expiryHeap_[b]->heapIndex = static_cast<int>(b);
+    }
+
+    void siftUp(size_t index) {
+        while (index > 0) {
+            const size_t parent = (index - 1) / 2;
+            if (expiryHeap_[parent]->expiresAtMs <= expiryHeap_[index]->expiresAtMs) {
+                break;
+            }
+            heapSwap(index, parent);
+            index = parent;
+        }
+    }
+
+    void siftDown(size_t index) {
+        const size_t count = expiryHeap_.size();
+        while (true) {
+            size_t smallest = index;
+            const size_t left = index * 2 + 1;
+            const size_t right = left + 1;
+            if (left < count && expiryHeap_[left]->expiresAtMs < expiryHeap_[smallest]->expiresAtMs) {
+                smallest = left;
+            }
+            if (right < count && expiryHeap_[right]->expiresAtMs < expiryHeap_[smallest]->expiresAtMs) {
+                smallest = right;
+            }
+            if (smallest == index) {
+                break;
+            }
+            heapSwap(index, smallest);
+            index = smallest;
+        }
+    }
+
+    void heapErase(CacheNode* node) {
+        const size_t index = static_cast<size_t>(node->heapIndex);
+        const size_t last = expiryHeap_.size() - 1;
+        if (index != last) {
+            heapSwap(index, last);
+        }
+        expiryHeap_.pop_back();
+        node->heapIndex = -1;
+        if (index < expiryHeap_.size()) {
+            siftDown(index);
+            siftUp(index);
+        }
+    }
+};
+
+} // namespace
+
 class FileCache::FileCachePrivate {
 public:
-    FileCachePrivate() = default;
+    FileCachePrivate() {
+        for (auto& shard : shards) {
+            shard = std::make_unique<CacheShard>();
+        }
+        maintenancePool.setMaxThreadCount(1);
+    }
     ~FileCachePrivate() = default;
 
-    bool initialized = false;
+    std::atomic<bool> initialized{false};
     QString cacheDirectory;
-    qint64 maxSize = 1024 * 1024 * 100; // 100MB default
-    qint64 maxEntries = 10000;
-    CachePolicy policy = CachePolicy::LeastRecentlyUsed;
-    bool compressionEnabled = true;
-    int compressionLevel = 6;
-    bool persistentCacheEnabled = true;
+    std::atomic<qint64> maxSize{1024 * 1024 * 100}; // 100MB default
+    std::atomic<qint64> maxEntries{10000};
+    std::atomic<CachePolicy> policy{CachePolicy::LeastRecentlyUsed};
+    std::atomic<bool> compressionEnabled{true};
+    std::atomic<int> compressionLevel{3};
+    std::atomic<CacheCodecId> codec{CacheCodecId::Lz4};
+    std::atomic<double> minCompressionRatio{DEFAULT_MIN_COMPRESSION_RATIO};
+    std::atomic<bool> persistentCacheEnabled{true};
+    std::atomic<bool> verifyChecksums{true};
+    CacheStorageMode storageMode = CacheStorageMode::InMemory;
     int cleanupInterval = 300000; // 5 minutes
 
-    std::unordered_map<QString, std::unique_ptr<CacheEntry>> entries;
-    CacheStats stats;
-    mutable QMutex mutex;
+    std::array<std::unique_ptr<CacheShard>, CACHE_SHARD_COUNT> shards;
+    // Running totals across shards, maintained under the owning shard's lock
+    // so limit checks never have to visit every shard
+    std::atomic<qint64> totalSize{0};
+    std::atomic<qint64> entryCount{0};
+    std::atomic<qint64> lastCleanupMs{QDateTime::currentMSecsSinceEpoch()};
+
+    // Zstd dictionaries by id; the active one is used for new entries while
+    // older ones stay loaded so existing entries remain readable
+    mutable QReadWriteLock dictionaryLock;
+    std::shared_ptr<const CompressionDictionary> activeDictionary;
+    QHash<quint32, std::shared_ptr<const CompressionDictionary>> dictionaries;
+
+    std::shared_ptr<const CompressionDictionary> dictionary(quint32 id) const {
+        QReadLocker locker(&dictionaryLock);
+        return dictionaries.value(id);
+    }
+
+    // MappedSegments mode only; created by initialize(), gone after shutdown()
+    std::unique_ptr<CacheSegmentStore> segments;
+
+    // Segment compaction runs on its own single thread so it never competes
+    // with callers for the global pool
+    QThreadPool maintenancePool;
+    QMutex compactionMutex;
+    std::atomic<bool> compactionScheduled{false};
+
+    // Persistent caches only. While the snapshot is still being restored in
+    // the background, keys decided by newer state are tombstoned so the
+    // loader does not bring back their snapshot copy.
+    std::unique_ptr<CacheIndex> index;
+    std::atomic<bool> indexLoading{false};
+    std::atomic<bool> snapshotScheduled{false};
+    QMutex snapshotMutex;
+    mutable QMutex tombstoneMutex;
+    QSet<QString> tombstones;
+
+    void tombstone(const QString& key) {
+        QMutexLocker locker(&tombstoneMutex);
+        tombstones.insert(key);
+    }
+
+    bool isTombstoned(const QString& key) const {
+        QMutexLocker locker(&tombstoneMutex);
+        return tombstones.contains(key);
+    }
+
+    // Shard must be locked by the caller, so journal order matches the
+    // order changes were applied in
+    void journal(const CacheEntry& entry) {
+        if (index) {
+            index->recordEntry(entry);
+        }
+    }
+
+    // Serializes initialize/shutdown/load/save and timer reconfiguration
+    QMutex lifecycleMutex;
     std::unique_ptr<QTimer> cleanupTimer;
     std::unique_ptr<QTimer> syncTimer;
     std::unique_ptr<InputValidator> validator;
+
+    CacheShard& shardFor(const QString& key) const {
+        return *shards[qHash(key) & (CACHE_SHARD_COUNT - 1)];
+    }
+
+    // Shard must be locked by the caller
+    CacheNode* insertNode(CacheShard& shard, CacheEntry entry) {
+        const qint64 size = entry.size;
+        CacheNode* node = shard.insert(std::move(entry));
+        totalSize.fetch_add(size);
+        entryCount.fetch_add(1);
+        return node;
+    }
+
+    // Shard must be locked by the caller
+    std::unique_ptr<CacheNode> detachNode(CacheShard& shard, CacheNode* node) {
+        auto owned = shard.detach(node);
+        totalSize.fetch_sub(owned->entry.size);
+        entryCount.fetch_sub(1);
+        if (index) {
+            index->recordRemoval(owned->entry.key);
+            if (indexLoading) {
+                tombstone(owned->entry.key);
+            }
+        }
+        return owned;
+    }
+
+    // Shard must be locked by the caller
+    std::vector<std::unique_ptr<CacheNode>> takeExpired(CacheShard& shard, qint64 nowMs) {
+        auto expired = shard.takeExpired(nowMs);
+        for (const auto& node : expired) {
+            totalSize.fetch_sub(node->entry.size);
+            entryCount.fetch_sub(1);
+            if (index) {
+                index->recordRemoval(node->entry.key);
+            }
+        }
+        return expired;
+    }
+
+    /**
+     * Picks the shard to evict from next. In a large cache, a preferred shard
+     * holding more than its share of the limits evicts locally, which keeps
+     * steady-state puts on a single lock; otherwise every shard offers its
+     * policy victim and the globally lowest-ranked one wins.
+     */
+    CacheShard* selectVictimShard(CachePolicy victimPolicy, const QString& excludedKey,
+                                  CacheShard* preferred, qint64 limitSize, qint64 limitEntries) const {
+        if (preferred && limitEntries >= LOCAL_EVICTION_MIN_ENTRIES) {
+            QMutexLocker locker(&preferred->mutex);
+            const bool overShare =
+                preferred->totalSize * CACHE_SHARD_COUNT > limitSize ||
+                static_cast<qint64>(preferred->nodes.size()) * CACHE_SHARD_COUNT > limitEntries;
+            if (overShare && preferred->victim(victimPolicy, excludedKey)) {
+                return preferred;
+            }
+        }
+
+        CacheShard* best = nullptr;
+        VictimRank bestRank;
+        for (const auto& shard : shards) {
+            QMutexLocker locker(&shard->mutex);
+            const CacheNode* candidate = shard->victim(victimPolicy, excludedKey);
+            if (!candidate) {
+                continue;
+            }
+            VictimRank candidateRank = CacheShard::rank(victimPolicy, candidate);
+            if (!best || candidateRank < bestRank) {
+                best = shard.get();
+                bestRank = candidateRank;
+            }
+        }
+        return best;
+    }
+
+    // Copies every entry one shard at a time; payloads are implicitly shared
+    QList<CacheEntry> snapshotEntries() const {
+        QList<CacheEntry> entries;
+        entries.reserve(entryCount.load());
+        for (const auto& shard : shards) {
+            QMutexLocker locker(&shard->mutex);
+            for (const auto& [key, node] : shard->nodes) {
+                entries.append(node->entry);
+            }
+        }
+        return entries;
+    }
+
+    QStringList resetShards() {
+        QStringList keys;
+        for (const auto& shard : shards) {
+            QMutexLocker locker(&shard->mutex);
+            for (const auto& [key, node] : shard->nodes) {
+                keys.append(key);
+            }
+            totalSize.fetch_sub(shard->totalSize);
+            entryCount.fetch_sub(static_cast<qint64>(shard->nodes.size()));
+            shard->reset();
+        }
+        return keys;
+    }
+};
+
+// Payload of a cache hit. Mapped payloads are pinned by the view, so they stay
+// readable even if the entry is evicted or compacted away meanwhile.
+struct FileCache::StoredPayload {
+    QByteArray inlineData;
+    CacheView mapped;
+    CacheCodecId codec = CacheCodecId::None;
+    quint32 dictionaryId = 0;
+    qint64 originalSize = 0;
+    QByteArray checksum;
+
+    // Valid while this payload is alive
+    QByteArray bytes() const { return mapped.isMapped() ? mapped.bytes() : inlineData; }
 };
 
 FileCache::FileCache(QObject* parent)
@@ -46,18 +639,6 @@ FileCache::FileCache(QObject* parent)
     , d(std::make_unique<FileCachePrivate>())
 {
     d->validator = std::make_unique<InputValidator>();
-    
-    // Initialize stats
-    d->stats.totalSize = 0;
-    d->stats.maxSize = d->maxSize;
-    d->stats.entryCount = 0;
-    d->stats.maxEntries = d->maxEntries;
-    d->stats.hitCount = 0;
-    d->stats.missCount = 0;
-    d->stats.evictionCount = 0;
-    d->stats.hitRate = 0.0;
-    d->stats.missRate = 0.0;
-    d->stats.lastCleanup = QDateTime::currentDateTime();
 
     // Set up cleanup timer
     d->cleanupTimer = std::make_unique<QTimer>(this);
@@ -75,7 +656,7 @@ FileCache::~FileCache() {
 }
 
 Expected<void, CacheError> FileCache::initialize(const QString& cacheDir, qint64 maxSize) {
-    QMutexLocker locker(&d->mutex);
+    QMutexLocker locker(&d->lifecycleMutex);
     
     if (d->initialized) {
         return Expected<void, CacheError>();
@@ -93,9 +674,19 @@ Expected<void, CacheError> FileCache::initialize(const QString& cacheDir, qint64
         }
     }
 
+    if (d->storageMode == CacheStorageMode::MappedSegments) {
+        // Segment files must be on disk to be mapped, so a non-persistent
+        // cache still uses them but discards them on open and shutdown
+        d->segments = std::make_unique<CacheSegmentStore>(QDir(cacheDir).filePath("segments"));
+        auto openResult = d->segments->open(d->persistentCacheEnabled);
+        if (!openResult.hasValue()) {
+            d->segments.reset();
+            return openResult;
+        }
+    }
+
     d->cacheDirectory = cacheDir;
     d->maxSize = maxSize;
-    d->stats.maxSize = maxSize;
     d->initialized = true;
 
     // Start timers
@@ -104,22 +695,53 @@ Expected<void, CacheError> FileCache::initialize(const QString& cacheDir, qint64
 
     // Load existing cache entries if persistent cache is enabled
     if (d->persistentCacheEnabled) {
-        QString cacheIndexPath = QDir(d->cacheDirectory).filePath("cache_index.dat");
-        if (QFile::exists(cacheIndexPath)) {
-            auto loadResult = load(cacheIndexPath);
-            if (!loadResult.hasValue()) {
-                Logger::instance().warn("Failed to load cache index, starting with empty cache");
+        loadDictionaries();
+
+        d->index = std::make_unique<CacheIndex>(d->cacheDirectory);
+        const bool hadSnapshot = d->index->hasSnapshot();
+        auto recovery = d->index->open();
+        if (!recovery.hasValue()) {
+            Logger::instance().warn("Failed to open cache index, running without persistence");
+            d->index.reset();
+        } else {
+            // Journaled state is newer than the snapshot and small, so it is
+            // applied right away; the snapshot itself loads in the background
+            const qint64 snapshotEntries = d->index->snapshotEntryCount();
+            d->indexLoading = snapshotEntries > 0;
+            for (auto it = recovery.value().puts.begin(); it != recovery.value().puts.end(); ++it) {
+                restoreEntry(it.value());
+                d->tombstone(it.key());
+            }
+            for (const QString& key : recovery.value().removals) {
+                d->tombstone(key);
+            }
+
+            if (snapshotEntries > 0) {
+                QtConcurrent::run(&d->maintenancePool, [this]() { loadIndexSnapshot(); });
+            } else {
+                d->index->releaseSnapshot();
+                d->tombstones.clear();
+            }
+        }
+
+        // Indexes from before the binary format are migrated once
+        const QString legacyIndexPath = QDir(d->cacheDirectory).filePath("cache_index.dat");
+        if (d->index && !hadSnapshot && QFile::exists(legacyIndexPath)) {
+            if (loadIndex(legacyIndexPath).hasValue() && writeIndexSnapshot().hasValue()) {
+                QFile::remove(legacyIndexPath);
+            } else {
+                Logger::instance().warn("Failed to migrate legacy cache index, starting with empty cache");
             }
         }
     }
 
-    Logger::instance().info("FileCache initialized: dir={}, maxSize={}", 
-                           cacheDir.toStdString(), maxSize);
+    Logger::instance().info("FileCache initialized: dir={}, maxSize={}, shards={}", 
+                           cacheDir.toStdString(), maxSize, CACHE_SHARD_COUNT);
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::shutdown() {
-    QMutexLocker locker(&d->mutex);
+    QMutexLocker locker(&d->lifecycleMutex);
     
     if (!d->initialized) {
         return Expected<void, CacheError>();
@@ -129,31 +751,43 @@ Expected<void, CacheError> FileCache::shutdown() {
     d->cleanupTimer->stop();
     d->syncTimer->stop();
 
-    // Save cache index if persistent cache is enabled
-    if (d->persistentCacheEnabled) {
-        QString cacheIndexPath = QDir(d->cacheDirectory).filePath("cache_index.dat");
-        auto saveResult = save(cacheIndexPath);
-        if (!saveResult.hasValue()) {
-            Logger::instance().warn("Failed to save cache index during shutdown");
+    // Lets a background index load finish, and keeps segment locations
+    // from moving after the final snapshot is taken
+    d->maintenancePool.waitForDone();
+
+    // A final snapshot makes the next start replay no journal at all
+    if (d->index) {
+        auto snapshotResult = writeIndexSnapshot();
+        if (!snapshotResult.hasValue()) {
+            Logger::instance().warn("Failed to write cache index snapshot during shutdown");
         }
+        d->index->close();
+        d->index.reset();
     }
 
     // Clear entries
-    d->entries.clear();
     d->initialized = false;
+    d->resetShards();
+
+    QMutexLocker compactionLocker(&d->compactionMutex);
+    if (d->segments) {
+        if (d->persistentCacheEnabled) {
+            d->segments->close();
+        } else {
+            d->segments->clear();
+        }
+        d->segments.reset();
+    }
 
     Logger::instance().info("FileCache shut down");
     return Expected<void, CacheError>();
 }
 
 bool FileCache::isInitialized() const {
-    QMutexLocker locker(&d->mutex);
     return d->initialized;
 }
 
 Expected<void, CacheError> FileCache::put(const QString& key, const QByteArray& data, qint64 ttl) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
@@ -167,8 +801,6 @@ Expected<void, CacheError> FileCache::put(const QString& key, const QByteArray&
 }
 
 Expected<QByteArray, CacheError> FileCache::get(const QString& key) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
@@ -178,62 +810,76 @@ Expected<QByteArray, CacheError> FileCache::get(const QString& key) {
         return makeUnexpected(CacheError::InvalidKey);
     }
 
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
-        // Try to load from disk if persistent cache is enabled
-        if (d->persistentCacheEnabled) {
-            auto loadResult = loadFromDisk(key);
-            if (loadResult.hasValue()) {
-                it = d->entries.find(key);
-            }
-        }
-        
-        if (it == d->entries.end()) {
-            d->stats.missCount++;
-            updateStats();
-            return makeUnexpected(CacheError::KeyNotFound);
-        }
+    auto stored = fetchStored(key);
+    if (!stored.hasValue()) {
+        return makeUnexpected(stored.error());
     }
 
-    auto& entry = it->second;
-    
-    // Check expiration
-    if (entry->ttl > 0) {
-        auto now = QDateTime::currentDateTime();
-        if (entry->createdAt.addSecs(entry->ttl) < now) {
-            removeEntry(key);
-            d->stats.missCount++;
-            updateStats();
-            return makeUnexpected(CacheError::KeyNotFound);
+    // Decompress if needed; mapped payloads are copied out exactly once
+    QByteArray result;
+    const StoredPayload& payload = stored.value();
+    if (payload.codec != CacheCodecId::None) {
+        auto decompressed = decompressData(payload.bytes(), payload.codec, payload.dictionaryId, payload.originalSize);
+        if (!decompressed.hasValue()) {
+            return makeUnexpected(decompressed.error());
         }
+        result = decompressed.value();
+    } else {
+        result = payload.mapped.isMapped() ? payload.mapped.toByteArray() : payload.inlineData;
     }
 
-    // Update access information
-    entry->lastAccessed = QDateTime::currentDateTime();
-    entry->accessCount++;
-    
-    d->stats.hitCount++;
-    updateStats();
-    
-    emit entryAccessed(key);
+    if (d->verifyChecksums && payload.checksum.size() == CHECKSUM_SIZE &&
+        !verifyChecksum(result, payload.checksum).value()) {
+        Logger::instance().warn("Checksum mismatch for cache entry {}, dropping it", key.toStdString());
+        removeEntry(key);
+        return makeUnexpected(CacheError::ChecksumMismatch);
+    }
 
-    QByteArray result = entry->data;
-    
-    // Decompress if needed
-    if (entry->compressed) {
-        auto decompressed = decompressData(result);
+    return result;
+}
+
+Expected<CacheView, CacheError> FileCache::getView(const QString& key) {
+    if (!d->initialized) {
+        return makeUnexpected(CacheError::InitializationFailed);
+    }
+
+    auto keyValidation = validateKey(key);
+    if (!keyValidation.hasValue()) {
+        return makeUnexpected(CacheError::InvalidKey);
+    }
+
+    auto stored = fetchStored(key);
+    if (!stored.hasValue()) {
+        return makeUnexpected(stored.error());
+    }
+
+    // Only uncompressed mapped payloads are zero-copy; everything else is
+    // served from a heap buffer owned by the view
+    CacheView view;
+    const StoredPayload& payload = stored.value();
+    if (payload.codec != CacheCodecId::None) {
+        auto decompressed = decompressData(payload.bytes(), payload.codec, payload.dictionaryId, payload.originalSize);
         if (!decompressed.hasValue()) {
-            return makeUnexpected(CacheError::DecompressionError);
+            return makeUnexpected(decompressed.error());
         }
-        result = decompressed.value();
+        view = CacheView::fromByteArray(decompressed.value());
+    } else if (payload.mapped.isMapped()) {
+        view = payload.mapped;
+    } else {
+        view = CacheView::fromByteArray(payload.inlineData);
     }
 
-    return result;
+    if (d->verifyChecksums && payload.checksum.size() == CHECKSUM_SIZE &&
+        !verifyChecksum(view.bytes(), payload.checksum).value()) {
+        Logger::instance().warn("Checksum mismatch for cache entry {}, dropping it", key.toStdString());
+        removeEntry(key);
+        return makeUnexpected(CacheError::ChecksumMismatch);
+    }
+
+    return view;
 }
 
 Expected<bool, CacheError> FileCache::contains(const QString& key) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
@@ -243,36 +889,41 @@ Expected<bool, CacheError> FileCache::contains(const QString& key) {
         return false;
     }
 
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
-        // Try to load from disk if persistent cache is enabled
-        if (d->persistentCacheEnabled) {
-            auto loadResult = loadFromDisk(key);
-            if (loadResult.hasValue()) {
-                it = d->entries.find(key);
+    faultInFromIndex(key);
+
+    CacheShard& shard = d->shardFor(key);
+    std::unique_ptr<CacheNode> expired;
+    {
+        QMutexLocker locker(&shard.mutex);
+        CacheNode* node = shard.find(key);
+        if (node) {
+            // Check expiration
+            if (node->expiresAtMs == 0 || node->expiresAtMs >= QDateTime::currentMSecsSinceEpoch()) {
+                return true;
             }
+            expired = d->detachNode(shard, node);
         }
-        
-        if (it == d->entries.end()) {
-            return false;
-        }
     }
 
-    // Check expiration
-    if (it->second->ttl > 0) {
-        auto now = QDateTime::currentDateTime();
-        if (it->second->createdAt.addSecs(it->second->ttl) < now) {
-            removeEntry(key);
-            return false;
+    if (expired) {
+        releaseStorage(expired->entry);
+        emit entryRemoved(key, expired->entry.size);
+        return false;
+    }
+
+    // Try to load from disk if persistent cache is enabled
+    if (d->persistentCacheEnabled && !d->segments) {
+        auto loaded = loadFromDisk(key);
+        if (loaded.hasValue()) {
+            storeEntry(std::move(loaded.value()));
+            return true;
         }
     }
 
-    return true;
+    return false;
 }
 
 Expected<void, CacheError> FileCache::remove(const QString& key) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
@@ -286,25 +937,34 @@ Expected<void, CacheError> FileCache::remove(const QString& key) {
 }
 
 Expected<void, CacheError> FileCache::clear() {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
+    // Stop a background index load before emptying the shards, so nothing
+    // from the snapshot is restored afterwards
+    if (d->index) {
+        d->index->releaseSnapshot();
+        d->maintenancePool.waitForDone();
+    }
+
+    const QStringList keys = d->resetShards();
+    for (const auto& shard : d->shards) {
+        shard->evictionCount = 0;
+    }
+
     // Remove all disk files if persistent cache is enabled
-    if (d->persistentCacheEnabled) {
-        for (const auto& [key, entry] : d->entries) {
+    if (d->segments) {
+        d->segments->clear();
+    } else if (d->persistentCacheEnabled) {
+        for (const QString& key : keys) {
             removeFromDisk(key);
         }
     }
 
-    d->entries.clear();
-    d->stats.totalSize = 0;
-    d->stats.entryCount = 0;
-    d->stats.evictionCount = 0;
-    
-    updateStats();
+    if (d->index && !writeIndexSnapshot().hasValue()) {
+        Logger::instance().warn("Failed to write cache index snapshot after clear");
+    }
     
     Logger::instance().info("FileCache cleared");
     emit cacheCleared();
@@ -322,7 +982,8 @@ Expected<void, CacheError> FileCache::putFile(const QString& key, const QString&
 }
 
 Expected<QString, CacheError> FileCache::getFile(const QString& key, const QString& outputPath) {
-    auto data = get(key);
+    // Written straight from the mapping when the entry allows it
+    auto data = getView(key);
     if (!data.hasValue()) {
         return makeUnexpected(data.error());
     }
@@ -337,7 +998,7 @@ Expected<QString, CacheError> FileCache::getFile(const QString& key, const QStri
         return makeUnexpected(CacheError::WriteError);
     }
 
-    if (file.write(data.value()) != data.value().size()) {
+    if (file.write(data.value().constData(), data.value().size()) != data.value().size()) {
         return makeUnexpected(CacheError::WriteError);
     }
 
@@ -392,59 +1053,48 @@ Expected<void, CacheError> FileCache::removeBatch(const QStringList& keys) {
 }
 
 Expected<void, CacheError> FileCache::setMaxSize(qint64 maxSize) {
-    QMutexLocker locker(&d->mutex);
-    
     if (maxSize <= 0) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
     d->maxSize = maxSize;
-    d->stats.maxSize = maxSize;
 
     // Trigger eviction if current size exceeds new limit
-    if (d->stats.totalSize > maxSize) {
-        evict(maxSize);
+    if (d->initialized && d->totalSize > maxSize) {
+        enforceLimits(maxSize, d->maxEntries, QString(), "Size limit exceeded");
     }
 
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::setMaxEntries(qint64 maxEntries) {
-    QMutexLocker locker(&d->mutex);
-    
     if (maxEntries <= 0) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
     d->maxEntries = maxEntries;
-    d->stats.maxEntries = maxEntries;
 
     // Trigger eviction if current count exceeds new limit
-    while (d->stats.entryCount > maxEntries) {
-        auto evictResult = evict(d->stats.totalSize - 1);
-        if (!evictResult.hasValue()) {
-            break;
-        }
+    if (d->initialized && d->entryCount > maxEntries) {
+        enforceLimits(d->maxSize, maxEntries, QString(), "Entry limit exceeded");
     }
 
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::setCachePolicy(CachePolicy policy) {
-    QMutexLocker locker(&d->mutex);
+    // Every shard maintains the structures for all policies, so switching
+    // takes effect on the next eviction without rebuilding anything
     d->policy = policy;
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::setCompressionEnabled(bool enabled) {
-    QMutexLocker locker(&d->mutex);
     d->compressionEnabled = enabled;
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::setCompressionLevel(int level) {
-    QMutexLocker locker(&d->mutex);
-    
     if (level < 1 || level > 9) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
@@ -453,14 +1103,69 @@ Expected<void, CacheError> FileCache::setCompressionLevel(int level) {
     return Expected<void, CacheError>();
 }
 
+Expected<void, CacheError> FileCache::setCompressionCodec(CacheCodecId codec) {
+    if (!CacheCodec::forId(codec)) {
+        return makeUnexpected(CacheError::CompressionError);
+    }
+
+    // Existing entries keep their codec until compact() recodes them
+    d->codec = codec;
+    return Expected<void, CacheError>();
+}
+
+Expected<void, CacheError> FileCache::setMinCompressionRatio(double ratio) {
+    if (ratio < 1.0) {
+        return makeUnexpected(CacheError::InitializationFailed);
+    }
+
+    d->minCompressionRatio = ratio;
+    return Expected<void, CacheError>();
+}
+
+Expected<void, CacheError> FileCache::setCompressionDictionary(const QByteArray& dictionary) {
+    return installDictionary(dictionary, true);
+}
+
+Expected<QByteArray, CacheError> FileCache::trainCompressionDictionary(const QList<QByteArray>& samples,
+                                                                       int maxDictionarySize) {
+    auto trained = CompressionDictionary::train(samples, maxDictionarySize, d->compressionLevel);
+    if (!trained.hasValue()) {
+        Logger::instance().warn("Failed to train cache compression dictionary from {} samples", samples.size());
+        return makeUnexpected(CacheError::CompressionError);
+    }
+
+    const QByteArray bytes = trained.value()->bytes();
+    auto installResult = installDictionary(bytes, true);
+    if (!installResult.hasValue()) {
+        return makeUnexpected(installResult.error());
+    }
+    return bytes;
+}
+
 Expected<void, CacheError> FileCache::setPersistentCacheEnabled(bool enabled) {
-    QMutexLocker locker(&d->mutex);
     d->persistentCacheEnabled = enabled;
     return Expected<void, CacheError>();
 }
 
+Expected<void, CacheError> FileCache::setStorageMode(CacheStorageMode mode) {
+    QMutexLocker locker(&d->lifecycleMutex);
+
+    // Entries cannot move between storage modes, so the mode is fixed once initialized
+    if (d->initialized) {
+        return makeUnexpected(CacheError::InitializationFailed);
+    }
+
+    d->storageMode = mode;
+    return Expected<void, CacheError>();
+}
+
+Expected<void, CacheError> FileCache::setChecksumVerificationEnabled(bool enabled) {
+    d->verifyChecksums = enabled;
+    return Expected<void, CacheError>();
+}
+
 Expected<void, CacheError> FileCache::setCleanupInterval(int intervalMs) {
-    QMutexLocker locker(&d->mutex);
+    QMutexLocker locker(&d->lifecycleMutex);
     
     if (intervalMs <= 0) {
         return makeUnexpected(CacheError::InitializationFailed);
@@ -475,139 +1180,208 @@ Expected<void, CacheError> FileCache::setCleanupInterval(int intervalMs) {
 }
 
 Expected<CacheStats, CacheError> FileCache::getStats() const {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    return d->stats;
+    // Counters live in the shards and are only summed when asked for
+    CacheStats stats{};
+    stats.maxSize = d->maxSize;
+    stats.maxEntries = d->maxEntries;
+    for (const auto& shard : d->shards) {
+        {
+            QMutexLocker locker(&shard->mutex);
+            stats.totalSize += shard->totalSize;
+            stats.entryCount += static_cast<qint64>(shard->nodes.size());
+        }
+        stats.hitCount += shard->hitCount.load(std::memory_order_relaxed);
+        stats.missCount += shard->missCount.load(std::memory_order_relaxed);
+        stats.evictionCount += shard->evictionCount.load(std::memory_order_relaxed);
+    }
+
+    qint64 total = stats.hitCount + stats.missCount;
+    if (total > 0) {
+        stats.hitRate = static_cast<double>(stats.hitCount) / total;
+        stats.missRate = static_cast<double>(stats.missCount) / total;
+    }
+    stats.lastCleanup = QDateTime::fromMSecsSinceEpoch(d->lastCleanupMs);
+
+    return stats;
 }
 
 Expected<CacheEntry, CacheError> FileCache::getEntry(const QString& key) const {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
+    CacheShard& shard = d->shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    const CacheNode* node = shard.find(key);
+    if (!node) {
         return makeUnexpected(CacheError::KeyNotFound);
     }
 
-    return *it->second;
+    return node->entry;
 }
 
 Expected<QStringList, CacheError> FileCache::getKeys() const {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
     QStringList keys;
-    for (const auto& [key, entry] : d->entries) {
-        keys.append(key);
+    keys.reserve(d->entryCount);
+    for (const auto& shard : d->shards) {
+        QMutexLocker locker(&shard->mutex);
+        for (const auto& [key, node] : shard->nodes) {
+            keys.append(key);
+        }
     }
     return keys;
 }
 
 Expected<qint64, CacheError> FileCache::getSize() const {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    return d->stats.totalSize;
+    return d->totalSize.load();
 }
 
 Expected<qint64, CacheError> FileCache::getEntryCount() const {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    return d->stats.entryCount;
+    return d->entryCount.load();
 }
 
 Expected<void, CacheError> FileCache::cleanup() {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    auto now = QDateTime::currentDateTime();
-    QStringList expiredKeys;
+    // Each shard pops expired entries off its TTL heap, so cleanup cost is
+    // proportional to what actually expired rather than to the cache size
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    qint64 removedCount = 0;
 
-    // Find expired entries
-    for (const auto& [key, entry] : d->entries) {
-        if (entry->ttl > 0 && entry->createdAt.addSecs(entry->ttl) < now) {
-            expiredKeys.append(key);
+    for (const auto& shard : d->shards) {
+        std::vector<std::unique_ptr<CacheNode>> expired;
+        {
+            QMutexLocker locker(&shard->mutex);
+            expired = d->takeExpired(*shard, nowMs);
         }
+        for (const auto& node : expired) {
+            releaseStorage(node->entry);
+            emit entryRemoved(node->entry.key, node->entry.size);
+        }
+        removedCount += static_cast<qint64>(expired.size());
     }
 
-    // Remove expired entries
-    for (const QString& key : expiredKeys) {
-        removeEntry(key);
-    }
-
-    d->stats.lastCleanup = now;
-    updateStats();
+    d->lastCleanupMs = nowMs;
+    scheduleSegmentCompaction();
 
-    Logger::instance().info("FileCache cleanup completed, removed {} expired entries", expiredKeys.size());
+    Logger::instance().info("FileCache cleanup completed, removed {} expired entries", removedCount);
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::compact() {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    // Compact by removing fragmentation and reorganizing data
-    // This is a simplified implementation
-    qint64 originalSize = d->stats.totalSize;
-    
-    // Recompress entries that might benefit from better compression
-    for (const auto& [key, entry] : d->entries) {
-        if (entry->compressed && entry->data.size() > 1024) {
-            auto decompressed = decompressData(entry->data);
-            if (decompressed.hasValue()) {
-                auto recompressed = compressData(decompressed.value());
-                if (recompressed.hasValue() && recompressed.value().size() < entry->data.size()) {
-                    qint64 oldSize = entry->size;
-                    entry->data = recompressed.value();
-                    entry->size = entry->data.size();
-                    d->stats.totalSize = d->stats.totalSize - oldSize + entry->size;
+    // Recode entries written with another codec or dictionary (including
+    // legacy zlib entries) into the current configuration. Payloads are
+    // recoded outside the shard lock and swapped in only if the entry was
+    // not replaced meanwhile.
+    const CacheCodecId targetCodec = d->compressionEnabled ? d->codec.load() : CacheCodecId::None;
+    quint32 targetDictionary = 0;
+    if (targetCodec == CacheCodecId::Zstd) {
+        QReadLocker locker(&d->dictionaryLock);
+        targetDictionary = d->activeDictionary ? d->activeDictionary->id() : 0;
+    }
+
+    qint64 savedBytes = 0;
+    qint64 recodedCount = 0;
+
+    for (const auto& shard : d->shards) {
+        QList<CacheEntry> candidates;
+        {
+            QMutexLocker locker(&shard->mutex);
+            for (const auto& [key, node] : shard->nodes) {
+                const CacheEntry& entry = node->entry;
+                // Segment payloads are not held in memory and keep their codec
+                if (entry.segmentOffset < 0 && entry.codec != CacheCodecId::None &&
+                    (entry.codec != targetCodec || entry.dictionaryId != targetDictionary)) {
+                    candidates.append(entry);
                 }
             }
         }
+
+        for (CacheEntry& candidate : candidates) {
+            auto decompressed = decompressData(candidate.data, candidate.codec, candidate.dictionaryId,
+                                               candidate.originalSize);
+            if (!decompressed.hasValue()) {
+                continue;
+            }
+
+            const QByteArray previousData = candidate.data;
+            candidate.data = decompressed.value();
+            compressEntry(candidate);
+
+            QMutexLocker locker(&shard->mutex);
+            CacheNode* node = shard->find(candidate.key);
+            if (!node || node->entry.data.constData() != previousData.constData()) {
+                continue;
+            }
+
+            CacheEntry& entry = node->entry;
+            const qint64 oldSize = entry.size;
+            entry.data = candidate.data;
+            entry.size = candidate.size;
+            entry.compressed = candidate.compressed;
+            entry.codec = candidate.codec;
+            entry.dictionaryId = candidate.dictionaryId;
+            shard->totalSize += entry.size - oldSize;
+            d->totalSize.fetch_add(entry.size - oldSize);
+            savedBytes += oldSize - entry.size;
+            ++recodedCount;
+        }
     }
 
-    qint64 savedBytes = originalSize - d->stats.totalSize;
-    Logger::instance().info("FileCache compaction completed, saved {} bytes", savedBytes);
+    if (d->segments) {
+        compactSegments();
+    }
+
+    Logger::instance().info("FileCache compaction completed, recoded {} entries, saved {} bytes",
+                            recodedCount, savedBytes);
     return Expected<void, CacheError>();
 }
 
 Expected<void, CacheError> FileCache::flush() {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    // Flush dirty entries to disk if using write-back policy
+    // Flush dirty entries to disk if using write-back policy. Entries are
+    // copied out under the shard lock and written without holding it.
     if (d->policy == CachePolicy::WriteBack && d->persistentCacheEnabled) {
-        for (const auto& [key, entry] : d->entries) {
-            if (entry->dirty) {
-                auto saveResult = saveToDisk(key);
-                if (saveResult.hasValue()) {
-                    entry->dirty = false;
+        for (const auto& shard : d->shards) {
+            QList<CacheEntry> dirtyEntries;
+            {
+                QMutexLocker locker(&shard->mutex);
+                for (const auto& [key, node] : shard->nodes) {
+                    if (node->entry.dirty) {
+                        node->entry.dirty = false;
+                        dirtyEntries.append(node->entry);
+                    }
+                }
+            }
+            for (const CacheEntry& entry : dirtyEntries) {
+                auto saveResult = saveToDisk(entry);
+                if (!saveResult.hasValue()) {
+                    Logger::instance().warn("Failed to flush cache entry: {}", entry.key.toStdString());
                 }
             }
         }
@@ -626,144 +1400,27 @@ Expected<qint64, CacheError> FileCache::evict(qint64 targetSize) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
-    qint64 bytesEvicted = 0;
-    
-    while (d->stats.totalSize > targetSize && !d->entries.empty()) {
-        QString keyToEvict;
-        
-        switch (d->policy) {
-            case CachePolicy::LeastRecentlyUsed: {
-                QDateTime oldest = QDateTime::currentDateTime();
-                for (const auto& [key, entry] : d->entries) {
-                    if (entry->lastAccessed < oldest) {
-                        oldest = entry->lastAccessed;
-                        keyToEvict = key;
-                    }
-                }
-                break;
-            }
-            case CachePolicy::LeastFrequentlyUsed: {
-                qint64 minAccess = std::numeric_limits<qint64>::max();
-                for (const auto& [key, entry] : d->entries) {
-                    if (entry->accessCount < minAccess) {
-                        minAccess = entry->accessCount;
-                        keyToEvict = key;
-                    }
-                }
-                break;
-            }
-            case CachePolicy::FirstInFirstOut: {
-                QDateTime oldest = QDateTime::currentDateTime();
-                for (const auto& [key, entry] : d->entries) {
-                    if (entry->createdAt < oldest) {
-                        oldest = entry->createdAt;
-                        keyToEvict = key;
-                    }
-                }
-                break;
-            }
-            default:
-                keyToEvict = d->entries.begin()->first;
-                break;
-        }
-
-        if (keyToEvict.isEmpty()) {
-            break;
-        }
-
-        auto it = d->entries.find(keyToEvict);
-        if (it != d->entries.end()) {
-            bytesEvicted += it->second->size;
-            evictEntry(keyToEvict, "Size limit exceeded");
-        }
-    }
-
-    return bytesEvicted;
+    return enforceLimits(targetSize, std::numeric_limits<qint64>::max(), QString(), "Size limit exceeded");
 }
 
 Expected<void, CacheError> FileCache::save(const QString& filePath) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
+    QMutexLocker locker(&d->lifecycleMutex);
     QString path = filePath.isEmpty() ? QDir(d->cacheDirectory).filePath("cache_index.dat") : filePath;
-    
-    QFile file(path);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return makeUnexpected(CacheError::WriteError);
-    }
-
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_6_0);
-
-    // Write header
-    stream << QString("FileCache");
-    stream << static_cast<quint32>(1); // Version
-    stream << static_cast<quint64>(d->entries.size());
-
-    // Write entries
-    for (const auto& [key, entry] : d->entries) {
-        auto serialized = serializeEntry(*entry);
-        if (!serialized.hasValue()) {
-            return makeUnexpected(CacheError::SerializationError);
-        }
-        stream << key << serialized.value();
-    }
-
-    Logger::instance().info("FileCache saved to {}", path.toStdString());
-    return Expected<void, CacheError>();
+    return saveIndex(path);
 }
 
 Expected<void, CacheError> FileCache::load(const QString& filePath) {
-    QMutexLocker locker(&d->mutex);
-    
     if (!d->initialized) {
         return makeUnexpected(CacheError::InitializationFailed);
     }
 
+    QMutexLocker locker(&d->lifecycleMutex);
     QString path = filePath.isEmpty() ? QDir(d->cacheDirectory).filePath("cache_index.dat") : filePath;
-    
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return makeUnexpected(CacheError::ReadError);
-    }
-
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_6_0);
-
-    // Read header
-    QString header;
-    quint32 version;
-    quint64 entryCount;
-    
-    stream >> header >> version >> entryCount;
-    
-    if (header != "FileCache" || version != 1) {
-        return makeUnexpected(CacheError::DeserializationError);
-    }
-
-    // Read entries
-    for (quint64 i = 0; i < entryCount; ++i) {
-        QString key;
-        QByteArray serializedEntry;
-        
-        stream >> key >> serializedEntry;
-        
-        auto entry = deserializeEntry(serializedEntry);
-        if (!entry.hasValue()) {
-            continue; // Skip corrupted entries
-        }
-
-        d->entries[key] = std::make_unique<CacheEntry>(entry.value());
-        d->stats.totalSize += entry.value().size;
-        d->stats.entryCount++;
-    }
-
-    updateStats();
-    Logger::instance().info("FileCache loaded from {}, {} entries", path.toStdString(), d->entries.size());
-    return Expected<void, CacheError>();
+    return loadIndex(path);
 }
 
 Expected<void, CacheError> FileCache::import(const QString& filePath) {
@@ -782,172 +1439,520 @@ void FileCache::performSync() {
     sync();
 }
 
-Expected<void, CacheError> FileCache::insertEntry(const QString& key, const QByteArray& data, qint64 ttl) {
-    qint64 dataSize = data.size();
-    
-    // Check if we need to make room
-    if (d->stats.totalSize + dataSize > d->maxSize) {
-        auto makeRoomResult = makeRoom(dataSize);
-        if (!makeRoomResult.hasValue()) {
-            return makeRoomResult;
+Expected<FileCache::StoredPayload, CacheError> FileCache::fetchStored(const QString& key) {
+    faultInFromIndex(key);
+
+    CacheShard& shard = d->shardFor(key);
+    std::unique_ptr<CacheNode> dropped;
+    StoredPayload payload;
+    bool found = false;
+    bool unreadable = false;
+
+    {
+        QMutexLocker locker(&shard.mutex);
+        CacheNode* node = shard.find(key);
+        if (node && node->expiresAtMs > 0 &&
+            node->expiresAtMs < QDateTime::currentMSecsSinceEpoch()) {
+            dropped = d->detachNode(shard, node);
+            node = nullptr;
+        }
+        if (node && node->entry.segmentOffset >= 0) {
+            // Pinning the segment under the shard lock keeps compaction from
+            // retiring it between the lookup and the read
+            auto view = d->segments
+                ? d->segments->read({node->entry.segmentId, node->entry.segmentOffset})
+                : Expected<CacheView, CacheError>(makeUnexpected(CacheError::ReadError));
+            if (view.hasValue()) {
+                payload.mapped = view.value();
+            } else {
+                dropped = d->detachNode(shard, node);
+                node = nullptr;
+                unreadable = true;
+            }
+        }
+        if (node) {
+            // Update access information
+            shard.touch(node);
+            node->entry.lastAccessed = QDateTime::currentDateTimeUtc();
+            if (!payload.mapped.isMapped()) {
+                payload.inlineData = node->entry.data;
+            }
+            payload.codec = node->entry.codec;
+            payload.dictionaryId = node->entry.dictionaryId;
+            payload.originalSize = node->entry.originalSize;
+            payload.checksum = node->entry.checksum;
+            found = true;
         }
     }
 
-    // Check entry count limit
-    if (d->stats.entryCount >= d->maxEntries) {
-        auto evictResult = evict(d->stats.totalSize - 1);
-        if (!evictResult.hasValue()) {
-            return makeUnexpected(CacheError::CacheFull);
+    if (dropped) {
+        if (unreadable) {
+            Logger::instance().warn("Cache segment record for {} is unreadable, dropping it", key.toStdString());
+        }
+        releaseStorage(dropped->entry);
+        emit entryRemoved(key, dropped->entry.size);
+    } else if (!found && d->persistentCacheEnabled && !d->segments) {
+        // Try to load from disk if persistent cache is enabled
+        auto loaded = loadFromDisk(key);
+        if (loaded.hasValue()) {
+            payload.inlineData = loaded.value().data;
+            payload.codec = loaded.value().codec;
+            payload.dictionaryId = loaded.value().dictionaryId;
+            payload.originalSize = loaded.value().originalSize;
+            payload.checksum = loaded.value().checksum;
+            found = true;
+            storeEntry(std::move(loaded.value()));
         }
     }
 
-    auto entry = std::make_unique<CacheEntry>();
-    entry->key = key;
-    entry->data = data;
-    entry->createdAt = QDateTime::currentDateTime();
-    entry->lastAccessed = entry->createdAt;
-    entry->lastModified = entry->createdAt;
-    entry->size = dataSize;
-    entry->accessCount = 1;
-    entry->ttl = ttl;
-    entry->compressed = false;
-    entry->dirty = false;
+    if (!found) {
+        shard.missCount.fetch_add(1, std::memory_order_relaxed);
+        return makeUnexpected(unreadable ? CacheError::ReadError : CacheError::KeyNotFound);
+    }
 
-    // Compress if enabled and data is large enough
-    if (d->compressionEnabled && data.size() > 1024) {
-        auto compressed = compressData(data);
-        if (compressed.hasValue()) {
-            entry->data = compressed.value();
-            entry->size = entry->data.size();
-            entry->compressed = true;
-            
-            emit compressionCompleted(key, dataSize, entry->size);
-        }
+    shard.hitCount.fetch_add(1, std::memory_order_relaxed);
+    emit entryAccessed(key);
+    return payload;
+}
+
+Expected<void, CacheError> FileCache::insertEntry(const QString& key, const QByteArray& data, qint64 ttl) {
+    qint64 dataSize = data.size();
+
+    // The entry is fully built before any shard lock is taken, so compression
+    // and hashing never block other threads
+    CacheEntry entry;
+    entry.key = key;
+    entry.data = data;
+    entry.createdAt = QDateTime::currentDateTimeUtc();
+    entry.lastAccessed = entry.createdAt;
+    entry.lastModified = entry.createdAt;
+    entry.size = dataSize;
+    entry.accessCount = 1;
+    entry.ttl = ttl;
+    entry.compressed = false;
+    entry.dirty = false;
+
+    if (compressEntry(entry)) {
+        emit compressionCompleted(key, dataSize, entry.size);
     }
 
     // Calculate checksum
     auto checksum = calculateChecksum(data);
     if (checksum.hasValue()) {
-        entry->checksum = checksum.value();
+        entry.checksum = checksum.value();
     }
 
-    // Save to disk if persistent cache is enabled
-    if (d->persistentCacheEnabled) {
-        auto saveResult = saveToDisk(key);
-        if (saveResult.hasValue()) {
+    if (d->segments) {
+        // Segment records are durable as soon as they are appended, so the
+        // write policies have nothing left to do
+        auto location = d->segments->append(key, entry.data);
+        if (!location.hasValue()) {
+            return makeUnexpected(location.error());
+        }
+        entry.segmentId = location.value().segment;
+        entry.segmentOffset = location.value().offset;
+        entry.data.clear();
+    } else if (d->persistentCacheEnabled) {
+        // Persist according to the write policy
+        const CachePolicy policy = d->policy;
+        if (policy == CachePolicy::WriteThrough) {
+            auto saveResult = saveToDisk(entry);
+            if (!saveResult.hasValue()) {
+                return saveResult;
+            }
             auto filePath = generateCacheFilePath(key);
             if (filePath.hasValue()) {
-                entry->filePath = filePath.value();
+                entry.filePath = filePath.value();
             }
+        } else if (policy == CachePolicy::WriteBack) {
+            entry.dirty = true;
+        }
+    }
+
+    storeEntry(std::move(entry));
+    return Expected<void, CacheError>();
+}
+
+void FileCache::storeEntry(CacheEntry entry) {
+    const QString key = entry.key;
+    const qint64 newSize = entry.size;
+    qint64 oldSize = -1;
+    CacheEntry replaced;
+
+    CacheShard& shard = d->shardFor(key);
+    {
+        QMutexLocker locker(&shard.mutex);
+        if (CacheNode* node = shard.find(key)) {
+            oldSize = node->entry.size;
+            replaced.segmentId = node->entry.segmentId;
+            replaced.segmentOffset = node->entry.segmentOffset;
+            shard.replace(node, std::move(entry));
+            d->totalSize.fetch_add(newSize - oldSize);
+            d->journal(node->entry);
+        } else {
+            d->journal(d->insertNode(shard, std::move(entry))->entry);
         }
     }
 
-    // Check if entry already exists
-    auto existingIt = d->entries.find(key);
-    if (existingIt != d->entries.end()) {
-        qint64 oldSize = existingIt->second->size;
-        d->stats.totalSize = d->stats.totalSize - oldSize + entry->size;
-        d->entries[key] = std::move(entry);
-        emit entryUpdated(key, oldSize, entry->size);
+    // The per-key file was overwritten in place, only a segment record is left behind
+    if (replaced.segmentOffset >= 0) {
+        releaseStorage(replaced);
+    }
+
+    if (oldSize >= 0) {
+        emit entryUpdated(key, oldSize, newSize);
     } else {
-        d->stats.totalSize += entry->size;
-        d->stats.entryCount++;
-        d->entries[key] = std::move(entry);
-        emit entryAdded(key, entry->size);
+        emit entryAdded(key, newSize);
+    }
+
+    // Enforced after the insert so the new entry can never be its own victim
+    if (d->totalSize > d->maxSize || d->entryCount > d->maxEntries) {
+        enforceLimits(d->maxSize, d->maxEntries, key, "Size limit exceeded");
+    }
+
+    scheduleIndexSnapshot();
+}
+
+Expected<void, CacheError> FileCache::removeEntry(const QString& key) {
+    faultInFromIndex(key);
+
+    CacheShard& shard = d->shardFor(key);
+    std::unique_ptr<CacheNode> removed;
+    {
+        QMutexLocker locker(&shard.mutex);
+        CacheNode* node = shard.find(key);
+        if (!node) {
+            return makeUnexpected(CacheError::KeyNotFound);
+        }
+        removed = d->detachNode(shard, node);
     }
 
-    updateStats();
+    releaseStorage(removed->entry);
+    emit entryRemoved(key, removed->entry.size);
+    scheduleIndexSnapshot();
     return Expected<void, CacheError>();
 }
 
-Expected<void, CacheError> FileCache::updateEntry(const QString& key, const QByteArray& data) {
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
-        return makeUnexpected(CacheError::KeyNotFound);
+qint64 FileCache::enforceLimits(qint64 maxSize, qint64 maxEntries, const QString& protectedKey, const QString& reason) {
+    const CachePolicy policy = d->policy;
+    CacheShard* preferred = protectedKey.isEmpty() ? nullptr : &d->shardFor(protectedKey);
+    qint64 bytesEvicted = 0;
+
+    while (d->totalSize > maxSize || d->entryCount > maxEntries) {
+        CacheShard* shard = d->selectVictimShard(policy, protectedKey, preferred, maxSize, maxEntries);
+        if (!shard) {
+            break;
+        }
+
+        std::unique_ptr<CacheNode> evicted;
+        {
+            QMutexLocker locker(&shard->mutex);
+            // The victim may have changed since it was ranked; whatever the
+            // shard offers now is still the right local choice
+            if (CacheNode* node = shard->victim(policy, protectedKey)) {
+                evicted = d->detachNode(*shard, node);
+                shard->evictionCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (!evicted) {
+            continue;
+        }
+
+        const CacheEntry& entry = evicted->entry;
+        bytesEvicted += entry.size;
+        releaseStorage(entry);
+        emit entryRemoved(entry.key, entry.size);
+        emit evictionOccurred(entry.key, reason);
     }
 
-    auto& entry = it->second;
-    qint64 oldSize = entry->size;
-    
-    entry->data = data;
-    entry->lastModified = QDateTime::currentDateTime();
-    entry->size = data.size();
-    entry->dirty = true;
+    return bytesEvicted;
+}
 
-    // Recompress if needed
-    if (d->compressionEnabled && entry->compressed && data.size() > 1024) {
-        auto compressed = compressData(data);
-        if (compressed.hasValue()) {
-            entry->data = compressed.value();
-            entry->size = entry->data.size();
+void FileCache::releaseStorage(const CacheEntry& entry) {
+    if (entry.segmentOffset >= 0) {
+        if (d->segments && d->segments->release({entry.segmentId, entry.segmentOffset})) {
+            scheduleSegmentCompaction();
         }
+    } else if (d->persistentCacheEnabled) {
+        removeFromDisk(entry.key);
     }
+}
 
-    d->stats.totalSize = d->stats.totalSize - oldSize + entry->size;
-    updateStats();
-    
-    emit entryUpdated(key, oldSize, entry->size);
-    return Expected<void, CacheError>();
+void FileCache::scheduleSegmentCompaction() {
+    if (!d->segments || d->compactionScheduled.exchange(true)) {
+        return;
+    }
+
+    QtConcurrent::run(&d->maintenancePool, [this]() {
+        d->compactionScheduled = false;
+        compactSegments();
+    });
 }
 
-Expected<void, CacheError> FileCache::removeEntry(const QString& key) {
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
-        return makeUnexpected(CacheError::KeyNotFound);
+void FileCache::compactSegments() {
+    QMutexLocker compactionLocker(&d->compactionMutex);
+
+    // Live byte counts are incomplete until the whole index is restored
+    if (!d->segments || d->indexLoading) {
+        return;
     }
 
-    qint64 size = it->second->size;
-    
-    // Remove from disk if persistent cache is enabled
-    if (d->persistentCacheEnabled) {
-        removeFromDisk(key);
+    // Live records of a sparse segment are appended to the active segment and
+    // their entries repointed; a record is only repointed if its entry still
+    // refers to it, so concurrent puts and removals always win
+    qint64 movedCount = 0;
+    qint64 retiredCount = 0;
+
+    for (quint32 segmentId : d->segments->compactionCandidates()) {
+        bool complete = true;
+
+        for (const auto& shard : d->shards) {
+            QList<std::pair<QString, qint64>> resident;
+            {
+                QMutexLocker locker(&shard->mutex);
+                for (const auto& [key, node] : shard->nodes) {
+                    if (node->entry.segmentOffset >= 0 && node->entry.segmentId == segmentId) {
+                        resident.append({key, node->entry.segmentOffset});
+                    }
+                }
+            }
+
+            for (const auto& [key, offset] : resident) {
+                const SegmentLocation from{segmentId, offset};
+                auto view = d->segments->read(from);
+                if (!view.hasValue()) {
+                    complete = false;
+                    continue;
+                }
+                auto to = d->segments->append(key, view.value().bytes());
+                if (!to.hasValue()) {
+                    complete = false;
+                    continue;
+                }
+
+                bool repointed = false;
+                {
+                    QMutexLocker locker(&shard->mutex);
+                    CacheNode* node = shard->find(key);
+                    if (node && node->entry.segmentId == segmentId && node->entry.segmentOffset == offset) {
+                        node->entry.segmentId = to.value().segment;
+                        node->entry.segmentOffset = to.value().offset;
+                        d->journal(node->entry);
+                        repointed = true;
+                    }
+                }
+                d->segments->release(repointed ? from : to.value());
+                movedCount += repointed ? 1 : 0;
+            }
+        }
+
+        // Views handed out before the move keep the retired file mapped
+        if (complete) {
+            d->segments->retire(segmentId);
+            ++retiredCount;
+        }
     }
 
-    d->entries.erase(it);
-    d->stats.totalSize -= size;
-    d->stats.entryCount--;
-    
-    updateStats();
-    
-    emit entryRemoved(key, size);
-    return Expected<void, CacheError>();
+    if (retiredCount > 0) {
+        const SegmentStoreStats stats = d->segments->stats();
+        Logger::instance().info("FileCache segment compaction moved {} entries, retired {} segments ({} of {} bytes live)",
+                                movedCount, retiredCount, stats.liveBytes, stats.usedBytes);
+    }
 }
 
-Expected<void, CacheError> FileCache::evictEntry(const QString& key, const QString& reason) {
-    auto removeResult = removeEntry(key);
-    if (removeResult.hasValue()) {
-        d->stats.evictionCount++;
-        updateStats();
-        emit evictionOccurred(key, reason);
+bool FileCache::restoreEntry(CacheEntry entry) {
+    const qint64 expiresAtMs = expiryFor(entry);
+    if (entry.key.isEmpty() || (expiresAtMs > 0 && expiresAtMs < QDateTime::currentMSecsSinceEpoch())) {
+        return false;
+    }
+
+    // The payload must still exist where the entry says it is
+    const SegmentLocation location{entry.segmentId, entry.segmentOffset};
+    if (location.isValid() ? !d->segments || !d->segments->contains(location)
+                           : entry.data.size() != entry.size) {
+        return false;
+    }
+
+    CacheShard& shard = d->shardFor(entry.key);
+    QMutexLocker locker(&shard.mutex);
+    if (shard.find(entry.key) || d->isTombstoned(entry.key)) {
+        return false;
     }
-    return removeResult;
+    if (location.isValid()) {
+        d->segments->markLive(location);
+    }
+    d->insertNode(shard, std::move(entry));
+    return true;
 }
 
-Expected<void, CacheError> FileCache::makeRoom(qint64 requiredSize) {
-    qint64 targetSize = d->maxSize - requiredSize;
-    auto result = evict(targetSize);
-    if (!result.hasValue()) {
-        return makeUnexpected(result.error());
+void FileCache::faultInFromIndex(const QString& key) {
+    if (!d->indexLoading || !d->index) {
+        return;
+    }
+
+    // A key the loader has not reached yet is restored on first use
+    auto entry = d->index->lookup(key);
+    if (entry.hasValue()) {
+        restoreEntry(std::move(entry.value()));
     }
-    return Expected<void, CacheError>();
 }
 
-Expected<QByteArray, CacheError> FileCache::compressData(const QByteArray& data) {
-    // Simplified compression using qCompress
-    QByteArray compressed = qCompress(data, d->compressionLevel);
-    if (compressed.isEmpty()) {
-        return makeUnexpected(CacheError::CompressionError);
+void FileCache::loadIndexSnapshot() {
+    const qint64 total = d->index->snapshotEntryCount();
+    qint64 restoredCount = 0;
+
+    for (qint64 first = 0; first < total; first += INDEX_LOAD_BATCH) {
+        QList<CacheEntry> batch = d->index->snapshotEntries(first, INDEX_LOAD_BATCH);
+        if (batch.isEmpty()) {
+            break; // Released by clear()
+        }
+        for (CacheEntry& entry : batch) {
+            restoredCount += restoreEntry(std::move(entry)) ? 1 : 0;
+        }
+    }
+
+    d->index->releaseSnapshot();
+    {
+        QMutexLocker locker(&d->tombstoneMutex);
+        d->indexLoading = false;
+        d->tombstones.clear();
+    }
+
+    enforceLimits(d->maxSize, d->maxEntries, QString(), "Size limit exceeded");
+    Logger::instance().info("FileCache index loaded: {} of {} snapshot entries restored", restoredCount, total);
+
+    // Live byte counts are complete now
+    scheduleSegmentCompaction();
+}
+
+void FileCache::scheduleIndexSnapshot() {
+    if (!d->index || d->indexLoading) {
+        return;
+    }
+
+    // Replaying a journal never costs more than loading one snapshot
+    const qint64 threshold = std::max(CacheIndex::SNAPSHOT_MIN_JOURNAL_OPS, d->entryCount.load());
+    if (d->index->journalLength() < threshold || d->snapshotScheduled.exchange(true)) {
+        return;
+    }
+
+    QtConcurrent::run(&d->maintenancePool, [this]() {
+        d->snapshotScheduled = false;
+        writeIndexSnapshot();
+    });
+}
+
+Expected<void, CacheError> FileCache::writeIndexSnapshot() {
+    QMutexLocker locker(&d->snapshotMutex);
+    if (!d->index || d->indexLoading) {
+        return makeUnexpected(CacheError::InitializationFailed);
+    }
+
+    // Journal first, so changes made while the entries are copied land in
+    // the journal that follows this snapshot
+    const quint64 generation = d->index->beginSnapshot();
+    if (generation == 0) {
+        return makeUnexpected(CacheError::WriteError);
+    }
+    return d->index->commitSnapshot(generation, d->snapshotEntries());
+}
+
+bool FileCache::compressEntry(CacheEntry& entry) {
+    const QByteArray raw = entry.data;
+    entry.originalSize = raw.size();
+    entry.size = raw.size();
+    entry.compressed = false;
+    entry.codec = CacheCodecId::None;
+    entry.dictionaryId = 0;
+
+    // Skip small payloads and formats that are already compressed
+    const CacheCodecId codecId = d->codec;
+    if (!d->compressionEnabled || codecId == CacheCodecId::None || raw.size() <= COMPRESSION_MIN_SIZE ||
+        CacheCodec::isLikelyIncompressible(raw)) {
+        return false;
+    }
+
+    std::shared_ptr<const CompressionDictionary> dictionary;
+    if (codecId == CacheCodecId::Zstd) {
+        QReadLocker locker(&d->dictionaryLock);
+        dictionary = d->activeDictionary;
+    }
+
+    auto compressed = CacheCodec::forId(codecId)->compress(raw, d->compressionLevel, dictionary.get());
+    if (!compressed.hasValue()) {
+        return false;
+    }
+
+    // Keep the raw payload when the saving does not pay for decompression
+    if (static_cast<double>(raw.size()) < compressed.value().size() * d->minCompressionRatio) {
+        return false;
     }
-    return compressed;
+
+    entry.data = compressed.value();
+    entry.size = entry.data.size();
+    entry.compressed = true;
+    entry.codec = codecId;
+    entry.dictionaryId = dictionary ? dictionary->id() : 0;
+    return true;
 }
 
-Expected<QByteArray, CacheError> FileCache::decompressData(const QByteArray& compressedData) {
-    // Simplified decompression using qUncompress
-    QByteArray decompressed = qUncompress(compressedData);
-    if (decompressed.isEmpty()) {
+Expected<QByteArray, CacheError> FileCache::decompressData(const QByteArray& data, CacheCodecId codec,
+                                                           quint32 dictionaryId, qint64 originalSize) {
+    const CacheCodec* decoder = CacheCodec::forId(codec);
+    if (!decoder) {
         return makeUnexpected(CacheError::DecompressionError);
     }
-    return decompressed;
+
+    std::shared_ptr<const CompressionDictionary> dictionary;
+    if (dictionaryId != 0) {
+        dictionary = d->dictionary(dictionaryId);
+        if (!dictionary) {
+            Logger::instance().warn("Cache entry needs unknown compression dictionary {}", dictionaryId);
+            return makeUnexpected(CacheError::DecompressionError);
+        }
+    }
+
+    auto decompressed = decoder->decompress(data, originalSize, dictionary.get());
+    if (!decompressed.hasValue()) {
+        return makeUnexpected(CacheError::DecompressionError);
+    }
+    return decompressed.value();
+}
+
+Expected<void, CacheError> FileCache::installDictionary(const QByteArray& dictionary, bool persist) {
+    auto prepared = CompressionDictionary::fromBytes(dictionary, d->compressionLevel);
+    if (!prepared.hasValue()) {
+        return makeUnexpected(CacheError::CompressionError);
+    }
+
+    const quint32 id = prepared.value()->id();
+    {
+        QWriteLocker locker(&d->dictionaryLock);
+        d->dictionaries.insert(id, prepared.value());
+        d->activeDictionary = prepared.value();
+    }
+
+    // Persisted entries reference dictionaries by id, so keep a copy next to them
+    if (persist && d->persistentCacheEnabled && !d->cacheDirectory.isEmpty()) {
+        QSaveFile file(QDir(d->cacheDirectory).filePath(QString("dictionary_%1.zdict").arg(id)));
+        if (!file.open(QIODevice::WriteOnly) || file.write(dictionary) != dictionary.size() || !file.commit()) {
+            Logger::instance().warn("Failed to persist cache compression dictionary {}", id);
+        }
+    }
+
+    Logger::instance().info("FileCache compression dictionary {} installed ({} bytes)", id, dictionary.size());
+    return Expected<void, CacheError>();
+}
+
+void FileCache::loadDictionaries() {
+    // Newest file becomes the active dictionary
+    const QFileInfoList files = QDir(d->cacheDirectory).entryInfoList({"dictionary_*.zdict"}, QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QFileInfo& info : files) {
+        QFile file(info.absoluteFilePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            installDictionary(file.readAll(), false);
+        }
+    }
 }
 
 Expected<QByteArray, CacheError> FileCache::serializeEntry(const CacheEntry& entry) {
@@ -967,6 +1972,11 @@ Expected<QByteArray, CacheError> FileCache::serializeEntry(const CacheEntry& ent
     stream << entry.dirty;
     stream << entry.filePath;
     stream << entry.checksum;
+    stream << static_cast<quint8>(entry.codec);
+    stream << entry.dictionaryId;
+    stream << entry.originalSize;
+    stream << entry.segmentId;
+    stream << entry.segmentOffset;
 
     return data;
 }
@@ -989,10 +1999,36 @@ Expected<CacheEntry, CacheError> FileCache::deserializeEntry(const QByteArray& d
     stream >> entry.filePath;
     stream >> entry.checksum;
 
+    if (stream.status() != QDataStream::Ok) {
+        return makeUnexpected(CacheError::DeserializationError);
+    }
+
+    // Entries written before codecs were recorded are either raw or qCompress'd
+    if (stream.atEnd()) {
+        entry.codec = entry.compressed ? CacheCodecId::Zlib : CacheCodecId::None;
+        entry.dictionaryId = 0;
+        entry.originalSize = entry.compressed ? -1 : entry.data.size();
+    } else {
+        quint8 codec = 0;
+        stream >> codec >> entry.dictionaryId >> entry.originalSize;
+        if (stream.status() != QDataStream::Ok || !CacheCodec::forId(static_cast<CacheCodecId>(codec))) {
+            return makeUnexpected(CacheError::DeserializationError);
+        }
+        entry.codec = static_cast<CacheCodecId>(codec);
+
+        // Segment locations were added after codecs
+        if (!stream.atEnd()) {
+            stream >> entry.segmentId >> entry.segmentOffset;
+            if (stream.status() != QDataStream::Ok) {
+                return makeUnexpected(CacheError::DeserializationError);
+            }
+        }
+    }
+
     return entry;
 }
 
-Expected<void, CacheError> FileCache::loadFromDisk(const QString& key) {
+Expected<CacheEntry, CacheError> FileCache::loadFromDisk(const QString& key) {
     if (!d->persistentCacheEnabled) {
         return makeUnexpected(CacheError::ReadError);
     }
@@ -1007,31 +2043,48 @@ Expected<void, CacheError> FileCache::loadFromDisk(const QString& key) {
         return makeUnexpected(CacheError::ReadError);
     }
 
-    QByteArray data = file.readAll();
-    return insertEntry(key, data, -1);
-}
+    auto entry = deserializeEntry(file.readAll());
+    if (!entry.hasValue()) {
+        return makeUnexpected(entry.error());
+    }
 
-Expected<void, CacheError> FileCache::saveToDisk(const QString& key) {
-    if (!d->persistentCacheEnabled) {
-        return Expected<void, CacheError>();
+    // sanitizeKey() is lossy, so the file may belong to a different key
+    if (entry.value().key != key) {
+        return makeUnexpected(CacheError::KeyNotFound);
     }
 
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
+    const qint64 expiresAtMs = expiryFor(entry.value());
+    if (expiresAtMs > 0 && expiresAtMs < QDateTime::currentMSecsSinceEpoch()) {
+        QFile::remove(filePath.value());
         return makeUnexpected(CacheError::KeyNotFound);
     }
 
-    auto filePath = generateCacheFilePath(key);
+    entry.value().dirty = false;
+    entry.value().filePath = filePath.value();
+    return entry;
+}
+
+Expected<void, CacheError> FileCache::saveToDisk(const CacheEntry& entry) {
+    if (!d->persistentCacheEnabled) {
+        return Expected<void, CacheError>();
+    }
+
+    auto filePath = generateCacheFilePath(entry.key);
     if (!filePath.hasValue()) {
         return makeUnexpected(CacheError::WriteError);
     }
 
+    auto serialized = serializeEntry(entry);
+    if (!serialized.hasValue()) {
+        return makeUnexpected(CacheError::SerializationError);
+    }
+
     QFile file(filePath.value());
     if (!file.open(QIODevice::WriteOnly)) {
         return makeUnexpected(CacheError::WriteError);
     }
 
-    if (file.write(it->second->data) != it->second->data.size()) {
+    if (file.write(serialized.value()) != serialized.value().size()) {
         return makeUnexpected(CacheError::WriteError);
     }
 
@@ -1052,35 +2105,114 @@ Expected<void, CacheError> FileCache::removeFromDisk(const QString& key) {
     return Expected<void, CacheError>();
 }
 
-Expected<void, CacheError> FileCache::validateKey(const QString& key) {
-    if (!d->validator || !d->validator->isValidCacheKey(key)) {
-        return makeUnexpected(CacheError::InvalidKey);
+Expected<void, CacheError> FileCache::saveIndex(const QString& filePath) {
+    // Snapshot first so no shard lock is held during file I/O
+    const QList<CacheEntry> entries = d->snapshotEntries();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return makeUnexpected(CacheError::WriteError);
     }
-    return Expected<void, CacheError>();
-}
 
-Expected<void, CacheError> FileCache::updateStats() {
-    qint64 total = d->stats.hitCount + d->stats.missCount;
-    if (total > 0) {
-        d->stats.hitRate = static_cast<double>(d->stats.hitCount) / total;
-        d->stats.missRate = static_cast<double>(d->stats.missCount) / total;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    // Write header
+    stream << QString("FileCache");
+    stream << static_cast<quint32>(1); // Version
+    stream << static_cast<quint64>(entries.size());
+
+    // Write entries
+    for (const CacheEntry& entry : entries) {
+        auto serialized = serializeEntry(entry);
+        if (!serialized.hasValue()) {
+            return makeUnexpected(CacheError::SerializationError);
+        }
+        stream << entry.key << serialized.value();
     }
+
+    Logger::instance().info("FileCache saved to {}", filePath.toStdString());
     return Expected<void, CacheError>();
 }
 
-Expected<void, CacheError> FileCache::checkExpiration(const QString& key) {
-    auto it = d->entries.find(key);
-    if (it == d->entries.end()) {
-        return makeUnexpected(CacheError::KeyNotFound);
+Expected<void, CacheError> FileCache::loadIndex(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return makeUnexpected(CacheError::ReadError);
     }
 
-    if (it->second->ttl > 0) {
-        auto now = QDateTime::currentDateTime();
-        if (it->second->createdAt.addSecs(it->second->ttl) < now) {
-            return removeEntry(key);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    // Read header
+    QString header;
+    quint32 version;
+    quint64 entryCount;
+    
+    stream >> header >> version >> entryCount;
+    
+    if (header != "FileCache" || version != 1) {
+        return makeUnexpected(CacheError::DeserializationError);
+    }
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    qint64 loadedCount = 0;
+
+    // Read entries
+    for (quint64 i = 0; i < entryCount; ++i) {
+        QString key;
+        QByteArray serializedEntry;
+        
+        stream >> key >> serializedEntry;
+        if (stream.status() != QDataStream::Ok) {
+            break;
         }
+        
+        auto entry = deserializeEntry(serializedEntry);
+        if (!entry.hasValue()) {
+            continue; // Skip corrupted entries
+        }
+
+        const qint64 expiresAtMs = expiryFor(entry.value());
+        if (expiresAtMs > 0 && expiresAtMs < nowMs) {
+            continue;
+        }
+
+        // Segment entries are only usable while their record still exists
+        const SegmentLocation location{entry.value().segmentId, entry.value().segmentOffset};
+        if (location.isValid()) {
+            if (!d->segments || !d->segments->contains(location)) {
+                continue;
+            }
+            d->segments->markLive(location);
+        }
+
+        entry.value().key = key;
+        CacheShard& shard = d->shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        if (CacheNode* existing = shard.find(key)) {
+            auto detached = d->detachNode(shard, existing);
+            if (detached->entry.segmentOffset >= 0) {
+                d->segments->release({detached->entry.segmentId, detached->entry.segmentOffset});
+            }
+        }
+        d->journal(d->insertNode(shard, std::move(entry.value()))->entry);
+        ++loadedCount;
     }
 
+    enforceLimits(d->maxSize, d->maxEntries, QString(), "Size limit exceeded");
+
+    // Records no index entry refers to any more leave sparse segments behind
+    scheduleSegmentCompaction();
+
+    Logger::instance().info("FileCache loaded from {}, {} entries", filePath.toStdString(), loadedCount);
+    return Expected<void, CacheError>();
+}
+
+Expected<void, CacheError> FileCache::validateKey(const QString& key) {
+    if (!d->validator || !d->validator->isValidCacheKey(key)) {
+        return makeUnexpected(CacheError::InvalidKey);
+    }
     return Expected<void, CacheError>();
 }
 
@@ -1090,7 +2222,10 @@ Expected<QString, CacheError> FileCache::generateCacheFilePath(const QString& ke
 }
 
 Expected<QByteArray, CacheError> FileCache::calculateChecksum(const QByteArray& data) {
-    return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    // Integrity check only, so a fast non-cryptographic hash is enough
+    QByteArray checksum(CHECKSUM_SIZE, Qt::Uninitialized);
+    qToBigEndian(CacheSegmentStore::checksum(data.constData(), data.size()), checksum.data());
+    return checksum;
 }
 
 Expected<bool, CacheError> FileCache::verifyChecksum(const QByteArray& data, const QByteArray& checksum) {
@@ -1102,8 +2237,9 @@ Expected<bool, CacheError> FileCache::verifyChecksum(const QByteArray& data, con
 }
 
 QString FileCache::sanitizeKey(const QString& key) {
+    static const QRegularExpression unsafeCharacters("[^a-zA-Z0-9_\\-]");
     QString sanitized = key;
-    sanitized.replace(QRegularExpression("[^a-zA-Z0-9_\\-]"), "_");
+    sanitized.replace(unsafeCharacters, "_");
     return sanitized;
 }
 
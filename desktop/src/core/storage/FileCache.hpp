@@ -12,6 +12,8 @@
 
 #include "core/common/Expected.hpp"
 #include "core/common/Logger.hpp"
+#include "CacheCodec.hpp"
+#include "CacheView.hpp"
 
 namespace Murmur {
 
@@ -25,7 +27,8 @@ enum class CacheError {
     CompressionError,
     DecompressionError,
     SerializationError,
-    DeserializationError
+    DeserializationError,
+    ChecksumMismatch
 };
 
 enum class CachePolicy {
@@ -37,6 +40,11 @@ enum class CachePolicy {
     WriteBack
 };
 
+enum class CacheStorageMode {
+    InMemory,        // Payloads live in memory, optionally mirrored to per-key files
+    MappedSegments   // Payloads live in memory-mapped, append-only segment files
+};
+
 struct CacheEntry {
     QString key;
     QByteArray data;
@@ -50,6 +58,11 @@ struct CacheEntry {
     bool dirty; // For write-back policy
     QString filePath; // For persistent cache
     QByteArray checksum;
+    CacheCodecId codec = CacheCodecId::None; // Codec that produced data
+    quint32 dictionaryId = 0; // Zstd dictionary used, 0 when none
+    qint64 originalSize = 0; // Uncompressed payload size
+    quint32 segmentId = 0; // MappedSegments mode: segment holding the payload
+    qint64 segmentOffset = -1; // MappedSegments mode: record offset, -1 when data is inline
 };
 
 struct CacheStats {
@@ -65,6 +78,19 @@ struct CacheStats {
     QDateTime lastCleanup;
 };
 
+/**
+ * @brief Thread-safe key/value cache with optional on-disk persistence
+ *
+ * Entries are spread over lock-striped shards by key hash. Each shard keeps
+ * intrusive recency, insertion and frequency lists plus a TTL heap, so
+ * lookups, inserts and victim selection are O(1) amortized under every
+ * CachePolicy. Size and entry limits are enforced across all shards.
+ *
+ * In CacheStorageMode::MappedSegments, payloads are appended to mmap'd
+ * segment files instead of being held in memory; getView() then serves
+ * uncompressed entries without copying, and sparse segments are compacted
+ * in the background.
+ */
 class FileCache : public QObject {
     Q_OBJECT
 
@@ -80,6 +106,8 @@ public:
     // Cache operations
     Expected<void, CacheError> put(const QString& key, const QByteArray& data, qint64 ttl = -1);
     Expected<QByteArray, CacheError> get(const QString& key);
+    // Zero-copy for uncompressed entries in MappedSegments mode
+    Expected<CacheView, CacheError> getView(const QString& key);
     Expected<bool, CacheError> contains(const QString& key);
     Expected<void, CacheError> remove(const QString& key);
     Expected<void, CacheError> clear();
@@ -101,7 +129,14 @@ public:
     Expected<void, CacheError> setCachePolicy(CachePolicy policy);
     Expected<void, CacheError> setCompressionEnabled(bool enabled);
     Expected<void, CacheError> setCompressionLevel(int level);
+    Expected<void, CacheError> setCompressionCodec(CacheCodecId codec);
+    Expected<void, CacheError> setMinCompressionRatio(double ratio);
+    Expected<void, CacheError> setCompressionDictionary(const QByteArray& dictionary);
+    Expected<QByteArray, CacheError> trainCompressionDictionary(const QList<QByteArray>& samples,
+                                                                int maxDictionarySize = 16 * 1024);
     Expected<void, CacheError> setPersistentCacheEnabled(bool enabled);
+    Expected<void, CacheError> setStorageMode(CacheStorageMode mode); // Before initialize() only
+    Expected<void, CacheError> setChecksumVerificationEnabled(bool enabled);
     Expected<void, CacheError> setCleanupInterval(int intervalMs);
 
     // Information
@@ -143,30 +178,45 @@ private:
     class FileCachePrivate;
     std::unique_ptr<FileCachePrivate> d;
 
+    struct StoredPayload;
+
     // Cache management
+    Expected<StoredPayload, CacheError> fetchStored(const QString& key);
     Expected<void, CacheError> insertEntry(const QString& key, const QByteArray& data, qint64 ttl);
-    Expected<void, CacheError> updateEntry(const QString& key, const QByteArray& data);
+    void storeEntry(CacheEntry entry);
     Expected<void, CacheError> removeEntry(const QString& key);
-    Expected<void, CacheError> evictEntry(const QString& key, const QString& reason);
-    Expected<void, CacheError> makeRoom(qint64 requiredSize);
+    qint64 enforceLimits(qint64 maxSize, qint64 maxEntries, const QString& protectedKey, const QString& reason);
 
     // Compression
-    Expected<QByteArray, CacheError> compressData(const QByteArray& data);
-    Expected<QByteArray, CacheError> decompressData(const QByteArray& compressedData);
+    bool compressEntry(CacheEntry& entry);
+    Expected<QByteArray, CacheError> decompressData(const QByteArray& data, CacheCodecId codec,
+                                                    quint32 dictionaryId, qint64 originalSize);
+    Expected<void, CacheError> installDictionary(const QByteArray& dictionary, bool persist);
+    void loadDictionaries();
 
     // Serialization
     Expected<QByteArray, CacheError> serializeEntry(const CacheEntry& entry);
     Expected<CacheEntry, CacheError> deserializeEntry(const QByteArray& data);
 
     // Persistence
-    Expected<void, CacheError> loadFromDisk(const QString& key);
-    Expected<void, CacheError> saveToDisk(const QString& key);
+    Expected<CacheEntry, CacheError> loadFromDisk(const QString& key);
+    Expected<void, CacheError> saveToDisk(const CacheEntry& entry);
     Expected<void, CacheError> removeFromDisk(const QString& key);
+    Expected<void, CacheError> saveIndex(const QString& filePath);
+    Expected<void, CacheError> loadIndex(const QString& filePath);
+    void releaseStorage(const CacheEntry& entry);
+    void scheduleSegmentCompaction();
+    void compactSegments();
+
+    // Binary index
+    bool restoreEntry(CacheEntry entry);
+    void faultInFromIndex(const QString& key);
+    void loadIndexSnapshot();
+    void scheduleIndexSnapshot();
+    Expected<void, CacheError> writeIndexSnapshot();
 
     // Utility
     Expected<void, CacheError> validateKey(const QString& key);
-    Expected<void, CacheError> updateStats();
-    Expected<void, CacheError> checkExpiration(const QString& key);
     Expected<QString, CacheError> generateCacheFilePath(const QString& key);
     Expected<QByteArray, CacheError> calculateChecksum(const QByteArray& data);
     Expected<bool, CacheError> verifyChecksum(const QByteArray& data, const QByteArray& checksum);
@@ -1,4 +1,7 @@
 #include "FileManager.hpp"
+#include "ContentStore.hpp"
+#include "DirectoryScanner.hpp"
+#include "DirectoryWatcher.hpp"
 #include "../common/Logger.hpp"
 #include <QtConcurrent>
 #include <QDir>
@@ -13,15 +16,169 @@
 #include <QTimer>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 namespace Murmur {
 
+namespace {
+
+// Kernel copies move at most this much per call so that cancellation and
+// progress are still observed on very large files
+constexpr qint64 KERNEL_COPY_CHUNK = 64 * 1024 * 1024;
+
+// Buffer for the userspace fallback
+constexpr qint64 COPY_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// Minimum time between progress reports of one copy
+constexpr qint64 PROGRESS_INTERVAL_MS = 100;
+
+// Name of the persisted scan index inside the cache directory
+const QString LIBRARY_INDEX_FILE = QStringLiteral("library_index.bin");
+
+// Content store inside the download directory: links only work within one
+// filesystem, and the scanner skips hidden directories
+const QString CONTENT_STORE_DIR = QStringLiteral(".content");
+
+// Lower-cased extension of the file name, without building a QFileInfo
+QString fileSuffix(const QString& path) {
+    const qsizetype dot = path.lastIndexOf(QLatin1Char('.'));
+    return dot > path.lastIndexOf(QLatin1Char('/')) ? path.mid(dot + 1).toLower() : QString();
+}
+
+bool isSameOrUnder(const QString& path, const QString& root) {
+    return path == root || (path.startsWith(root) &&
+           (root.endsWith(QLatin1Char('/')) || path.at(root.size()) == QLatin1Char('/')));
+}
+
+enum class CopyResult {
+    Done,
+    Unsupported,
+    Failed,
+    Cancelled
+};
+
+// Called with the bytes copied so far; returns false to cancel
+using CopyProgress = std::function<bool(qint64)>;
+
+#ifdef Q_OS_LINUX
+bool isUnsupportedCopyError(int error) {
+    return error == ENOSYS || error == EXDEV || error == EOPNOTSUPP || error == EINVAL || error == ENOTTY;
+}
+
+// Shares the source's extents on copy-on-write filesystems (Btrfs, XFS,
+// bcachefs) without reading or writing any data. Any failure just means
+// the next method has to do the work.
+bool cloneFile(int sourceFd, int destFd) {
+#ifdef FICLONE
+    return ::ioctl(destFd, FICLONE, sourceFd) == 0;
+#else
+    Q_UNUSED(sourceFd);
+    Q_UNUSED(destFd);
+    return false;
+#endif
+}
+
+// copy_file_range() keeps the data in the kernel and lets network
+// filesystems copy server-side; sendfile() covers kernels and filesystem
+// pairs without it. Both advance the file offsets, so on Unsupported the
+// caller resumes at `copied`.
+CopyResult copyInKernel(int sourceFd, int destFd, qint64 totalSize, qint64& copied, const CopyProgress& progress) {
+    bool useCopyRange = true;
+
+    while (copied < totalSize) {
+        const size_t chunk = static_cast<size_t>(std::min(totalSize - copied, KERNEL_COPY_CHUNK));
+        ssize_t result = useCopyRange
+            ? ::copy_file_range(sourceFd, nullptr, destFd, nullptr, chunk, 0)
+            : ::sendfile(destFd, sourceFd, nullptr, chunk);
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!isUnsupportedCopyError(errno)) {
+                return CopyResult::Failed;
+            }
+            if (!useCopyRange) {
+                return CopyResult::Unsupported;
+            }
+            useCopyRange = false;
+            continue;
+        }
+
+        // Files that report a size but read short (procfs, FUSE) are left
+        // to the buffered loop
+        if (result == 0) {
+            return CopyResult::Unsupported;
+        }
+
+        copied += result;
+        if (!progress(copied)) {
+            return CopyResult::Cancelled;
+        }
+    }
+
+    // The source may have grown since it was stat'ed
+    return CopyResult::Unsupported;
+}
+#endif
+
+CopyResult copyBuffered(QFile& source, QFile& dest, qint64& copied, const CopyProgress& progress) {
+    if (!source.seek(copied) || !dest.seek(copied)) {
+        return CopyResult::Failed;
+    }
+
+    QByteArray buffer(COPY_BUFFER_SIZE, Qt::Uninitialized);
+    while (true) {
+        const qint64 read = source.read(buffer.data(), buffer.size());
+        if (read < 0) {
+            return CopyResult::Failed;
+        }
+        if (read == 0) {
+            return CopyResult::Done;
+        }
+        if (dest.write(buffer.constData(), read) != read) {
+            return CopyResult::Failed;
+        }
+
+        copied += read;
+        if (!progress(copied)) {
+            return CopyResult::Cancelled;
+        }
+    }
+}
+
+} // namespace
+
 struct FileManager::FileManagerPrivate {
     mutable QMutex operationsMutex;
     QHash<QString, FileOperation> activeOperations;
+    // Polled by running copies without taking operationsMutex
+    QHash<QString, std::shared_ptr<std::atomic<bool>>> cancelFlags;
     QStringList videoExtensions = {"mp4", "avi", "mkv", "mov", "wmv", "flv", "webm", "m4v", "mpg", "mpeg", "3gp", "ogv"};
     QStringList audioExtensions = {"mp3", "wav", "flac", "aac", "ogg", "wma", "m4a"};
     QStringList subtitleExtensions = {"srt", "vtt", "ass", "ssa", "sub", "sbv"};
+    QSet<QString> videoSuffixes;
+    QSet<QString> audioSuffixes;
+    QSet<QString> subtitleSuffixes;
+    
+    DirectoryScanner scanner;
+    ContentStore contentStore;
+    DirectoryWatcher* watcher = nullptr;
+    QStringList watchedRoots; // Guarded by operationsMutex
     
     QString defaultDownloadPath;
     QString defaultExportPath;
@@ -35,6 +192,16 @@ FileManager::FileManager(QObject* parent)
     , d(std::make_unique<FileManagerPrivate>()) {
     Logger::instance().info("FileManager created");
     initializePaths();
+    
+    d->videoSuffixes = QSet<QString>(d->videoExtensions.cbegin(), d->videoExtensions.cend());
+    d->audioSuffixes = QSet<QString>(d->audioExtensions.cbegin(), d->audioExtensions.cend());
+    d->subtitleSuffixes = QSet<QString>(d->subtitleExtensions.cbegin(), d->subtitleExtensions.cend());
+    
+    d->scanner.setIndexPath(QDir(d->cachePath).filePath(LIBRARY_INDEX_FILE));
+    d->contentStore.setRoot(QDir(d->defaultDownloadPath).filePath(CONTENT_STORE_DIR));
+    d->watcher = new DirectoryWatcher(this);
+    connect(d->watcher, &DirectoryWatcher::directoryChanged, this, &FileManager::onWatchedDirectoryChanged);
+    connect(d->watcher, &DirectoryWatcher::overflowed, this, &FileManager::onWatcherOverflowed);
 }
 
 FileManager::~FileManager() {
@@ -96,6 +263,8 @@ QFuture<Expected<bool, FileError>> FileManager::deleteFile(const QString& path)
             return makeUnexpected(FileError::DeleteFailed);
         }
         
+        d->contentStore.remove(path);
+        d->contentStore.saveIndex();
         return true;
     });
 }
@@ -108,7 +277,11 @@ QFuture<Expected<bool, FileError>> FileManager::deleteDirectory(const QString& p
         }
         
         if (recursive) {
-            if (!dir.removeRecursively()) {
+            // A partial delete still removed some library files
+            const bool removed = dir.removeRecursively();
+            d->contentStore.removeTree(dir.absolutePath());
+            d->contentStore.saveIndex();
+            if (!removed) {
                 return makeUnexpected(FileError::DeleteFailed);
             }
         } else {
@@ -133,14 +306,7 @@ QFuture<Expected<QString, FileError>> FileManager::importVideo(const QString& so
             return makeUnexpected(FileError::CreateFailed);
         }
         
-        QString destPath = generateUniqueFileName(destDir, sourceInfo.fileName());
-        
-        auto copyResult = copyFileSync(sourcePath, destPath, QUuid::createUuid().toString(QUuid::WithoutBraces));
-        if (!copyResult.hasValue()) {
-            return makeUnexpected(copyResult.error());
-        }
-        
-        return destPath;
+        return importFileSync(sourcePath, generateUniqueFileName(destDir, sourceInfo.fileName()));
     });
 }
 
@@ -155,9 +321,8 @@ QFuture<Expected<QStringList, FileError>> FileManager::importVideoDirectory(cons
         QString destDir = destinationDir.isEmpty() ? getDefaultDownloadPath() : destinationDir;
         
         for (const QString& videoFile : videoFilesResult.value()) {
-            auto importResult = copyFileSync(videoFile, 
-                generateUniqueFileName(destDir, QFileInfo(videoFile).fileName()),
-                QUuid::createUuid().toString(QUuid::WithoutBraces));
+            auto importResult = importFileSync(videoFile,
+                generateUniqueFileName(destDir, QFileInfo(videoFile).fileName()));
             
             if (importResult.hasValue()) {
                 importedFiles.append(importResult.value());
@@ -249,18 +414,19 @@ qint64 FileManager::getFileSize(const QString& path) const {
 }
 
 bool FileManager::isVideoFile(const QString& path) const {
-    QFileInfo info(path);
-    return d->videoExtensions.contains(info.suffix().toLower());
+    return d->videoSuffixes.contains(fileSuffix(path));
 }
 
 bool FileManager::isAudioFile(const QString& path) const {
-    QFileInfo info(path);
-    return d->audioExtensions.contains(info.suffix().toLower());
+    return d->audioSuffixes.contains(fileSuffix(path));
 }
 
 bool FileManager::isSubtitleFile(const QString& path) const {
-    QFileInfo info(path);
-    return d->subtitleExtensions.contains(info.suffix().toLower());
+    return d->subtitleSuffixes.contains(fileSuffix(path));
+}
+
+QString FileManager::contentHash(const QString& path) const {
+    return d->contentStore.keyForPath(path);
 }
 
 QString FileManager::generateUniqueFileName(const QString& basePath, const QString& fileName) const {
@@ -280,11 +446,43 @@ QString FileManager::generateUniqueFileName(const QString& basePath, const QStri
     return dir.absoluteFilePath(uniqueName);
 }
 
+void FileManager::watchDirectory(const QString& path) {
+    const QString root = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    {
+        QMutexLocker locker(&d->operationsMutex);
+        if (d->watchedRoots.contains(root)) {
+            return;
+        }
+        d->watchedRoots.append(root);
+    }
+    
+    // The scan brings the index up to date and watches every directory it visits
+    QtConcurrent::run([this, root]() {
+        auto result = d->scanner.scan(root, true);
+        if (result.hasValue()) {
+            finishScan(result.value().directories);
+        }
+    });
+}
+
+void FileManager::unwatchDirectory(const QString& path) {
+    const QString root = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    {
+        QMutexLocker locker(&d->operationsMutex);
+        d->watchedRoots.removeAll(root);
+    }
+    d->watcher->removeTree(root);
+    d->scanner.clearWatchedTree(root);
+}
+
 void FileManager::cancelOperation(const QString& operationId) {
     QMutexLocker locker(&d->operationsMutex);
     if (d->activeOperations.contains(operationId)) {
         d->activeOperations[operationId].cancelled = true;
     }
+    if (auto flag = d->cancelFlags.value(operationId)) {
+        flag->store(true, std::memory_order_relaxed);
+    }
 }
 
 void FileManager::cancelAllOperations() {
@@ -292,6 +490,9 @@ void FileManager::cancelAllOperations() {
     for (auto& operation : d->activeOperations) {
         operation.cancelled = true;
     }
+    for (const auto& flag : std::as_const(d->cancelFlags)) {
+        flag->store(true, std::memory_order_relaxed);
+    }
 }
 
 QList<FileOperation> FileManager::getActiveOperations() const {
@@ -311,61 +512,141 @@ void FileManager::onFileOperationProgress(const QString& operationId, qint64 pro
     emit operationProgress(operationId, processed, total);
 }
 
-Expected<DirectoryInfo, FileError> FileManager::analyzeDirectorySync(const QString& path) {
-    QDir dir(path);
-    if (!dir.exists()) {
-        return makeUnexpected(FileError::NotFound);
+void FileManager::onWatchedDirectoryChanged(const QString& path) {
+    // Files written in place leave the directory's mtime alone, so the
+    // index cannot be trusted for this directory any more
+    d->scanner.invalidate(path);
+    if (!d->watcher->isWatching(path)) {
+        // The kernel dropped the watch, so the directory is stat'ed on each scan again
+        d->scanner.setWatched(path, false);
     }
+    emit directoryChanged(path);
+}
+
+void FileManager::onWatcherOverflowed() {
+    Logger::instance().warn("FileManager: directory watcher overflowed, dropping the library index");
+    d->scanner.invalidateAll();
     
-    DirectoryInfo info;
-    info.path = path;
+    QStringList roots;
+    {
+        QMutexLocker locker(&d->operationsMutex);
+        roots = d->watchedRoots;
+    }
+    for (const QString& root : roots) {
+        emit directoryChanged(root);
+    }
+}
+
+void FileManager::finishScan(const QStringList& directories) {
+    d->scanner.saveIndex();
     
-    QDirIterator iterator(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    QStringList roots;
+    {
+        QMutexLocker locker(&d->operationsMutex);
+        roots = d->watchedRoots;
+    }
+    if (roots.isEmpty()) {
+        return;
+    }
     
-    while (iterator.hasNext()) {
-        QString filePath = iterator.next();
-        QFileInfo fileInfo(filePath);
-        
-        if (fileInfo.isFile()) {
-            info.fileCount++;
-            info.totalSize += fileInfo.size();
-            
-            if (isVideoFile(filePath)) {
-                info.videoFiles.append(filePath);
-            } else if (isAudioFile(filePath)) {
-                info.audioFiles.append(filePath);
-            } else if (isSubtitleFile(filePath)) {
-                info.subtitleFiles.append(filePath);
+    // New directories under a watched tree are picked up as they are scanned
+    QStringList watched;
+    for (const QString& directory : directories) {
+        for (const QString& root : roots) {
+            if (isSameOrUnder(directory, root)) {
+                watched.append(directory);
+                break;
             }
-        } else if (fileInfo.isDir()) {
-            info.dirCount++;
         }
     }
+    if (!watched.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this, watched]() {
+            for (const QString& directory : watched) {
+                if (d->watcher->addPath(directory)) {
+                    d->scanner.setWatched(directory, true);
+                }
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+Expected<DirectoryInfo, FileError> FileManager::analyzeDirectorySync(const QString& path) {
+    auto scanResult = d->scanner.scan(path, true);
+    if (!scanResult.hasValue()) {
+        return makeUnexpected(scanResult.error() == ScanError::NotFound ? FileError::NotFound : FileError::PermissionDenied);
+    }
+    const ScanResult& scan = scanResult.value();
     
+    DirectoryInfo info;
+    info.path = path;
+    info.fileCount = static_cast<int>(scan.files.size());
+    info.dirCount = static_cast<int>(scan.directories.size()) - 1; // Not counting the root
+    
+    for (const ScannedFile& file : scan.files) {
+        info.totalSize += file.size;
+        
+        const QString suffix = fileSuffix(file.path);
+        if (d->videoSuffixes.contains(suffix)) {
+            info.videoFiles.append(file.path);
+        } else if (d->audioSuffixes.contains(suffix)) {
+            info.audioFiles.append(file.path);
+        } else if (d->subtitleSuffixes.contains(suffix)) {
+            info.subtitleFiles.append(file.path);
+        }
+    }
+    
+    // Workers finish in any order
+    info.videoFiles.sort();
+    info.audioFiles.sort();
+    info.subtitleFiles.sort();
+    
+    finishScan(scan.directories);
     return info;
 }
 
 Expected<QStringList, FileError> FileManager::findVideoFilesSync(const QString& path, bool recursive) {
-    QDir dir(path);
-    if (!dir.exists()) {
-        return makeUnexpected(FileError::NotFound);
+    auto scanResult = d->scanner.scan(path, recursive);
+    if (!scanResult.hasValue()) {
+        return makeUnexpected(scanResult.error() == ScanError::NotFound ? FileError::NotFound : FileError::PermissionDenied);
     }
+    const ScanResult& scan = scanResult.value();
     
     QStringList videoFiles;
-    QStringList nameFilters;
+    for (const ScannedFile& file : scan.files) {
+        if (d->videoSuffixes.contains(fileSuffix(file.path))) {
+            videoFiles.append(file.path);
+        }
+    }
+    videoFiles.sort();
     
-    for (const QString& ext : d->videoExtensions) {
-        nameFilters << QString("*.%1").arg(ext);
+    finishScan(scan.directories);
+    return videoFiles;
+}
+
+Expected<QString, FileError> FileManager::importFileSync(const QString& source, const QString& destination) {
+    // Content already in the library is linked rather than copied again
+    auto match = d->contentStore.findDuplicate(source);
+    if (match.hasValue() && match.value().stored &&
+        d->contentStore.linkTo(match.value().key, destination).hasValue()) {
+        Logger::instance().info("FileManager: {} is already in the library, linked as {}",
+                                source.toStdString(), destination.toStdString());
+        d->contentStore.saveIndex();
+        return destination;
     }
     
-    QDirIterator::IteratorFlag flags = recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
-    QDirIterator iterator(path, nameFilters, QDir::Files, flags);
+    auto copyResult = copyFileSync(source, destination, QUuid::createUuid().toString(QUuid::WithoutBraces));
+    if (!copyResult.hasValue()) {
+        return makeUnexpected(copyResult.error());
+    }
     
-    while (iterator.hasNext()) {
-        videoFiles.append(iterator.next());
+    // Failing to record the content only costs later deduplication
+    auto addResult = d->contentStore.add(destination, match.hasValue() ? match.value().hash : QString());
+    if (addResult.hasError()) {
+        Logger::instance().warn("FileManager: could not add {} to the content store", destination.toStdString());
     }
+    d->contentStore.saveIndex();
     
-    return videoFiles;
+    return destination;
 }
 
 Expected<QString, FileError> FileManager::copyFileSync(const QString& source, const QString& destination, const QString& operationId) {
@@ -374,6 +655,8 @@ Expected<QString, FileError> FileManager::copyFileSync(const QString& source, co
         return makeUnexpected(FileError::NotFound);
     }
     
+    auto cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    
     // Register operation
     {
         QMutexLocker locker(&d->operationsMutex);
@@ -384,69 +667,87 @@ Expected<QString, FileError> FileManager::copyFileSync(const QString& source, co
         operation.type = "copy";
         operation.totalSize = sourceInfo.size();
         d->activeOperations[operationId] = operation;
+        d->cancelFlags[operationId] = cancelFlag;
     }
     
+    auto finishOperation = [this, &operationId]() {
+        QMutexLocker locker(&d->operationsMutex);
+        d->activeOperations.remove(operationId);
+        d->cancelFlags.remove(operationId);
+    };
+    
     emit operationStarted(operationId, "copy", source, destination);
     
+    // Unbuffered, since reads and writes are already large and the kernel
+    // paths bypass QFile entirely
     QFile sourceFile(source);
     QFile destFile(destination);
     
-    if (!sourceFile.open(QIODevice::ReadOnly)) {
+    if (!sourceFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        finishOperation();
         emit operationFailed(operationId, FileError::PermissionDenied, "Cannot read source file");
         return makeUnexpected(FileError::PermissionDenied);
     }
     
-    if (!destFile.open(QIODevice::WriteOnly)) {
+    if (!destFile.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        finishOperation();
         emit operationFailed(operationId, FileError::PermissionDenied, "Cannot write destination file");
         return makeUnexpected(FileError::PermissionDenied);
     }
     
-    const qint64 bufferSize = 64 * 1024; // 64KB buffer
+    const qint64 totalSize = sourceInfo.size();
     qint64 totalProcessed = 0;
-    qint64 totalSize = sourceInfo.size();
-    
-    while (!sourceFile.atEnd()) {
-        // Check for cancellation
-        {
-            QMutexLocker locker(&d->operationsMutex);
-            if (d->activeOperations.contains(operationId) && d->activeOperations[operationId].cancelled) {
-                destFile.remove();
-                return makeUnexpected(FileError::Unknown); // Cancelled
-            }
-        }
-        
-        QByteArray data = sourceFile.read(bufferSize);
-        if (data.isEmpty()) {
-            break;
-        }
-        
-        qint64 written = destFile.write(data);
-        if (written != data.size()) {
-            destFile.remove();
-            emit operationFailed(operationId, FileError::CopyFailed, "Write failed");
-            return makeUnexpected(FileError::CopyFailed);
+    
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+    auto progress = [&](qint64 processed) {
+        if (progressTimer.elapsed() >= PROGRESS_INTERVAL_MS) {
+            progressTimer.restart();
+            onFileOperationProgress(operationId, processed, totalSize);
         }
-        
-        totalProcessed += written;
-        onFileOperationProgress(operationId, totalProcessed, totalSize);
+        return !cancelFlag->load(std::memory_order_relaxed);
+    };
+    
+    // Cheapest method first: clone, then in-kernel copy, then a buffered loop
+    // that picks up wherever the others stopped
+    CopyResult result = CopyResult::Unsupported;
+#ifdef Q_OS_LINUX
+    if (cloneFile(sourceFile.handle(), destFile.handle())) {
+        totalProcessed = totalSize;
+        result = CopyResult::Done;
+    } else {
+        result = copyInKernel(sourceFile.handle(), destFile.handle(), totalSize, totalProcessed, progress);
+    }
+#endif
+    if (result == CopyResult::Unsupported) {
+        result = copyBuffered(sourceFile, destFile, totalProcessed, progress);
     }
     
-    // Mark operation as completed
-    {
-        QMutexLocker locker(&d->operationsMutex);
-        if (d->activeOperations.contains(operationId)) {
-            d->activeOperations[operationId].completed = true;
-            d->activeOperations.remove(operationId);
+    if (result != CopyResult::Done) {
+        destFile.remove();
+        finishOperation();
+        if (result == CopyResult::Cancelled) {
+            return makeUnexpected(FileError::Unknown); // Cancelled
         }
+        Logger::instance().warn("FileManager: copy of {} failed after {} bytes", source.toStdString(), totalProcessed);
+        emit operationFailed(operationId, FileError::CopyFailed, "Write failed");
+        return makeUnexpected(FileError::CopyFailed);
     }
     
+    // The final report is never throttled
+    onFileOperationProgress(operationId, totalProcessed, totalSize);
+    finishOperation();
+    
     emit operationCompleted(operationId, destination);
     return destination;
 }
 
 Expected<QString, FileError> FileManager::moveFileSync(const QString& source, const QString& destination, const QString& operationId) {
-    // Try quick rename first
-    if (QFile::rename(source, destination)) {
+    // Try quick rename first. QFile::rename() would silently fall back to its
+    // own uncancellable copy across filesystems; QDir::rename() does not.
+    if (QDir().rename(source, destination)) {
+        d->contentStore.move(source, destination);
+        d->contentStore.saveIndex();
         emit operationCompleted(operationId, destination);
         return destination;
     }
@@ -460,6 +761,10 @@ Expected<QString, FileError> FileManager::moveFileSync(const QString& source, co
     if (!QFile::remove(source)) {
         // Copy succeeded but delete failed - log warning but don't fail
         Logger::instance().warn("Move operation: failed to delete source file after copy");
+    } else {
+        // The copy is not linked to the stored object
+        d->contentStore.remove(source);
+        d->contentStore.saveIndex();
     }
     
     return destination;
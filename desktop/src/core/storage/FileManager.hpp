@@ -91,6 +91,14 @@ public:
     bool isSubtitleFile(const QString& path) const;
     QString generateUniqueFileName(const QString& basePath, const QString& fileName) const;
     
+    // Content key of an imported file (32 hex digits, shared by identical copies),
+    // or empty if it was not imported or has changed since
+    QString contentHash(const QString& path) const;
+    
+    // Library indexing: keeps the scan index of a tree current as it changes
+    void watchDirectory(const QString& path);
+    void unwatchDirectory(const QString& path);
+    
     // Operation management
     void cancelOperation(const QString& operationId);
     void cancelAllOperations();
@@ -101,9 +109,12 @@ signals:
     void operationProgress(const QString& operationId, qint64 processed, qint64 total);
     void operationCompleted(const QString& operationId, const QString& result);
     void operationFailed(const QString& operationId, FileError error, const QString& errorMessage);
+    void directoryChanged(const QString& path);
 
 private slots:
     void onFileOperationProgress(const QString& operationId, qint64 processed, qint64 total);
+    void onWatchedDirectoryChanged(const QString& path);
+    void onWatcherOverflowed();
 
 private:
     struct FileManagerPrivate;
@@ -115,8 +126,10 @@ private:
     
     Expected<DirectoryInfo, FileError> analyzeDirectorySync(const QString& path);
     Expected<QStringList, FileError> findVideoFilesSync(const QString& path, bool recursive);
+    Expected<QString, FileError> importFileSync(const QString& source, const QString& destination);
     Expected<QString, FileError> copyFileSync(const QString& source, const QString& destination, const QString& operationId);
     Expected<QString, FileError> moveFileSync(const QString& source, const QString& destination, const QString& operationId);
+    void finishScan(const QStringList& directories);
     
     void initializePaths();
     bool ensureDirectoryExists(const QString& path);
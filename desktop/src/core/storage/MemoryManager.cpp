@@ -5,29 +5,142 @@
 #include <QtCore/QMutexLocker>
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
-#include <QtCore/QCryptographicHash>
+#include <array>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <iterator>
 #include <new>
+#include <optional>
 
 namespace Murmur {
 
+namespace {
+
+constexpr size_t POOL_TYPE_COUNT = static_cast<size_t>(MemoryPoolType::Large) + 1;
+
+// A magazine caches up to this many bytes of one size class, within the
+// block count bounds below
+constexpr size_t MAGAZINE_BYTES = 256 * 1024;
+constexpr size_t MIN_MAGAZINE_BLOCKS = 4;
+constexpr size_t MAX_MAGAZINE_BLOCKS = 64;
+
+// Soft cap on what one thread keeps cached across all magazines
+constexpr size_t THREAD_CACHE_BYTES = 4 * 1024 * 1024;
+
+std::atomic<quint64> nextManagerId{1};
+
+size_t poolIndex(MemoryPoolType type) {
+    return static_cast<size_t>(type);
+}
+
+size_t magazineCapacity(int sizeClass) {
+    return std::clamp(MAGAZINE_BYTES / SlabAllocator::classSize(sizeClass), MIN_MAGAZINE_BLOCKS, MAX_MAGAZINE_BLOCKS);
+}
+
+// Recorded per block only in debug mode
+struct AllocationTrace {
+    std::string allocatedBy;
+    size_t requestedSize;
+    size_t alignment;
+    std::chrono::steady_clock::time_point allocatedAt;
+};
+
+// Application-level allocation counters of one pool
+struct PoolCounters {
+    size_t allocatedBytes = 0;
+    size_t freedBytes = 0;
+    size_t allocationCount = 0;
+    size_t freeCount = 0;
+
+    void add(const PoolCounters& other) {
+        allocatedBytes += other.allocatedBytes;
+        freedBytes += other.freedBytes;
+        allocationCount += other.allocationCount;
+        freeCount += other.freeCount;
+    }
+};
+
+// Blocks of one size class a thread took from a pool, used LIFO
+struct Magazine {
+    std::unique_ptr<void*[]> blocks;
+    size_t count = 0;
+};
+
+/**
+ * @brief Per-thread allocation cache of one MemoryManager
+ *
+ * The owner thread locks the mutex for every allocation and free; it is
+ * only contended while the manager flushes the cache.
+ */
+struct ThreadCache {
+    QMutex mutex;
+    std::atomic<bool> detached{false};
+    size_t cachedBytes = 0;
+    std::array<std::array<Magazine, SlabAllocator::SIZE_CLASS_COUNT>, POOL_TYPE_COUNT> magazines;
+    std::array<PoolCounters, POOL_TYPE_COUNT> counters;
+};
+
+// This thread's caches, one per manager it has allocated from
+thread_local std::vector<std::pair<quint64, std::shared_ptr<ThreadCache>>> threadCaches;
+
+MemoryBlock describeBlock(const MemoryPool& pool, void* ptr, size_t size, const AllocationTrace* trace) {
+    MemoryBlock block;
+    block.ptr = ptr;
+    block.size = size;
+    block.alignment = pool.alignment;
+    block.poolType = pool.type;
+    block.allocatedAt = pool.createdAt;
+    block.isActive = true;
+    block.requestedSize = size;
+
+    if (trace) {
+        block.allocatedBy = trace->allocatedBy;
+        block.alignment = trace->alignment;
+        block.allocatedAt = trace->allocatedAt;
+        block.requestedSize = trace->requestedSize;
+    }
+    return block;
+}
+
+void updateAvailable(MemoryPool& pool) {
+    pool.availableSize = pool.totalSize > pool.usedSize ? pool.totalSize - pool.usedSize : 0;
+}
+
+} // namespace
+
 class MemoryManager::MemoryManagerPrivate {
 public:
     MemoryManagerPrivate() = default;
     ~MemoryManagerPrivate() = default;
 
-    bool initialized = false;
-    size_t totalMemoryLimit = 1024 * 1024 * 1024; // 1GB default
-    size_t currentUsage = 0;
-    size_t peakUsage = 0;
+    const quint64 id = nextManagerId++;
+    std::atomic<bool> initialized{false};
+    std::atomic<size_t> totalMemoryLimit{1024 * 1024 * 1024}; // 1GB default
     double memoryPressureThreshold = 0.8; // 80%
-    bool debugMode = false;
+    std::atomic<bool> debugMode{false};
     int garbageCollectionInterval = 60000; // 1 minute
 
+    // Bytes taken out of the pools, including what thread caches hold;
+    // the memory limit applies to this
+    std::atomic<size_t> heldBytes{0};
+    std::atomic<size_t> peakHeldBytes{0};
+
+    // Pools are owned by the map; the allocation paths only read the slots
     std::unordered_map<MemoryPoolType, std::unique_ptr<MemoryPool>> pools;
-    std::unordered_map<void*, MemoryPoolType> pointerToPool;
+    std::array<std::atomic<MemoryPool*>, POOL_TYPE_COUNT> poolSlots{};
+
+    // Guards the cache registry and the counters of retired caches
+    QMutex cachesMutex;
+    std::vector<std::shared_ptr<ThreadCache>> caches;
+    std::array<PoolCounters, POOL_TYPE_COUNT> retiredCounters;
+
+    QMutex traceMutex;
+    std::unordered_map<void*, AllocationTrace> traces;
+    std::atomic<size_t> traceCount{0};
+
+    // Guards configuration, pool management and stats
     MemoryStats stats;
     mutable QMutex mutex;
 
@@ -38,8 +151,192 @@ public:
     MemoryPressureCallback pressureCallback;
     OutOfMemoryCallback oomCallback;
     LeakDetectionCallback leakCallback;
+
+    MemoryPool* poolFor(MemoryPoolType type) const {
+        return poolSlots[poolIndex(type)].load(std::memory_order_acquire);
+    }
+
+    std::shared_ptr<ThreadCache> threadCache();
+    bool reserve(size_t bytes);
+    void unreserve(size_t bytes);
+    size_t refill(ThreadCache& cache, MemoryPool& pool, int sizeClass, MemoryError& error);
+    size_t drain(ThreadCache& cache, MemoryPool& pool, int sizeClass, size_t count);
+    size_t flushCaches(std::optional<MemoryPoolType> onlyPool, bool detach, bool exitedOnly = false);
+    PoolCounters counters(std::optional<MemoryPoolType> onlyPool);
+    void dropTraces(const MemoryPool& pool);
 };
 
+std::shared_ptr<ThreadCache> MemoryManager::MemoryManagerPrivate::threadCache() {
+    for (auto it = threadCaches.begin(); it != threadCaches.end();) {
+        if (it->second->detached.load(std::memory_order_acquire)) {
+            // Left behind by a manager that shut down
+            it = threadCaches.erase(it);
+        } else if (it->first == id) {
+            return it->second;
+        } else {
+            ++it;
+        }
+    }
+
+    auto cache = std::make_shared<ThreadCache>();
+    {
+        QMutexLocker locker(&cachesMutex);
+        caches.push_back(cache);
+    }
+    threadCaches.emplace_back(id, cache);
+    return cache;
+}
+
+bool MemoryManager::MemoryManagerPrivate::reserve(size_t bytes) {
+    const size_t limit = totalMemoryLimit.load(std::memory_order_relaxed);
+    size_t held = heldBytes.load(std::memory_order_relaxed);
+    do {
+        if (held + bytes > limit) {
+            return false;
+        }
+    } while (!heldBytes.compare_exchange_weak(held, held + bytes, std::memory_order_relaxed));
+
+    size_t peak = peakHeldBytes.load(std::memory_order_relaxed);
+    while (held + bytes > peak &&
+           !peakHeldBytes.compare_exchange_weak(peak, held + bytes, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void MemoryManager::MemoryManagerPrivate::unreserve(size_t bytes) {
+    heldBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryManager::MemoryManagerPrivate::refill(ThreadCache& cache, MemoryPool& pool, int sizeClass, MemoryError& error) {
+    Magazine& magazine = cache.magazines[poolIndex(pool.type)][sizeClass];
+    const size_t capacity = magazineCapacity(sizeClass);
+    const size_t blockSize = SlabAllocator::classSize(sizeClass);
+    if (!magazine.blocks) {
+        magazine.blocks = std::make_unique<void*[]>(capacity);
+    }
+
+    // Half a magazine leaves room for the next few frees without a drain;
+    // close to the memory limit, take a single block
+    size_t batch = capacity / 2;
+    if (!reserve(batch * blockSize)) {
+        batch = 1;
+        if (!reserve(blockSize)) {
+            error = MemoryError::OutOfMemory;
+            return 0;
+        }
+    }
+
+    size_t acquired = 0;
+    {
+        QMutexLocker poolLocker(&pool.mutex);
+        acquired = pool.allocator->acquireBatch(sizeClass, magazine.blocks.get(), batch);
+        pool.usedSize += acquired * blockSize;
+        pool.blockCount += acquired;
+        updateAvailable(pool);
+    }
+
+    unreserve((batch - acquired) * blockSize);
+    if (acquired == 0) {
+        error = MemoryError::PoolExhausted;
+        return 0;
+    }
+
+    magazine.count = acquired;
+    cache.cachedBytes += acquired * blockSize;
+    return acquired * blockSize;
+}
+
+size_t MemoryManager::MemoryManagerPrivate::drain(ThreadCache& cache, MemoryPool& pool, int sizeClass, size_t count) {
+    Magazine& magazine = cache.magazines[poolIndex(pool.type)][sizeClass];
+    count = std::min(count, magazine.count);
+    if (count == 0) {
+        return 0;
+    }
+
+    // The oldest blocks go back; the most recently freed stay hot
+    const size_t blockSize = SlabAllocator::classSize(sizeClass);
+    {
+        QMutexLocker poolLocker(&pool.mutex);
+        for (size_t i = 0; i < count; ++i) {
+            pool.allocator->release(magazine.blocks[i]);
+        }
+        pool.usedSize -= count * blockSize;
+        pool.blockCount -= count;
+        updateAvailable(pool);
+    }
+
+    std::move(magazine.blocks.get() + count, magazine.blocks.get() + magazine.count, magazine.blocks.get());
+    magazine.count -= count;
+    cache.cachedBytes -= count * blockSize;
+    unreserve(count * blockSize);
+    return count * blockSize;
+}
+
+size_t MemoryManager::MemoryManagerPrivate::flushCaches(std::optional<MemoryPoolType> onlyPool, bool detach, bool exitedOnly) {
+    QMutexLocker locker(&cachesMutex);
+    size_t flushed = 0;
+
+    for (auto it = caches.begin(); it != caches.end();) {
+        // Only the registry still refers to the cache of a thread that exited
+        const bool exited = it->use_count() == 1;
+        if (exitedOnly && !exited) {
+            ++it;
+            continue;
+        }
+
+        const bool retire = detach || exited;
+        ThreadCache& cache = **it;
+        {
+            QMutexLocker cacheLocker(&cache.mutex);
+            for (size_t type = 0; type < POOL_TYPE_COUNT; ++type) {
+                MemoryPool* pool = poolSlots[type].load(std::memory_order_acquire);
+                if (!pool || (onlyPool && poolIndex(*onlyPool) != type && !retire)) {
+                    continue;
+                }
+                for (size_t sizeClass = 0; sizeClass < SlabAllocator::SIZE_CLASS_COUNT; ++sizeClass) {
+                    flushed += drain(cache, *pool, static_cast<int>(sizeClass), MAX_MAGAZINE_BLOCKS);
+                }
+            }
+
+            if (retire) {
+                cache.detached.store(true, std::memory_order_release);
+                for (size_t type = 0; type < POOL_TYPE_COUNT; ++type) {
+                    retiredCounters[type].add(cache.counters[type]);
+                    cache.counters[type] = PoolCounters();
+                }
+            }
+        }
+
+        it = retire ? caches.erase(it) : std::next(it);
+    }
+    return flushed;
+}
+
+PoolCounters MemoryManager::MemoryManagerPrivate::counters(std::optional<MemoryPoolType> onlyPool) {
+    QMutexLocker locker(&cachesMutex);
+    PoolCounters total;
+
+    for (size_t type = 0; type < POOL_TYPE_COUNT; ++type) {
+        if (onlyPool && poolIndex(*onlyPool) != type) {
+            continue;
+        }
+        total.add(retiredCounters[type]);
+        for (const auto& cache : caches) {
+            QMutexLocker cacheLocker(&cache->mutex);
+            total.add(cache->counters[type]);
+        }
+    }
+    return total;
+}
+
+void MemoryManager::MemoryManagerPrivate::dropTraces(const MemoryPool& pool) {
+    QMutexLocker locker(&traceMutex);
+    for (auto it = traces.begin(); it != traces.end();) {
+        it = pool.allocator->contains(it->first) ? traces.erase(it) : std::next(it);
+    }
+    traceCount.store(traces.size(), std::memory_order_relaxed);
+}
+
 MemoryManager::MemoryManager(QObject* parent)
     : QObject(parent)
     , d(std::make_unique<MemoryManagerPrivate>())
@@ -87,8 +384,8 @@ Expected<void, MemoryError> MemoryManager::initialize(size_t totalMemoryLimit) {
     }
 
     d->totalMemoryLimit = totalMemoryLimit;
-    d->currentUsage = 0;
-    d->peakUsage = 0;
+    d->heldBytes = 0;
+    d->peakHeldBytes = 0;
 
     // Create default pools
     auto pools = {
@@ -106,7 +403,7 @@ Expected<void, MemoryError> MemoryManager::initialize(size_t totalMemoryLimit) {
         if (poolType == MemoryPoolType::Large) {
             poolSize = totalMemoryLimit / 4; // Larger pool for large allocations
         }
-        
+
         auto result = createPool(poolType, poolSize);
         if (!result.hasValue()) {
             Logger::instance().warn("Failed to create pool for type {}", static_cast<int>(poolType));
@@ -125,52 +422,44 @@ Expected<void, MemoryError> MemoryManager::initialize(size_t totalMemoryLimit) {
 }
 
 Expected<void, MemoryError> MemoryManager::shutdown() {
+    // Final leak detection takes the locks itself
+    detectLeaks();
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->initialized) {
         return Expected<void, MemoryError>();
     }
 
+    d->initialized = false;
+
     // Stop timers
     d->gcTimer->stop();
     d->pressureTimer->stop();
     d->leakTimer->stop();
 
-    // Perform final leak detection
-    detectLeaks();
+    // Detached caches are dropped by their threads on next use
+    d->flushCaches(std::nullopt, true);
 
-    // Free all pools
+    // Free all pools; their regions go with the allocators
     for (auto& [type, pool] : d->pools) {
-        for (auto& [ptr, block] : pool->blocks) {
-            if (block->isActive) {
-                std::free(block->ptr);
-                emit memoryFreed(block->size, block->ptr);
-            }
-        }
-        pool->blocks.clear();
-        
-        if (pool->basePtr) {
-            std::free(pool->basePtr);
-        }
+        releasePoolBlocks(pool.get());
+        d->poolSlots[poolIndex(type)].store(nullptr, std::memory_order_release);
     }
 
     d->pools.clear();
-    d->pointerToPool.clear();
-    d->currentUsage = 0;
-    d->initialized = false;
+    d->retiredCounters.fill(PoolCounters());
+    d->heldBytes = 0;
 
     Logger::instance().info("MemoryManager shut down");
     return Expected<void, MemoryError>();
 }
 
 bool MemoryManager::isInitialized() const {
-    QMutexLocker locker(&d->mutex);
     return d->initialized;
 }
 
 Expected<void*, MemoryError> MemoryManager::allocate(size_t size, size_t alignment, MemoryPoolType poolType, const std::string& allocatedBy) {
-    QMutexLocker locker(&d->mutex);
-
     if (!d->initialized) {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
@@ -189,8 +478,6 @@ Expected<void*, MemoryError> MemoryManager::allocate(size_t size, size_t alignme
 }
 
 Expected<void, MemoryError> MemoryManager::deallocate(void* ptr) {
-    QMutexLocker locker(&d->mutex);
-
     if (!d->initialized) {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
@@ -199,30 +486,28 @@ Expected<void, MemoryError> MemoryManager::deallocate(void* ptr) {
         return Expected<void, MemoryError>();
     }
 
-    auto validation = validatePointer(ptr);
-    if (!validation.hasValue()) {
-        return makeUnexpected(validation.error());
-    }
-
     return internalDeallocate(ptr);
 }
 
 Expected<void*, MemoryError> MemoryManager::reallocate(void* ptr, size_t newSize, size_t alignment) {
-    QMutexLocker locker(&d->mutex);
-
     if (!d->initialized) {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
-    if (!ptr) {
-        return allocate(newSize, alignment);
-    }
-
     auto sizeValidation = validateSize(newSize);
     if (!sizeValidation.hasValue()) {
         return makeUnexpected(sizeValidation.error());
     }
 
+    auto alignmentValidation = validateAlignment(alignment);
+    if (!alignmentValidation.hasValue()) {
+        return makeUnexpected(alignmentValidation.error());
+    }
+
+    if (!ptr) {
+        return internalAllocate(newSize, alignment, MemoryPoolType::General, "");
+    }
+
     // Find the existing block
     auto poolResult = findPoolForPointer(ptr);
     if (!poolResult.hasValue()) {
@@ -230,16 +515,28 @@ Expected<void*, MemoryError> MemoryManager::reallocate(void* ptr, size_t newSize
     }
 
     auto pool = poolResult.value();
-    auto blockIt = pool->blocks.find(ptr);
-    if (blockIt == pool->blocks.end()) {
+    const size_t oldSize = pool->allocator->blockSize(ptr);
+    if (oldSize == 0) {
         return makeUnexpected(MemoryError::InvalidPointer);
     }
 
-    auto& block = blockIt->second;
-    size_t oldSize = block->size;
+    // A request that rounds to the same size class stays where it is
+    if (SlabAllocator::roundedSize(newSize, alignment) == oldSize &&
+        reinterpret_cast<quintptr>(ptr) % alignment == 0) {
+        return ptr;
+    }
+
+    std::string allocatedBy;
+    if (d->traceCount.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker traceLocker(&d->traceMutex);
+        auto trace = d->traces.find(ptr);
+        if (trace != d->traces.end()) {
+            allocatedBy = trace->second.allocatedBy;
+        }
+    }
 
     // Allocate new block
-    auto newPtr = internalAllocate(newSize, alignment, pool->type, block->allocatedBy);
+    auto newPtr = internalAllocate(newSize, alignment, pool->type, allocatedBy);
     if (!newPtr.hasValue()) {
         return makeUnexpected(newPtr.error());
     }
@@ -271,6 +568,17 @@ Expected<void, MemoryError> MemoryManager::createPool(MemoryPoolType type, size_
         return makeUnexpected(alignmentValidation.error());
     }
 
+    // Replacing a pool releases everything allocated from the old one
+    if (d->pools.count(type)) {
+        destroyPool(type);
+    }
+
+    auto allocator = std::make_unique<SlabAllocator>(size);
+    if (!allocator->isValid()) {
+        return makeUnexpected(MemoryError::InitializationFailed);
+    }
+    allocator->setLimit(size);
+
     auto pool = std::make_unique<MemoryPool>();
     pool->type = type;
     pool->totalSize = size;
@@ -278,11 +586,13 @@ Expected<void, MemoryError> MemoryManager::createPool(MemoryPoolType type, size_
     pool->availableSize = size;
     pool->blockCount = 0;
     pool->maxBlockSize = size / 2; // Max block is half the pool size
-    pool->basePtr = nullptr;
+    pool->basePtr = allocator->base();
+    pool->allocator = std::move(allocator);
     pool->isActive = true;
     pool->alignment = alignment;
     pool->createdAt = std::chrono::steady_clock::now();
 
+    d->poolSlots[poolIndex(type)].store(pool.get(), std::memory_order_release);
     d->pools[type] = std::move(pool);
     d->stats.poolCount++;
 
@@ -297,24 +607,9 @@ Expected<void, MemoryError> MemoryManager::destroyPool(MemoryPoolType type) {
         return makeUnexpected(MemoryError::InvalidPointer);
     }
 
-    auto& pool = it->second;
-    
-    // Free all blocks in the pool
-    for (auto& [ptr, block] : pool->blocks) {
-        if (block->isActive) {
-            std::free(block->ptr);
-            emit memoryFreed(block->size, block->ptr);
-        }
-    }
-
-    // Remove pointer mappings
-    for (auto& [ptr, block] : pool->blocks) {
-        d->pointerToPool.erase(ptr);
-    }
-
-    if (pool->basePtr) {
-        std::free(pool->basePtr);
-    }
+    // Free all blocks in the pool; the region goes with the allocator
+    releasePoolBlocks(it->second.get());
+    d->poolSlots[poolIndex(type)].store(nullptr, std::memory_order_release);
 
     d->pools.erase(it);
     d->stats.poolCount--;
@@ -331,11 +626,33 @@ Expected<void, MemoryError> MemoryManager::resizePool(MemoryPoolType type, size_
     }
 
     auto pool = poolResult.value();
-    
+
+    // Blocks cached by threads would otherwise count against the new size
+    d->flushCaches(type, false);
+    QMutexLocker poolLocker(&pool->mutex);
+
     if (newSize < pool->usedSize) {
         return makeUnexpected(MemoryError::InvalidSize);
     }
 
+    // The region cannot move while blocks live in it, so an occupied pool
+    // can only grow up to the region it reserved
+    if (newSize > pool->allocator->capacity()) {
+        if (pool->allocator->heldBlocks() > 0) {
+            Logger::instance().warn("Cannot grow memory pool type {} beyond its region while blocks are live",
+                                    static_cast<int>(type));
+            return makeUnexpected(MemoryError::PoolExhausted);
+        }
+
+        auto allocator = std::make_unique<SlabAllocator>(newSize);
+        if (!allocator->isValid()) {
+            return makeUnexpected(MemoryError::AllocationFailed);
+        }
+        pool->basePtr = allocator->base();
+        pool->allocator = std::move(allocator);
+    }
+
+    pool->allocator->setLimit(newSize);
     pool->totalSize = newSize;
     pool->availableSize = newSize - pool->usedSize;
     pool->maxBlockSize = newSize / 2;
@@ -350,21 +667,7 @@ Expected<void, MemoryError> MemoryManager::clearPool(MemoryPoolType type) {
         return makeUnexpected(poolResult.error());
     }
 
-    auto pool = poolResult.value();
-    
-    // Free all blocks
-    for (auto& [ptr, block] : pool->blocks) {
-        if (block->isActive) {
-            std::free(block->ptr);
-            emit memoryFreed(block->size, block->ptr);
-        }
-        d->pointerToPool.erase(ptr);
-    }
-
-    pool->blocks.clear();
-    pool->usedSize = 0;
-    pool->availableSize = pool->totalSize;
-    pool->blockCount = 0;
+    releasePoolBlocks(poolResult.value());
 
     Logger::instance().info("Cleared memory pool type {}", static_cast<int>(type));
     return Expected<void, MemoryError>();
@@ -427,31 +730,33 @@ Expected<void, MemoryError> MemoryManager::garbageCollect() {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
-    size_t freedBytes = 0;
-    auto maxAge = std::chrono::seconds(300); // 5 minutes
+    // Blocks cached by threads that have since exited go back first
+    size_t freedBytes = d->flushCaches(std::nullopt, false, true);
 
-    auto cleanupResult = cleanupUnusedBlocks(maxAge);
+    // Live blocks are never touched; only slabs that stayed empty for a
+    // whole collection interval are returned to their pool
+    auto cleanupResult = cleanupUnusedBlocks(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::milliseconds(d->garbageCollectionInterval)));
     if (cleanupResult.hasValue()) {
-        freedBytes = cleanupResult.value();
+        freedBytes += cleanupResult.value();
     }
 
-    // Compact memory
-    compactMemory();
-
     Logger::instance().info("Garbage collection completed, freed {} bytes", freedBytes);
     emit garbageCollectionCompleted(freedBytes);
     return Expected<void, MemoryError>();
 }
 
 Expected<void, MemoryError> MemoryManager::compactMemory() {
+    QMutexLocker locker(&d->mutex);
     size_t compactedBytes = 0;
 
-    // Defragment all pools
+    // Blocks never move, and free page runs are coalesced as they are
+    // released, so compaction empties the thread caches and returns every
+    // empty slab
+    d->flushCaches(std::nullopt, false);
     for (auto& [type, pool] : d->pools) {
-        auto result = defragmentPool(type);
-        if (result.hasValue()) {
-            compactedBytes += pool->totalSize - pool->usedSize;
-        }
+        QMutexLocker poolLocker(&pool->mutex);
+        compactedBytes += pool->allocator->releaseEmptySlabs(std::chrono::steady_clock::duration::zero());
     }
 
     Logger::instance().info("Memory compaction completed, compacted {} bytes", compactedBytes);
@@ -460,56 +765,29 @@ Expected<void, MemoryError> MemoryManager::compactMemory() {
 }
 
 Expected<void, MemoryError> MemoryManager::defragmentPool(MemoryPoolType type) {
+    QMutexLocker locker(&d->mutex);
+
     auto poolResult = findPool(type);
     if (!poolResult.hasValue()) {
         return makeUnexpected(poolResult.error());
     }
 
     auto pool = poolResult.value();
-    
-    // Simple defragmentation - move active blocks to the beginning
-    std::vector<std::pair<void*, std::unique_ptr<MemoryBlock>>> activeBlocks;
-    
-    for (auto& [ptr, block] : pool->blocks) {
-        if (block->isActive) {
-            activeBlocks.emplace_back(ptr, std::move(block));
-        }
-    }
+    d->flushCaches(type, false);
 
-    pool->blocks.clear();
-    
-    // Reinsert active blocks
-    for (auto& [ptr, block] : activeBlocks) {
-        pool->blocks[ptr] = std::move(block);
-    }
+    QMutexLocker poolLocker(&pool->mutex);
+    const size_t released = pool->allocator->releaseEmptySlabs(std::chrono::steady_clock::duration::zero());
 
-    Logger::instance().info("Defragmented memory pool type {}", static_cast<int>(type));
+    Logger::instance().info("Defragmented memory pool type {}, released {} bytes", static_cast<int>(type), released);
     return Expected<void, MemoryError>();
 }
 
 Expected<size_t, MemoryError> MemoryManager::cleanupUnusedBlocks(std::chrono::seconds maxAge) {
     size_t freedBytes = 0;
-    auto now = std::chrono::steady_clock::now();
 
     for (auto& [type, pool] : d->pools) {
-        std::vector<void*> blocksToRemove;
-        
-        for (auto& [ptr, block] : pool->blocks) {
-            if (block->isActive && (now - block->allocatedAt) > maxAge) {
-                blocksToRemove.push_back(ptr);
-            }
-        }
-
-        for (void* ptr : blocksToRemove) {
-            auto blockIt = pool->blocks.find(ptr);
-            if (blockIt != pool->blocks.end()) {
-                freedBytes += blockIt->second->size;
-                std::free(blockIt->second->ptr);
-                pool->blocks.erase(blockIt);
-                d->pointerToPool.erase(ptr);
-                emit memoryFreed(blockIt->second->size, ptr);
-            }
-        }
+        QMutexLocker poolLocker(&pool->mutex);
+        freedBytes += pool->allocator->releaseEmptySlabs(maxAge);
     }
 
     return freedBytes;
@@ -522,6 +800,17 @@ Expected<MemoryStats, MemoryError> MemoryManager::getStats() const {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
+    // Counters are kept per thread and only merged here
+    const PoolCounters counters = d->counters(std::nullopt);
+    d->stats.totalAllocated = counters.allocatedBytes;
+    d->stats.totalFreed = counters.freedBytes;
+    d->stats.allocationCount = counters.allocationCount;
+    d->stats.freeCount = counters.freeCount;
+    d->stats.currentUsage = counters.allocatedBytes - counters.freedBytes;
+    d->stats.activeBlocks = counters.allocationCount - counters.freeCount;
+    d->stats.peakUsage = d->peakHeldBytes.load(std::memory_order_relaxed);
+
+    calculateFragmentation();
     return d->stats;
 }
 
@@ -538,14 +827,26 @@ Expected<MemoryStats, MemoryError> MemoryManager::getPoolStats(MemoryPoolType ty
     }
 
     const auto& pool = it->second;
-    
-    MemoryStats stats;
+    const PoolCounters counters = d->counters(type);
+
+    MemoryStats stats{};
     stats.totalAllocated = pool->totalSize;
-    stats.currentUsage = pool->usedSize;
-    stats.activeBlocks = pool->blockCount;
+    stats.totalFreed = counters.freedBytes;
+    stats.currentUsage = counters.allocatedBytes - counters.freedBytes;
+    stats.allocationCount = counters.allocationCount;
+    stats.freeCount = counters.freeCount;
+    stats.activeBlocks = counters.allocationCount - counters.freeCount;
     stats.poolCount = 1;
-    // Calculate other stats based on pool data
-    
+    stats.lastReset = d->stats.lastReset;
+
+    // Bytes taken from the pool, including blocks sitting in thread caches
+    QMutexLocker poolLocker(&pool->mutex);
+    const size_t freeBytes = pool->allocator->freeBytes();
+    stats.peakUsage = pool->usedSize;
+    stats.largestFreeBlock = pool->allocator->largestFreeRun();
+    stats.smallestFreeBlock = pool->allocator->smallestFreeRun();
+    stats.fragmentationRatio = freeBytes > 0 ? 1.0 - static_cast<double>(stats.largestFreeBlock) / freeBytes : 0.0;
+
     return stats;
 }
 
@@ -557,13 +858,15 @@ Expected<std::vector<MemoryBlock>, MemoryError> MemoryManager::getActiveBlocks()
     }
 
     std::vector<MemoryBlock> blocks;
-    
+
+    // Blocks cached by threads are not live and are not listed
     for (const auto& [type, pool] : d->pools) {
-        for (const auto& [ptr, block] : pool->blocks) {
-            if (block->isActive) {
-                blocks.push_back(*block);
-            }
-        }
+        QMutexLocker poolLocker(&pool->mutex);
+        QMutexLocker traceLocker(&d->traceMutex);
+        pool->allocator->forEachBlock([&](void* ptr, size_t size) {
+            auto trace = d->traces.find(ptr);
+            blocks.push_back(describeBlock(*pool, ptr, size, trace != d->traces.end() ? &trace->second : nullptr));
+        });
     }
 
     return blocks;
@@ -582,12 +885,14 @@ Expected<std::vector<MemoryBlock>, MemoryError> MemoryManager::getPoolBlocks(Mem
     }
 
     std::vector<MemoryBlock> blocks;
-    
-    for (const auto& [ptr, block] : it->second->blocks) {
-        if (block->isActive) {
-            blocks.push_back(*block);
-        }
-    }
+    const MemoryPool& pool = *it->second;
+
+    QMutexLocker poolLocker(&pool.mutex);
+    QMutexLocker traceLocker(&d->traceMutex);
+    pool.allocator->forEachBlock([&](void* ptr, size_t size) {
+        auto trace = d->traces.find(ptr);
+        blocks.push_back(describeBlock(pool, ptr, size, trace != d->traces.end() ? &trace->second : nullptr));
+    });
 
     return blocks;
 }
@@ -599,13 +904,12 @@ Expected<void, MemoryError> MemoryManager::setMemoryLimit(size_t limit) {
         return makeUnexpected(MemoryError::InvalidSize);
     }
 
-    if (limit < d->currentUsage) {
+    if (limit < d->heldBytes.load(std::memory_order_relaxed)) {
         return makeUnexpected(MemoryError::InvalidSize);
     }
 
     d->totalMemoryLimit = limit;
-    d->stats.totalAllocated = limit;
-    
+
     return Expected<void, MemoryError>();
 }
 
@@ -645,7 +949,6 @@ Expected<void, MemoryError> MemoryManager::setMemoryPressureThreshold(double thr
 }
 
 Expected<void, MemoryError> MemoryManager::setDebugMode(bool enabled) {
-    QMutexLocker locker(&d->mutex);
     d->debugMode = enabled;
     return Expected<void, MemoryError>();
 }
@@ -657,22 +960,21 @@ Expected<void, MemoryError> MemoryManager::validateMemory() {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
+    // The allocator tables only add up with no blocks sitting in caches
+    d->flushCaches(std::nullopt, false);
+
     // Validate all pools
     for (const auto& [type, pool] : d->pools) {
+        QMutexLocker poolLocker(&pool->mutex);
         auto poolValidation = validatePool(pool.get());
         if (!poolValidation.hasValue()) {
             return poolValidation;
         }
 
-        // Validate all blocks in the pool
-        for (const auto& [ptr, block] : pool->blocks) {
-            if (block->isActive) {
-                auto checksumValid = verifyChecksum(*block);
-                if (!checksumValid.hasValue() || !checksumValid.value()) {
-                    Logger::instance().error("Memory corruption detected in block at {}", ptr);
-                    return makeUnexpected(MemoryError::InvalidPointer);
-                }
-            }
+        // Cross-check the allocator's side tables
+        if (!pool->allocator->validate()) {
+            Logger::instance().error("Memory corruption detected in pool type {}", static_cast<int>(type));
+            return makeUnexpected(MemoryError::InvalidPointer);
         }
     }
 
@@ -691,14 +993,30 @@ Expected<void, MemoryError> MemoryManager::detectLeaks() {
     auto now = std::chrono::steady_clock::now();
     auto leakThreshold = std::chrono::minutes(30); // Consider blocks older than 30 minutes as potential leaks
 
-    for (const auto& [type, pool] : d->pools) {
-        for (const auto& [ptr, block] : pool->blocks) {
-            if (block->isActive && (now - block->allocatedAt) > leakThreshold) {
-                leakedBlocks.push_back(*block);
+    // Block ages are only known for blocks allocated in debug mode
+    std::vector<std::pair<void*, AllocationTrace>> candidates;
+    {
+        QMutexLocker traceLocker(&d->traceMutex);
+        for (const auto& [ptr, trace] : d->traces) {
+            if ((now - trace.allocatedAt) > leakThreshold) {
+                candidates.emplace_back(ptr, trace);
             }
         }
     }
 
+    for (const auto& [ptr, trace] : candidates) {
+        auto pool = findPoolForPointer(ptr);
+        if (!pool.hasValue()) {
+            continue;
+        }
+
+        QMutexLocker poolLocker(&pool.value()->mutex);
+        const size_t size = pool.value()->allocator->blockSize(ptr);
+        if (size > 0) {
+            leakedBlocks.push_back(describeBlock(*pool.value(), ptr, size, &trace));
+        }
+    }
+
     if (!leakedBlocks.empty()) {
         size_t totalLeakedSize = 0;
         for (const auto& block : leakedBlocks) {
@@ -706,7 +1024,7 @@ Expected<void, MemoryError> MemoryManager::detectLeaks() {
             emit memoryLeakDetected(block.size, QString::fromStdString(block.allocatedBy));
         }
 
-        Logger::instance().warn("Detected {} potential memory leaks, total size: {} bytes", 
+        Logger::instance().warn("Detected {} potential memory leaks, total size: {} bytes",
                                  leakedBlocks.size(), totalLeakedSize);
 
         if (d->leakCallback) {
@@ -729,29 +1047,38 @@ Expected<void, MemoryError> MemoryManager::dumpMemoryMap(const QString& filePath
         return makeUnexpected(MemoryError::AllocationFailed);
     }
 
+    const PoolCounters counters = d->counters(std::nullopt);
+
     QTextStream stream(&file);
     stream << "Memory Map Dump\n";
     stream << "===============\n\n";
 
-    stream << "Total Memory Limit: " << d->totalMemoryLimit << " bytes\n";
-    stream << "Current Usage: " << d->currentUsage << " bytes\n";
-    stream << "Peak Usage: " << d->peakUsage << " bytes\n";
+    stream << "Total Memory Limit: " << d->totalMemoryLimit.load() << " bytes\n";
+    stream << "Current Usage: " << counters.allocatedBytes - counters.freedBytes << " bytes\n";
+    stream << "Held By Pools: " << d->heldBytes.load() << " bytes\n";
+    stream << "Peak Usage: " << d->peakHeldBytes.load() << " bytes\n";
     stream << "Active Pools: " << d->pools.size() << "\n\n";
 
     for (const auto& [type, pool] : d->pools) {
+        QMutexLocker poolLocker(&pool->mutex);
         stream << "Pool Type: " << static_cast<int>(type) << "\n";
         stream << "  Total Size: " << pool->totalSize << " bytes\n";
         stream << "  Used Size: " << pool->usedSize << " bytes\n";
         stream << "  Available Size: " << pool->availableSize << " bytes\n";
         stream << "  Block Count: " << pool->blockCount << "\n";
+        stream << "  Committed Size: " << pool->allocator->committedBytes() << " bytes\n";
+        stream << "  Largest Free Run: " << pool->allocator->largestFreeRun() << " bytes\n";
         stream << "  Active Blocks:\n";
 
-        for (const auto& [ptr, block] : pool->blocks) {
-            if (block->isActive) {
-                stream << "    " << ptr << " - " << block->size << " bytes"
-                       << " (allocated by: " << QString::fromStdString(block->allocatedBy) << ")\n";
+        QMutexLocker traceLocker(&d->traceMutex);
+        pool->allocator->forEachBlock([&](void* ptr, size_t size) {
+            auto trace = d->traces.find(ptr);
+            stream << "    " << ptr << " - " << size << " bytes";
+            if (trace != d->traces.end()) {
+                stream << " (allocated by: " << QString::fromStdString(trace->second.allocatedBy) << ")";
             }
-        }
+            stream << "\n";
+        });
         stream << "\n";
     }
 
@@ -766,6 +1093,7 @@ Expected<double, MemoryError> MemoryManager::getFragmentationRatio() const {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
+    calculateFragmentation();
     return d->stats.fragmentationRatio;
 }
 
@@ -776,6 +1104,7 @@ Expected<size_t, MemoryError> MemoryManager::getLargestFreeBlock() const {
         return makeUnexpected(MemoryError::InitializationFailed);
     }
 
+    calculateFragmentation();
     return d->stats.largestFreeBlock;
 }
 
@@ -807,59 +1136,101 @@ void MemoryManager::performLeakDetection() {
 }
 
 Expected<void*, MemoryError> MemoryManager::internalAllocate(size_t size, size_t alignment, MemoryPoolType poolType, const std::string& allocatedBy) {
-    if (d->currentUsage + size > d->totalMemoryLimit) {
-        if (d->oomCallback) {
-            d->oomCallback(size);
-        }
-        emit outOfMemory(size);
-        return makeUnexpected(MemoryError::OutOfMemory);
-    }
-
-    auto poolResult = findPool(poolType);
-    if (!poolResult.hasValue()) {
-        return makeUnexpected(poolResult.error());
+    MemoryPool* pool = d->poolFor(poolType);
+    if (!pool) {
+        return makeUnexpected(MemoryError::InvalidPointer);
     }
 
-    auto pool = poolResult.value();
-    
-    if (pool->usedSize + size > pool->totalSize) {
-        return makeUnexpected(MemoryError::PoolExhausted);
-    }
+    const size_t blockSize = SlabAllocator::roundedSize(size, alignment);
+    const int sizeClass = SlabAllocator::sizeClassFor(size, alignment);
 
-    // Allocate memory
     void* ptr = nullptr;
-    if (alignment > 1) {
-        ptr = std::aligned_alloc(alignment, size);
-    } else {
-        ptr = std::malloc(size);
-    }
+    size_t takenBytes = 0;
+    std::optional<MemoryError> error;
+
+    for (bool retried = false;; retried = true) {
+        {
+            auto cache = d->threadCache();
+            QMutexLocker cacheLocker(&cache->mutex);
+            if (cache->detached.load(std::memory_order_relaxed)) {
+                return makeUnexpected(MemoryError::InitializationFailed);
+            }
 
-    if (!ptr) {
-        return makeUnexpected(MemoryError::AllocationFailed);
-    }
+            if (sizeClass >= 0) {
+                // Small blocks come from this thread's magazine; only a refill
+                // touches the pool
+                Magazine& magazine = cache->magazines[poolIndex(poolType)][sizeClass];
+                if (magazine.count == 0) {
+                    MemoryError refillError = MemoryError::AllocationFailed;
+                    takenBytes = d->refill(*cache, *pool, sizeClass, refillError);
+                    if (takenBytes == 0) {
+                        error = refillError;
+                    }
+                }
+                if (!error) {
+                    ptr = magazine.blocks[--magazine.count];
+                    cache->cachedBytes -= blockSize;
+                }
+            } else if (!d->reserve(blockSize)) {
+                error = MemoryError::OutOfMemory;
+            } else {
+                QMutexLocker poolLocker(&pool->mutex);
+                ptr = pool->allocator->acquire(size, alignment);
+                if (ptr) {
+                    pool->usedSize += blockSize;
+                    pool->blockCount++;
+                    updateAvailable(*pool);
+                    takenBytes = blockSize;
+                } else {
+                    d->unreserve(blockSize);
+                    error = MemoryError::PoolExhausted;
+                }
+            }
+
+            if (ptr) {
+                PoolCounters& counters = cache->counters[poolIndex(poolType)];
+                counters.allocatedBytes += blockSize;
+                counters.allocationCount++;
+            }
+        }
+
+        if (!error || retried) {
+            break;
+        }
 
-    // Add block to pool
-    auto addResult = addBlock(pool, ptr, size, alignment, allocatedBy);
-    if (!addResult.hasValue()) {
-        std::free(ptr);
-        return makeUnexpected(addResult.error());
+        // The free blocks may all sit in other threads' caches; take them
+        // back and try once more
+        const bool exhausted = *error == MemoryError::PoolExhausted;
+        d->flushCaches(exhausted ? std::optional<MemoryPoolType>(poolType) : std::nullopt, false);
+        error.reset();
     }
 
-    // Update stats
-    updateStats(pool, size, true);
-    
-    d->currentUsage += size;
-    if (d->currentUsage > d->peakUsage) {
-        d->peakUsage = d->currentUsage;
+    // Callbacks and signals run with no allocator lock held
+    if (error) {
+        if (*error == MemoryError::OutOfMemory) {
+            if (d->oomCallback) {
+                d->oomCallback(size);
+            }
+            emit outOfMemory(size);
+        }
+        return makeUnexpected(*error);
     }
 
-    d->pointerToPool[ptr] = poolType;
+    pool->allocator->markLive(ptr);
 
-    if (d->debugMode) {
-        logAllocation(ptr, size, allocatedBy);
+    if (d->debugMode.load(std::memory_order_relaxed)) {
+        {
+            QMutexLocker traceLocker(&d->traceMutex);
+            d->traces[ptr] = AllocationTrace{allocatedBy, size, alignment, std::chrono::steady_clock::now()};
+            d->traceCount.store(d->traces.size(), std::memory_order_relaxed);
+        }
+        logAllocation(ptr, blockSize, allocatedBy);
     }
 
-    emit memoryAllocated(size, ptr);
+    // Reported once per batch taken from the pool
+    if (takenBytes > 0) {
+        emit memoryAllocated(takenBytes, ptr);
+    }
     return ptr;
 }
 
@@ -869,36 +1240,65 @@ Expected<void, MemoryError> MemoryManager::internalDeallocate(void* ptr) {
         return makeUnexpected(MemoryError::InvalidPointer);
     }
 
+    // Inside a pool region but not the start of a live block. Clearing the
+    // live bit is atomic, so of two racing frees of a block only one passes
     auto pool = poolResult.value();
-    auto blockIt = pool->blocks.find(ptr);
-    if (blockIt == pool->blocks.end()) {
-        return makeUnexpected(MemoryError::InvalidPointer);
+    if (!pool->allocator->clearLive(ptr)) {
+        return makeUnexpected(MemoryError::DoubleFreePrevention);
     }
 
-    auto& block = blockIt->second;
-    if (!block->isActive) {
-        return makeUnexpected(MemoryError::DoubleFreePrevention);
+    const int sizeClass = pool->allocator->blockClass(ptr);
+    size_t size = 0;
+    size_t returnedBytes = 0;
+
+    {
+        auto cache = d->threadCache();
+        QMutexLocker cacheLocker(&cache->mutex);
+
+        if (sizeClass >= 0 && !cache->detached.load(std::memory_order_relaxed)) {
+            size = SlabAllocator::classSize(sizeClass);
+            Magazine& magazine = cache->magazines[poolIndex(pool->type)][sizeClass];
+            const size_t capacity = magazineCapacity(sizeClass);
+            if (!magazine.blocks) {
+                magazine.blocks = std::make_unique<void*[]>(capacity);
+            }
+
+            // A full magazine, or a thread over its cache budget, hands half
+            // the magazine back to the pool in one batch
+            if (magazine.count == capacity || cache->cachedBytes + size > THREAD_CACHE_BYTES) {
+                returnedBytes = d->drain(*cache, *pool, sizeClass, std::max<size_t>(1, magazine.count / 2));
+            }
+            magazine.blocks[magazine.count++] = ptr;
+            cache->cachedBytes += size;
+        } else {
+            QMutexLocker poolLocker(&pool->mutex);
+            size = pool->allocator->release(ptr);
+            pool->usedSize -= size;
+            pool->blockCount--;
+            updateAvailable(*pool);
+            d->unreserve(size);
+            returnedBytes = size;
+        }
+
+        PoolCounters& counters = cache->counters[poolIndex(pool->type)];
+        counters.freedBytes += size;
+        counters.freeCount++;
+    }
+
+    if (d->traceCount.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker traceLocker(&d->traceMutex);
+        d->traces.erase(ptr);
+        d->traceCount.store(d->traces.size(), std::memory_order_relaxed);
     }
 
-    size_t size = block->size;
-    
-    // Free memory
-    std::free(ptr);
-    
-    // Remove block from pool
-    removeBlock(pool, ptr);
-    
-    // Update stats
-    updateStats(pool, size, false);
-    
-    d->currentUsage -= size;
-    d->pointerToPool.erase(ptr);
-
-    if (d->debugMode) {
+    if (d->debugMode.load(std::memory_order_relaxed)) {
         logDeallocation(ptr, size);
     }
 
-    emit memoryFreed(size, ptr);
+    // Reported once per batch returned to the pool
+    if (returnedBytes > 0) {
+        emit memoryFreed(returnedBytes, ptr);
+    }
     return Expected<void, MemoryError>();
 }
 
@@ -910,73 +1310,48 @@ Expected<MemoryPool*, MemoryError> MemoryManager::findPool(MemoryPoolType type)
     return it->second.get();
 }
 
-Expected<MemoryPool*, MemoryError> MemoryManager::findPoolForPointer(void* ptr) {
-    auto it = d->pointerToPool.find(ptr);
-    if (it == d->pointerToPool.end()) {
-        return makeUnexpected(MemoryError::InvalidPointer);
+Expected<MemoryPool*, MemoryError> MemoryManager::findPoolForPointer(const void* ptr) const {
+    // Pools own disjoint regions, so a range check identifies the pool
+    for (const auto& slot : d->poolSlots) {
+        MemoryPool* pool = slot.load(std::memory_order_acquire);
+        if (pool && pool->allocator->contains(ptr)) {
+            return pool;
+        }
     }
-    return findPool(it->second);
+    return makeUnexpected(MemoryError::InvalidPointer);
 }
 
-Expected<void, MemoryError> MemoryManager::addBlock(MemoryPool* pool, void* ptr, size_t size, size_t alignment, const std::string& allocatedBy) {
-    auto block = std::make_unique<MemoryBlock>();
-    block->ptr = ptr;
-    block->size = size;
-    block->alignment = alignment;
-    block->poolType = pool->type;
-    block->allocatedAt = std::chrono::steady_clock::now();
-    block->allocatedBy = allocatedBy;
-    block->isActive = true;
-    block->requestedSize = size;
-
-    // Calculate checksum
-    auto checksum = calculateChecksum(ptr, size);
-    if (checksum.hasValue()) {
-        block->checksum = checksum.value();
-    }
-
-    pool->blocks[ptr] = std::move(block);
-    pool->blockCount++;
-    pool->usedSize += size;
-    pool->availableSize -= size;
+Expected<void, MemoryError> MemoryManager::releasePoolBlocks(MemoryPool* pool) {
+    d->flushCaches(pool->type, false);
 
-    return Expected<void, MemoryError>();
-}
+    size_t liveBytes = 0;
+    size_t liveBlocks = 0;
+    {
+        QMutexLocker poolLocker(&pool->mutex);
+        pool->allocator->forEachBlock([&](void*, size_t size) {
+            liveBytes += size;
+            liveBlocks++;
+        });
 
-Expected<void, MemoryError> MemoryManager::removeBlock(MemoryPool* pool, void* ptr) {
-    auto it = pool->blocks.find(ptr);
-    if (it == pool->blocks.end()) {
-        return makeUnexpected(MemoryError::InvalidPointer);
+        d->unreserve(pool->allocator->heldBytes());
+        pool->allocator->reset();
+        pool->usedSize = 0;
+        pool->availableSize = pool->totalSize;
+        pool->blockCount = 0;
     }
 
-    size_t size = it->second->size;
-    pool->blocks.erase(it);
-    pool->blockCount--;
-    pool->usedSize -= size;
-    pool->availableSize += size;
-
-    return Expected<void, MemoryError>();
-}
-
-Expected<void, MemoryError> MemoryManager::updateStats(MemoryPool* pool, size_t size, bool isAllocation) {
-    if (isAllocation) {
-        d->stats.totalAllocated += size;
-        d->stats.allocationCount++;
-        d->stats.activeBlocks++;
-    } else {
-        d->stats.totalFreed += size;
-        d->stats.freeCount++;
-        d->stats.activeBlocks--;
+    // Blocks still live when the pool is released count as freed
+    {
+        QMutexLocker cachesLocker(&d->cachesMutex);
+        PoolCounters& counters = d->retiredCounters[poolIndex(pool->type)];
+        counters.freedBytes += liveBytes;
+        counters.freeCount += liveBlocks;
     }
+    d->dropTraces(*pool);
 
-    d->stats.currentUsage = d->currentUsage;
-    if (d->currentUsage > d->stats.peakUsage) {
-        d->stats.peakUsage = d->currentUsage;
+    if (liveBytes > 0) {
+        emit memoryFreed(liveBytes, pool->basePtr);
     }
-
-    // Update fragmentation ratio
-    calculateFragmentation();
-    
     return Expected<void, MemoryError>();
 }
 
@@ -985,8 +1360,8 @@ Expected<void, MemoryError> MemoryManager::validatePointer(void* ptr) const {
         return makeUnexpected(MemoryError::InvalidPointer);
     }
 
-    auto it = d->pointerToPool.find(ptr);
-    if (it == d->pointerToPool.end()) {
+    auto isValid = isPointerValid(ptr);
+    if (!isValid.hasValue() || !isValid.value()) {
         return makeUnexpected(MemoryError::InvalidPointer);
     }
 
@@ -998,7 +1373,7 @@ Expected<void, MemoryError> MemoryManager::validateSize(size_t size) const {
         return makeUnexpected(MemoryError::InvalidSize);
     }
 
-    if (size > d->totalMemoryLimit) {
+    if (size > d->totalMemoryLimit.load(std::memory_order_relaxed)) {
         return makeUnexpected(MemoryError::InvalidSize);
     }
 
@@ -1010,6 +1385,11 @@ Expected<void, MemoryError> MemoryManager::validateAlignment(size_t alignment) c
         return makeUnexpected(MemoryError::InvalidAlignment);
     }
 
+    // Large blocks are page runs, so their alignment is capped at a page
+    if (alignment > SlabAllocator::MAX_ALIGNMENT) {
+        return makeUnexpected(MemoryError::InvalidAlignment);
+    }
+
     return Expected<void, MemoryError>();
 }
 
@@ -1029,26 +1409,29 @@ Expected<void, MemoryError> MemoryManager::validatePool(const MemoryPool* pool)
     return Expected<void, MemoryError>();
 }
 
-Expected<void, MemoryError> MemoryManager::calculateFragmentation() {
+Expected<void, MemoryError> MemoryManager::calculateFragmentation() const {
     size_t totalFree = 0;
+    size_t usableFree = 0;
     size_t largestFree = 0;
     size_t smallestFree = SIZE_MAX;
 
+    // Free memory is only fragmented within a pool; each pool's largest
+    // free run is what a single request could still get from it
     for (const auto& [type, pool] : d->pools) {
-        size_t poolFree = pool->availableSize;
-        totalFree += poolFree;
-        
-        if (poolFree > largestFree) {
-            largestFree = poolFree;
-        }
-        
-        if (poolFree < smallestFree && poolFree > 0) {
-            smallestFree = poolFree;
+        QMutexLocker poolLocker(&pool->mutex);
+        const size_t poolLargest = pool->allocator->largestFreeRun();
+        const size_t poolSmallest = pool->allocator->smallestFreeRun();
+        totalFree += pool->allocator->freeBytes();
+        usableFree += poolLargest;
+        largestFree = std::max(largestFree, poolLargest);
+
+        if (poolSmallest < smallestFree && poolSmallest > 0) {
+            smallestFree = poolSmallest;
         }
     }
 
     if (totalFree > 0) {
-        d->stats.fragmentationRatio = 1.0 - (static_cast<double>(largestFree) / totalFree);
+        d->stats.fragmentationRatio = 1.0 - (static_cast<double>(usableFree) / totalFree);
     } else {
         d->stats.fragmentationRatio = 0.0;
     }
@@ -1060,8 +1443,8 @@ Expected<void, MemoryError> MemoryManager::calculateFragmentation() {
 }
 
 Expected<void, MemoryError> MemoryManager::updatePressure() {
-    double pressure = static_cast<double>(d->currentUsage) / d->totalMemoryLimit;
-    
+    double pressure = static_cast<double>(d->heldBytes.load(std::memory_order_relaxed)) / d->totalMemoryLimit.load();
+
     if (pressure > d->memoryPressureThreshold) {
         if (d->pressureCallback) {
             d->pressureCallback(pressure);
@@ -1077,29 +1460,8 @@ Expected<size_t, MemoryError> MemoryManager::alignSize(size_t size, size_t align
 }
 
 Expected<bool, MemoryError> MemoryManager::isPointerValid(void* ptr) const {
-    return d->pointerToPool.find(ptr) != d->pointerToPool.end();
-}
-
-Expected<QByteArray, MemoryError> MemoryManager::calculateChecksum(void* ptr, size_t size) const {
-    if (!ptr || size == 0) {
-        return makeUnexpected(MemoryError::InvalidPointer);
-    }
-
-    QByteArray data(static_cast<const char*>(ptr), static_cast<qsizetype>(size));
-    return QCryptographicHash::hash(data, QCryptographicHash::Md5);
-}
-
-Expected<bool, MemoryError> MemoryManager::verifyChecksum(const MemoryBlock& block) const {
-    if (!block.ptr || block.size == 0) {
-        return false;
-    }
-
-    auto currentChecksum = calculateChecksum(block.ptr, block.size);
-    if (!currentChecksum.hasValue()) {
-        return false;
-    }
-
-    return currentChecksum.value() == block.checksum;
+    auto pool = findPoolForPointer(ptr);
+    return pool.hasValue() && pool.value()->allocator->blockSize(ptr) > 0;
 }
 
 Expected<void, MemoryError> MemoryManager::logAllocation(void* ptr, size_t size, const std::string& allocatedBy) {
@@ -1113,10 +1475,9 @@ Expected<void, MemoryError> MemoryManager::logDeallocation(void* ptr, size_t siz
 }
 
 Expected<void, MemoryError> MemoryManager::logMemoryStatus() {
-    Logger::instance().info("Memory Status - Current: {} bytes, Peak: {} bytes, Limit: {} bytes", 
-                           d->currentUsage, d->peakUsage, d->totalMemoryLimit);
+    Logger::instance().info("Memory Status - Held: {} bytes, Peak: {} bytes, Limit: {} bytes",
+                           d->heldBytes.load(), d->peakHeldBytes.load(), d->totalMemoryLimit.load());
     return Expected<void, MemoryError>();
 }
 
 } // namespace Murmur
-
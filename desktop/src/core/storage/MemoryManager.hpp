@@ -12,6 +12,7 @@
 
 #include "core/common/Expected.hpp"
 #include "core/common/Logger.hpp"
+#include "SlabAllocator.hpp"
 
 namespace Murmur {
 
@@ -47,9 +48,15 @@ struct MemoryBlock {
     std::string allocatedBy;
     bool isActive;
     size_t requestedSize;
-    QByteArray checksum;
 };
 
+/**
+ * @brief A reserved region serving one MemoryPoolType
+ *
+ * Blocks are carved from the region by a SlabAllocator; usedSize counts
+ * the rounded block sizes taken out, including blocks cached by threads.
+ * The mutex guards the allocator and the size fields.
+ */
 struct MemoryPool {
     MemoryPoolType type;
     size_t totalSize;
@@ -58,10 +65,11 @@ struct MemoryPool {
     size_t blockCount;
     size_t maxBlockSize;
     void* basePtr;
-    std::unordered_map<void*, std::unique_ptr<MemoryBlock>> blocks;
+    std::unique_ptr<SlabAllocator> allocator;
     bool isActive;
     size_t alignment;
     std::chrono::steady_clock::time_point createdAt;
+    mutable QMutex mutex;
 };
 
 struct MemoryStats {
@@ -79,6 +87,15 @@ struct MemoryStats {
     std::chrono::steady_clock::time_point lastReset;
 };
 
+/**
+ * @brief Pooled allocator for media, transcription and torrent buffers
+ *
+ * allocate() and deallocate() may be called from any thread. Each thread
+ * keeps a small magazine of blocks per size class and takes or returns
+ * them in batches, so the pool locks are only touched on a refill or a
+ * drain. Pool management (create, destroy, resize, clear) and shutdown
+ * must not race with allocations from the pools they affect.
+ */
 class MemoryManager : public QObject {
     Q_OBJECT
 
@@ -126,6 +143,8 @@ public:
     Expected<void, MemoryError> setPoolLimit(MemoryPoolType type, size_t limit);
     Expected<void, MemoryError> setGarbageCollectionInterval(int intervalMs);
     Expected<void, MemoryError> setMemoryPressureThreshold(double threshold);
+    // Debug mode records where and when each block was allocated, which
+    // leak detection and the block listings report
     Expected<void, MemoryError> setDebugMode(bool enabled);
 
     // Diagnostics
@@ -145,6 +164,7 @@ public:
     void setLeakDetectionCallback(LeakDetectionCallback callback);
 
 signals:
+    // Emitted per batch taken from or returned to a pool, not per block
     void memoryAllocated(size_t size, void* ptr);
     void memoryFreed(size_t size, void* ptr);
     void memoryPressure(double pressure);
@@ -168,12 +188,10 @@ private:
     Expected<void*, MemoryError> internalAllocate(size_t size, size_t alignment, MemoryPoolType poolType, const std::string& allocatedBy);
     Expected<void, MemoryError> internalDeallocate(void* ptr);
     Expected<MemoryPool*, MemoryError> findPool(MemoryPoolType type);
-    Expected<MemoryPool*, MemoryError> findPoolForPointer(void* ptr);
+    Expected<MemoryPool*, MemoryError> findPoolForPointer(const void* ptr) const;
 
     // Memory management
-    Expected<void, MemoryError> addBlock(MemoryPool* pool, void* ptr, size_t size, size_t alignment, const std::string& allocatedBy);
-    Expected<void, MemoryError> removeBlock(MemoryPool* pool, void* ptr);
-    Expected<void, MemoryError> updateStats(MemoryPool* pool, size_t size, bool isAllocation);
+    Expected<void, MemoryError> releasePoolBlocks(MemoryPool* pool);
 
     // Validation
     Expected<void, MemoryError> validatePointer(void* ptr) const;
@@ -182,12 +200,10 @@ private:
     Expected<void, MemoryError> validatePool(const MemoryPool* pool) const;
 
     // Utility
-    Expected<void, MemoryError> calculateFragmentation();
+    Expected<void, MemoryError> calculateFragmentation() const;
     Expected<void, MemoryError> updatePressure();
     Expected<size_t, MemoryError> alignSize(size_t size, size_t alignment) const;
     Expected<bool, MemoryError> isPointerValid(void* ptr) const;
-    Expected<QByteArray, MemoryError> calculateChecksum(void* ptr, size_t size) const;
-    Expected<bool, MemoryError> verifyChecksum(const MemoryBlock& block) const;
 
     // Debug
     Expected<void, MemoryError> logAllocation(void* ptr, size_t size, const std::string& allocatedBy);
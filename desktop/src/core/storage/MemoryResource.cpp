@@ -0,0 +1,53 @@
+#include "MemoryResource.hpp"
+#include "core/common/Logger.hpp"
+
+#include <algorithm>
+
+namespace Murmur {
+
+PoolMemoryResource::PoolMemoryResource(MemoryManager& manager, MemoryPoolType poolType, std::string allocatedBy)
+    : manager_(&manager)
+    , poolType_(poolType)
+    , allocatedBy_(std::move(allocatedBy))
+{
+}
+
+void* PoolMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    // The manager rejects empty blocks, but a resource must hand out a
+    // distinct pointer for them
+    auto block = manager_->allocate(std::max<size_t>(bytes, 1), std::max<size_t>(alignment, 16), poolType_, allocatedBy_);
+    if (!block.hasValue()) {
+        throw std::bad_alloc();
+    }
+
+    bytesAllocated_.fetch_add(bytes, std::memory_order_relaxed);
+    return block.value();
+}
+
+void PoolMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t) {
+    auto result = manager_->deallocate(ptr);
+    if (!result.hasValue()) {
+        Logger::instance().warn("PoolMemoryResource: failed to release {} bytes at {}", bytes, ptr);
+        return;
+    }
+
+    bytesAllocated_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool PoolMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    if (this == &other) {
+        return true;
+    }
+
+    // Any resource over the same pool can free what this one allocated
+    auto pool = dynamic_cast<const PoolMemoryResource*>(&other);
+    return pool && pool->manager_ == manager_ && pool->poolType_ == poolType_;
+}
+
+TaskArena::TaskArena(MemoryManager& manager, MemoryPoolType poolType, size_t initialChunkSize, std::string allocatedBy)
+    : upstream_(manager, poolType, std::move(allocatedBy))
+    , arena_(std::max<size_t>(initialChunkSize, 1), &upstream_)
+{
+}
+
+} // namespace Murmur
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include "MemoryManager.hpp"
+
+namespace Murmur {
+
+/**
+ * @brief std::pmr::memory_resource drawing from one MemoryManager pool
+ *
+ * Lets pmr containers (std::pmr::vector, std::pmr::string, ...) allocate
+ * from a pool instead of the global heap. Failures throw std::bad_alloc, as
+ * the standard containers expect. The manager must outlive the resource and
+ * everything allocated through it.
+ */
+class PoolMemoryResource : public std::pmr::memory_resource {
+public:
+    PoolMemoryResource(MemoryManager& manager, MemoryPoolType poolType, std::string allocatedBy = "");
+
+    MemoryManager& manager() const { return *manager_; }
+    MemoryPoolType poolType() const { return poolType_; }
+
+    // Bytes currently allocated through this resource, as requested
+    size_t bytesAllocated() const { return bytesAllocated_.load(std::memory_order_relaxed); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    MemoryManager* manager_;
+    MemoryPoolType poolType_;
+    std::string allocatedBy_;
+    std::atomic<size_t> bytesAllocated_{0};
+};
+
+/**
+ * @brief Typed allocator over a MemoryManager pool
+ *
+ * For containers that take an allocator template argument rather than a
+ * memory_resource. Copies, including rebound ones, allocate from the same
+ * pool and compare equal.
+ */
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator(MemoryManager& manager, MemoryPoolType poolType) noexcept
+        : manager_(&manager), poolType_(poolType) {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+        : manager_(other.manager()), poolType_(other.poolType()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        auto block = manager_->allocate(std::max<size_t>(n * sizeof(T), 1), std::max(alignof(T), size_t(16)), poolType_);
+        if (!block.hasValue()) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block.value());
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        manager_->deallocate(ptr);
+    }
+
+    MemoryManager* manager() const noexcept { return manager_; }
+    MemoryPoolType poolType() const noexcept { return poolType_; }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return manager_ == other.manager() && poolType_ == other.poolType();
+    }
+
+private:
+    MemoryManager* manager_;
+    MemoryPoolType poolType_;
+};
+
+/**
+ * @brief Monotonic arena for the scratch allocations of one task
+ *
+ * Allocations are carved from chunks taken from a pool and are never freed
+ * one by one; all of them go back to the pool at once in release() or when
+ * the arena is destroyed. A conversion or transcription task creates one,
+ * builds its buffers and segment lists with std::pmr containers on
+ * resource(), and drops it when the task finishes.
+ *
+ * An arena is not thread-safe. Containers allocated from it must not
+ * outlive it.
+ */
+class TaskArena {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    TaskArena(MemoryManager& manager, MemoryPoolType poolType,
+              size_t initialChunkSize = DEFAULT_CHUNK_SIZE, std::string allocatedBy = "");
+
+    TaskArena(const TaskArena&) = delete;
+    TaskArena& operator=(const TaskArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena_; }
+
+    template<typename T>
+    std::pmr::polymorphic_allocator<T> allocator() { return std::pmr::polymorphic_allocator<T>(&arena_); }
+
+    // Returns every chunk to the pool; the arena can be reused afterwards
+    void release() { arena_.release(); }
+
+    // Bytes of chunks taken from the pool
+    size_t bytesReserved() const { return upstream_.bytesAllocated(); }
+
+private:
+    PoolMemoryResource upstream_;
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+} // namespace Murmur
@@ -0,0 +1,523 @@
+#include "SlabAllocator.hpp"
+#include "core/common/Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace Murmur {
+
+namespace {
+
+// Every slab holds at least this many objects, which bounds the slack at
+// the end of a slab to an eighth of it
+constexpr size_t MIN_OBJECTS_PER_SLAB = 8;
+
+} // namespace
+
+SlabAllocator::SlabAllocator(size_t capacity) {
+    pageCount_ = std::max<size_t>(1, (capacity + PAGE_SIZE - 1) / PAGE_SIZE);
+    if (pageCount_ >= NONE) {
+        Logger::instance().error("Slab region of {} bytes is too large", capacity);
+        return;
+    }
+
+    // The region is only reserved here; pages are committed by the OS as
+    // they are first touched
+    base_ = static_cast<char*>(std::aligned_alloc(PAGE_SIZE, pageCount_ * PAGE_SIZE));
+    if (!base_) {
+        Logger::instance().error("Failed to reserve slab region of {} bytes", pageCount_ * PAGE_SIZE);
+        return;
+    }
+
+    liveBits_ = static_cast<quint64*>(std::calloc((pageCount_ * PAGE_SIZE / GRANULE + 63) / 64, sizeof(quint64)));
+    if (!liveBits_) {
+        Logger::instance().error("Failed to allocate slab side tables for {} pages", pageCount_);
+        std::free(base_);
+        base_ = nullptr;
+        return;
+    }
+
+    pages_.resize(pageCount_);
+    limitPages_ = pageCount_;
+    partial_.fill(NONE);
+    emptySlab_.fill(NONE);
+    insertFreeRun(0, static_cast<quint32>(pageCount_));
+}
+
+SlabAllocator::~SlabAllocator() {
+    std::free(liveBits_);
+    std::free(base_);
+}
+
+void* SlabAllocator::allocate(size_t size, size_t alignment) {
+    void* ptr = acquire(size, alignment);
+    if (ptr) {
+        markLive(ptr);
+    }
+    return ptr;
+}
+
+size_t SlabAllocator::deallocate(void* ptr) {
+    return clearLive(ptr) ? release(ptr) : 0;
+}
+
+void* SlabAllocator::acquire(size_t size, size_t alignment) {
+    if (!base_ || size == 0 || alignment > MAX_ALIGNMENT) {
+        return nullptr;
+    }
+
+    const int sizeClass = sizeClassFor(size, alignment);
+    return sizeClass >= 0 ? allocateSmall(sizeClass) : allocateLarge(size);
+}
+
+size_t SlabAllocator::acquireBatch(int sizeClass, void** blocks, size_t count) {
+    if (!base_ || sizeClass < 0 || sizeClass >= static_cast<int>(SIZE_CLASS_COUNT)) {
+        return 0;
+    }
+
+    size_t acquired = 0;
+    while (acquired < count) {
+        void* ptr = allocateSmall(sizeClass);
+        if (!ptr) {
+            break;
+        }
+        blocks[acquired++] = ptr;
+    }
+    return acquired;
+}
+
+size_t SlabAllocator::release(void* ptr) {
+    const size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - base_);
+    const quint32 run = pages_[offset / PAGE_SIZE].runStart;
+    const Page& head = pages_[run];
+    const size_t size = head.state == PageState::Large
+        ? static_cast<size_t>(head.runPages) * PAGE_SIZE
+        : classSize(head.sizeClass);
+
+    heldBytes_ -= size;
+    --heldBlocks_;
+    if (head.state == PageState::Large) {
+        releaseRun(run);
+    } else {
+        releaseSmall(run, offset);
+    }
+    return size;
+}
+
+bool SlabAllocator::markLive(void* ptr) {
+    if (!contains(ptr)) {
+        return false;
+    }
+    const size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - base_);
+    return offset % GRANULE == 0 && setLive(offset, true);
+}
+
+bool SlabAllocator::clearLive(void* ptr) {
+    if (!contains(ptr)) {
+        return false;
+    }
+    const size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - base_);
+    return offset % GRANULE == 0 && setLive(offset, false);
+}
+
+int SlabAllocator::blockClass(const void* ptr) const {
+    const size_t offset = static_cast<size_t>(static_cast<const char*>(ptr) - base_);
+    const Page& head = pages_[pages_[offset / PAGE_SIZE].runStart];
+    return head.state == PageState::Slab ? head.sizeClass : -1;
+}
+
+size_t SlabAllocator::blockSize(const void* ptr) const {
+    if (!contains(ptr)) {
+        return 0;
+    }
+
+    const size_t offset = static_cast<size_t>(static_cast<const char*>(ptr) - base_);
+    if (offset % GRANULE != 0 || !isLive(offset)) {
+        return 0;
+    }
+
+    const Page& head = pages_[pages_[offset / PAGE_SIZE].runStart];
+    if (head.state == PageState::Large) {
+        return static_cast<size_t>(head.runPages) * PAGE_SIZE;
+    }
+    return classSize(head.sizeClass);
+}
+
+bool SlabAllocator::contains(const void* ptr) const {
+    const char* p = static_cast<const char*>(ptr);
+    return base_ && p >= base_ && p < base_ + pageCount_ * PAGE_SIZE;
+}
+
+void SlabAllocator::setLimit(size_t bytes) {
+    limitPages_ = std::clamp<size_t>((bytes + PAGE_SIZE - 1) / PAGE_SIZE, 1, pageCount_);
+}
+
+size_t SlabAllocator::freeBytes() const {
+    return pagesInUse_ >= limitPages_ ? 0 : (limitPages_ - pagesInUse_) * PAGE_SIZE;
+}
+
+size_t SlabAllocator::largestFreeRun() const {
+    if (freeRuns_.empty()) {
+        return 0;
+    }
+    return std::min<size_t>(freeRuns_.rbegin()->first * PAGE_SIZE, freeBytes());
+}
+
+size_t SlabAllocator::smallestFreeRun() const {
+    if (freeRuns_.empty()) {
+        return 0;
+    }
+    return std::min<size_t>(freeRuns_.begin()->first * PAGE_SIZE, freeBytes());
+}
+
+size_t SlabAllocator::releaseEmptySlabs(std::chrono::steady_clock::duration maxAge) {
+    const auto now = std::chrono::steady_clock::now();
+    size_t released = 0;
+
+    for (size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass) {
+        const quint32 slab = emptySlab_[sizeClass];
+        if (slab == NONE || now - emptySince_[sizeClass] < maxAge) {
+            continue;
+        }
+        emptySlab_[sizeClass] = NONE;
+        released += static_cast<size_t>(pages_[slab].runPages) * PAGE_SIZE;
+        releaseRun(slab);
+    }
+    return released;
+}
+
+void SlabAllocator::reset() {
+    if (!base_) {
+        return;
+    }
+
+    // Clearing live bits block by block keeps untouched parts uncommitted
+    forEachBlock([this](void* ptr, size_t) {
+        setLive(static_cast<size_t>(static_cast<char*>(ptr) - base_), false);
+    });
+
+    std::fill(pages_.begin(), pages_.end(), Page{});
+    partial_.fill(NONE);
+    emptySlab_.fill(NONE);
+    freeRuns_.clear();
+    pagesInUse_ = 0;
+    heldBytes_ = 0;
+    heldBlocks_ = 0;
+    insertFreeRun(0, static_cast<quint32>(pageCount_));
+}
+
+void SlabAllocator::forEachBlock(const std::function<void(void* ptr, size_t size)>& visit) const {
+    size_t page = 0;
+    while (page < pageCount_) {
+        const Page& head = pages_[page];
+        if (head.state == PageState::Large) {
+            visit(base_ + page * PAGE_SIZE, static_cast<size_t>(head.runPages) * PAGE_SIZE);
+        } else if (head.state == PageState::Slab) {
+            const size_t objectSize = classSize(head.sizeClass);
+            for (quint32 i = 0; i < head.carved; ++i) {
+                const size_t offset = page * PAGE_SIZE + i * objectSize;
+                if (isLive(offset)) {
+                    visit(base_ + offset, objectSize);
+                }
+            }
+        }
+        page += std::max<quint32>(head.runPages, 1);
+    }
+}
+
+bool SlabAllocator::validate() const {
+    if (!base_) {
+        return false;
+    }
+
+    size_t page = 0;
+    size_t usedPages = 0;
+    size_t freeRuns = 0;
+    size_t heldBlocks = 0;
+    size_t heldBytes = 0;
+
+    while (page < pageCount_) {
+        const Page& head = pages_[page];
+        const quint32 length = head.runPages;
+        if (length == 0 || page + length > pageCount_ || pages_[page + length - 1].runStart != page) {
+            Logger::instance().error("Slab page table is inconsistent at page {}", page);
+            return false;
+        }
+
+        if (head.state == PageState::Free) {
+            if (!freeRuns_.contains({length, static_cast<quint32>(page)})) {
+                Logger::instance().error("Free page run at {} is not indexed", page);
+                return false;
+            }
+            ++freeRuns;
+        } else {
+            usedPages += length;
+            size_t live = 0;
+            size_t objectSize = static_cast<size_t>(length) * PAGE_SIZE;
+            size_t objects = 1;
+            if (head.state == PageState::Slab) {
+                objectSize = classSize(head.sizeClass);
+                objects = head.carved;
+            }
+            for (size_t i = 0; i < objects; ++i) {
+                live += isLive(page * PAGE_SIZE + i * objectSize) ? 1 : 0;
+            }
+            if (head.state == PageState::Slab && live != head.live) {
+                Logger::instance().error("Slab at page {} counts {} live objects, found {}", page, head.live, live);
+                return false;
+            }
+            heldBlocks += live;
+            heldBytes += live * objectSize;
+        }
+        page += length;
+    }
+
+    if (freeRuns != freeRuns_.size() || usedPages != pagesInUse_ ||
+        heldBlocks != heldBlocks_ || heldBytes != heldBytes_) {
+        Logger::instance().error("Slab allocator totals do not match its page table");
+        return false;
+    }
+    return true;
+}
+
+size_t SlabAllocator::roundedSize(size_t size, size_t alignment) {
+    if (size == 0 || alignment > MAX_ALIGNMENT) {
+        return 0;
+    }
+    const int sizeClass = sizeClassFor(size, alignment);
+    if (sizeClass >= 0) {
+        return classSize(sizeClass);
+    }
+    return (size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
+
+int SlabAllocator::sizeClassFor(size_t size, size_t alignment) {
+    size = std::max({size, alignment, GRANULE});
+    if (size > MAX_SMALL_SIZE) {
+        return -1;
+    }
+
+    int sizeClass = 0;
+    if (size <= 128) {
+        sizeClass = static_cast<int>((size + GRANULE - 1) / GRANULE) - 1;
+    } else {
+        const size_t v = size - 1;
+        const int log = std::bit_width(v) - 1;
+        const size_t power = size_t(1) << log;
+        sizeClass = 8 + (log - 7) * 4 + static_cast<int>((v - power) / (power / 4));
+    }
+
+    // Slabs are page aligned, so objects are aligned to any power of two
+    // that divides the class size
+    while (sizeClass < static_cast<int>(SIZE_CLASS_COUNT) && classSize(sizeClass) % alignment != 0) {
+        ++sizeClass;
+    }
+    return sizeClass < static_cast<int>(SIZE_CLASS_COUNT) ? sizeClass : -1;
+}
+
+size_t SlabAllocator::classSize(int sizeClass) {
+    // 16..128 in steps of 16, then four steps per power of two up to 256 KiB
+    if (sizeClass < 8) {
+        return static_cast<size_t>(sizeClass + 1) * GRANULE;
+    }
+    const int step = sizeClass - 8;
+    const size_t power = size_t(128) << (step / 4);
+    return power + power / 4 * static_cast<size_t>(step % 4 + 1);
+}
+
+quint32 SlabAllocator::slabPages(int sizeClass) {
+    return static_cast<quint32>((classSize(sizeClass) * MIN_OBJECTS_PER_SLAB + PAGE_SIZE - 1) / PAGE_SIZE);
+}
+
+void* SlabAllocator::allocateSmall(int sizeClass) {
+    quint32 slab = partial_[sizeClass];
+    if (slab == NONE) {
+        slab = emptySlab_[sizeClass];
+        emptySlab_[sizeClass] = NONE;
+        if (slab == NONE) {
+            slab = takeRun(slabPages(sizeClass), PageState::Slab);
+            if (slab == NONE) {
+                return nullptr;
+            }
+            pages_[slab].sizeClass = static_cast<quint16>(sizeClass);
+        }
+        pushPartial(slab);
+    }
+
+    Page& head = pages_[slab];
+    const size_t objectSize = classSize(sizeClass);
+    const size_t objects = static_cast<size_t>(head.runPages) * PAGE_SIZE / objectSize;
+    char* slabBase = base_ + static_cast<size_t>(slab) * PAGE_SIZE;
+
+    // Reuse freed objects first; fresh objects are carved off the end so a
+    // new slab does not touch pages it has not handed out yet
+    quint32 index = head.freeHead;
+    if (index != NONE) {
+        std::memcpy(&head.freeHead, slabBase + index * objectSize, sizeof(quint32));
+    } else {
+        index = head.carved++;
+    }
+
+    ++head.live;
+    if (head.live == objects) {
+        unlinkPartial(slab);
+    }
+
+    heldBytes_ += objectSize;
+    ++heldBlocks_;
+    return slabBase + index * objectSize;
+}
+
+void* SlabAllocator::allocateLarge(size_t size) {
+    const size_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (pages > pageCount_) {
+        return nullptr;
+    }
+
+    const quint32 run = takeRun(static_cast<quint32>(pages), PageState::Large);
+    if (run == NONE) {
+        return nullptr;
+    }
+
+    heldBytes_ += pages * PAGE_SIZE;
+    ++heldBlocks_;
+    return base_ + static_cast<size_t>(run) * PAGE_SIZE;
+}
+
+void SlabAllocator::releaseSmall(quint32 slab, size_t offset) {
+    Page& head = pages_[slab];
+    const int sizeClass = head.sizeClass;
+    const size_t objectSize = classSize(sizeClass);
+    const size_t objects = static_cast<size_t>(head.runPages) * PAGE_SIZE / objectSize;
+    const quint32 index = static_cast<quint32>((offset - static_cast<size_t>(slab) * PAGE_SIZE) / objectSize);
+
+    std::memcpy(base_ + offset, &head.freeHead, sizeof(quint32));
+    head.freeHead = index;
+
+    const bool wasFull = head.live == objects;
+    --head.live;
+    if (wasFull) {
+        pushPartial(slab);
+    }
+    if (head.live > 0) {
+        return;
+    }
+
+    // Keep one empty slab per class aside, so partial slabs fill up first
+    // and alloc/free pairs do not thrash; further empty slabs are released
+    unlinkPartial(slab);
+    if (emptySlab_[sizeClass] == NONE) {
+        emptySlab_[sizeClass] = slab;
+        emptySince_[sizeClass] = std::chrono::steady_clock::now();
+    } else {
+        releaseRun(slab);
+    }
+}
+
+quint32 SlabAllocator::takeRun(quint32 pages, PageState state) {
+    // Best fit: the shortest free run that is long enough
+    auto it = freeRuns_.lower_bound({pages, 0});
+    if (pagesInUse_ + pages > limitPages_ || it == freeRuns_.end()) {
+        // Cached empty slabs are the only memory that can be reclaimed here
+        if (releaseEmptySlabs(std::chrono::steady_clock::duration::zero()) == 0) {
+            return NONE;
+        }
+        it = freeRuns_.lower_bound({pages, 0});
+        if (pagesInUse_ + pages > limitPages_ || it == freeRuns_.end()) {
+            return NONE;
+        }
+    }
+
+    const auto [length, start] = *it;
+    freeRuns_.erase(it);
+    if (length > pages) {
+        insertFreeRun(start + pages, length - pages);
+    }
+
+    for (quint32 page = start; page < start + pages; ++page) {
+        Page& entry = pages_[page];
+        entry = Page{};
+        entry.runStart = start;
+        entry.runPages = pages;
+        entry.state = state;
+    }
+    pagesInUse_ += pages;
+    return start;
+}
+
+void SlabAllocator::releaseRun(quint32 start) {
+    quint32 length = pages_[start].runPages;
+    pagesInUse_ -= length;
+
+    // Coalesce with the free runs on either side
+    if (start > 0 && pages_[start - 1].state == PageState::Free) {
+        const quint32 previous = pages_[start - 1].runStart;
+        const quint32 previousLength = pages_[previous].runPages;
+        freeRuns_.erase({previousLength, previous});
+        start = previous;
+        length += previousLength;
+    }
+    const quint32 following = start + length;
+    if (following < pageCount_ && pages_[following].state == PageState::Free) {
+        const quint32 followingLength = pages_[following].runPages;
+        freeRuns_.erase({followingLength, following});
+        length += followingLength;
+    }
+
+    insertFreeRun(start, length);
+}
+
+void SlabAllocator::insertFreeRun(quint32 start, quint32 pages) {
+    // Only the ends of a free run are kept current; that is all coalescing
+    // looks at, and pages inside it carry no live bits
+    Page head;
+    head.runStart = start;
+    head.runPages = pages;
+    pages_[start] = head;
+    pages_[start + pages - 1] = head;
+    freeRuns_.insert({pages, start});
+}
+
+void SlabAllocator::pushPartial(quint32 slab) {
+    Page& head = pages_[slab];
+    const int sizeClass = head.sizeClass;
+    head.prev = NONE;
+    head.next = partial_[sizeClass];
+    if (head.next != NONE) {
+        pages_[head.next].prev = slab;
+    }
+    partial_[sizeClass] = slab;
+}
+
+void SlabAllocator::unlinkPartial(quint32 slab) {
+    Page& head = pages_[slab];
+    if (head.prev != NONE) {
+        pages_[head.prev].next = head.next;
+    } else if (partial_[head.sizeClass] == slab) {
+        partial_[head.sizeClass] = head.next;
+    }
+    if (head.next != NONE) {
+        pages_[head.next].prev = head.prev;
+    }
+    head.prev = head.next = NONE;
+}
+
+bool SlabAllocator::isLive(size_t offset) const {
+    const size_t granule = offset / GRANULE;
+    return (std::atomic_ref<quint64>(liveBits_[granule / 64]).load(std::memory_order_acquire) >> (granule % 64)) & 1;
+}
+
+bool SlabAllocator::setLive(size_t offset, bool live) {
+    // Atomic, so the owner of a block can flip its bit without the lock
+    const size_t granule = offset / GRANULE;
+    const quint64 mask = quint64(1) << (granule % 64);
+    std::atomic_ref<quint64> word(liveBits_[granule / 64]);
+    const quint64 previous = live ? word.fetch_or(mask, std::memory_order_acq_rel)
+                                  : word.fetch_and(~mask, std::memory_order_acq_rel);
+    return ((previous & mask) != 0) != live;
+}
+
+} // namespace Murmur
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace Murmur {
+
+/**
+ * @brief Size-class slab allocator over one reserved region
+ *
+ * The region is reserved once and split into 64 KiB pages. Requests up to
+ * MAX_SMALL_SIZE are rounded up to a size class (four classes per power of
+ * two, so at most a fifth of a block is slack) and served from slabs: page
+ * runs holding objects of a single class, with a free list threaded through
+ * the free objects. Larger requests take a run of whole pages. Free page
+ * runs are coalesced with their neighbours when released and reused
+ * best-fit, so external fragmentation stays bounded by the page size.
+ *
+ * All bookkeeping lives in side tables: one entry per page and one live bit
+ * per 16-byte granule. Nothing is allocated per block, and allocating or
+ * freeing a small block is O(1).
+ *
+ * Blocks can be acquired without being marked live, so a caller can keep
+ * a cache of them; the live bit then records which blocks the application
+ * holds. The allocator is not thread-safe, except for markLive() and
+ * clearLive(); callers serialize everything else.
+ */
+class SlabAllocator {
+public:
+    static constexpr size_t PAGE_SIZE = 64 * 1024;
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_SMALL_SIZE = 256 * 1024;
+    static constexpr size_t MAX_ALIGNMENT = PAGE_SIZE;
+    static constexpr size_t SIZE_CLASS_COUNT = 52;
+
+    explicit SlabAllocator(size_t capacity);
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    // False when the region could not be reserved
+    bool isValid() const { return base_ != nullptr; }
+    void* base() const { return base_; }
+
+    /**
+     * @brief Allocate a block of at least size bytes
+     * @return nullptr when the region or the limit has no room left
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Release a block
+     * @return Usable size of the released block, 0 when ptr is not a live block
+     */
+    size_t deallocate(void* ptr);
+
+    // Like allocate(), but the block is not marked live
+    void* acquire(size_t size, size_t alignment);
+    // Acquires up to count blocks of one size class, returns how many it got
+    size_t acquireBatch(int sizeClass, void** blocks, size_t count);
+    // Takes back an acquired block that is not live, returns its size
+    size_t release(void* ptr);
+
+    // Flip the live bit of an acquired block; false when it already had that state
+    bool markLive(void* ptr);
+    bool clearLive(void* ptr);
+
+    // Size class of an acquired block, -1 for page runs
+    int blockClass(const void* ptr) const;
+
+    // Usable size of a live block, 0 for anything else
+    size_t blockSize(const void* ptr) const;
+    bool contains(const void* ptr) const;
+
+    // Caps the bytes held by slabs and page runs; the region itself is not resized
+    void setLimit(size_t bytes);
+    size_t limit() const { return limitPages_ * PAGE_SIZE; }
+
+    size_t capacity() const { return pageCount_ * PAGE_SIZE; }
+    size_t committedBytes() const { return pagesInUse_ * PAGE_SIZE; }
+    // Acquired and not yet released, whether live or cached by a caller
+    size_t heldBytes() const { return heldBytes_; }
+    size_t heldBlocks() const { return heldBlocks_; }
+    size_t freeBytes() const;
+    size_t largestFreeRun() const;
+    size_t smallestFreeRun() const;
+
+    /**
+     * @brief Return cached empty slabs to the free page runs
+     * @param maxAge Only slabs that have been empty at least this long
+     * @return Bytes returned
+     */
+    size_t releaseEmptySlabs(std::chrono::steady_clock::duration maxAge);
+
+    // Drops every block and returns the whole region to a single free run
+    void reset();
+
+    // Visits live blocks in address order
+    void forEachBlock(const std::function<void(void* ptr, size_t size)>& visit) const;
+
+    // Cross-checks the page table, free runs, slab counters and live bits;
+    // only meaningful while no acquired blocks are cached by a caller
+    bool validate() const;
+
+    // Usable size a request would get, 0 when it cannot be served
+    static size_t roundedSize(size_t size, size_t alignment);
+
+    // Size class a request maps to, -1 when it needs a page run
+    static int sizeClassFor(size_t size, size_t alignment);
+    static size_t classSize(int sizeClass);
+
+private:
+    static constexpr quint32 NONE = 0xFFFFFFFF;
+    static constexpr quint16 NO_CLASS = 0xFFFF;
+
+    enum class PageState : quint8 { Free, Slab, Large };
+
+    // Run fields are valid on every page of a used run and on the first and
+    // last page of a free run; slab fields only on the first page of a slab
+    struct Page {
+        quint32 runStart = 0;
+        quint32 runPages = 0;
+        PageState state = PageState::Free;
+        quint16 sizeClass = NO_CLASS;
+        quint32 freeHead = NONE;
+        quint32 carved = 0;
+        quint32 live = 0;
+        quint32 prev = NONE;
+        quint32 next = NONE;
+    };
+
+    char* base_ = nullptr;
+    size_t pageCount_ = 0;
+    size_t limitPages_ = 0;
+    size_t pagesInUse_ = 0;
+    size_t heldBytes_ = 0;
+    size_t heldBlocks_ = 0;
+
+    std::vector<Page> pages_;
+    // Calloc'ed so that, like the region, it is only committed where touched
+    quint64* liveBits_ = nullptr;
+    // Free page runs as (length, first page), smallest first
+    std::set<std::pair<quint32, quint32>> freeRuns_;
+
+    // Slabs of each class with at least one free object
+    std::array<quint32, SIZE_CLASS_COUNT> partial_{};
+    // One empty slab per class is kept aside so alloc/free pairs do not
+    // take and release page runs over and over
+    std::array<quint32, SIZE_CLASS_COUNT> emptySlab_{};
+    std::array<std::chrono::steady_clock::time_point, SIZE_CLASS_COUNT> emptySince_{};
+
+    static quint32 slabPages(int sizeClass);
+
+    void* allocateSmall(int sizeClass);
+    void* allocateLarge(size_t size);
+    void releaseSmall(quint32 slab, size_t offset);
+
+    quint32 takeRun(quint32 pages, PageState state);
+    void releaseRun(quint32 start);
+    void insertFreeRun(quint32 start, quint32 pages);
+
+    void pushPartial(quint32 slab);
+    void unlinkPartial(quint32 slab);
+
+    bool isLive(size_t offset) const;
+    bool setLive(size_t offset, bool live);
+};
+
+} // namespace Murmur
@@ -14,17 +14,145 @@
 #include <QRegularExpression>
 #include <QDebug>
 #include <QThread>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
 
 namespace Murmur {
 
+namespace {
+
+// FTS5 tables are standalone and share the owning row's rowid, so triggers
+// find their row by primary key instead of scanning the index. VACUUM may
+// renumber implicit rowids, so vacuum() rebuilds the indexes afterwards.
+// Update triggers only fire when an indexed value actually changed; the
+// bulk and write-behind statements SET every column on each write.
+struct SearchIndexDefinition {
+    const char* table;
+    const char* create;
+    const char* populate;
+    QStringList triggers;
+};
+
+const QList<SearchIndexDefinition>& searchIndexDefinitions() {
+    static const QList<SearchIndexDefinition> definitions = {
+        {
+            "transcriptions_fts",
+            R"(CREATE VIRTUAL TABLE IF NOT EXISTS transcriptions_fts USING fts5(
+                full_text, tokenize = 'unicode61 remove_diacritics 2'
+            ))",
+            "INSERT INTO transcriptions_fts (rowid, full_text) SELECT rowid, coalesce(full_text, '') FROM transcriptions",
+            {
+                R"(CREATE TRIGGER IF NOT EXISTS transcriptions_fts_insert AFTER INSERT ON transcriptions BEGIN
+                    INSERT INTO transcriptions_fts (rowid, full_text) VALUES (new.rowid, coalesce(new.full_text, ''));
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS transcriptions_fts_delete AFTER DELETE ON transcriptions BEGIN
+                    DELETE FROM transcriptions_fts WHERE rowid = old.rowid;
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS transcriptions_fts_update AFTER UPDATE OF full_text ON transcriptions
+                    WHEN old.full_text IS NOT new.full_text BEGIN
+                    DELETE FROM transcriptions_fts WHERE rowid = old.rowid;
+                    INSERT INTO transcriptions_fts (rowid, full_text) VALUES (new.rowid, coalesce(new.full_text, ''));
+                END)"
+            }
+        },
+        {
+            "media_fts",
+            R"(CREATE VIRTUAL TABLE IF NOT EXISTS media_fts USING fts5(
+                original_name, file_path, tokenize = 'unicode61 remove_diacritics 2'
+            ))",
+            "INSERT INTO media_fts (rowid, original_name, file_path) SELECT rowid, original_name, file_path FROM media",
+            {
+                R"(CREATE TRIGGER IF NOT EXISTS media_fts_insert AFTER INSERT ON media BEGIN
+                    INSERT INTO media_fts (rowid, original_name, file_path) VALUES (new.rowid, new.original_name, new.file_path);
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS media_fts_delete AFTER DELETE ON media BEGIN
+                    DELETE FROM media_fts WHERE rowid = old.rowid;
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS media_fts_update AFTER UPDATE OF original_name, file_path ON media
+                    WHEN old.original_name IS NOT new.original_name OR old.file_path IS NOT new.file_path BEGIN
+                    DELETE FROM media_fts WHERE rowid = old.rowid;
+                    INSERT INTO media_fts (rowid, original_name, file_path) VALUES (new.rowid, new.original_name, new.file_path);
+                END)"
+            }
+        },
+        {
+            "torrents_fts",
+            R"(CREATE VIRTUAL TABLE IF NOT EXISTS torrents_fts USING fts5(
+                name, tokenize = 'unicode61 remove_diacritics 2'
+            ))",
+            "INSERT INTO torrents_fts (rowid, name) SELECT rowid, name FROM torrents",
+            {
+                R"(CREATE TRIGGER IF NOT EXISTS torrents_fts_insert AFTER INSERT ON torrents BEGIN
+                    INSERT INTO torrents_fts (rowid, name) VALUES (new.rowid, new.name);
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS torrents_fts_delete AFTER DELETE ON torrents BEGIN
+                    DELETE FROM torrents_fts WHERE rowid = old.rowid;
+                END)",
+                R"(CREATE TRIGGER IF NOT EXISTS torrents_fts_update AFTER UPDATE OF name ON torrents
+                    WHEN old.name IS NOT new.name BEGIN
+                    DELETE FROM torrents_fts WHERE rowid = old.rowid;
+                    INSERT INTO torrents_fts (rowid, name) VALUES (new.rowid, new.name);
+                END)"
+            }
+        }
+    };
+    return definitions;
+}
+
+// Every trigger the search index has used; dropped before the tables are rebuilt
+const char* const SEARCH_INDEX_TRIGGERS[] = {
+    "transcriptions_fts_insert", "transcriptions_fts_delete", "transcriptions_fts_update",
+    "media_fts_insert", "media_fts_delete", "media_fts_update",
+    "torrents_fts_insert", "torrents_fts_delete", "torrents_fts_update"
+};
+
+} // namespace
+
+struct StorageManager::ReaderConnection {
+    QString name;
+    QSqlDatabase database;
+    int generation = 0;
+    StatementCache statements;
+    QMetaObject::Connection threadFinished;
+    
+    ~ReaderConnection() {
+        QObject::disconnect(threadFinished);
+        statements.clear();
+        if (database.isOpen()) {
+            database.close();
+        }
+        database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
 const QString StorageManager::DEFAULT_JOURNAL_MODE = "WAL";
 const int StorageManager::CURRENT_SCHEMA_VERSION;
+const int StorageManager::MAX_FLUSH_RETRY_DELAY_MS;
 
 StorageManager::StorageManager(QObject* parent)
     : QObject(parent)
     , connectionName_(QString("MurmurDB_%1_%2_%3").arg(QDateTime::currentMSecsSinceEpoch()).arg(reinterpret_cast<quintptr>(this), 0, 16).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16))
     , autoCommit_(true)
-    , inTransaction_(false) {
+    , inTransaction_(false)
+    , searchIndexAvailable_(false)
+    , readersEnabled_(false)
+    , readerSerial_(0)
+    , readerGeneration_(0)
+    , flushScheduled_(false)
+    , writeBehindWindowMs_(DEFAULT_WRITE_BEHIND_WINDOW_MS)
+    , flushRetryDelayMs_(0)
+    , writeBehindTimer_(new QTimer(this))
+    , statementCacheHits_(0)
+    , statementCacheMisses_(0) {
+    
+    // Flushes run where database_ was opened, never on the queueing thread
+    writeBehindTimer_->setSingleShot(true);
+    connect(writeBehindTimer_, &QTimer::timeout, this, [this]() {
+        flushPendingWrites();
+    });
     
     // Initialize SQL statements
     sqlInsertTorrent_ = R"(
@@ -78,6 +206,24 @@ StorageManager::StorageManager(QObject* parent)
     
     sqlDeleteMedia_ = "DELETE FROM media WHERE id = ?";
     
+    // Keeps the original date_added on conflict
+    sqlUpsertMedia_ = R"(
+        INSERT INTO media (id, torrent_hash, file_path, original_name, mime_type,
+                         file_size, duration, width, height, frame_rate, video_codec,
+                         audio_codec, has_transcription, date_added, last_played,
+                         playback_position, metadata)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        ON CONFLICT(id) DO UPDATE SET
+            torrent_hash = excluded.torrent_hash, file_path = excluded.file_path,
+            original_name = excluded.original_name, mime_type = excluded.mime_type,
+            file_size = excluded.file_size, duration = excluded.duration,
+            width = excluded.width, height = excluded.height,
+            frame_rate = excluded.frame_rate, video_codec = excluded.video_codec,
+            audio_codec = excluded.audio_codec, has_transcription = excluded.has_transcription,
+            last_played = excluded.last_played, playback_position = excluded.playback_position,
+            metadata = excluded.metadata
+    )";
+    
     // Transcription SQL statements
     sqlInsertTranscription_ = R"(
         INSERT INTO transcriptions (id, media_id, language, model_used, full_text,
@@ -124,6 +270,7 @@ StorageManager::~StorageManager() {
 }
 
 Expected<bool, StorageError> StorageManager::initialize(const QString& databasePath) {
+    QWriteLocker connectionLocker(&connectionLock_);
     QMutexLocker locker(&databaseMutex_);
     
     QString dbPath = databasePath;
@@ -139,6 +286,8 @@ Expected<bool, StorageError> StorageManager::initialize(const QString& databaseP
     }
 
     // If the connection is open, close it before re-initializing
+    closeReaders();
+    invalidateStatementCache();
     if (database_.isOpen()) {
         database_.close();
     }
@@ -186,6 +335,10 @@ Expected<bool, StorageError> StorageManager::initialize(const QString& databaseP
     // Set synchronous mode for better performance
     config.exec("PRAGMA synchronous = NORMAL");
     
+    // A new file gets the current schema straight from createTables()
+    config.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'torrents'");
+    const bool freshDatabase = config.next() && config.value(0).toInt() == 0;
+    
     // Create tables if they don't exist
     auto createResult = createTables();
     if (createResult.hasError()) {
@@ -198,13 +351,37 @@ Expected<bool, StorageError> StorageManager::initialize(const QString& databaseP
         return validateResult;
     }
     
+    if (freshDatabase) {
+        if (!config.exec(QString("PRAGMA user_version = %1").arg(CURRENT_SCHEMA_VERSION))) {
+            return makeUnexpected(StorageError::QueryFailed);
+        }
+    } else {
+        // Databases from older releases still need their data migrations
+        auto migrateResult = migrateDatabaseLocked();
+        if (migrateResult.hasError()) {
+            Logger::instance().error("Failed to upgrade database schema");
+            return migrateResult;
+        }
+    }
+    
+    // In-memory databases are private to one connection
+    readersEnabled_ = !dbPath.contains(":memory:");
+    
     Logger::instance().info("Database initialized successfully: {}", dbPath.toStdString());
     return true;
 }
 
 void StorageManager::close() {
+    // Queued writes must reach disk before the connection goes away
+    drainWriteBehind();
+    
+    QWriteLocker connectionLocker(&connectionLock_);
     QMutexLocker locker(&databaseMutex_);
     
+    // Statements must go before the connection they were prepared on
+    closeReaders();
+    invalidateStatementCache();
+    
     if (database_.isOpen()) {
         if (inTransaction_) {
             database_.rollback();
@@ -214,6 +391,7 @@ void StorageManager::close() {
     
     // Release reference to the connection
     database_ = QSqlDatabase(); 
+    searchIndexAvailable_ = false;
     if (QSqlDatabase::contains(connectionName_)) {
         QSqlDatabase::removeDatabase(connectionName_);
     }
@@ -276,6 +454,303 @@ Expected<bool, StorageError> StorageManager::rollbackTransaction() {
     return true;
 }
 
+Expected<bool, StorageError> StorageManager::updateTorrentsBulk(const QList<TorrentRecord>& torrents) {
+    for (const auto& torrent : torrents) {
+        auto validateResult = validateTorrentRecord(torrent);
+        if (validateResult.hasError()) {
+            return validateResult;
+        }
+    }
+    
+    {
+        QMutexLocker locker(&databaseMutex_);
+        
+        auto result = runInTransaction([&]() -> Expected<bool, StorageError> {
+            for (const auto& torrent : torrents) {
+                auto updateResult = executeTorrentUpdate(torrent);
+                if (updateResult.hasError()) {
+                    return updateResult;
+                }
+            }
+            return true;
+        });
+        if (result.hasError()) {
+            return result;
+        }
+    }
+    
+    for (const auto& torrent : torrents) {
+        emit torrentUpdated(torrent.infoHash);
+    }
+    return true;
+}
+
+Expected<QStringList, StorageError> StorageManager::upsertMediaBatch(const QList<MediaRecord>& media) {
+    QList<MediaRecord> records = media;
+    QStringList ids;
+    ids.reserve(records.size());
+    
+    for (auto& record : records) {
+        if (record.id.isEmpty()) {
+            record.id = generateId();
+        }
+        
+        if (!record.isValid()) {
+            Logger::instance().error("MediaRecord failed built-in validation");
+            return makeUnexpected(StorageError::InvalidData);
+        }
+        
+        auto validateResult = validateMediaRecord(record);
+        if (validateResult.hasError()) {
+            return makeUnexpected(validateResult.error());
+        }
+        
+        ids.append(record.id);
+    }
+    
+    {
+        QMutexLocker locker(&databaseMutex_);
+        
+        auto result = runInTransaction([&]() -> Expected<bool, StorageError> {
+            auto queryResult = prepareQuery(sqlUpsertMedia_);
+            if (queryResult.hasError()) {
+                return makeUnexpected(queryResult.error());
+            }
+            
+            QSqlQuery& query = *queryResult.value();
+            for (const auto& record : records) {
+                bindMediaParams(query, record);
+                auto executeResult = executeQuery(query);
+                if (executeResult.hasError()) {
+                    return executeResult;
+                }
+            }
+            return true;
+        });
+        if (result.hasError()) {
+            return makeUnexpected(result.error());
+        }
+    }
+    
+    for (const QString& id : ids) {
+        emit mediaUpdated(id);
+    }
+    return ids;
+}
+
+void StorageManager::queueTorrentUpdate(const TorrentRecord& torrent) {
+    QMutexLocker locker(&pendingMutex_);
+    
+    // A full record supersedes any queued progress for the same torrent
+    pendingProgress_.remove(torrent.infoHash);
+    pendingTorrents_.insert(torrent.infoHash, torrent);
+    scheduleWriteBehindFlush();
+}
+
+void StorageManager::queueTorrentProgress(const QString& infoHash, double progress) {
+    QMutexLocker locker(&pendingMutex_);
+    
+    auto it = pendingTorrents_.find(infoHash);
+    if (it != pendingTorrents_.end()) {
+        it->progress = progress;
+    } else {
+        pendingProgress_.insert(infoHash, progress);
+    }
+    scheduleWriteBehindFlush();
+}
+
+void StorageManager::queuePlaybackPosition(const QString& mediaId, qint64 position) {
+    QMutexLocker locker(&pendingMutex_);
+    
+    pendingPositions_.insert(mediaId, position);
+    scheduleWriteBehindFlush();
+}
+
+void StorageManager::setWriteBehindWindow(int milliseconds) {
+    QMutexLocker locker(&pendingMutex_);
+    writeBehindWindowMs_ = qMax(0, milliseconds);
+}
+
+int StorageManager::pendingWriteCount() const {
+    QMutexLocker locker(&pendingMutex_);
+    return pendingTorrents_.size() + pendingProgress_.size() + pendingPositions_.size();
+}
+
+Expected<bool, StorageError> StorageManager::flushPendingWrites() {
+    QHash<QString, TorrentRecord> torrents;
+    QHash<QString, double> progress;
+    QHash<QString, qint64> positions;
+    {
+        QMutexLocker locker(&pendingMutex_);
+        torrents.swap(pendingTorrents_);
+        progress.swap(pendingProgress_);
+        positions.swap(pendingPositions_);
+        flushScheduled_ = false;
+    }
+    
+    if (torrents.isEmpty() && progress.isEmpty() && positions.isEmpty()) {
+        return true;
+    }
+    
+    auto result = [&]() -> Expected<bool, StorageError> {
+        QMutexLocker locker(&databaseMutex_);
+        
+        return runInTransaction([&]() -> Expected<bool, StorageError> {
+            for (const auto& torrent : std::as_const(torrents)) {
+                auto updateResult = executeTorrentUpdate(torrent);
+                if (updateResult.hasError()) {
+                    return updateResult;
+                }
+            }
+            
+            if (!progress.isEmpty()) {
+                auto queryResult = prepareQuery("UPDATE torrents SET progress = ?, last_active = ? WHERE info_hash = ?");
+                if (queryResult.hasError()) {
+                    return makeUnexpected(queryResult.error());
+                }
+                
+                QSqlQuery& query = *queryResult.value();
+                const QDateTime now = QDateTime::currentDateTime();
+                for (auto it = progress.cbegin(); it != progress.cend(); ++it) {
+                    query.bindValue(0, it.value());
+                    query.bindValue(1, now);
+                    query.bindValue(2, it.key());
+                    auto executeResult = executeQuery(query);
+                    if (executeResult.hasError()) {
+                        return executeResult;
+                    }
+                }
+            }
+            
+            if (!positions.isEmpty()) {
+                auto queryResult = prepareQuery("UPDATE media SET playback_position = ?, last_played = ? WHERE id = ?");
+                if (queryResult.hasError()) {
+                    return makeUnexpected(queryResult.error());
+                }
+                
+                QSqlQuery& query = *queryResult.value();
+                const QDateTime now = QDateTime::currentDateTime();
+                for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+                    query.bindValue(0, it.value());
+                    query.bindValue(1, now);
+                    query.bindValue(2, it.key());
+                    auto executeResult = executeQuery(query);
+                    if (executeResult.hasError()) {
+                        return executeResult;
+                    }
+                }
+            }
+            
+            return true;
+        });
+    }();
+    
+    if (result.hasError()) {
+        // Put back whatever newer writes have not already replaced
+        QMutexLocker locker(&pendingMutex_);
+        for (auto it = torrents.cbegin(); it != torrents.cend(); ++it) {
+            if (!pendingTorrents_.contains(it.key())) {
+                pendingTorrents_.insert(it.key(), it.value());
+            }
+        }
+        for (auto it = progress.cbegin(); it != progress.cend(); ++it) {
+            if (!pendingTorrents_.contains(it.key()) && !pendingProgress_.contains(it.key())) {
+                pendingProgress_.insert(it.key(), it.value());
+            }
+        }
+        for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+            if (!pendingPositions_.contains(it.key())) {
+                pendingPositions_.insert(it.key(), it.value());
+            }
+        }
+        
+        // Back off so a locked or full database is not hammered every window
+        flushRetryDelayMs_ = flushRetryDelayMs_ > 0
+            ? qMin(flushRetryDelayMs_ * 2, MAX_FLUSH_RETRY_DELAY_MS)
+            : qMax(writeBehindWindowMs_, 100);
+        scheduleWriteBehindFlush();
+        Logger::instance().error("Write-behind flush failed, {} writes requeued, retrying in {} ms",
+                                 torrents.size() + progress.size() + positions.size(), flushRetryDelayMs_);
+        return result;
+    }
+    
+    {
+        QMutexLocker locker(&pendingMutex_);
+        flushRetryDelayMs_ = 0;
+    }
+    
+    for (auto it = torrents.cbegin(); it != torrents.cend(); ++it) {
+        emit torrentUpdated(it.key());
+    }
+    for (auto it = positions.cbegin(); it != positions.cend(); ++it) {
+        emit playbackPositionSaved(it.key(), it.value());
+    }
+    return true;
+}
+
+void StorageManager::scheduleWriteBehindFlush() {
+    // pendingMutex_ is held by the caller
+    if (flushScheduled_) {
+        return;
+    }
+    flushScheduled_ = true;
+    
+    // QTimer can only be started from its own thread
+    const int interval = flushRetryDelayMs_ > 0 ? flushRetryDelayMs_ : writeBehindWindowMs_;
+    QTimer* timer = writeBehindTimer_;
+    if (QThread::currentThread() == thread()) {
+        timer->start(interval);
+    } else {
+        QMetaObject::invokeMethod(timer, [timer, interval]() { timer->start(interval); }, Qt::QueuedConnection);
+    }
+}
+
+void StorageManager::drainWriteBehind() {
+    // Called on the owning thread; a pending timer finds nothing left to flush
+    flushPendingWrites();
+}
+
+Expected<bool, StorageError> StorageManager::runInTransaction(const std::function<Expected<bool, StorageError>()>& body) {
+    if (!database_.isOpen()) {
+        return makeUnexpected(StorageError::DatabaseNotOpen);
+    }
+    
+    // Join a transaction the caller already opened
+    if (inTransaction_) {
+        return body();
+    }
+    
+    if (!database_.transaction()) {
+        Logger::instance().error("Failed to begin transaction: {}", database_.lastError().text().toStdString());
+        return makeUnexpected(StorageError::TransactionFailed);
+    }
+    
+    auto result = body();
+    if (result.hasError()) {
+        database_.rollback();
+        return result;
+    }
+    
+    if (!database_.commit()) {
+        Logger::instance().error("Failed to commit transaction: {}", database_.lastError().text().toStdString());
+        database_.rollback();
+        return makeUnexpected(StorageError::TransactionFailed);
+    }
+    
+    return true;
+}
+
+Expected<bool, StorageError> StorageManager::executeTorrentUpdate(const TorrentRecord& torrent) {
+    auto queryResult = prepareQuery(sqlUpdateTorrent_);
+    if (queryResult.hasError()) {
+        return makeUnexpected(queryResult.error());
+    }
+    
+    QSqlQuery& query = *queryResult.value();
+    bindTorrentUpdateParams(query, torrent);
+    return executeQuery(query);
+}
+
 Expected<bool, StorageError> StorageManager::addTorrent(const TorrentRecord& torrent) {
     // Use the helper method that properly handles constraint violations
     return insertTorrentRecord(torrent);
@@ -295,7 +770,7 @@ Expected<bool, StorageError> StorageManager::insertTorrentRecord(const TorrentRe
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     bindTorrentParams(query, torrent);
     
     auto executeResult = executeQuery(query);
@@ -320,28 +795,8 @@ Expected<bool, StorageError> StorageManager::updateTorrent(const TorrentRecord&
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
-    
-    // Bind parameters (excluding info_hash which is WHERE condition)
-    query.bindValue(0, torrent.name);
-    query.bindValue(1, torrent.magnetUri);
-    query.bindValue(2, torrent.size);
-    query.bindValue(3, torrent.lastActive);
-    query.bindValue(4, torrent.savePath);
-    query.bindValue(5, torrent.progress);
-    query.bindValue(6, torrent.status);
-    query.bindValue(7, QJsonDocument(torrent.metadata).toJson(QJsonDocument::Compact));
-    
-    // Ensure files is never null or empty by providing a valid empty string
-    QString filesString = torrent.files.isEmpty() ? "" : torrent.files.join(";");
-    query.bindValue(8, filesString);
-    
-    query.bindValue(9, torrent.seeders);
-    query.bindValue(10, torrent.leechers);
-    query.bindValue(11, torrent.downloaded);
-    query.bindValue(12, torrent.uploaded);
-    query.bindValue(13, torrent.ratio);
-    query.bindValue(14, torrent.infoHash);  // WHERE condition
+    QSqlQuery& query = *queryResult.value();
+    bindTorrentUpdateParams(query, torrent);
     
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
@@ -357,14 +812,14 @@ Expected<TorrentRecord, StorageError> StorageManager::getTorrent(const QString&
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery(sqlSelectTorrent_);
+    auto queryResult = scope.prepare(sqlSelectTorrent_);
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, infoHash);
     
     auto executeResult = executeQuery(query);
@@ -380,14 +835,14 @@ Expected<TorrentRecord, StorageError> StorageManager::getTorrent(const QString&
 }
 
 Expected<QList<TorrentRecord>, StorageError> StorageManager::getAllTorrents() {
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM torrents ORDER BY date_added DESC");
+    auto queryResult = scope.prepare("SELECT * FROM torrents ORDER BY date_added DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
         return makeUnexpected(executeResult.error());
@@ -479,7 +934,15 @@ Expected<bool, StorageError> StorageManager::createTables() {
         "CREATE INDEX IF NOT EXISTS idx_media_torrent_hash ON media(torrent_hash)",
         "CREATE INDEX IF NOT EXISTS idx_media_date_added ON media(date_added)",
         "CREATE INDEX IF NOT EXISTS idx_transcriptions_media_id ON transcriptions(media_id)",
-        "CREATE INDEX IF NOT EXISTS idx_playback_sessions_media_id ON playback_sessions(media_id)"
+        "CREATE INDEX IF NOT EXISTS idx_playback_sessions_media_id ON playback_sessions(media_id)",
+        
+        // Keyset pagination indexes
+        "CREATE INDEX IF NOT EXISTS idx_torrents_page ON torrents(date_added, info_hash)",
+        "CREATE INDEX IF NOT EXISTS idx_media_page ON media(date_added, id)",
+        "CREATE INDEX IF NOT EXISTS idx_transcriptions_page ON transcriptions(date_created, id)",
+        
+        // Content hash recorded by imports, for reusing results across copies
+        "CREATE INDEX IF NOT EXISTS idx_media_content_hash ON media(json_extract(metadata, '$.contentHash'))"
     };
     
     for (const QString& statement : createStatements) {
@@ -490,6 +953,77 @@ Expected<bool, StorageError> StorageManager::createTables() {
         }
     }
     
+    return createSearchIndex();
+}
+
+Expected<bool, StorageError> StorageManager::createSearchIndex() {
+    searchIndexAvailable_ = false;
+    
+    for (const auto& definition : searchIndexDefinitions()) {
+        QSqlQuery query(database_);
+        
+        query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = ?");
+        query.bindValue(0, QString::fromLatin1(definition.table));
+        bool existed = query.exec() && query.next() && query.value(0).toInt() > 0;
+        
+        // SQLite builds without FTS5 keep working on the LIKE fallback
+        if (!query.exec(definition.create)) {
+            Logger::instance().warn("Full-text search unavailable, {}: {}",
+                                    definition.table, query.lastError().text().toStdString());
+            return true;
+        }
+        
+        for (const QString& trigger : definition.triggers) {
+            if (!query.exec(trigger)) {
+                Logger::instance().error("Failed to create search trigger: {}", query.lastError().text().toStdString());
+                return makeUnexpected(StorageError::QueryFailed);
+            }
+        }
+        
+        // Backfill rows written before the index existed
+        if (!existed && !query.exec(definition.populate)) {
+            Logger::instance().error("Failed to populate {}: {}", definition.table, query.lastError().text().toStdString());
+            return makeUnexpected(StorageError::QueryFailed);
+        }
+    }
+    
+    searchIndexAvailable_ = true;
+    return true;
+}
+
+bool StorageManager::dropLegacySearchIndex() {
+    QSqlQuery query(database_);
+    for (const char* trigger : SEARCH_INDEX_TRIGGERS) {
+        if (!query.exec(QString("DROP TRIGGER IF EXISTS %1").arg(QString::fromLatin1(trigger)))) {
+            return false;
+        }
+    }
+    for (const auto& definition : searchIndexDefinitions()) {
+        if (!query.exec(QString("DROP TABLE IF EXISTS %1").arg(QString::fromLatin1(definition.table)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Caller holds databaseMutex_
+Expected<bool, StorageError> StorageManager::repopulateSearchIndexLocked() {
+    if (!database_.transaction()) {
+        return makeUnexpected(StorageError::TransactionFailed);
+    }
+    
+    QSqlQuery query(database_);
+    for (const auto& definition : searchIndexDefinitions()) {
+        if (!query.exec(QString("DELETE FROM %1").arg(definition.table)) || !query.exec(definition.populate)) {
+            Logger::instance().error("Search index rebuild failed: {}", query.lastError().text().toStdString());
+            database_.rollback();
+            return makeUnexpected(StorageError::QueryFailed);
+        }
+    }
+    
+    if (!database_.commit()) {
+        return makeUnexpected(StorageError::TransactionFailed);
+    }
     return true;
 }
 
@@ -515,18 +1049,165 @@ Expected<bool, StorageError> StorageManager::validateSchema() {
     return true;
 }
 
-Expected<QSqlQuery, StorageError> StorageManager::prepareQuery(const QString& sql) {
-    if (!database_.isOpen()) {
+Expected<QSqlQuery*, StorageError> StorageManager::prepareQuery(const QString& sql) {
+    return prepareCached(database_, statementCache_, sql);
+}
+
+Expected<QSqlQuery*, StorageError> StorageManager::prepareCached(QSqlDatabase& database, StatementCache& cache, const QString& sql) {
+    if (!database.isOpen()) {
         return makeUnexpected(StorageError::DatabaseNotOpen);
     }
     
-    QSqlQuery query(database_);
-    if (!query.prepare(sql)) {
-        Logger::instance().error("Failed to prepare query: {}", query.lastError().text().toStdString());
+    auto it = cache.find(sql);
+    if (it != cache.end()) {
+        ++statementCacheHits_;
+        // Reset the previous run; callers rebind every placeholder
+        it->second->finish();
+        return it->second.get();
+    }
+    
+    ++statementCacheMisses_;
+    
+    auto query = std::make_unique<QSqlQuery>(database);
+    query->setForwardOnly(true);
+    if (!query->prepare(sql)) {
+        Logger::instance().error("Failed to prepare query: {}", query->lastError().text().toStdString());
         return makeUnexpected(StorageError::QueryFailed);
     }
     
-    return query;
+    QSqlQuery* prepared = query.get();
+    cache.emplace(sql, std::move(query));
+    return prepared;
+}
+
+StorageManager::ReadScope::ReadScope(StorageManager* manager)
+    : manager_(manager) {
+    manager_->connectionLock_.lockForRead();
+    reader_ = manager_->readerForCurrentThread();
+    if (!reader_) {
+        manager_->databaseMutex_.lock();
+    }
+}
+
+StorageManager::ReadScope::~ReadScope() {
+    // An unfinished SELECT would pin this connection's WAL snapshot
+    for (QSqlQuery* query : prepared_) {
+        query->finish();
+    }
+    if (!reader_) {
+        manager_->databaseMutex_.unlock();
+    }
+    manager_->connectionLock_.unlock();
+}
+
+Expected<QSqlQuery*, StorageError> StorageManager::ReadScope::prepare(const QString& sql) {
+    auto result = reader_
+        ? manager_->prepareCached(reader_->database, reader_->statements, sql)
+        : manager_->prepareQuery(sql);
+    if (result.hasValue()) {
+        prepared_.append(result.value());
+    }
+    return result;
+}
+
+std::shared_ptr<StorageManager::ReaderConnection> StorageManager::readerForCurrentThread() {
+    // Inside an explicit transaction reads must see its uncommitted writes
+    if (!readersEnabled_ || inTransaction_) {
+        return nullptr;
+    }
+    
+    QThread* thread = QThread::currentThread();
+    
+    // A reader left over from an earlier connection is closed here, on the
+    // thread that opened it
+    std::shared_ptr<ReaderConnection> stale;
+    QMutexLocker locker(&readersMutex_);
+    
+    auto it = readers_.find(thread);
+    if (it != readers_.end()) {
+        if (it.value()->generation == readerGeneration_) {
+            return it.value();
+        }
+        stale = it.value();
+        readers_.erase(it);
+    }
+    
+    if (readers_.size() >= MAX_READER_CONNECTIONS) {
+        return nullptr;
+    }
+    
+    auto reader = std::make_shared<ReaderConnection>();
+    reader->name = QString("%1_reader_%2").arg(connectionName_).arg(++readerSerial_);
+    reader->generation = readerGeneration_;
+    reader->database = QSqlDatabase::addDatabase("QSQLITE", reader->name);
+    reader->database.setDatabaseName(database_.databaseName());
+    
+    if (!reader->database.open()) {
+        Logger::instance().warn("Failed to open reader connection: {}", reader->database.lastError().text().toStdString());
+        return nullptr;
+    }
+    
+    QSqlQuery config(reader->database);
+    config.exec(QString("PRAGMA cache_size = -%1").arg(DEFAULT_CACHE_SIZE_MB * 1024));
+    config.exec("PRAGMA query_only = ON");
+    
+    // Qt connections are thread-affine, so the reader dies with its thread
+    reader->threadFinished = connect(thread, &QThread::finished, this, [this, thread]() {
+        releaseReader(thread);
+    }, Qt::DirectConnection);
+    
+    readers_.insert(thread, reader);
+    return reader;
+}
+
+void StorageManager::releaseReader(QThread* thread) {
+    std::shared_ptr<ReaderConnection> reader;
+    {
+        QMutexLocker locker(&readersMutex_);
+        reader = readers_.take(thread);
+    }
+}
+
+void StorageManager::closeReaders() {
+    // connectionLock_ is held exclusively, so no reader is in use. Connections
+    // may only be closed by their own thread: other threads' readers are
+    // marked stale and go on their next read or when the thread finishes.
+    std::shared_ptr<ReaderConnection> own;
+    {
+        QMutexLocker locker(&readersMutex_);
+        ++readerGeneration_;
+        own = readers_.take(QThread::currentThread());
+    }
+    readersEnabled_ = false;
+}
+
+int StorageManager::readerConnectionCount() const {
+    // Stale readers are only waiting for their thread to drop them
+    QMutexLocker locker(&readersMutex_);
+    return std::count_if(readers_.cbegin(), readers_.cend(), [this](const auto& reader) {
+        return reader->generation == readerGeneration_;
+    });
+}
+
+void StorageManager::finishCachedStatements() {
+    // Open read cursors block VACUUM, checkpoints and some DDL
+    for (auto& entry : statementCache_) {
+        entry.second->finish();
+    }
+}
+
+void StorageManager::invalidateStatementCache() {
+    statementCache_.clear();
+}
+
+StatementCacheStats StorageManager::getStatementCacheStats() const {
+    QMutexLocker locker(&databaseMutex_);
+    
+    StatementCacheStats stats;
+    stats.hits = statementCacheHits_;
+    stats.misses = statementCacheMisses_;
+    stats.cachedStatements = static_cast<int>(statementCache_.size());
+    return stats;
 }
 
 Expected<bool, StorageError> StorageManager::executeQuery(QSqlQuery& query) {
@@ -596,6 +1277,29 @@ void StorageManager::bindTorrentParams(QSqlQuery& query, const TorrentRecord& to
     query.bindValue(15, torrent.ratio);
 }
 
+void StorageManager::bindTorrentUpdateParams(QSqlQuery& query, const TorrentRecord& torrent) {
+    // Bind parameters (info_hash last, as the WHERE condition)
+    query.bindValue(0, torrent.name);
+    query.bindValue(1, torrent.magnetUri);
+    query.bindValue(2, torrent.size);
+    query.bindValue(3, torrent.lastActive);
+    query.bindValue(4, torrent.savePath);
+    query.bindValue(5, torrent.progress);
+    query.bindValue(6, torrent.status);
+    query.bindValue(7, QJsonDocument(torrent.metadata).toJson(QJsonDocument::Compact));
+    
+    // Ensure files is never null or empty by providing a valid empty string
+    QString filesString = torrent.files.isEmpty() ? "" : torrent.files.join(";");
+    query.bindValue(8, filesString);
+    
+    query.bindValue(9, torrent.seeders);
+    query.bindValue(10, torrent.leechers);
+    query.bindValue(11, torrent.downloaded);
+    query.bindValue(12, torrent.uploaded);
+    query.bindValue(13, torrent.ratio);
+    query.bindValue(14, torrent.infoHash);  // WHERE condition
+}
+
 Expected<bool, StorageError> StorageManager::validateTorrentRecord(const TorrentRecord& torrent) {
     if (torrent.infoHash.isEmpty() || !InputValidator::validateInfoHash(torrent.infoHash)) {
         Logger::instance().error("Invalid info hash: '{}'", torrent.infoHash.toStdString());
@@ -661,8 +1365,13 @@ StorageError StorageManager::mapSqlError(const QSqlError& error) {
 }
 
 Expected<bool, StorageError> StorageManager::migrateDatabase() {
+    QWriteLocker connectionLocker(&connectionLock_);
     QMutexLocker locker(&databaseMutex_);
-    
+    return migrateDatabaseLocked();
+}
+
+// Caller holds connectionLock_ for writing and databaseMutex_
+Expected<bool, StorageError> StorageManager::migrateDatabaseLocked() {
     // Get current schema version
     int currentVersion = 0;
     {
@@ -681,6 +1390,8 @@ Expected<bool, StorageError> StorageManager::migrateDatabase() {
     
     Logger::instance().info("Migrating database from version {} to {}", currentVersion, CURRENT_SCHEMA_VERSION);
     
+    finishCachedStatements();
+    
     // Begin transaction
     if (!database_.transaction()) {
         return makeUnexpected(StorageError::TransactionFailed);
@@ -707,6 +1418,12 @@ Expected<bool, StorageError> StorageManager::migrateDatabase() {
         return makeUnexpected(StorageError::TransactionFailed);
     }
     
+    // Cached statements were compiled against the old schema; readers
+    // reconnect lazily with fresh caches
+    invalidateStatementCache();
+    closeReaders();
+    readersEnabled_ = !database_.databaseName().contains(":memory:");
+    
     Logger::instance().info("Database migration completed successfully");
     return true;
 }
@@ -785,6 +1502,51 @@ bool StorageManager::applyMigration(int toVersion) {
             
             break;
             
+        case 2:
+            // Full-text search index and sync triggers
+            if (createSearchIndex().hasError()) {
+                return false;
+            }
+            
+            break;
+            
+        case 3:
+            // Keyset pagination indexes
+            if (!query.exec("CREATE INDEX IF NOT EXISTS idx_torrents_page ON torrents(date_added, info_hash)")) {
+                return false;
+            }
+            
+            if (!query.exec("CREATE INDEX IF NOT EXISTS idx_media_page ON media(date_added, id)")) {
+                return false;
+            }
+            
+            if (!query.exec("CREATE INDEX IF NOT EXISTS idx_transcriptions_page ON transcriptions(date_created, id)")) {
+                return false;
+            }
+            
+            // Keyset cursors cannot step past NULL sort values
+            if (!query.exec("UPDATE transcriptions SET date_created = CURRENT_TIMESTAMP WHERE date_created IS NULL")) {
+                return false;
+            }
+            
+            break;
+            
+        case 4:
+            // Content hash lookups
+            if (!query.exec("CREATE INDEX IF NOT EXISTS idx_media_content_hash ON media(json_extract(metadata, '$.contentHash'))")) {
+                return false;
+            }
+            
+            break;
+            
+        case 5:
+            // Search index rows keyed by rowid; the old ones were found by scan
+            if (!dropLegacySearchIndex() || createSearchIndex().hasError()) {
+                return false;
+            }
+            
+            break;
+            
         default:
             Logger::instance().warn("Unknown migration version: {}", toVersion);
             return false;
@@ -798,14 +1560,14 @@ Expected<MediaRecord, StorageError> StorageManager::getMedia(const QString& medi
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery(sqlSelectMedia_);
+    auto queryResult = scope.prepare(sqlSelectMedia_);
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, mediaId);
     
     auto executeResult = executeQuery(query);
@@ -825,14 +1587,14 @@ Expected<QList<MediaRecord>, StorageError> StorageManager::getMediaByTorrent(con
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM media WHERE torrent_hash = ? ORDER BY date_added DESC");
+    auto queryResult = scope.prepare("SELECT * FROM media WHERE torrent_hash = ? ORDER BY date_added DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, torrentHash);
     
     auto executeResult = executeQuery(query);
@@ -848,19 +1610,59 @@ Expected<QList<MediaRecord>, StorageError> StorageManager::getMediaByTorrent(con
     return mediaList;
 }
 
+Expected<QList<MediaRecord>, StorageError> StorageManager::getMediaByContentHash(const QString& contentHash) {
+    static const QRegularExpression hexPattern("^[0-9a-f]{32}$");
+    if (!hexPattern.match(contentHash).hasMatch()) {
+        return makeUnexpected(StorageError::InvalidData);
+    }
+    
+    ReadScope scope(this);
+    
+    // Same expression as idx_media_content_hash so the index is used
+    auto queryResult = scope.prepare("SELECT * FROM media WHERE json_extract(metadata, '$.contentHash') = ? ORDER BY date_added DESC");
+    if (queryResult.hasError()) {
+        return makeUnexpected(queryResult.error());
+    }
+    
+    QSqlQuery& query = *queryResult.value();
+    query.bindValue(0, contentHash);
+    
+    auto executeResult = executeQuery(query);
+    if (executeResult.hasError()) {
+        return makeUnexpected(executeResult.error());
+    }
+    
+    QList<MediaRecord> mediaList;
+    while (query.next()) {
+        mediaList.append(mediaFromQuery(query));
+    }
+    
+    return mediaList;
+}
+
 Expected<QList<MediaRecord>, StorageError> StorageManager::searchMedia(const QString& query) {
-    QMutexLocker locker(&databaseMutex_);
+    QStringList terms = searchTerms(query);
     
-    QString searchQuery = "SELECT * FROM media WHERE original_name LIKE ? OR file_path LIKE ? ORDER BY date_added DESC";
-    auto queryResult = prepareQuery(searchQuery);
+    ReadScope scope(this);
+    
+    bool useIndex = searchIndexAvailable_ && !terms.isEmpty();
+    QString searchQuery = useIndex
+        ? R"(SELECT media.* FROM media_fts JOIN media ON media.rowid = media_fts.rowid
+             WHERE media_fts MATCH ? ORDER BY bm25(media_fts), media.date_added DESC)"
+        : "SELECT * FROM media WHERE original_name LIKE ? OR file_path LIKE ? ORDER BY date_added DESC";
+    auto queryResult = scope.prepare(searchQuery);
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery sqlQuery = std::move(queryResult.value());
-    QString searchPattern = "%" + query + "%";
-    sqlQuery.bindValue(0, searchPattern);
-    sqlQuery.bindValue(1, searchPattern);
+    QSqlQuery& sqlQuery = *queryResult.value();
+    if (useIndex) {
+        sqlQuery.bindValue(0, buildMatchExpression(terms));
+    } else {
+        QString searchPattern = "%" + query + "%";
+        sqlQuery.bindValue(0, searchPattern);
+        sqlQuery.bindValue(1, searchPattern);
+    }
     
     auto executeResult = executeQuery(sqlQuery);
     if (executeResult.hasError()) {
@@ -883,7 +1685,7 @@ Expected<bool, StorageError> StorageManager::updatePlaybackPosition(const QStrin
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, position);
     query.bindValue(1, QDateTime::currentDateTime());
     query.bindValue(2, mediaId);
@@ -928,7 +1730,7 @@ Expected<QString, StorageError> StorageManager::insertMediaRecord(const MediaRec
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     bindMediaParams(query, mediaWithId);
     
     auto executeResult = executeQuery(query);
@@ -1077,7 +1879,7 @@ Expected<QString, StorageError> StorageManager::addTranscription(const Transcrip
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     bindTranscriptionParams(query, transcriptionWithId);
     
     auto executeResult = executeQuery(query);
@@ -1101,7 +1903,7 @@ Expected<bool, StorageError> StorageManager::updateMedia(const MediaRecord& medi
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     
     // Bind parameters (excluding id which is WHERE condition)
     query.bindValue(0, media.torrentHash);
@@ -1131,14 +1933,14 @@ Expected<bool, StorageError> StorageManager::updateMedia(const MediaRecord& medi
 }
 
 Expected<TranscriptionRecord, StorageError> StorageManager::getTranscriptionByMedia(const QString& mediaId) {
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM transcriptions WHERE media_id = ? ORDER BY date_created DESC LIMIT 1");
+    auto queryResult = scope.prepare("SELECT * FROM transcriptions WHERE media_id = ? ORDER BY date_created DESC LIMIT 1");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, mediaId);
     
     auto executeResult = executeQuery(query);
@@ -1184,7 +1986,8 @@ void StorageManager::bindTranscriptionParams(QSqlQuery& query, const Transcripti
     query.bindValue(4, transcription.fullText);
     query.bindValue(5, QJsonDocument(transcription.timestamps).toJson(QJsonDocument::Compact));
     query.bindValue(6, transcription.confidence);
-    query.bindValue(7, transcription.dateCreated);
+    // NULL dates would drop out of keyset pagination
+    query.bindValue(7, transcription.dateCreated.isValid() ? transcription.dateCreated : QDateTime::currentDateTime());
     query.bindValue(8, transcription.processingTime);
     query.bindValue(9, transcription.status);
 }
@@ -1247,7 +2050,7 @@ Expected<bool, StorageError> StorageManager::removeTorrent(const QString& infoHa
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, infoHash);
     
     auto executeResult = executeQuery(query);
@@ -1265,14 +2068,14 @@ Expected<bool, StorageError> StorageManager::removeTorrent(const QString& infoHa
 }
 
 Expected<QList<TorrentRecord>, StorageError> StorageManager::getActiveTorrents() {
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM torrents WHERE status IN ('downloading', 'seeding', 'checking') ORDER BY last_active DESC");
+    auto queryResult = scope.prepare("SELECT * FROM torrents WHERE status IN ('downloading', 'seeding', 'checking') ORDER BY last_active DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
         return makeUnexpected(executeResult.error());
@@ -1302,7 +2105,7 @@ Expected<bool, StorageError> StorageManager::updateTorrentProgress(const QString
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, progress);
     query.bindValue(1, QDateTime::currentDateTime());
     query.bindValue(2, infoHash);
@@ -1336,7 +2139,7 @@ Expected<bool, StorageError> StorageManager::updateTorrentStatus(const QString&
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, status);
     query.bindValue(1, QDateTime::currentDateTime());
     query.bindValue(2, infoHash);
@@ -1365,7 +2168,7 @@ Expected<bool, StorageError> StorageManager::removeMedia(const QString& mediaId)
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, mediaId);
     
     auto executeResult = executeQuery(query);
@@ -1382,14 +2185,14 @@ Expected<bool, StorageError> StorageManager::removeMedia(const QString& mediaId)
 }
 
 Expected<QList<MediaRecord>, StorageError> StorageManager::getAllMedia() {
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM media ORDER BY date_added DESC");
+    auto queryResult = scope.prepare("SELECT * FROM media ORDER BY date_added DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
         return makeUnexpected(executeResult.error());
@@ -1408,14 +2211,14 @@ Expected<QList<MediaRecord>, StorageError> StorageManager::getRecentMedia(int li
         limit = 20; // Default fallback
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM media WHERE last_played IS NOT NULL ORDER BY last_played DESC LIMIT ?");
+    auto queryResult = scope.prepare("SELECT * FROM media WHERE last_played IS NOT NULL ORDER BY last_played DESC LIMIT ?");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, limit);
     
     auto executeResult = executeQuery(query);
@@ -1444,7 +2247,7 @@ Expected<bool, StorageError> StorageManager::updateTranscription(const Transcrip
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     
     // Bind parameters (excluding id which is WHERE condition)
     query.bindValue(0, transcription.language);
@@ -1480,7 +2283,7 @@ Expected<bool, StorageError> StorageManager::removeTranscription(const QString&
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, transcriptionId);
     
     auto executeResult = executeQuery(query);
@@ -1501,14 +2304,14 @@ Expected<TranscriptionRecord, StorageError> StorageManager::getTranscription(con
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery(sqlSelectTranscription_);
+    auto queryResult = scope.prepare(sqlSelectTranscription_);
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, transcriptionId);
     
     auto executeResult = executeQuery(query);
@@ -1524,14 +2327,14 @@ Expected<TranscriptionRecord, StorageError> StorageManager::getTranscription(con
 }
 
 Expected<QList<TranscriptionRecord>, StorageError> StorageManager::getAllTranscriptions() {
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM transcriptions ORDER BY date_created DESC");
+    auto queryResult = scope.prepare("SELECT * FROM transcriptions ORDER BY date_created DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
         return makeUnexpected(executeResult.error());
@@ -1562,7 +2365,7 @@ Expected<bool, StorageError> StorageManager::updateTranscriptionStatus(const QSt
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, status);
     query.bindValue(1, transcriptionId);
     
@@ -1579,7 +2382,7 @@ Expected<bool, StorageError> StorageManager::updateTranscriptionStatus(const QSt
         // Update media has_transcription flag
         auto mediaUpdateResult = prepareQuery("UPDATE media SET has_transcription = TRUE WHERE id = (SELECT media_id FROM transcriptions WHERE id = ?)");
         if (mediaUpdateResult.hasValue()) {
-            QSqlQuery mediaQuery = std::move(mediaUpdateResult.value());
+            QSqlQuery& mediaQuery = *mediaUpdateResult.value();
             mediaQuery.bindValue(0, transcriptionId);
             executeQuery(mediaQuery);
         }
@@ -1598,7 +2401,7 @@ Expected<QString, StorageError> StorageManager::recordPlaybackSession(const Play
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     bindSessionParams(query, session);
     
     auto executeResult = executeQuery(query);
@@ -1618,7 +2421,7 @@ Expected<bool, StorageError> StorageManager::updatePlaybackSession(const Playbac
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, session.endTime);
     query.bindValue(1, session.endPosition);
     query.bindValue(2, session.totalDuration);
@@ -1646,14 +2449,14 @@ Expected<QList<PlaybackSession>, StorageError> StorageManager::getPlaybackHistor
         limit = 10; // Default fallback
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM playback_sessions WHERE media_id = ? ORDER BY start_time DESC LIMIT ?");
+    auto queryResult = scope.prepare("SELECT * FROM playback_sessions WHERE media_id = ? ORDER BY start_time DESC LIMIT ?");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, mediaId);
     query.bindValue(1, limit);
     
@@ -1682,7 +2485,7 @@ Expected<bool, StorageError> StorageManager::markSessionCompleted(const QString&
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
+    QSqlQuery& query = *queryResult.value();
     query.bindValue(0, QDateTime::currentDateTime());
     query.bindValue(1, sessionId);
     
@@ -1712,7 +2515,7 @@ Expected<bool, StorageError> StorageManager::clearPlaybackPositions() {
         rollbackTransaction();
         return makeUnexpected(clearMediaQueryResult.error());
     }
-    QSqlQuery clearMediaQuery = std::move(clearMediaQueryResult.value());
+    QSqlQuery& clearMediaQuery = *clearMediaQueryResult.value();
     auto clearMediaResult = executeQuery(clearMediaQuery);
     if (clearMediaResult.hasError()) {
         rollbackTransaction();
@@ -1725,7 +2528,7 @@ Expected<bool, StorageError> StorageManager::clearPlaybackPositions() {
         rollbackTransaction();
         return makeUnexpected(clearSessionsQueryResult.error());
     }
-    QSqlQuery clearSessionsQuery = std::move(clearSessionsQueryResult.value());
+    QSqlQuery& clearSessionsQuery = *clearSessionsQueryResult.value();
     auto clearSessionsResult = executeQuery(clearSessionsQuery);
     if (clearSessionsResult.hasError()) {
         rollbackTransaction();
@@ -1748,17 +2551,27 @@ Expected<QList<TorrentRecord>, StorageError> StorageManager::searchTorrents(cons
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    QStringList terms = searchTerms(sanitizedQuery);
+    
+    ReadScope scope(this);
     
-    auto queryResult = prepareQuery("SELECT * FROM torrents WHERE name LIKE ? OR magnet_uri LIKE ? ORDER BY date_added DESC");
+    bool useIndex = searchIndexAvailable_ && !terms.isEmpty();
+    auto queryResult = scope.prepare(useIndex
+        ? R"(SELECT torrents.* FROM torrents_fts JOIN torrents ON torrents.rowid = torrents_fts.rowid
+             WHERE torrents_fts MATCH ? ORDER BY bm25(torrents_fts), torrents.date_added DESC)"
+        : "SELECT * FROM torrents WHERE name LIKE ? OR magnet_uri LIKE ? ORDER BY date_added DESC");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
-    QString searchPattern = "%" + sanitizedQuery + "%";
-    query.bindValue(0, searchPattern);
-    query.bindValue(1, searchPattern);
+    QSqlQuery& query = *queryResult.value();
+    if (useIndex) {
+        query.bindValue(0, buildMatchExpression(terms));
+    } else {
+        QString searchPattern = "%" + sanitizedQuery + "%";
+        query.bindValue(0, searchPattern);
+        query.bindValue(1, searchPattern);
+    }
     
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
@@ -1774,33 +2587,197 @@ Expected<QList<TorrentRecord>, StorageError> StorageManager::searchTorrents(cons
 }
 
 Expected<QList<TranscriptionRecord>, StorageError> StorageManager::searchTranscriptions(const QString& searchQuery) {
+    auto hitsResult = searchTranscriptionsRanked(searchQuery, -1);
+    if (hitsResult.hasError()) {
+        return makeUnexpected(hitsResult.error());
+    }
+    
+    QList<TranscriptionRecord> transcriptions;
+    for (auto& hit : hitsResult.value()) {
+        transcriptions.append(std::move(hit.transcription));
+    }
+    
+    return transcriptions;
+}
+
+Expected<QList<TranscriptionSearchHit>, StorageError> StorageManager::searchTranscriptionsRanked(const QString& searchQuery, int limit) {
     QString sanitizedQuery = sanitizeQuery(searchQuery);
     if (sanitizedQuery.isEmpty()) {
         return makeUnexpected(StorageError::InvalidData);
     }
     
-    QMutexLocker locker(&databaseMutex_);
+    QStringList terms = searchTerms(sanitizedQuery);
     
-    auto queryResult = prepareQuery("SELECT * FROM transcriptions WHERE full_text LIKE ? ORDER BY date_created DESC");
+    ReadScope scope(this);
+    
+    // bm25() is negative with better matches lower; snippet column 0 is full_text
+    bool useIndex = searchIndexAvailable_ && !terms.isEmpty();
+    auto queryResult = scope.prepare(useIndex
+        ? R"(SELECT transcriptions.*,
+                    snippet(transcriptions_fts, 0, '<b>', '</b>', '...', 24) AS match_snippet,
+                    bm25(transcriptions_fts) AS match_rank
+             FROM transcriptions_fts JOIN transcriptions ON transcriptions.rowid = transcriptions_fts.rowid
+             WHERE transcriptions_fts MATCH ?
+             ORDER BY match_rank, transcriptions.date_created DESC
+             LIMIT ?)"
+        : "SELECT * FROM transcriptions WHERE full_text LIKE ? ORDER BY date_created DESC LIMIT ?");
     if (queryResult.hasError()) {
         return makeUnexpected(queryResult.error());
     }
     
-    QSqlQuery query = std::move(queryResult.value());
-    QString searchPattern = "%" + sanitizedQuery + "%";
-    query.bindValue(0, searchPattern);
+    QSqlQuery& query = *queryResult.value();
+    query.bindValue(0, useIndex ? buildMatchExpression(terms) : "%" + sanitizedQuery + "%");
+    query.bindValue(1, limit > 0 ? limit : -1);
     
     auto executeResult = executeQuery(query);
     if (executeResult.hasError()) {
         return makeUnexpected(executeResult.error());
     }
     
-    QList<TranscriptionRecord> transcriptions;
+    QList<TranscriptionSearchHit> hits;
     while (query.next()) {
-        transcriptions.append(transcriptionFromQuery(query));
+        TranscriptionSearchHit hit;
+        hit.transcription = transcriptionFromQuery(query);
+        if (useIndex) {
+            hit.snippet = query.value("match_snippet").toString();
+            hit.score = -query.value("match_rank").toDouble();
+        }
+        locateSearchHit(hit, useIndex ? terms : QStringList{sanitizedQuery});
+        hits.append(std::move(hit));
     }
     
-    return transcriptions;
+    return hits;
+}
+
+// Paginated listings
+namespace {
+
+const QString TORRENT_SUMMARY_COLUMNS = "info_hash, name, size, date_added, progress, status, seeders, leechers";
+const QString MEDIA_SUMMARY_COLUMNS = "id, torrent_hash, original_name, mime_type, file_size, duration, width, height, "
+                                      "has_transcription, date_added, last_played, playback_position";
+const QString TRANSCRIPTION_SUMMARY_COLUMNS = "id, media_id, language, model_used, confidence, date_created, status";
+
+} // namespace
+
+template<typename T>
+Expected<RecordPage<T>, StorageError> StorageManager::fetchPage(const QString& columns, const QString& table,
+                                                                const QString& sortColumn, const QString& keyColumn,
+                                                                const PageCursor& after, int limit,
+                                                                T (StorageManager::*convert)(const QSqlQuery&)) {
+    limit = qBound(1, limit, MAX_PAGE_SIZE);
+    
+    // Row-value comparison lets SQLite seek the (sort, key) index directly
+    QString sql = QString("SELECT %1 FROM %2 %3 ORDER BY %4 DESC, %5 DESC LIMIT ?")
+        .arg(columns, table,
+             after.isValid() ? QString("WHERE (%1, %2) < (?, ?)").arg(sortColumn, keyColumn) : QString(),
+             sortColumn, keyColumn);
+    
+    ReadScope scope(this);
+    
+    auto queryResult = scope.prepare(sql);
+    if (queryResult.hasError()) {
+        return makeUnexpected(queryResult.error());
+    }
+    
+    QSqlQuery& query = *queryResult.value();
+    int index = 0;
+    if (after.isValid()) {
+        query.bindValue(index++, after.sortValue);
+        query.bindValue(index++, after.key);
+    }
+    // One extra row tells us whether another page exists
+    query.bindValue(index, limit + 1);
+    
+    auto executeResult = executeQuery(query);
+    if (executeResult.hasError()) {
+        return makeUnexpected(executeResult.error());
+    }
+    
+    RecordPage<T> page;
+    page.items.reserve(limit);
+    while (query.next()) {
+        if (page.items.size() == limit) {
+            page.hasMore = true;
+            break;
+        }
+        page.items.append((this->*convert)(query));
+        page.next.sortValue = query.value(sortColumn);
+        page.next.key = query.value(keyColumn).toString();
+    }
+    
+    return page;
+}
+
+Expected<RecordPage<TorrentRecord>, StorageError> StorageManager::getTorrentsPage(const PageCursor& after, int limit) {
+    return fetchPage<TorrentRecord>("*", "torrents", "date_added", "info_hash", after, limit,
+                                    &StorageManager::torrentFromQuery);
+}
+
+Expected<RecordPage<TorrentSummary>, StorageError> StorageManager::getTorrentSummaries(const PageCursor& after, int limit) {
+    return fetchPage<TorrentSummary>(TORRENT_SUMMARY_COLUMNS, "torrents", "date_added", "info_hash", after, limit,
+                                     &StorageManager::torrentSummaryFromQuery);
+}
+
+Expected<RecordPage<MediaRecord>, StorageError> StorageManager::getMediaPage(const PageCursor& after, int limit) {
+    return fetchPage<MediaRecord>("*", "media", "date_added", "id", after, limit,
+                                  &StorageManager::mediaFromQuery);
+}
+
+Expected<RecordPage<MediaSummary>, StorageError> StorageManager::getMediaSummaries(const PageCursor& after, int limit) {
+    return fetchPage<MediaSummary>(MEDIA_SUMMARY_COLUMNS, "media", "date_added", "id", after, limit,
+                                   &StorageManager::mediaSummaryFromQuery);
+}
+
+Expected<RecordPage<TranscriptionRecord>, StorageError> StorageManager::getTranscriptionsPage(const PageCursor& after, int limit) {
+    return fetchPage<TranscriptionRecord>("*", "transcriptions", "date_created", "id", after, limit,
+                                          &StorageManager::transcriptionFromQuery);
+}
+
+Expected<RecordPage<TranscriptionSummary>, StorageError> StorageManager::getTranscriptionSummaries(const PageCursor& after, int limit) {
+    return fetchPage<TranscriptionSummary>(TRANSCRIPTION_SUMMARY_COLUMNS, "transcriptions", "date_created", "id", after, limit,
+                                           &StorageManager::transcriptionSummaryFromQuery);
+}
+
+TorrentSummary StorageManager::torrentSummaryFromQuery(const QSqlQuery& query) {
+    TorrentSummary summary;
+    summary.infoHash = query.value("info_hash").toString();
+    summary.name = query.value("name").toString();
+    summary.size = query.value("size").toLongLong();
+    summary.dateAdded = query.value("date_added").toDateTime();
+    summary.progress = query.value("progress").toDouble();
+    summary.status = query.value("status").toString();
+    summary.seeders = query.value("seeders").toInt();
+    summary.leechers = query.value("leechers").toInt();
+    return summary;
+}
+
+MediaSummary StorageManager::mediaSummaryFromQuery(const QSqlQuery& query) {
+    MediaSummary summary;
+    summary.id = query.value("id").toString();
+    summary.torrentHash = query.value("torrent_hash").toString();
+    summary.originalName = query.value("original_name").toString();
+    summary.mimeType = query.value("mime_type").toString();
+    summary.fileSize = query.value("file_size").toLongLong();
+    summary.duration = query.value("duration").toLongLong();
+    summary.width = query.value("width").toInt();
+    summary.height = query.value("height").toInt();
+    summary.hasTranscription = query.value("has_transcription").toBool();
+    summary.dateAdded = query.value("date_added").toDateTime();
+    summary.lastPlayed = query.value("last_played").toDateTime();
+    summary.playbackPosition = query.value("playback_position").toLongLong();
+    return summary;
+}
+
+TranscriptionSummary StorageManager::transcriptionSummaryFromQuery(const QSqlQuery& query) {
+    TranscriptionSummary summary;
+    summary.id = query.value("id").toString();
+    summary.mediaId = query.value("media_id").toString();
+    summary.language = query.value("language").toString();
+    summary.modelUsed = query.value("model_used").toString();
+    summary.confidence = query.value("confidence").toDouble();
+    summary.dateCreated = query.value("date_created").toDateTime();
+    summary.status = query.value("status").toString();
+    return summary;
 }
 
 // Statistics operations 
@@ -1960,12 +2937,22 @@ Expected<bool, StorageError> StorageManager::vacuum() {
         return makeUnexpected(StorageError::DatabaseNotOpen);
     }
     
+    finishCachedStatements();
+    
     QSqlQuery query(database_);
     if (!query.exec("VACUUM")) {
         Logger::instance().error("VACUUM failed: {}", query.lastError().text().toStdString());
         return makeUnexpected(StorageError::QueryFailed);
     }
     
+    // Index rows follow rowids, which VACUUM may have renumbered
+    if (searchIndexAvailable_) {
+        auto rebuildResult = repopulateSearchIndexLocked();
+        if (rebuildResult.hasError()) {
+            return rebuildResult;
+        }
+    }
+    
     Logger::instance().info("Database VACUUM completed");
     return true;
 }
@@ -1977,6 +2964,8 @@ Expected<bool, StorageError> StorageManager::reindex() {
         return makeUnexpected(StorageError::DatabaseNotOpen);
     }
     
+    finishCachedStatements();
+    
     QSqlQuery query(database_);
     if (!query.exec("REINDEX")) {
         Logger::instance().error("REINDEX failed: {}", query.lastError().text().toStdString());
@@ -1987,6 +2976,55 @@ Expected<bool, StorageError> StorageManager::reindex() {
     return true;
 }
 
+Expected<bool, StorageError> StorageManager::rebuildSearchIndex() {
+    QMutexLocker locker(&databaseMutex_);
+    
+    if (!database_.isOpen()) {
+        return makeUnexpected(StorageError::DatabaseNotOpen);
+    }
+    
+    if (!searchIndexAvailable_) {
+        return makeUnexpected(StorageError::QueryFailed);
+    }
+    
+    auto result = repopulateSearchIndexLocked();
+    if (result.hasError()) {
+        return result;
+    }
+    
+    Logger::instance().info("Search index rebuild completed");
+    return true;
+}
+
+Expected<bool, StorageError> StorageManager::optimizeSearchIndex() {
+    QMutexLocker locker(&databaseMutex_);
+    
+    if (!database_.isOpen()) {
+        return makeUnexpected(StorageError::DatabaseNotOpen);
+    }
+    
+    if (!searchIndexAvailable_) {
+        return makeUnexpected(StorageError::QueryFailed);
+    }
+    
+    // Merges all b-tree segments of each index into one
+    QSqlQuery query(database_);
+    for (const auto& definition : searchIndexDefinitions()) {
+        if (!query.exec(QString("INSERT INTO %1(%1) VALUES('optimize')").arg(definition.table))) {
+            Logger::instance().error("Search index optimize failed: {}", query.lastError().text().toStdString());
+            return makeUnexpected(StorageError::QueryFailed);
+        }
+    }
+    
+    Logger::instance().info("Search index optimize completed");
+    return true;
+}
+
+bool StorageManager::isSearchIndexAvailable() const {
+    QMutexLocker locker(&databaseMutex_);
+    return searchIndexAvailable_;
+}
+
 Expected<bool, StorageError> StorageManager::cleanupOrphanedRecords() {
     QMutexLocker locker(&databaseMutex_);
     
@@ -2059,6 +3097,7 @@ Expected<bool, StorageError> StorageManager::backupDatabase(const QString& backu
     }
     
     // Ensure all pending transactions are committed before backup
+    finishCachedStatements();
     QSqlQuery commitQuery(database_);
     commitQuery.exec("PRAGMA wal_checkpoint(FULL)");
     
@@ -2080,6 +3119,7 @@ Expected<bool, StorageError> StorageManager::backupDatabase(const QString& backu
 }
 
 Expected<bool, StorageError> StorageManager::restoreDatabase(const QString& backupPath) {
+    QWriteLocker connectionLocker(&connectionLock_);
     QMutexLocker locker(&databaseMutex_);
     
     QFileInfo backupInfo(backupPath);
@@ -2089,6 +3129,8 @@ Expected<bool, StorageError> StorageManager::restoreDatabase(const QString& back
     
     // Close current database
     QString currentPath = database_.databaseName();
+    closeReaders();
+    invalidateStatementCache();
     database_.close();
     
     // Remove current database
@@ -2132,8 +3174,16 @@ Expected<bool, StorageError> StorageManager::restoreDatabase(const QString& back
             Logger::instance().error("Failed to create schema for restored database");
             return schemaResult;
         }
+    } else {
+        // Backups taken before the search index existed are backfilled here
+        auto indexResult = createSearchIndex();
+        if (indexResult.hasError()) {
+            return indexResult;
+        }
     }
     
+    readersEnabled_ = !currentPath.contains(":memory:");
+    
     Logger::instance().info("Database restored from: {}", backupPath.toStdString());
     return true;
 }
@@ -2202,6 +3252,58 @@ QString StorageManager::sanitizeQuery(const QString& query) {
     return sanitized.trimmed();
 }
 
+QStringList StorageManager::searchTerms(const QString& query) const {
+    static const QRegularExpression separators(R"([^\w]+)", QRegularExpression::UseUnicodePropertiesOption);
+    
+    QStringList terms = query.split(separators, Qt::SkipEmptyParts);
+    if (terms.size() > MAX_SEARCH_TERMS) {
+        terms = terms.mid(0, MAX_SEARCH_TERMS);
+    }
+    
+    return terms;
+}
+
+QString StorageManager::buildMatchExpression(const QStringList& terms) const {
+    // Each term is quoted so FTS5 operators in user input are taken literally,
+    // and prefix-matched so partial words behave like the old LIKE search
+    QStringList phrases;
+    for (const QString& term : terms) {
+        phrases.append(QString("\"%1\"*").arg(term));
+    }
+    
+    return phrases.join(' ');
+}
+
+void StorageManager::locateSearchHit(TranscriptionSearchHit& hit, const QStringList& terms) const {
+    const QString& text = hit.transcription.fullText;
+    
+    for (const QString& term : terms) {
+        int offset = text.indexOf(term, 0, Qt::CaseInsensitive);
+        if (offset >= 0 && (hit.matchOffset < 0 || offset < hit.matchOffset)) {
+            hit.matchOffset = offset;
+        }
+    }
+    
+    if (hit.matchOffset < 0) {
+        return;
+    }
+    
+    // Segment texts concatenate (space separated) to fullText, so walk them
+    // until the running length passes the match offset
+    QJsonArray segments = hit.transcription.timestamps.value("segments").toArray();
+    int position = 0;
+    for (int i = 0; i < segments.size(); ++i) {
+        QJsonObject segment = segments.at(i).toObject();
+        position += segment.value("text").toString().length() + 1;
+        if (position > hit.matchOffset) {
+            hit.segmentIndex = i;
+            hit.segmentStart = segment.value("startTime").toInteger();
+            hit.segmentEnd = segment.value("endTime").toInteger();
+            return;
+        }
+    }
+}
+
 Expected<bool, StorageError> StorageManager::performMigration(int targetVersion) {
     switch (targetVersion) {
         case 1:
@@ -2209,6 +3311,15 @@ Expected<bool, StorageError> StorageManager::performMigration(int targetVersion)
             Logger::instance().info("Migration to version 1: Initial schema");
             return true;
             
+        case 2:
+            // Search index is created alongside the tables in createTables()
+            Logger::instance().info("Migration to version 2: Full-text search index");
+            return true;
+            
+        case 3:
+            Logger::instance().info("Migration to version 3: Pagination indexes");
+            return true;
+            
         default:
             Logger::instance().error("Unknown migration target version: {}", targetVersion);
             return makeUnexpected(StorageError::QueryFailed);
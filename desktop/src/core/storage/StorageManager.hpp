@@ -5,6 +5,10 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QTimer>
+#include <QHash>
 #include <QDateTime>
 #include <QVariant>
 #include <QJsonObject>
@@ -13,6 +17,11 @@
 #include "../common/RetryManager.hpp"
 #include "../common/ErrorRecovery.hpp"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
 namespace Murmur {
 
 enum class StorageError {
@@ -115,6 +124,75 @@ struct PlaybackSession {
     bool completed;
 };
 
+// List-view projections: no metadata/timestamps JSON and no transcript text
+struct TorrentSummary {
+    QString infoHash;
+    QString name;
+    qint64 size = 0;
+    QDateTime dateAdded;
+    double progress = 0.0;
+    QString status;
+    int seeders = 0;
+    int leechers = 0;
+};
+
+struct MediaSummary {
+    QString id;
+    QString torrentHash;
+    QString originalName;
+    QString mimeType;
+    qint64 fileSize = 0;
+    qint64 duration = 0;  // milliseconds
+    int width = 0;
+    int height = 0;
+    bool hasTranscription = false;
+    QDateTime dateAdded;
+    QDateTime lastPlayed;
+    qint64 playbackPosition = 0;  // milliseconds
+};
+
+struct TranscriptionSummary {
+    QString id;
+    QString mediaId;
+    QString language;
+    QString modelUsed;
+    double confidence = 0.0;
+    QDateTime dateCreated;
+    QString status;
+};
+
+// Keyset position in (date, id) descending order; default means first page.
+// The sort value is kept exactly as stored so it compares the same on rebind.
+struct PageCursor {
+    QVariant sortValue;
+    QString key;
+    
+    bool isValid() const { return !key.isEmpty(); }
+};
+
+template<typename T>
+struct RecordPage {
+    QList<T> items;
+    PageCursor next;       // Pass back to fetch the following page
+    bool hasMore = false;
+};
+
+struct StatementCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    int cachedStatements = 0;
+};
+
+struct TranscriptionSearchHit {
+    TranscriptionRecord transcription;
+    QString snippet;          // Excerpt with matches wrapped in <b></b>
+    double score = 0.0;       // BM25 relevance, higher is better
+    int matchOffset = -1;     // Character offset of the first match in fullText
+    int segmentIndex = -1;    // Index into timestamps["segments"], -1 if not located
+    qint64 segmentStart = 0;  // milliseconds
+    qint64 segmentEnd = 0;    // milliseconds
+};
+
 /**
  * @brief SQLite-based storage manager for application data
  * 
@@ -123,6 +201,9 @@ struct PlaybackSession {
  */
 class StorageManager : public QObject {
     Q_OBJECT
+    
+    struct ReaderConnection;
+    using StatementCache = std::unordered_map<QString, std::unique_ptr<QSqlQuery>>;
 
 public:
     explicit StorageManager(QObject* parent = nullptr);
@@ -138,6 +219,20 @@ public:
     Expected<bool, StorageError> commitTransaction();
     Expected<bool, StorageError> rollbackTransaction();
     
+    // Bulk writes (one transaction per call)
+    Expected<bool, StorageError> updateTorrentsBulk(const QList<TorrentRecord>& torrents);
+    Expected<QStringList, StorageError> upsertMediaBatch(const QList<MediaRecord>& media);
+    
+    // Write-behind queue: writes to the same key within the window coalesce
+    // and are flushed together in one transaction on the thread that owns the
+    // connection. Queueing is safe from any thread.
+    void queueTorrentUpdate(const TorrentRecord& torrent);
+    void queueTorrentProgress(const QString& infoHash, double progress);
+    void queuePlaybackPosition(const QString& mediaId, qint64 position);
+    Expected<bool, StorageError> flushPendingWrites();
+    void setWriteBehindWindow(int milliseconds);
+    int pendingWriteCount() const;
+    
     // Torrent operations
     Expected<bool, StorageError> addTorrent(const TorrentRecord& torrent);
     Expected<bool, StorageError> updateTorrent(const TorrentRecord& torrent);
@@ -145,6 +240,8 @@ public:
     Expected<TorrentRecord, StorageError> getTorrent(const QString& infoHash);
     Expected<QList<TorrentRecord>, StorageError> getAllTorrents();
     Expected<QList<TorrentRecord>, StorageError> getActiveTorrents();
+    Expected<RecordPage<TorrentRecord>, StorageError> getTorrentsPage(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
+    Expected<RecordPage<TorrentSummary>, StorageError> getTorrentSummaries(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
     Expected<bool, StorageError> updateTorrentProgress(const QString& infoHash, double progress);
     Expected<bool, StorageError> updateTorrentStatus(const QString& infoHash, const QString& status);
     
@@ -154,7 +251,10 @@ public:
     Expected<bool, StorageError> removeMedia(const QString& mediaId);
     Expected<MediaRecord, StorageError> getMedia(const QString& mediaId);
     Expected<QList<MediaRecord>, StorageError> getMediaByTorrent(const QString& torrentHash);
+    Expected<QList<MediaRecord>, StorageError> getMediaByContentHash(const QString& contentHash);
     Expected<QList<MediaRecord>, StorageError> getAllMedia();
+    Expected<RecordPage<MediaRecord>, StorageError> getMediaPage(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
+    Expected<RecordPage<MediaSummary>, StorageError> getMediaSummaries(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
     Expected<bool, StorageError> updatePlaybackPosition(const QString& mediaId, qint64 position);
     Expected<QList<MediaRecord>, StorageError> getRecentMedia(int limit = 20);
     
@@ -165,6 +265,8 @@ public:
     Expected<TranscriptionRecord, StorageError> getTranscription(const QString& transcriptionId);
     Expected<TranscriptionRecord, StorageError> getTranscriptionByMedia(const QString& mediaId);
     Expected<QList<TranscriptionRecord>, StorageError> getAllTranscriptions();
+    Expected<RecordPage<TranscriptionRecord>, StorageError> getTranscriptionsPage(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
+    Expected<RecordPage<TranscriptionSummary>, StorageError> getTranscriptionSummaries(const PageCursor& after = {}, int limit = DEFAULT_PAGE_SIZE);
     Expected<bool, StorageError> updateTranscriptionStatus(const QString& transcriptionId, const QString& status);
     
     // Playback history
@@ -178,6 +280,7 @@ public:
     Expected<QList<TorrentRecord>, StorageError> searchTorrents(const QString& query);
     Expected<QList<MediaRecord>, StorageError> searchMedia(const QString& query);
     Expected<QList<TranscriptionRecord>, StorageError> searchTranscriptions(const QString& query);
+    Expected<QList<TranscriptionSearchHit>, StorageError> searchTranscriptionsRanked(const QString& query, int limit = 50);
     
     // Statistics and analytics
     Expected<QJsonObject, StorageError> getTorrentStatistics();
@@ -188,6 +291,9 @@ public:
     // Maintenance operations
     Expected<bool, StorageError> vacuum();
     Expected<bool, StorageError> reindex();
+    Expected<bool, StorageError> rebuildSearchIndex();
+    Expected<bool, StorageError> optimizeSearchIndex();
+    bool isSearchIndexAvailable() const;
     Expected<bool, StorageError> cleanupOrphanedRecords();
     Expected<bool, StorageError> backupDatabase(const QString& backupPath);
     Expected<bool, StorageError> restoreDatabase(const QString& backupPath);
@@ -197,6 +303,8 @@ public:
     void setCacheSize(int sizeMB);
     void setJournalMode(const QString& mode);  // "WAL", "DELETE", "TRUNCATE"
     Expected<int, StorageError> getSchemaVersion() const;
+    StatementCacheStats getStatementCacheStats() const;
+    int readerConnectionCount() const;
     
     // Testing support
     Expected<bool, StorageError> testMigrateDatabase();
@@ -208,6 +316,7 @@ signals:
     void mediaAdded(const QString& mediaId);
     void mediaUpdated(const QString& mediaId);
     void transcriptionCompleted(const QString& mediaId);
+    void playbackPositionSaved(const QString& mediaId, qint64 position);
     void databaseError(StorageError error, const QString& description);
 
 private slots:
@@ -217,15 +326,51 @@ private:
     // Database initialization
     Expected<bool, StorageError> createTables();
     Expected<bool, StorageError> migrateDatabase();
+    Expected<bool, StorageError> migrateDatabaseLocked();
     Expected<bool, StorageError> validateSchema();
+    Expected<bool, StorageError> createSearchIndex();
+    bool dropLegacySearchIndex();
+    Expected<bool, StorageError> repopulateSearchIndexLocked();
+    
+    // Read routing: a per-thread reader connection when one is available,
+    // otherwise the writer under databaseMutex_. Finishes its statements on
+    // exit so reader snapshots never outlive the call.
+    class ReadScope {
+    public:
+        explicit ReadScope(StorageManager* manager);
+        ~ReadScope();
+        Expected<QSqlQuery*, StorageError> prepare(const QString& sql);
+        
+    private:
+        StorageManager* manager_;
+        std::shared_ptr<ReaderConnection> reader_;
+        QList<QSqlQuery*> prepared_;
+    };
+    
+    std::shared_ptr<ReaderConnection> readerForCurrentThread();
+    void releaseReader(QThread* thread);
+    void closeReaders();
     
     // SQL helpers
-    Expected<QSqlQuery, StorageError> prepareQuery(const QString& sql);
+    Expected<QSqlQuery*, StorageError> prepareQuery(const QString& sql);
+    Expected<QSqlQuery*, StorageError> prepareCached(QSqlDatabase& database, StatementCache& cache, const QString& sql);
+    void finishCachedStatements();
+    void invalidateStatementCache();
     Expected<bool, StorageError> executeQuery(QSqlQuery& query);
     Expected<QVariant, StorageError> executeScalar(const QString& sql, const QVariantList& params = {}) const;
     
+    // Keyset pagination over (sortColumn, keyColumn) descending
+    template<typename T>
+    Expected<RecordPage<T>, StorageError> fetchPage(const QString& columns, const QString& table,
+                                                    const QString& sortColumn, const QString& keyColumn,
+                                                    const PageCursor& after, int limit,
+                                                    T (StorageManager::*convert)(const QSqlQuery&));
+    
     // Record conversion
     TorrentRecord torrentFromQuery(const QSqlQuery& query);
+    TorrentSummary torrentSummaryFromQuery(const QSqlQuery& query);
+    MediaSummary mediaSummaryFromQuery(const QSqlQuery& query);
+    TranscriptionSummary transcriptionSummaryFromQuery(const QSqlQuery& query);
     MediaRecord mediaFromQuery(const QSqlQuery& query);
     TranscriptionRecord transcriptionFromQuery(const QSqlQuery& query);
     PlaybackSession sessionFromQuery(const QSqlQuery& query);
@@ -236,6 +381,13 @@ private:
     void bindTranscriptionParams(QSqlQuery& query, const TranscriptionRecord& transcription);
     void bindSessionParams(QSqlQuery& query, const PlaybackSession& session);
     
+    // Write helpers; callers hold databaseMutex_
+    Expected<bool, StorageError> runInTransaction(const std::function<Expected<bool, StorageError>()>& body);
+    Expected<bool, StorageError> executeTorrentUpdate(const TorrentRecord& torrent);
+    void bindTorrentUpdateParams(QSqlQuery& query, const TorrentRecord& torrent);
+    void scheduleWriteBehindFlush();
+    void drainWriteBehind();
+    
     // Insert helpers (for easier testing of constraint violations)
     Expected<bool, StorageError> insertTorrentRecord(const TorrentRecord& torrent);
     Expected<QString, StorageError> insertMediaRecord(const MediaRecord& media);
@@ -251,6 +403,9 @@ private:
     // Utility functions
     QString generateId();
     QString sanitizeQuery(const QString& query);
+    QStringList searchTerms(const QString& query) const;
+    QString buildMatchExpression(const QStringList& terms) const;
+    void locateSearchHit(TranscriptionSearchHit& hit, const QStringList& terms) const;
     StorageError mapSqlError(const QSqlError& error);
     
     // Error handling and recovery methods
@@ -261,13 +416,40 @@ private:
     mutable QMutex databaseMutex_;
     QString connectionName_;
     bool autoCommit_;
-    bool inTransaction_;
+    std::atomic<bool> inTransaction_;
+    std::atomic<bool> searchIndexAvailable_;
+    
+    // Reader pool. connectionLock_ is held shared by every read and
+    // exclusively while connections are opened or closed; readersMutex_
+    // only guards the map. Lock order: connectionLock_, databaseMutex_.
+    mutable QReadWriteLock connectionLock_;
+    mutable QMutex readersMutex_;
+    QHash<QThread*, std::shared_ptr<ReaderConnection>> readers_;
+    bool readersEnabled_;
+    int readerSerial_;
+    int readerGeneration_;  // Bumped by closeReaders(); older readers are stale
+    
+    // Write-behind state, guarded by pendingMutex_ (never taken inside databaseMutex_)
+    mutable QMutex pendingMutex_;
+    QHash<QString, TorrentRecord> pendingTorrents_;
+    QHash<QString, double> pendingProgress_;
+    QHash<QString, qint64> pendingPositions_;
+    bool flushScheduled_;
+    int writeBehindWindowMs_;
+    int flushRetryDelayMs_;  // 0 unless the last flush failed
+    QTimer* writeBehindTimer_;  // Lives on the owning thread
     
     // Error handling and recovery
     std::unique_ptr<ErrorRecovery> errorRecovery_;
     std::unique_ptr<RetryManager> retryManager_;
     
-    // SQL statements (prepared for performance)
+    // Compiled statements keyed by SQL text, owned by this connection. Keys are
+    // the fixed statements in StorageManager.cpp, so the cache stays bounded.
+    StatementCache statementCache_;
+    std::atomic<quint64> statementCacheHits_;
+    std::atomic<quint64> statementCacheMisses_;
+    
+    // SQL statements (prepared once per connection via statementCache_)
     QString sqlInsertTorrent_;
     QString sqlUpdateTorrent_;
     QString sqlSelectTorrent_;
@@ -283,11 +465,18 @@ private:
     QString sqlInsertSession_;
     QString sqlUpdateSession_;
     QString sqlSelectSession_;
+    QString sqlUpsertMedia_;
     
     // Configuration
     static const int DEFAULT_CACHE_SIZE_MB = 64;
     static const QString DEFAULT_JOURNAL_MODE;
-    static const int CURRENT_SCHEMA_VERSION = 1;
+    static const int CURRENT_SCHEMA_VERSION = 5;
+    static const int MAX_SEARCH_TERMS = 16;
+    static const int DEFAULT_WRITE_BEHIND_WINDOW_MS = 1000;
+    static const int MAX_FLUSH_RETRY_DELAY_MS = 30000;
+    static const int MAX_READER_CONNECTIONS = 8;
+    static const int DEFAULT_PAGE_SIZE = 100;
+    static const int MAX_PAGE_SIZE = 1000;
     
     // Private helper methods
     bool applyMigration(int toVersion);
@@ -0,0 +1,237 @@
+#include "AlertPump.hpp"
+#include "../common/Logger.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMetaObject>
+#include <QtCore/QMutexLocker>
+
+#include <libtorrent/session.hpp>
+#include <libtorrent/alert_types.hpp>
+#include <libtorrent/magnet_uri.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/write_resume_data.hpp>
+
+#include <chrono>
+#include <utility>
+
+namespace Murmur {
+
+namespace {
+
+QString hexHash(const libtorrent::sha1_hash& hash) {
+    return QString::fromLatin1(QByteArray(hash.data(), static_cast<int>(hash.size())).toHex());
+}
+
+// Runs on the pump thread; anything that calls into the session belongs here
+void decodeAlert(const libtorrent::alert* alert, AlertBatch& batch) {
+    TorrentEvent event;
+
+    switch (alert->type()) {
+        case libtorrent::add_torrent_alert::alert_type: {
+            auto* added = libtorrent::alert_cast<libtorrent::add_torrent_alert>(alert);
+            const auto& params = added->params;
+            event.infoHash = hexHash(params.ti ? params.ti->info_hashes().v1 : params.info_hashes.v1);
+            if (added->error) {
+                event.type = TorrentEventType::AddFailed;
+                event.error = added->error;
+                break;
+            }
+            event.type = TorrentEventType::Added;
+            event.handle = added->handle;
+            event.torrentInfo = params.ti;
+            event.name = QString::fromStdString(params.ti ? params.ti->name() : params.name);
+            event.savePath = QString::fromStdString(params.save_path);
+            if (!params.ti) {
+                event.magnetUri = QString::fromStdString(libtorrent::make_magnet_uri(added->handle));
+            }
+            break;
+        }
+
+        case libtorrent::torrent_removed_alert::alert_type: {
+            auto* removed = libtorrent::alert_cast<libtorrent::torrent_removed_alert>(alert);
+            event.type = TorrentEventType::Removed;
+            event.infoHash = hexHash(removed->info_hashes.v1);
+            break;
+        }
+
+        case libtorrent::state_changed_alert::alert_type: {
+            auto* changed = libtorrent::alert_cast<libtorrent::state_changed_alert>(alert);
+            event.type = TorrentEventType::StateChanged;
+            event.infoHash = hexHash(changed->handle.info_hashes().v1);
+            event.handle = changed->handle;
+            event.state = static_cast<int>(changed->state);
+            event.previousState = static_cast<int>(changed->prev_state);
+            break;
+        }
+
+        case libtorrent::torrent_finished_alert::alert_type: {
+            auto* finished = libtorrent::alert_cast<libtorrent::torrent_finished_alert>(alert);
+            event.type = TorrentEventType::Finished;
+            event.infoHash = hexHash(finished->handle.info_hashes().v1);
+            event.handle = finished->handle;
+            break;
+        }
+
+        case libtorrent::torrent_error_alert::alert_type: {
+            auto* failed = libtorrent::alert_cast<libtorrent::torrent_error_alert>(alert);
+            event.type = TorrentEventType::Error;
+            event.infoHash = hexHash(failed->handle.info_hashes().v1);
+            event.handle = failed->handle;
+            event.error = failed->error;
+            break;
+        }
+
+        case libtorrent::metadata_received_alert::alert_type: {
+            auto* metadata = libtorrent::alert_cast<libtorrent::metadata_received_alert>(alert);
+            event.type = TorrentEventType::MetadataReceived;
+            event.infoHash = hexHash(metadata->handle.info_hashes().v1);
+            event.handle = metadata->handle;
+            event.torrentInfo = metadata->handle.torrent_file();
+            break;
+        }
+
+        case libtorrent::piece_finished_alert::alert_type: {
+            auto* piece = libtorrent::alert_cast<libtorrent::piece_finished_alert>(alert);
+            event.type = TorrentEventType::PieceFinished;
+            event.infoHash = hexHash(piece->handle.info_hashes().v1);
+            event.piece = static_cast<int>(piece->piece_index);
+            break;
+        }
+
+        case libtorrent::tracker_error_alert::alert_type: {
+            auto* tracker = libtorrent::alert_cast<libtorrent::tracker_error_alert>(alert);
+            event.type = TorrentEventType::TrackerError;
+            event.infoHash = hexHash(tracker->handle.info_hashes().v1);
+            event.tracker = QString::fromStdString(tracker->tracker_url());
+            event.error = tracker->error;
+            break;
+        }
+
+        case libtorrent::save_resume_data_alert::alert_type: {
+            // Encoding here keeps bencoding of large torrents off the GUI thread
+            auto* saved = libtorrent::alert_cast<libtorrent::save_resume_data_alert>(alert);
+            event.type = TorrentEventType::ResumeDataSaved;
+            event.infoHash = hexHash(saved->handle.info_hashes().v1);
+            const std::vector<char> buffer = libtorrent::write_resume_data_buf(saved->params);
+            event.resumeData = QByteArray(buffer.data(), static_cast<int>(buffer.size()));
+            break;
+        }
+
+        case libtorrent::save_resume_data_failed_alert::alert_type: {
+            auto* failed = libtorrent::alert_cast<libtorrent::save_resume_data_failed_alert>(alert);
+            event.type = TorrentEventType::ResumeDataFailed;
+            event.infoHash = hexHash(failed->handle.info_hashes().v1);
+            event.error = failed->error;
+            break;
+        }
+
+        case libtorrent::state_update_alert::alert_type: {
+            auto* update = libtorrent::alert_cast<libtorrent::state_update_alert>(alert);
+            batch.statuses.insert(batch.statuses.end(), update->status.begin(), update->status.end());
+            return;
+        }
+
+        case libtorrent::session_stats_alert::alert_type: {
+            auto* stats = libtorrent::alert_cast<libtorrent::session_stats_alert>(alert);
+            const auto counters = stats->counters();
+            batch.sessionCounters.assign(counters.begin(), counters.end());
+            return;
+        }
+
+        default:
+            return;
+    }
+
+    batch.events.append(std::move(event));
+}
+
+} // namespace
+
+AlertPump::AlertPump(libtorrent::session& session, QObject* parent)
+    : QObject(parent)
+    , session_(session) {
+}
+
+AlertPump::~AlertPump() {
+    stop();
+}
+
+void AlertPump::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&AlertPump::run, this);
+}
+
+void AlertPump::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool AlertPump::isRunning() const {
+    return running_;
+}
+
+void AlertPump::run() {
+    std::vector<libtorrent::alert*> alerts;
+
+    while (running_) {
+        if (!session_.wait_for_alert(std::chrono::milliseconds(WAIT_TIMEOUT_MS))) {
+            continue;
+        }
+
+        // Alerts stay valid until the next pop_alerts(), so decode them now
+        session_.pop_alerts(&alerts);
+        AlertBatch batch;
+        for (const libtorrent::alert* alert : alerts) {
+            try {
+                decodeAlert(alert, batch);
+            } catch (const std::exception& e) {
+                Logger::instance().warn("AlertPump: failed to decode {}: {}", alert->what(), e.what());
+            }
+        }
+
+        if (!batch.isEmpty()) {
+            {
+                QMutexLocker locker(&pendingMutex_);
+                pending_.events.append(std::move(batch.events));
+                pending_.statuses.insert(pending_.statuses.end(),
+                                         std::make_move_iterator(batch.statuses.begin()),
+                                         std::make_move_iterator(batch.statuses.end()));
+                if (!batch.sessionCounters.empty()) {
+                    pending_.sessionCounters = std::move(batch.sessionCounters);
+                }
+            }
+
+            // One queued call covers everything added until it runs
+            if (!deliveryQueued_.exchange(true)) {
+                QMetaObject::invokeMethod(this, &AlertPump::deliver, Qt::QueuedConnection);
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(MIN_BATCH_INTERVAL_MS));
+    }
+}
+
+void AlertPump::flush() {
+    deliver();
+}
+
+void AlertPump::deliver() {
+    AlertBatch batch;
+    {
+        QMutexLocker locker(&pendingMutex_);
+        batch = std::exchange(pending_, AlertBatch{});
+        deliveryQueued_ = false;
+    }
+
+    if (!batch.isEmpty()) {
+        emit batchReady(batch);
+    }
+}
+
+} // namespace Murmur
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/torrent_status.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace libtorrent {
+    class session;
+}
+
+namespace Murmur {
+
+enum class TorrentEventType {
+    Added,
+    AddFailed,
+    Removed,
+    StateChanged,
+    Finished,
+    Error,
+    MetadataReceived,
+    PieceFinished,
+    TrackerError,
+    ResumeDataSaved,
+    ResumeDataFailed
+};
+
+/**
+ * @brief One libtorrent alert, decoded into plain values
+ *
+ * libtorrent reuses alert memory on the next pop_alerts(), so everything a
+ * handler needs is copied out on the pump thread. Fields not listed for a
+ * type are left at their defaults.
+ */
+struct TorrentEvent {
+    TorrentEventType type = TorrentEventType::Error;
+    QString infoHash;
+    libtorrent::torrent_handle handle;   // Added, MetadataReceived, Finished, Error
+    int piece = -1;                      // PieceFinished
+    int state = 0;                       // StateChanged: libtorrent::torrent_status::state_t
+    int previousState = 0;               // StateChanged
+    std::error_code error;               // AddFailed, Error, TrackerError, ResumeDataFailed
+    QString name;                        // Added
+    QString savePath;                    // Added
+    QString magnetUri;                   // Added, when added without metadata
+    QString tracker;                     // TrackerError
+    QByteArray resumeData;               // ResumeDataSaved, encoded by write_resume_data_buf()
+    std::shared_ptr<const libtorrent::torrent_info> torrentInfo;  // Added, MetadataReceived
+};
+
+/**
+ * @brief Everything decoded from one or more pop_alerts() calls
+ */
+struct AlertBatch {
+    QList<TorrentEvent> events;
+    std::vector<libtorrent::torrent_status> statuses;  // From state_update_alert, oldest first
+    std::vector<std::int64_t> sessionCounters;         // Latest session_stats_alert, empty if none
+
+    bool isEmpty() const { return events.isEmpty() && statuses.empty() && sessionCounters.empty(); }
+};
+
+/**
+ * @brief Drains a session's alerts on a dedicated thread
+ *
+ * The thread blocks in wait_for_alert(), pops everything queued and decodes
+ * it into an AlertBatch. Batches are handed to the pump's own thread with a
+ * single queued call and delivered through batchReady(). While a delivery
+ * is still pending, new events are appended to the same batch, so a busy
+ * GUI thread receives one large batch instead of a backlog of small ones.
+ * Deliveries are at least MIN_BATCH_INTERVAL_MS apart, which lets alert
+ * storms during rechecks and peer churn coalesce.
+ *
+ * The pump must be stopped, or destroyed, before the session it drains.
+ */
+class AlertPump : public QObject {
+    Q_OBJECT
+
+public:
+    // How often the thread wakes to check for stop() when no alerts arrive
+    static constexpr int WAIT_TIMEOUT_MS = 250;
+    static constexpr int MIN_BATCH_INTERVAL_MS = 50;
+
+    explicit AlertPump(libtorrent::session& session, QObject* parent = nullptr);
+    ~AlertPump() override;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // Delivers whatever the thread decoded but has not delivered yet; call
+    // after stop() so nothing queued is lost at shutdown
+    void flush();
+
+signals:
+    void batchReady(const AlertBatch& batch);
+
+private:
+    libtorrent::session& session_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    QMutex pendingMutex_;
+    AlertBatch pending_;
+    std::atomic<bool> deliveryQueued_{false};
+
+    void run();
+    void deliver();
+};
+
+} // namespace Murmur
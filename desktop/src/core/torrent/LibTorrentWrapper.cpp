@@ -1,4 +1,6 @@
 #include "LibTorrentWrapper.hpp"
+#include "TorrentStream.hpp"
+#include "AlertPump.hpp"
 #include "../common/Logger.hpp"
 #include "../storage/StorageManager.hpp"
 
@@ -13,6 +15,7 @@
 #include <QtCore/QUrl>
 #include <QtCore/QUrlQuery>
 #include <QtCore/QDirIterator>
+#include <QtCore/QPointer>
 #include <QCryptographicHash>
 
 // LibTorrent includes
@@ -33,7 +36,7 @@
 #include <libtorrent/sha1_hash.hpp>
 #include <libtorrent/aux_/session_settings.hpp>
 #include <libtorrent/version.hpp>
-#include <libtorrent/session.hpp>
+#include <libtorrent/session_params.hpp>
 #include <iomanip>
 #include <sstream>
 
@@ -52,13 +55,16 @@ std::string to_hex(const libtorrent::sha1_hash& hash) {
 struct LibTorrentWrapper::LibTorrentWrapperPrivate {
     std::unique_ptr<libtorrent::session> session;
     QHash<QString, libtorrent::torrent_handle> torrents;
-    QTimer* alertTimer = nullptr;
+    std::unique_ptr<AlertPump> alertPump;
     QTimer* statsTimer = nullptr;
     mutable QMutex torrentsMutex;
     
     // Storage manager for persistence
     StorageManager* storageManager = nullptr;
     
+    // Open playback streams; only touched on the wrapper's thread
+    QMultiHash<QString, QPointer<TorrentStream>> streams;
+    
     // Configuration
     TorrentSettings currentSettings;
     bool initialized = false;
@@ -78,11 +84,6 @@ LibTorrentWrapper::LibTorrentWrapper(QObject* parent)
     
     d->sessionStartTime = QDateTime::currentDateTime();
     
-    // Create alert processing timer
-    d->alertTimer = new QTimer(this);
-    d->alertTimer->setInterval(100); // Process alerts every 100ms
-    connect(d->alertTimer, &QTimer::timeout, this, &LibTorrentWrapper::processAlerts);
-    
     // Create statistics update timer
     d->statsTimer = new QTimer(this);
     d->statsTimer->setInterval(1000); // Update stats every second
@@ -121,8 +122,10 @@ Expected<bool, TorrentError> LibTorrentWrapper::initialize(const TorrentSettings
     d->currentSettings = settings;
     d->initialized = true;
     
-    // Start timers
-    d->alertTimer->start();
+    // Alerts are drained off the GUI thread and delivered in batches
+    d->alertPump = std::make_unique<AlertPump>(*d->session);
+    connect(d->alertPump.get(), &AlertPump::batchReady, this, &LibTorrentWrapper::handleAlertBatch);
+    d->alertPump->start();
     d->statsTimer->start();
     
     Logger::instance().info( "LibTorrent session initialized successfully");
@@ -134,9 +137,9 @@ void LibTorrentWrapper::shutdown() {
         return;
     }
     
-    // Stop timers
-    d->alertTimer->stop();
+    // Stop timers; the pump waits on the session, so it goes before it
     d->statsTimer->stop();
+    d->alertPump.reset();
     
     // Save session state if needed
     if (d->session) {
@@ -500,6 +503,34 @@ Expected<bool, TorrentError> LibTorrentWrapper::setFilePriorities(const QString&
     }
 }
 
+Expected<TorrentStream*, TorrentError> LibTorrentWrapper::openStream(const QString& infoHash, int fileIndex, QObject* parent) {
+    auto* handle = findTorrent(infoHash);
+    if (!handle || !handle->is_valid()) {
+        return makeUnexpected(TorrentError::TorrentNotFound);
+    }
+    
+    try {
+        auto created = TorrentStream::create(*handle, infoHash, fileIndex, parent);
+        if (created.hasError()) {
+            return created;
+        }
+        TorrentStream* stream = created.value();
+        
+        d->streams.insert(infoHash, stream);
+        connect(stream, &QObject::destroyed, this, [this, infoHash]() {
+            // The QPointer is already null by now
+            d->streams.remove(infoHash, QPointer<TorrentStream>());
+        });
+        
+        Logger::instance().info("Streaming {} from torrent {}", stream->fileName().toStdString(), infoHash.toStdString());
+        return stream;
+        
+    } catch (const std::exception& e) {
+        Logger::instance().error("Exception in openStream: {}", e.what());
+        return makeUnexpected(TorrentError::LibtorrentError);
+    }
+}
+
 Expected<TorrentStats, TorrentError> LibTorrentWrapper::getTorrentStats(const QString& infoHash) const {
     libtorrent::torrent_handle* handle = findTorrent(infoHash);
     if (!handle) {
@@ -786,7 +817,8 @@ Expected<bool, TorrentError> LibTorrentWrapper::initializeSession(const TorrentS
         d->stats_idx_total_upload = libtorrent::find_metric_idx("net.sent_payload_bytes");
         d->stats_idx_dht_nodes = libtorrent::find_metric_idx("dht.nodes");
 
-        libtorrent::settings_pack pack;
+        // The profile tunes disk, buffers and queueing; explicit settings below win
+        libtorrent::settings_pack pack = TorrentProfiles::settings(settings.performanceProfile);
         
         // Basic settings
         pack.set_str(libtorrent::settings_pack::user_agent, settings.userAgent.toStdString());
@@ -801,12 +833,14 @@ Expected<bool, TorrentError> LibTorrentWrapper::initializeSession(const TorrentS
         
         // Connection limits
         pack.set_int(libtorrent::settings_pack::connections_limit, settings.maxConnections);
-        pack.set_int(libtorrent::settings_pack::active_downloads, settings.maxSeeds);
         
-        // Create session
-        d->session = std::make_unique<libtorrent::session>(pack);
+        // Create session; the profile also picks the disk backend
+        libtorrent::session_params params(std::move(pack));
+        TorrentProfiles::applyDiskBackend(params, settings.performanceProfile);
+        d->session = std::make_unique<libtorrent::session>(std::move(params));
         
-        Logger::instance().info( "LibTorrent session created");
+        Logger::instance().info("LibTorrent session created ({})",
+                                TorrentProfiles::id(settings.performanceProfile).toStdString());
         return true;
         
     } catch (const std::exception& e) {
@@ -845,169 +879,138 @@ void LibTorrentWrapper::setupAlertHandling() {
         libtorrent::alert_category::tracker |
         libtorrent::alert_category::connect |
         libtorrent::alert_category::status |
-        libtorrent::alert_category::stats
+        libtorrent::alert_category::stats |
+        libtorrent::alert_category::piece_progress
     );
     d->session->apply_settings(pack);
 }
 
-void LibTorrentWrapper::processAlerts() {
-    if (!d->session) {
-        return;
+void LibTorrentWrapper::handleAlertBatch(const AlertBatch& batch) {
+    for (const TorrentEvent& event : batch.events) {
+        try {
+            handleTorrentEvent(event);
+        } catch (const std::exception& e) {
+            Logger::instance().warn("Exception processing torrent event: {}", e.what());
+        }
     }
     
-    std::vector<libtorrent::alert*> alerts;
-    d->session->pop_alerts(&alerts);
-    
-    for (auto* alert : alerts) {
-        processAlert(alert);
+    if (!batch.sessionCounters.empty()) {
+        // Use cached indices to access stats counters
+        const auto& counters = batch.sessionCounters;
+        if (d->stats_idx_total_download != -1)
+            d->lastStats.totalDownloaded = counters[d->stats_idx_total_download];
+        if (d->stats_idx_total_upload != -1)
+            d->lastStats.totalUploaded = counters[d->stats_idx_total_upload];
+        if (d->stats_idx_dht_nodes != -1)
+            d->lastStats.dhtNodes = counters[d->stats_idx_dht_nodes];
     }
 }
 
-void LibTorrentWrapper::processAlert(const libtorrent::alert* alert) {
-    if (!alert) return;
+void LibTorrentWrapper::handleTorrentEvent(const TorrentEvent& event) {
+    const QString& infoHash = event.infoHash;
     
-    try {
-        switch (alert->type()) {
-            case libtorrent::add_torrent_alert::alert_type: {
-                auto* addedAlert = libtorrent::alert_cast<libtorrent::add_torrent_alert>(alert);
-                if (addedAlert) {
-                    QString infoHash = extractInfoHash(addedAlert->handle);
-                    if (addedAlert->handle.is_valid()) {
-                        {
-                            QMutexLocker locker(&d->torrentsMutex);
-                            d->torrents[infoHash] = addedAlert->handle;
-                        }
+    switch (event.type) {
+        case TorrentEventType::Added: {
+            {
+                QMutexLocker locker(&d->torrentsMutex);
+                d->torrents[infoHash] = event.handle;
+            }
+            
+            // Save torrent to storage manager
+            if (d->storageManager) {
+                try {
+                    const auto& torrentInfo = event.torrentInfo;
+                    
+                    TorrentRecord record;
+                    record.infoHash = infoHash;
+                    record.name = event.name;
+                    record.size = torrentInfo ? torrentInfo->total_size() : 0;
+                    record.dateAdded = QDateTime::currentDateTime();
+                    record.lastActive = QDateTime::currentDateTime();
+                    record.savePath = event.savePath;
+                    record.progress = 0.0; // Will be updated by progress alerts
+                    record.status = "downloading";
+                    record.seeders = 0;
+                    record.leechers = 0;
+                    record.downloaded = 0;
+                    record.uploaded = 0;
+                    record.ratio = 0.0;
+                    
+                    // Store metadata including torrent data if available
+                    QJsonObject metadata;
+                    if (torrentInfo) {
+                        // Save torrent data for later restoration
+                        std::vector<char> torrentBuffer;
+                        libtorrent::bencode(std::back_inserter(torrentBuffer), 
+                                          libtorrent::create_torrent(*torrentInfo).generate());
+                        QByteArray torrentData(torrentBuffer.data(), torrentBuffer.size());
+                        metadata["torrent_data"] = QString::fromUtf8(torrentData.toBase64());
                         
-                        // Save torrent to storage manager
-                        if (d->storageManager) {
-                            try {
-                                auto torrentStatus = addedAlert->handle.status();
-                                auto torrentInfo = addedAlert->handle.torrent_file();
-                                
-                                TorrentRecord record;
-                                record.infoHash = infoHash;
-                                record.name = QString::fromStdString(torrentStatus.name);
-                                record.size = torrentInfo ? torrentInfo->total_size() : 0;
-                                record.dateAdded = QDateTime::currentDateTime();
-                                record.lastActive = QDateTime::currentDateTime();
-                                record.savePath = QString::fromStdString(torrentStatus.save_path);
-                                record.progress = 0.0; // Will be updated by progress alerts
-                                record.status = "downloading";
-                                record.seeders = 0;
-                                record.leechers = 0;
-                                record.downloaded = 0;
-                                record.uploaded = 0;
-                                record.ratio = 0.0;
-                                
-                                // Store metadata including torrent data if available
-                                QJsonObject metadata;
-                                if (torrentInfo) {
-                                    // Save torrent data for later restoration
-                                    std::vector<char> torrentBuffer;
-                                    libtorrent::bencode(std::back_inserter(torrentBuffer), 
-                                                      libtorrent::create_torrent(*torrentInfo).generate());
-                                    QByteArray torrentData(torrentBuffer.data(), torrentBuffer.size());
-                                    metadata["torrent_data"] = QString::fromUtf8(torrentData.toBase64());
-                                    
-                                    // Store file list
-                                    QStringList files;
-                                    for (int i = 0; i < torrentInfo->num_files(); ++i) {
-                                        files.append(QString::fromStdString(torrentInfo->files().file_path(i)));
-                                    }
-                                    record.files = files;
-                                }
-                                
-                                // Check if this is a magnet link (no torrent_info initially)
-                                if (!torrentInfo) {
-                                    // This is likely a magnet link, try to get the magnet URI
-                                    auto magnetUri = libtorrent::make_magnet_uri(addedAlert->handle);
-                                    if (!magnetUri.empty()) {
-                                        record.magnetUri = QString::fromStdString(magnetUri);
-                                    }
-                                }
-                                
-                                record.metadata = metadata;
-                                
-                                auto saveResult = d->storageManager->addTorrent(record);
-                                if (!saveResult) {
-                                    Logger::instance().warn("Failed to save torrent to storage: {}", 
-                                                           static_cast<int>(saveResult.error()));
-                                } else {
-                                    Logger::instance().debug("Torrent {} saved to storage", record.name.toStdString());
-                                }
-                                
-                            } catch (const std::exception& e) {
-                                Logger::instance().warn("Exception while saving torrent to storage: {}", e.what());
-                            }
+                        // Store file list
+                        QStringList files;
+                        for (int i = 0; i < torrentInfo->num_files(); ++i) {
+                            files.append(QString::fromStdString(torrentInfo->files().file_path(i)));
                         }
-                        
-                        QString name = QString::fromStdString(addedAlert->handle.status().name);
-                        emit torrentAdded(infoHash, name);
+                        record.files = files;
                     }
+                    
+                    // Magnet links have no torrent_info yet; the pump built the URI
+                    record.magnetUri = event.magnetUri;
+                    record.metadata = metadata;
+                    
+                    auto saveResult = d->storageManager->addTorrent(record);
+                    if (!saveResult) {
+                        Logger::instance().warn("Failed to save torrent to storage: {}", 
+                                               static_cast<int>(saveResult.error()));
+                    } else {
+                        Logger::instance().debug("Torrent {} saved to storage", record.name.toStdString());
+                    }
+                    
+                } catch (const std::exception& e) {
+                    Logger::instance().warn("Exception while saving torrent to storage: {}", e.what());
                 }
-                break;
-            }
-            
-            case libtorrent::torrent_removed_alert::alert_type: {
-                auto* removedAlert = libtorrent::alert_cast<libtorrent::torrent_removed_alert>(alert);
-                if (removedAlert) {
-                    QString infoHash = QString::fromStdString(to_hex(removedAlert->info_hashes.v1));
-                    emit torrentRemoved(infoHash);
-                }
-                break;
-            }
-            
-            case libtorrent::state_changed_alert::alert_type: {
-                auto* stateAlert = libtorrent::alert_cast<libtorrent::state_changed_alert>(alert);
-                if (stateAlert) {
-                    QString infoHash = extractInfoHash(stateAlert->handle);
-                    TorrentState oldState = mapTorrentState(stateAlert->prev_state);
-                    TorrentState newState = mapTorrentState(stateAlert->state);
-                    emit torrentStateChanged(infoHash, oldState, newState);
-                }
-                break;
-            }
-            
-            case libtorrent::torrent_finished_alert::alert_type: {
-                auto* finishedAlert = libtorrent::alert_cast<libtorrent::torrent_finished_alert>(alert);
-                if (finishedAlert) {
-                    QString infoHash = extractInfoHash(finishedAlert->handle);
-                    emit torrentFinished(infoHash);
-                }
-                break;
             }
             
-            case libtorrent::tracker_error_alert::alert_type: {
-                auto* trackerAlert = libtorrent::alert_cast<libtorrent::tracker_error_alert>(alert);
-                if (trackerAlert) {
-                    QString infoHash = extractInfoHash(trackerAlert->handle);
-                    QString tracker = QString::fromStdString(trackerAlert->tracker_url());
-                    QString error = QString::fromStdString(trackerAlert->error.message());
-                    emit trackerError(infoHash, tracker, error);
+            emit torrentAdded(infoHash, event.name);
+            break;
+        }
+        
+        case TorrentEventType::Removed:
+            for (const auto& stream : d->streams.values(infoHash)) {
+                if (stream) {
+                    stream->onTorrentRemoved();
                 }
-                break;
             }
-            
-            case libtorrent::session_stats_alert::alert_type: {
-                auto* stats_alert = libtorrent::alert_cast<libtorrent::session_stats_alert>(alert);
-                if (stats_alert) {
-                    auto counters = stats_alert->counters();
-                    // Use cached indices to access stats counters
-                    if (d->stats_idx_total_download != -1)
-                        d->lastStats.totalDownloaded = counters[d->stats_idx_total_download];
-                    if (d->stats_idx_total_upload != -1)
-                        d->lastStats.totalUploaded = counters[d->stats_idx_total_upload];
-                    if (d->stats_idx_dht_nodes != -1)
-                        d->lastStats.dhtNodes = counters[d->stats_idx_dht_nodes];
+            emit torrentRemoved(infoHash);
+            break;
+        
+        case TorrentEventType::StateChanged:
+            emit torrentStateChanged(infoHash, mapTorrentState(event.previousState), mapTorrentState(event.state));
+            break;
+        
+        case TorrentEventType::Finished:
+            emit torrentFinished(infoHash);
+            break;
+        
+        case TorrentEventType::PieceFinished:
+            for (const auto& stream : d->streams.values(infoHash)) {
+                if (stream) {
+                    stream->onPieceFinished(event.piece);
                 }
-                break;
             }
-
-            default:
-                break;
-        }
-    } catch (const std::exception& e) {
-        Logger::instance().warn("Exception processing alert: {}", e.what());
+            emit pieceCompleted(infoHash, event.piece);
+            break;
+        
+        case TorrentEventType::MetadataReceived:
+            emit metadataReceived(infoHash);
+            break;
+        
+        case TorrentEventType::TrackerError:
+            emit trackerError(infoHash, event.tracker, QString::fromStdString(event.error.message()));
+            break;
+        
+        default:
+            break;
     }
 }
 
@@ -1209,7 +1212,8 @@ QString LibTorrentWrapper::generateSavePath(const QString& basePath, const QStri
 void LibTorrentWrapper::applySessionSettings(const TorrentSettings& settings) {
     if (!d->session) return;
     
-    libtorrent::settings_pack pack;
+    // Every profile sets the same keys, so switching fully replaces the previous one
+    libtorrent::settings_pack pack = TorrentProfiles::settings(settings.performanceProfile);
     
     // Update rate limits
     pack.set_int(libtorrent::settings_pack::download_rate_limit, settings.maxDownloadRate > 0 ? settings.maxDownloadRate * 1024 : -1);
@@ -1293,6 +1297,8 @@ QString LibTorrentWrapper::translateTorrentError(TorrentError error) const {
             return "Timeout error";
         case TorrentError::CancellationRequested:
             return "Operation cancelled";
+        case TorrentError::MetadataPending:
+            return "Torrent metadata not received yet";
         case TorrentError::UnknownError:
         default:
             return "Unknown error";
@@ -13,6 +13,7 @@
 #include <QMutex>
 
 #include "../common/Expected.hpp"
+#include "TorrentProfiles.hpp"
 
 namespace libtorrent {
     class session;
@@ -21,11 +22,14 @@ namespace libtorrent {
     class add_torrent_params;
     struct torrent_status;
     struct session_stats_alert;
-    struct alert;
 }
 
 namespace Murmur {
     class StorageManager;
+    class TorrentStream;
+    class AlertPump;
+    struct AlertBatch;
+    struct TorrentEvent;
 }
 
 namespace Murmur {
@@ -50,6 +54,7 @@ enum class TorrentError {
     NetworkFailure,
     CancellationRequested,
     FileSystemError,
+    MetadataPending,
     UnknownError
 };
 
@@ -129,6 +134,8 @@ struct TorrentSettings {
     int seedTimeLimit = 0;         // Auto-remove after seeding time (hours)
     QStringList trackers;
     QString userAgent = "MurmurDesktop/1.0";
+    // Owners building settings from Config pass TorrentProfiles::configured()
+    TorrentPerformanceProfile performanceProfile = TorrentPerformanceProfile::Balanced;
 };
 
 // Progress callback function types
@@ -281,6 +288,17 @@ public:
      */
     Expected<bool, TorrentError> setFilePriorities(const QString& infoHash, const QList<int>& priorities);
 
+    /**
+     * @brief Open a file of a torrent for playback while it downloads
+     * @param infoHash Torrent info hash
+     * @param fileIndex File to stream, or -1 for the largest file
+     * @param parent Owner of the returned stream
+     * @return Open, read-only stream or error; MetadataPending until a magnet
+     *         link's metadata has arrived (see metadataReceived())
+     */
+    Expected<TorrentStream*, TorrentError> openStream(const QString& infoHash, int fileIndex = -1,
+                                                      QObject* parent = nullptr);
+
     /**
      * @brief Get torrent statistics
      * @param infoHash Torrent info hash
@@ -382,6 +400,7 @@ signals:
     void torrentProgress(const QString& infoHash, const TorrentStats& stats);
     void torrentFinished(const QString& infoHash);
     void torrentError(const QString& infoHash, TorrentError error, const QString& errorMessage);
+    void metadataReceived(const QString& infoHash);
     
     // File-level signals
     void fileCompleted(const QString& infoHash, const QString& filePath);
@@ -398,7 +417,7 @@ signals:
     void peerDisconnected(const QString& infoHash, const QString& peerAddress);
 
 private slots:
-    void processAlerts();
+    void handleAlertBatch(const AlertBatch& batch);
     void updateStatistics();
 
 private:
@@ -409,7 +428,7 @@ private:
     Expected<bool, TorrentError> initializeSession(const TorrentSettings& settings);
     Expected<bool, TorrentError> configureSession(const TorrentSettings& settings);
     void setupAlertHandling();
-    void processAlert(const libtorrent::alert* alert);
+    void handleTorrentEvent(const TorrentEvent& event);
     
     // Torrent management helpers
     libtorrent::torrent_handle* findTorrent(const QString& infoHash) const;
@@ -0,0 +1,79 @@
+#include "ResumeDataStore.hpp"
+#include "../common/Logger.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QPair>
+#include <QtCore/QSaveFile>
+#include <QtConcurrent/QtConcurrent>
+
+namespace Murmur {
+
+ResumeDataStore::ResumeDataStore(const QString& directory)
+    : directory_(directory) {
+    QDir().mkpath(directory_);
+}
+
+QString ResumeDataStore::directory() const {
+    return directory_;
+}
+
+int ResumeDataStore::save(const QHash<QString, QByteArray>& entries) {
+    QMutexLocker locker(&mutex_);
+
+    int written = 0;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        QSaveFile file(filePath(it.key()));
+        if (!file.open(QIODevice::WriteOnly) || file.write(it.value()) != it.value().size() || !file.commit()) {
+            Logger::instance().warn("ResumeDataStore: failed to write resume data for {}: {}",
+                                    it.key().toStdString(), file.errorString().toStdString());
+            continue;
+        }
+        ++written;
+    }
+    return written;
+}
+
+void ResumeDataStore::remove(const QString& infoHash) {
+    QMutexLocker locker(&mutex_);
+    QFile::remove(filePath(infoHash));
+}
+
+QHash<QString, QByteArray> ResumeDataStore::loadAll() const {
+    QStringList paths;
+    {
+        QMutexLocker locker(&mutex_);
+        const QStringList names = QDir(directory_).entryList({QStringLiteral("*") + FILE_SUFFIX}, QDir::Files);
+        paths.reserve(names.size());
+        for (const QString& name : names) {
+            paths.append(QDir(directory_).filePath(name));
+        }
+    }
+
+    // Hundreds of small files load faster with several reads in flight
+    const QList<QPair<QString, QByteArray>> loaded = QtConcurrent::blockingMapped<QList<QPair<QString, QByteArray>>>(
+        paths, [](const QString& path) {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                return QPair<QString, QByteArray>();
+            }
+            return qMakePair(QFileInfo(path).completeBaseName(), file.readAll());
+        });
+
+    QHash<QString, QByteArray> entries;
+    entries.reserve(loaded.size());
+    for (const auto& entry : loaded) {
+        if (!entry.first.isEmpty() && !entry.second.isEmpty()) {
+            entries.insert(entry.first, entry.second);
+        }
+    }
+    return entries;
+}
+
+QString ResumeDataStore::filePath(const QString& infoHash) const {
+    return QDir(directory_).filePath(infoHash + FILE_SUFFIX);
+}
+
+} // namespace Murmur
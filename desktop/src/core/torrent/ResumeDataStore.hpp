@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+namespace Murmur {
+
+/**
+ * @brief Fast-resume files for the torrent session, one per torrent
+ *
+ * Each torrent's resume data, as produced by write_resume_data_buf(), lives
+ * in <infohash>.fastresume inside the store directory. Keeping one file per
+ * torrent means a save only rewrites the torrents that changed, and a
+ * damaged file costs a recheck of one torrent rather than of all of them.
+ *
+ * Files are replaced atomically. The store knows nothing about libtorrent;
+ * TorrentEngine encodes and decodes the data. All methods are thread-safe.
+ */
+class ResumeDataStore {
+public:
+    static constexpr const char* FILE_SUFFIX = ".fastresume";
+
+    explicit ResumeDataStore(const QString& directory);
+
+    QString directory() const;
+
+    // Writes every entry, keyed by info hash; returns how many were written
+    int save(const QHash<QString, QByteArray>& entries);
+
+    void remove(const QString& infoHash);
+
+    // Reads all stored entries, several files at a time
+    QHash<QString, QByteArray> loadAll() const;
+
+private:
+    QString directory_;
+    mutable QMutex mutex_;
+
+    QString filePath(const QString& infoHash) const;
+};
+
+} // namespace Murmur
@@ -1,6 +1,9 @@
 #include "TorrentEngine.hpp"
 #include "TorrentStateModel.hpp"
 #include "TorrentSecurityWrapper.hpp"
+#include "AlertPump.hpp"
+#include "ResumeDataStore.hpp"
+#include "TorrentStream.hpp"
 #include "../common/Logger.hpp"
 #include "../common/Config.hpp"
 #include <QtCore/QStandardPaths>
@@ -9,6 +12,8 @@
 #include <QtCore/QUrl>
 #include <QtCore/QUrlQuery>
 #include <QtCore/QMetaObject>
+#include <QtCore/QSet>
+#include <QtCore/QDeadlineTimer>
 #include <libtorrent/alert_types.hpp>
 #include <libtorrent/create_torrent.hpp>
 #include <libtorrent/file_storage.hpp>
@@ -17,6 +22,10 @@
 #include <libtorrent/sha1_hash.hpp>
 #include <libtorrent/entry.hpp>
 #include <libtorrent/span.hpp>
+#include <libtorrent/session_params.hpp>
+#include <libtorrent/read_resume_data.hpp>
+#include <libtorrent/write_resume_data.hpp>
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -38,18 +47,22 @@ TorrentEngine::TorrentEngine(QObject* parent)
     : QObject(parent)
     , torrentModel_(std::make_unique<TorrentStateModel>(this))
     , securityWrapper_(std::make_unique<TorrentSecurityWrapper>())
-    , alertTimer_(new QTimer(this))
     , updateTimer_(new QTimer(this))
+    , resumeTimer_(new QTimer(this))
+    , resumeStore_(std::make_unique<ResumeDataStore>(Config::instance().getDataPath() + "/torrents/resume"))
 {
     // Initialize download path
     downloadPath_ = Config::instance().getTorrentSettings().downloadPath;
+    performanceProfile_ = TorrentProfiles::configured();
     
-    // Setup timers
-    alertTimer_->setInterval(100); // 100ms for responsive alerts
+    resumeWriter_.setMaxThreadCount(1);
+    
+    // Alerts arrive through the pump thread; the timer only asks for status updates
     updateTimer_->setInterval(1000); // 1s for UI updates
+    resumeTimer_->setInterval(RESUME_SAVE_INTERVAL_MS);
     
-    connect(alertTimer_, &QTimer::timeout, this, &TorrentEngine::handleLibtorrentAlerts);
     connect(updateTimer_, &QTimer::timeout, this, &TorrentEngine::updateTorrentStates);
+    connect(resumeTimer_, &QTimer::timeout, this, &TorrentEngine::saveResumeData);
     
     // Initialize session
     initializeSession();
@@ -137,18 +150,12 @@ TorrentEngine::addTorrent(const QString& magnetUri) {
                 info.name = QString("Torrent %1").arg(hashString.left(8));
             }
             
-            // Store torrent
-            {
-                QWriteLocker locker(&torrentsLock_);
-                torrents_[hashString] = info;
-                torrentHandles_[hashString] = handle;
+            // Store torrent; a restore of the same torrent may have won the race
+            if (registerTorrent(hashString, info, handle)) {
+                torrentModel_->addTorrent(info);
+                emit torrentAdded(hashString);
             }
             
-            // Update model
-            torrentModel_->addTorrent(info);
-            
-            emit torrentAdded(hashString);
-            
             MURMUR_INFO("Torrent added successfully: {}", hashString.toStdString());
             return info;
             
@@ -266,18 +273,12 @@ TorrentEngine::addTorrentFromData(const QByteArray& torrentData) {
                 info.files.append(QString::fromStdString(files.file_path(libtorrent::file_index_t(i))));
             }
             
-            // Store in internal data structures
-            {
-                QWriteLocker locker(&torrentsLock_);
-                torrents_[hashString] = info;
-                torrentHandles_[hashString] = handle;
+            // Store torrent; a restore of the same torrent may have won the race
+            if (registerTorrent(hashString, info, handle)) {
+                torrentModel_->addTorrent(info);
+                emit torrentAdded(hashString);
             }
             
-            // Update model
-            torrentModel_->addTorrent(info);
-            
-            emit torrentAdded(hashString);
-            
             MURMUR_INFO("Torrent added from data successfully: {}", hashString.toStdString());
             return info;
             
@@ -367,18 +368,12 @@ TorrentEngine::seedFile(const QString& filePath) {
             
             QString hashString = getInfoHashFromHandle(handle);
             
-            // Store torrent
-            {
-                QWriteLocker locker(&torrentsLock_);
-                torrents_[hashString] = info;
-                torrentHandles_[hashString] = handle;
+            // Store torrent; a restore of the same torrent may have won the race
+            if (registerTorrent(hashString, info, handle)) {
+                torrentModel_->addTorrent(info);
+                emit torrentAdded(hashString);
             }
             
-            // Update model
-            torrentModel_->addTorrent(info);
-            
-            emit torrentAdded(hashString);
-            
             MURMUR_INFO("File seeding started: {}", filePath.toStdString());
             return info;
             
@@ -404,9 +399,16 @@ Expected<void, TorrentError> TorrentEngine::removeTorrent(const QString& infoHas
         // Remove from internal storage
         torrents_.remove(infoHash);
         torrentHandles_.erase(it);
+        resumeDirty_.remove(infoHash);
+        
+        // Queued behind any pending write, so the file cannot come back
+        QtConcurrent::run(&resumeWriter_, [store = resumeStore_.get(), infoHash]() {
+            store->remove(infoHash);
+        });
         
         // Update model
         torrentModel_->removeTorrent(infoHash);
+        abortStreams(infoHash);
         
         emit torrentRemoved(infoHash);
         
@@ -419,6 +421,47 @@ Expected<void, TorrentError> TorrentEngine::removeTorrent(const QString& infoHas
     }
 }
 
+Expected<TorrentStream*, TorrentError> TorrentEngine::openStream(const QString& infoHash, int fileIndex, QObject* parent) {
+    libtorrent::torrent_handle handle;
+    {
+        QReadLocker locker(&torrentsLock_);
+        auto it = torrentHandles_.find(infoHash);
+        if (it == torrentHandles_.end()) {
+            return makeUnexpected(TorrentError::TorrentNotFound);
+        }
+        handle = it.value();
+    }
+    
+    try {
+        auto created = TorrentStream::create(handle, infoHash, fileIndex, parent);
+        if (created.hasError()) {
+            return created;
+        }
+        TorrentStream* stream = created.value();
+        
+        streams_.insert(infoHash, stream);
+        connect(stream, &QObject::destroyed, this, [this, infoHash]() {
+            // The QPointer is already null by now
+            streams_.remove(infoHash, QPointer<TorrentStream>());
+        });
+        
+        MURMUR_INFO("Streaming {} from torrent {}", stream->fileName().toStdString(), infoHash.toStdString());
+        return stream;
+        
+    } catch (const std::exception& e) {
+        MURMUR_ERROR("Exception in openStream: {}", e.what());
+        return makeUnexpected(TorrentError::LibtorrentError);
+    }
+}
+
+void TorrentEngine::abortStreams(const QString& infoHash) {
+    for (const auto& stream : streams_.values(infoHash)) {
+        if (stream) {
+            stream->onTorrentRemoved();
+        }
+    }
+}
+
 Expected<void, TorrentError> TorrentEngine::pauseTorrent(const QString& infoHash) {
     try {
         QReadLocker locker(&torrentsLock_);
@@ -507,6 +550,23 @@ void TorrentEngine::setDownloadPath(const QString& path) {
     }
 }
 
+void TorrentEngine::setPerformanceProfile(TorrentPerformanceProfile profile) {
+    performanceProfile_ = profile;
+    if (!session_) return;
+    
+    // Every profile sets the same keys, so this replaces the previous tuning
+    session_->apply_settings(TorrentProfiles::settings(profile));
+    MURMUR_INFO("Performance profile set to {}", TorrentProfiles::id(profile).toStdString());
+    
+    if (TorrentProfiles::usesMmapDiskBackend(profile) != sessionUsesMmap_) {
+        MURMUR_INFO("Disk backend change takes effect when the session restarts");
+    }
+}
+
+TorrentPerformanceProfile TorrentEngine::performanceProfile() const {
+    return performanceProfile_;
+}
+
 bool TorrentEngine::isSessionActive() const {
     return sessionActive_ && session_ != nullptr;
 }
@@ -514,8 +574,14 @@ bool TorrentEngine::isSessionActive() const {
 void TorrentEngine::startSession() {
     if (!sessionActive_) {
         initializeSession();
-        alertTimer_->start();
+        if (session_) {
+            alertPump_ = std::make_unique<AlertPump>(*session_);
+            connect(alertPump_.get(), &AlertPump::batchReady, this, &TorrentEngine::handleAlertBatch);
+            alertPump_->start();
+            restoreTorrents();
+        }
         updateTimer_->start();
+        resumeTimer_->start();
         sessionActive_ = true;
         MURMUR_INFO("Torrent session started");
     }
@@ -523,13 +589,36 @@ void TorrentEngine::startSession() {
 
 void TorrentEngine::stopSession() {
     if (sessionActive_) {
-        alertTimer_->stop();
         updateTimer_->stop();
+        resumeTimer_->stop();
+        restoreFuture_.waitForFinished();
         
         if (session_) {
             session_->pause();
+        }
+        
+        // Readers blocked on a piece must not wait for a session that is going away
+        for (const QString& infoHash : streams_.uniqueKeys()) {
+            abortStreams(infoHash);
+        }
+        
+        // The pump drains the session, so it has to go first. Anything it
+        // decoded but did not deliver yet may include resume data.
+        if (alertPump_) {
+            alertPump_->stop();
+            alertPump_->flush();
+            alertPump_.reset();
+        }
+        
+        if (session_) {
+            saveAllResumeDataBlocking();
             session_.reset();
         }
+        {
+            QWriteLocker locker(&torrentsLock_);
+            pendingRestores_.clear();
+        }
+        resumeWriter_.waitForDone();
         
         sessionActive_ = false;
         MURMUR_INFO("Torrent session stopped");
@@ -554,29 +643,36 @@ bool TorrentEngine::isInitialized() const {
     return session_ != nullptr && sessionActive_;
 }
 
-void TorrentEngine::handleLibtorrentAlerts() {
-    if (!session_) return;
+void TorrentEngine::handleAlertBatch(const AlertBatch& batch) {
+    QHash<QString, QByteArray> resumeData;
+    for (const TorrentEvent& event : batch.events) {
+        if (event.type == TorrentEventType::ResumeDataSaved) {
+            // Answers can trail a removal; only keep torrents still in the session
+            if (hasTorrent(event.infoHash)) {
+                resumeData.insert(event.infoHash, event.resumeData);
+            }
+            continue;
+        }
+        handleTorrentEvent(event);
+    }
     
-    std::vector<libtorrent::alert*> alerts;
-    session_->pop_alerts(&alerts);
+    // Everything saved in this cycle goes to disk in one write job
+    if (!resumeData.isEmpty()) {
+        writeResumeData(resumeData);
+    }
     
-    for (libtorrent::alert* alert : alerts) {
-        handleTorrentAlert(alert);
+    // All status changes of the cycle reach the model as one update
+    if (!batch.statuses.empty()) {
+        applyStateUpdates(batch.statuses);
     }
 }
 
 void TorrentEngine::updateTorrentStates() {
-    QWriteLocker locker(&torrentsLock_);
+    if (!session_) return;
     
-    for (auto it = torrentHandles_.begin(); it != torrentHandles_.end(); ++it) {
-        const QString& infoHash = it.key();
-        const libtorrent::torrent_handle& handle = it.value();
-        
-        if (handle.is_valid()) {
-            updateTorrentInfo(infoHash, handle);
-            emitTorrentUpdate(infoHash);
-        }
-    }
+    // Non-blocking: libtorrent answers with a state_update_alert containing
+    // only the torrents whose status changed since the previous request.
+    session_->post_torrent_updates();
 }
 
 QString TorrentEngine::getInfoHashFromHandle(const libtorrent::torrent_handle& handle) const {
@@ -596,18 +692,15 @@ TorrentEngine::TorrentInfo TorrentEngine::createTorrentInfo(const libtorrent::to
     libtorrent::torrent_status status = handle.status();
     
     if (status.has_metadata) {
-        auto torrentFile = handle.torrent_file();
-        if (torrentFile) {
-            info.name = QString::fromStdString(torrentFile->name());
-            info.size = torrentFile->total_size();
-            
-            // Get file list
-            for (int i = 0; i < torrentFile->num_files(); ++i) {
-                info.files.append(QString::fromStdString(torrentFile->files().file_path(libtorrent::file_index_t(i))));
-            }
-        }
+        populateTorrentMetadata(info, handle);
     }
     
+    applyTorrentStatus(info, status);
+    
+    return info;
+}
+
+void TorrentEngine::applyTorrentStatus(TorrentInfo& info, const libtorrent::torrent_status& status) const {
     info.progress = status.progress;
     info.peers = status.num_peers;
     info.seeders = status.num_seeds;
@@ -615,6 +708,7 @@ TorrentEngine::TorrentInfo TorrentEngine::createTorrentInfo(const libtorrent::to
     info.downloadRate = status.download_payload_rate;
     info.uploadRate = status.upload_payload_rate;
     info.isPaused = (status.flags & libtorrent::torrent_flags::paused) != 0;
+    info.isSeeding = false;
     info.savePath = QString::fromStdString(status.save_path);
     
     // Determine status
@@ -632,30 +726,110 @@ TorrentEngine::TorrentInfo TorrentEngine::createTorrentInfo(const libtorrent::to
     } else {
         info.status = "connecting";
     }
+}
+
+void TorrentEngine::populateTorrentMetadata(TorrentInfo& info, const libtorrent::torrent_handle& handle) const {
+    auto torrentFile = handle.torrent_file();
+    if (torrentFile) {
+        populateTorrentMetadata(info, *torrentFile);
+    }
+}
+
+void TorrentEngine::populateTorrentMetadata(TorrentInfo& info, const libtorrent::torrent_info& torrentFile) const {
+    info.name = QString::fromStdString(torrentFile.name());
+    info.size = torrentFile.total_size();
     
-    return info;
+    // Get file list
+    const auto& files = torrentFile.files();
+    QStringList fileList;
+    fileList.reserve(files.num_files());
+    for (int i = 0; i < files.num_files(); ++i) {
+        fileList.append(QString::fromStdString(files.file_path(libtorrent::file_index_t(i))));
+    }
+    info.files = std::move(fileList);
 }
 
-void TorrentEngine::updateTorrentInfo(const QString& infoHash, const libtorrent::torrent_handle& handle) {
-    auto it = torrents_.find(infoHash);
-    if (it != torrents_.end()) {
-        TorrentInfo updated = createTorrentInfo(handle);
-        updated.magnetUri = it.value().magnetUri; // Preserve magnet URI
-        torrents_[infoHash] = updated;
+void TorrentEngine::applyStateUpdates(const std::vector<libtorrent::torrent_status>& statuses) {
+    QList<TorrentInfo> changed;
+    changed.reserve(static_cast<qsizetype>(statuses.size()));
+    QList<TorrentInfo> withMetadata;
+    
+    {
+        QWriteLocker locker(&torrentsLock_);
+        
+        // A batch can hold several updates for one torrent; only the newest counts
+        QSet<QString> seen;
+        for (auto statusIt = statuses.rbegin(); statusIt != statuses.rend(); ++statusIt) {
+            const auto& status = *statusIt;
+            QString infoHash = QString::fromStdString(to_hex_str(status.info_hashes.v1));
+            if (seen.contains(infoHash)) {
+                continue;
+            }
+            seen.insert(infoHash);
+            
+            auto it = torrents_.find(infoHash);
+            if (it == torrents_.end()) {
+                continue;
+            }
+            
+            if (status.need_save_resume) {
+                resumeDirty_.insert(infoHash);
+            }
+            
+            // Metadata may have arrived before the torrent was registered here
+            if (status.has_metadata && it.value().files.isEmpty()) {
+                if (auto torrentFile = status.torrent_file.lock()) {
+                    populateTorrentMetadata(it.value(), *torrentFile);
+                    withMetadata.append(it.value());
+                }
+            }
+            
+            applyTorrentStatus(it.value(), status);
+            changed.append(it.value());
+        }
+    }
+    
+    if (changed.isEmpty()) {
+        return;
+    }
+    
+    for (const auto& info : changed) {
+        emit torrentProgress(info.infoHash, info.progress);
+    }
+    torrentModel_->updateTorrents(changed);
+    for (const auto& info : withMetadata) {
+        torrentModel_->setTorrentFiles(info.infoHash, info.files);
     }
 }
 
-void TorrentEngine::emitTorrentUpdate(const QString& infoHash) {
-    auto it = torrents_.find(infoHash);
-    if (it != torrents_.end()) {
-        emit torrentProgress(infoHash, it.value().progress);
-        torrentModel_->updateTorrent(it.value());
+void TorrentEngine::applyMetadataReceived(const QString& infoHash,
+                                          const std::shared_ptr<const libtorrent::torrent_info>& torrentFile) {
+    if (!torrentFile) {
+        return;
     }
+    
+    TorrentInfo updated;
+    
+    {
+        QWriteLocker locker(&torrentsLock_);
+        auto it = torrents_.find(infoHash);
+        if (it == torrents_.end()) {
+            return;
+        }
+        
+        populateTorrentMetadata(it.value(), *torrentFile);
+        updated = it.value();
+    }
+    
+    torrentModel_->updateTorrent(updated);
+    torrentModel_->setTorrentFiles(infoHash, updated.files);
+    MURMUR_DEBUG("Metadata received: {} ({} files)", infoHash.toStdString(), updated.files.size());
 }
 
 void TorrentEngine::initializeSession() {
     try {
-        libtorrent::settings_pack settings;
+        // The profile tunes disk, buffers and queueing; the values below are ours
+        libtorrent::settings_pack settings = TorrentProfiles::settings(performanceProfile_);
         
         // Basic settings
         settings.set_str(libtorrent::settings_pack::user_agent, "Murmur Desktop/1.0");
@@ -669,14 +843,18 @@ void TorrentEngine::initializeSession() {
                         libtorrent::alert_category::error |
                         libtorrent::alert_category::status |
                         libtorrent::alert_category::storage |
-                        libtorrent::alert_category::stats);
+                        libtorrent::alert_category::stats |
+                        libtorrent::alert_category::piece_progress);
         
-        session_ = std::make_unique<libtorrent::session>(settings);
+        libtorrent::session_params params(std::move(settings));
+        TorrentProfiles::applyDiskBackend(params, performanceProfile_);
+        session_ = std::make_unique<libtorrent::session>(std::move(params));
+        sessionUsesMmap_ = TorrentProfiles::usesMmapDiskBackend(performanceProfile_);
         
         configureSessionSettings();
         addDefaultTrackers();
         
-        MURMUR_INFO("LibTorrent session initialized");
+        MURMUR_INFO("LibTorrent session initialized ({})", TorrentProfiles::id(performanceProfile_).toStdString());
         
     } catch (const std::exception& e) {
         MURMUR_ERROR("Failed to initialize session: {}", e.what());
@@ -692,6 +870,162 @@ void TorrentEngine::addDefaultTrackers() {
     // Default trackers are added per-torrent in add_torrent_params
 }
 
+void TorrentEngine::restoreTorrents() {
+    // Reading and decoding run off the GUI thread, and torrents are added
+    // asynchronously; each shows up when its add_torrent_alert arrives
+    restoreFuture_ = QtConcurrent::run([this, session = session_.get(), store = resumeStore_.get()]() {
+        const QHash<QString, QByteArray> entries = store->loadAll();
+        if (entries.isEmpty()) {
+            return;
+        }
+        
+        QStringList infoHashes = entries.keys();
+        std::atomic<int> restored{0};
+        QtConcurrent::blockingMap(infoHashes, [&](const QString& infoHash) {
+            const QByteArray& buffer = entries[infoHash];
+            libtorrent::error_code ec;
+            libtorrent::add_torrent_params params = libtorrent::read_resume_data(
+                libtorrent::span<const char>(buffer.constData(), buffer.size()), ec);
+            if (ec) {
+                MURMUR_WARN("Discarding unreadable resume data for {}: {}", infoHash.toStdString(), ec.message());
+                return;
+            }
+            
+            // Only Added events for these are registered as restores
+            {
+                QWriteLocker locker(&torrentsLock_);
+                pendingRestores_.insert(infoHash);
+            }
+            session->async_add_torrent(std::move(params));
+            ++restored;
+        });
+        
+        MURMUR_INFO("Restoring {} torrents from resume data", restored.load());
+    });
+}
+
+void TorrentEngine::saveResumeData() {
+    QList<libtorrent::torrent_handle> handles;
+    {
+        QWriteLocker locker(&torrentsLock_);
+        for (const QString& infoHash : std::as_const(resumeDirty_)) {
+            auto it = torrentHandles_.constFind(infoHash);
+            if (it != torrentHandles_.cend()) {
+                handles.append(it.value());
+            }
+        }
+        resumeDirty_.clear();
+    }
+    
+    // Answers come back as save_resume_data_alerts through the pump
+    for (const auto& handle : handles) {
+        try {
+            handle.save_resume_data(libtorrent::torrent_handle::only_if_modified |
+                                    libtorrent::torrent_handle::save_info_dict);
+        } catch (const std::exception& e) {
+            MURMUR_WARN("Failed to request resume data: {}", e.what());
+        }
+    }
+}
+
+void TorrentEngine::writeResumeData(const QHash<QString, QByteArray>& entries) {
+    QtConcurrent::run(&resumeWriter_, [store = resumeStore_.get(), entries]() {
+        const int written = store->save(entries);
+        MURMUR_DEBUG("Saved resume data for {} torrents", written);
+    });
+}
+
+// Reads the session's alerts directly, so the pump must be stopped first
+void TorrentEngine::saveAllResumeDataBlocking() {
+    int outstanding = 0;
+    {
+        QReadLocker locker(&torrentsLock_);
+        for (const auto& handle : std::as_const(torrentHandles_)) {
+            try {
+                if (handle.is_valid()) {
+                    handle.save_resume_data(libtorrent::torrent_handle::only_if_modified |
+                                            libtorrent::torrent_handle::save_info_dict);
+                    ++outstanding;
+                }
+            } catch (const std::exception& e) {
+                MURMUR_WARN("Failed to request resume data: {}", e.what());
+            }
+        }
+    }
+    
+    // Every request is answered by either a saved or a failed alert
+    QHash<QString, QByteArray> entries;
+    QDeadlineTimer deadline(SHUTDOWN_RESUME_TIMEOUT_MS);
+    std::vector<libtorrent::alert*> alerts;
+    while (outstanding > 0 && !deadline.hasExpired()) {
+        if (!session_->wait_for_alert(std::chrono::milliseconds(deadline.remainingTime()))) {
+            break;
+        }
+        
+        session_->pop_alerts(&alerts);
+        for (const libtorrent::alert* alert : alerts) {
+            if (auto* saved = libtorrent::alert_cast<libtorrent::save_resume_data_alert>(alert)) {
+                const std::vector<char> buffer = libtorrent::write_resume_data_buf(saved->params);
+                entries.insert(getInfoHashFromHandle(saved->handle),
+                               QByteArray(buffer.data(), static_cast<int>(buffer.size())));
+                --outstanding;
+            } else if (libtorrent::alert_cast<libtorrent::save_resume_data_failed_alert>(alert)) {
+                --outstanding;
+            }
+        }
+    }
+    
+    if (outstanding > 0) {
+        MURMUR_WARN("{} torrents did not report resume data before shutdown", outstanding);
+    }
+    if (!entries.isEmpty()) {
+        writeResumeData(entries);
+    }
+}
+
+void TorrentEngine::applyTorrentAdded(const TorrentEvent& event) {
+    // Torrents added through addTorrent*() are registered by the caller;
+    // only the ones restoreTorrents() queued are new here
+    {
+        QReadLocker locker(&torrentsLock_);
+        if (!pendingRestores_.contains(event.infoHash)) {
+            return;
+        }
+    }
+    
+    TorrentInfo info;
+    info.infoHash = event.infoHash;
+    info.name = event.name.isEmpty() ? QString("Torrent %1").arg(event.infoHash.left(8)) : event.name;
+    info.savePath = event.savePath;
+    info.magnetUri = event.magnetUri;
+    if (event.torrentInfo) {
+        populateTorrentMetadata(info, *event.torrentInfo);
+    }
+    
+    if (!registerTorrent(event.infoHash, info, event.handle)) {
+        return;
+    }
+    
+    torrentModel_->addTorrent(info);
+    emit torrentAdded(event.infoHash);
+    MURMUR_DEBUG("Torrent restored: {}", event.infoHash.toStdString());
+}
+
+bool TorrentEngine::registerTorrent(const QString& infoHash, TorrentInfo& info, const libtorrent::torrent_handle& handle) {
+    QWriteLocker locker(&torrentsLock_);
+    pendingRestores_.remove(infoHash);
+    
+    // Whoever registers first announces the torrent; later callers get its info
+    auto existing = torrents_.constFind(infoHash);
+    if (existing != torrents_.cend()) {
+        info = existing.value();
+        return false;
+    }
+    torrents_.insert(infoHash, info);
+    torrentHandles_.insert(infoHash, handle);
+    return true;
+}
+
 TorrentError TorrentEngine::mapLibtorrentError(const libtorrent::error_code& ec) const {
     if (ec == libtorrent::errors::invalid_torrent_handle) {
         return TorrentError::TorrentNotFound;
@@ -702,28 +1036,42 @@ TorrentError TorrentEngine::mapLibtorrentError(const libtorrent::error_code& ec)
     }
 }
 
-void TorrentEngine::handleTorrentAlert(const libtorrent::alert* alert) {
-    switch (alert->type()) {
-        case libtorrent::torrent_finished_alert::alert_type: {
-            auto* finished = libtorrent::alert_cast<libtorrent::torrent_finished_alert>(alert);
-            if (finished) {
-                QString infoHash = getInfoHashFromHandle(finished->handle);
-                emit torrentCompleted(infoHash);
-                MURMUR_INFO("Torrent completed: {}", infoHash.toStdString());
-            }
+void TorrentEngine::handleTorrentEvent(const TorrentEvent& event) {
+    switch (event.type) {
+        case TorrentEventType::Finished:
+            emit torrentCompleted(event.infoHash);
+            MURMUR_INFO("Torrent completed: {}", event.infoHash.toStdString());
+            break;
+        
+        case TorrentEventType::Error: {
+            TorrentError errorType = mapLibtorrentError(event.error);
+            emit torrentError(event.infoHash, errorType);
+            MURMUR_ERROR("Torrent error: {} - {}", event.infoHash.toStdString(), event.error.message());
             break;
         }
         
-        case libtorrent::torrent_error_alert::alert_type: {
-            auto* error = libtorrent::alert_cast<libtorrent::torrent_error_alert>(alert);
-            if (error) {
-                QString infoHash = getInfoHashFromHandle(error->handle);
-                TorrentError errorType = mapLibtorrentError(error->error);
-                emit torrentError(infoHash, errorType);
-                MURMUR_ERROR("Torrent error: {} - {}", infoHash.toStdString(), error->error.message());
+        case TorrentEventType::MetadataReceived:
+            applyMetadataReceived(event.infoHash, event.torrentInfo);
+            break;
+        
+        case TorrentEventType::Added:
+            applyTorrentAdded(event);
+            break;
+        
+        case TorrentEventType::PieceFinished:
+            for (const auto& stream : streams_.values(event.infoHash)) {
+                if (stream) {
+                    stream->onPieceFinished(event.piece);
+                }
+            }
+            break;
+        
+        case TorrentEventType::ResumeDataFailed:
+            // Torrents that did not change since their last save report this too
+            if (event.error != libtorrent::errors::resume_data_not_modified) {
+                MURMUR_WARN("Failed to save resume data for {}: {}", event.infoHash.toStdString(), event.error.message());
             }
             break;
-        }
         
         default:
             break;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "LibTorrentWrapper.hpp"
+#include "TorrentProfiles.hpp"
 #include "../common/Expected.hpp"
 #include "../security/InputValidator.hpp"
 #include <QtCore/QObject>
@@ -9,16 +10,26 @@
 #include <QtCore/QTimer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QHash>
+#include <QtCore/QMultiHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QThreadPool>
 #include <QtConcurrent/QtConcurrent>
 #include <libtorrent/session.hpp>
 #include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/torrent_status.hpp>
 #include <libtorrent/magnet_uri.hpp>
 #include <memory>
 
 namespace Murmur {
 
 class TorrentStateModel;
+class TorrentStream;
 class TorrentSecurityWrapper;
+class ResumeDataStore;
+class AlertPump;
+struct AlertBatch;
+struct TorrentEvent;
 
 class TorrentEngine : public QObject {
     Q_OBJECT
@@ -42,6 +53,11 @@ public:
         QString status = "Unknown";
     };
     
+    // Resume data of changed torrents is written this often
+    static constexpr int RESUME_SAVE_INTERVAL_MS = 60000;
+    // How long shutdown waits for the final resume data
+    static constexpr int SHUTDOWN_RESUME_TIMEOUT_MS = 10000;
+    
     explicit TorrentEngine(QObject* parent = nullptr);
     ~TorrentEngine();
     
@@ -59,6 +75,11 @@ public:
     Expected<TorrentInfo, TorrentError> getTorrentInfo(const QString& infoHash) const;
     bool hasTorrent(const QString& infoHash) const;
     
+    // Plays a file while the torrent downloads (see TorrentStream); fileIndex
+    // -1 picks the largest file. Call from the engine's thread.
+    Expected<TorrentStream*, TorrentError> openStream(const QString& infoHash, int fileIndex = -1,
+                                                      QObject* parent = nullptr);
+    
     // Qt model for UI binding
     TorrentStateModel* torrentModel() const { return torrentModel_.get(); }
     
@@ -66,6 +87,10 @@ public:
     void configureSession(int maxConnections, int uploadRate, int downloadRate);
     void setDownloadPath(const QString& path);
     
+    // Applies at once, except a disk backend change, which waits for the next session
+    void setPerformanceProfile(TorrentPerformanceProfile profile);
+    TorrentPerformanceProfile performanceProfile() const;
+    
     // Session state
     bool isSessionActive() const;
     void startSession();
@@ -86,38 +111,65 @@ signals:
     void torrentUpdated(const QString& infoHash);
     
 private slots:
-    void handleLibtorrentAlerts();
+    void handleAlertBatch(const AlertBatch& batch);
     void updateTorrentStates();
+    void saveResumeData();
     
 private:
     std::unique_ptr<libtorrent::session> session_;
     std::unique_ptr<TorrentStateModel> torrentModel_;
     std::unique_ptr<TorrentSecurityWrapper> securityWrapper_;
-    QTimer* alertTimer_;
+    std::unique_ptr<AlertPump> alertPump_;
     QTimer* updateTimer_;
+    QTimer* resumeTimer_;
+    
+    // Resume files are written on one thread so saves and removals stay ordered
+    std::unique_ptr<ResumeDataStore> resumeStore_;
+    QThreadPool resumeWriter_;
+    QFuture<void> restoreFuture_;
     
     // Thread-safe torrent storage
     mutable QReadWriteLock torrentsLock_;
     QHash<QString, TorrentInfo> torrents_;
     QHash<QString, libtorrent::torrent_handle> torrentHandles_;
+    QSet<QString> resumeDirty_;  // Torrents flagged need_save_resume since the last save
+    QSet<QString> pendingRestores_;  // Queued by restoreTorrents(), not yet added
+    
+    // Open streams, fed piece completions from the alert batches
+    QMultiHash<QString, QPointer<TorrentStream>> streams_;
     
     QString downloadPath_;
     bool sessionActive_ = false;
+    TorrentPerformanceProfile performanceProfile_ = TorrentPerformanceProfile::Balanced;
+    bool sessionUsesMmap_ = true;  // Disk backend the running session was created with
     
     // Helper methods
     QString getInfoHashFromHandle(const libtorrent::torrent_handle& handle) const;
     TorrentInfo createTorrentInfo(const libtorrent::torrent_handle& handle) const;
-    void updateTorrentInfo(const QString& infoHash, const libtorrent::torrent_handle& handle);
-    void emitTorrentUpdate(const QString& infoHash);
+    void applyTorrentStatus(TorrentInfo& info, const libtorrent::torrent_status& status) const;
+    void populateTorrentMetadata(TorrentInfo& info, const libtorrent::torrent_handle& handle) const;
+    void populateTorrentMetadata(TorrentInfo& info, const libtorrent::torrent_info& torrentFile) const;
+    
+    // Delta updates driven by post_torrent_updates()
+    void applyStateUpdates(const std::vector<libtorrent::torrent_status>& statuses);
+    void applyMetadataReceived(const QString& infoHash, const std::shared_ptr<const libtorrent::torrent_info>& torrentFile);
     
     // Session management
     void initializeSession();
     void configureSessionSettings();
     void addDefaultTrackers();
     
+    // Fast resume
+    void restoreTorrents();
+    void writeResumeData(const QHash<QString, QByteArray>& entries);
+    void saveAllResumeDataBlocking();
+    void applyTorrentAdded(const TorrentEvent& event);
+    bool registerTorrent(const QString& infoHash, TorrentInfo& info, const libtorrent::torrent_handle& handle);
+    
     // Error handling
     TorrentError mapLibtorrentError(const libtorrent::error_code& ec) const;
-    void handleTorrentAlert(const libtorrent::alert* alert);
+    void handleTorrentEvent(const TorrentEvent& event);
+    void abortStreams(const QString& infoHash);
 };
 
 } // namespace Murmur
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "TorrentFilesModel.hpp"
+
+namespace Murmur {
+
+TorrentFilesModel::TorrentFilesModel(const QString& infoHash, QObject* parent)
+    : QAbstractListModel(parent)
+    , infoHash_(infoHash)
+{
+}
+
+int TorrentFilesModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return files_.size();
+}
+
+QVariant TorrentFilesModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= files_.size()) {
+        return QVariant();
+    }
+
+    const QString& path = files_.at(index.row());
+
+    switch (role) {
+        case PathRole:
+            return path;
+        case NameRole:
+        case Qt::DisplayRole:
+            return path.section('/', -1);
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TorrentFilesModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[PathRole] = "path";
+    roles[NameRole] = "name";
+    return roles;
+}
+
+QString TorrentFilesModel::infoHash() const {
+    return infoHash_;
+}
+
+void TorrentFilesModel::setFiles(const QStringList& files) {
+    if (files == files_) {
+        return;
+    }
+
+    beginResetModel();
+    files_ = files;
+    endResetModel();
+
+    emit countChanged();
+}
+
+} // namespace Murmur
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QStringList>
+
+namespace Murmur {
+
+/**
+ * @brief File list of one torrent
+ *
+ * Created on demand by TorrentStateModel::filesModel(), so the torrent
+ * list's delegates never carry file lists around. The model is reset only
+ * when the torrent's files actually change, which happens once when
+ * metadata arrives.
+ */
+class TorrentFilesModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(QString infoHash READ infoHash CONSTANT)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum FileRole {
+        PathRole = Qt::UserRole + 1,
+        NameRole
+    };
+    Q_ENUM(FileRole)
+
+    explicit TorrentFilesModel(const QString& infoHash, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString infoHash() const;
+    void setFiles(const QStringList& files);
+
+signals:
+    void countChanged();
+
+private:
+    QString infoHash_;
+    QStringList files_;
+};
+
+} // namespace Murmur
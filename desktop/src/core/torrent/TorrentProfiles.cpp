@@ -0,0 +1,161 @@
+#include "TorrentProfiles.hpp"
+#include "../common/Config.hpp"
+
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/session.hpp>
+#include <libtorrent/session_params.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/posix_disk_io.hpp>
+
+namespace Murmur {
+
+namespace {
+
+constexpr int KiB = 1024;
+constexpr int MiB = 1024 * 1024;
+
+struct ProfileValues {
+    const char* name;
+
+    // Disk
+    int aioThreads;
+    int hashingThreads;
+    int maxQueuedDiskBytes;
+    int filePoolSize;
+    int checkingMemUsage;  // In 16 KiB blocks
+    bool mmapBackend;
+
+    // Peers
+    int sendBufferWatermark;
+    int sendBufferLowWatermark;
+    int sendBufferWatermarkFactor;
+    int maxOutRequestQueue;
+    int maxAllowedInRequestQueue;
+    int maxPeerlistSize;
+    int maxPausedPeerlistSize;
+
+    // Choking
+    int chokingAlgorithm;
+    int seedChokingAlgorithm;
+    int unchokeSlotsLimit;
+    int suggestMode;
+
+    // Queueing
+    int activeDownloads;
+    int activeSeeds;
+    int activeChecking;
+    int activeLimit;
+};
+
+// libtorrent 2.0 defaults
+constexpr ProfileValues BALANCED = {
+    "balanced",
+    10, 1, 1 * MiB, 40, 256, true,
+    500 * KiB, 10 * KiB, 50, 500, 500, 3000, 1000,
+    libtorrent::settings_pack::fixed_slots_choker, libtorrent::settings_pack::round_robin, 8,
+    libtorrent::settings_pack::no_piece_suggestions,
+    3, 5, 1, 500
+};
+
+// Large send buffers and disk queues keep fast disks busy; the rate based
+// choker unchokes as many peers as the upload can actually serve
+constexpr ProfileValues HIGH_THROUGHPUT = {
+    "high-throughput",
+    32, 4, 7 * MiB, 500, 2048, true,
+    3 * MiB, 1 * MiB, 150, 1500, 2000, 4000, 1000,
+    libtorrent::settings_pack::rate_based_choker, libtorrent::settings_pack::fastest_upload, 100,
+    libtorrent::settings_pack::suggest_read_cache,
+    20, 2000, 2, 2000
+};
+
+// pread/pwrite storage avoids mapping whole files into the address space
+constexpr ProfileValues LOW_MEMORY = {
+    "low-memory",
+    2, 1, 256 * KiB, 8, 8, false,
+    128 * KiB, 8 * KiB, 20, 100, 100, 500, 50,
+    libtorrent::settings_pack::fixed_slots_choker, libtorrent::settings_pack::round_robin, 4,
+    libtorrent::settings_pack::no_piece_suggestions,
+    2, 3, 1, 15
+};
+
+const ProfileValues& valuesFor(TorrentPerformanceProfile profile) {
+    switch (profile) {
+        case TorrentPerformanceProfile::HighThroughput:
+            return HIGH_THROUGHPUT;
+        case TorrentPerformanceProfile::LowMemory:
+            return LOW_MEMORY;
+        case TorrentPerformanceProfile::Balanced:
+        default:
+            return BALANCED;
+    }
+}
+
+void fillSettings(libtorrent::settings_pack& pack, const ProfileValues& values) {
+    using sp = libtorrent::settings_pack;
+
+    pack.set_int(sp::aio_threads, values.aioThreads);
+    pack.set_int(sp::hashing_threads, values.hashingThreads);
+    pack.set_int(sp::max_queued_disk_bytes, values.maxQueuedDiskBytes);
+    pack.set_int(sp::file_pool_size, values.filePoolSize);
+    pack.set_int(sp::checking_mem_usage, values.checkingMemUsage);
+
+    pack.set_int(sp::send_buffer_watermark, values.sendBufferWatermark);
+    pack.set_int(sp::send_buffer_low_watermark, values.sendBufferLowWatermark);
+    pack.set_int(sp::send_buffer_watermark_factor, values.sendBufferWatermarkFactor);
+    pack.set_int(sp::max_out_request_queue, values.maxOutRequestQueue);
+    pack.set_int(sp::max_allowed_in_request_queue, values.maxAllowedInRequestQueue);
+    pack.set_int(sp::max_peerlist_size, values.maxPeerlistSize);
+    pack.set_int(sp::max_paused_peerlist_size, values.maxPausedPeerlistSize);
+
+    pack.set_int(sp::choking_algorithm, values.chokingAlgorithm);
+    pack.set_int(sp::seed_choking_algorithm, values.seedChokingAlgorithm);
+    pack.set_int(sp::unchoke_slots_limit, values.unchokeSlotsLimit);
+    pack.set_int(sp::suggest_mode, values.suggestMode);
+
+    pack.set_int(sp::active_downloads, values.activeDownloads);
+    pack.set_int(sp::active_seeds, values.activeSeeds);
+    pack.set_int(sp::active_checking, values.activeChecking);
+    pack.set_int(sp::active_limit, values.activeLimit);
+}
+
+} // namespace
+
+QString TorrentProfiles::name(TorrentPerformanceProfile profile) {
+    return QString::fromLatin1(valuesFor(profile).name);
+}
+
+TorrentPerformanceProfile TorrentProfiles::fromName(const QString& name) {
+    for (auto profile : {TorrentPerformanceProfile::HighThroughput, TorrentPerformanceProfile::LowMemory}) {
+        if (name.compare(TorrentProfiles::name(profile), Qt::CaseInsensitive) == 0) {
+            return profile;
+        }
+    }
+    return TorrentPerformanceProfile::Balanced;
+}
+
+TorrentPerformanceProfile TorrentProfiles::configured() {
+    return fromName(Config::instance().getTorrentSettings().performanceProfile);
+}
+
+QString TorrentProfiles::id(TorrentPerformanceProfile profile) {
+    return QString("%1/v%2").arg(name(profile)).arg(VERSION);
+}
+
+libtorrent::settings_pack TorrentProfiles::settings(TorrentPerformanceProfile profile) {
+    libtorrent::settings_pack pack;
+    fillSettings(pack, valuesFor(profile));
+    return pack;
+}
+
+bool TorrentProfiles::usesMmapDiskBackend(TorrentPerformanceProfile profile) {
+    return valuesFor(profile).mmapBackend;
+}
+
+void TorrentProfiles::applyDiskBackend(libtorrent::session_params& params, TorrentPerformanceProfile profile) {
+    // The default backend is the mmap one wherever the platform supports it
+    params.disk_io_constructor = usesMmapDiskBackend(profile)
+        ? libtorrent::disk_io_constructor_type(libtorrent::default_disk_io_constructor)
+        : libtorrent::disk_io_constructor_type(libtorrent::posix_disk_io_constructor);
+}
+
+} // namespace Murmur
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QtCore/QString>
+
+namespace libtorrent {
+    struct settings_pack;
+    struct session_params;
+}
+
+namespace Murmur {
+
+enum class TorrentPerformanceProfile {
+    Balanced,        // libtorrent's defaults; a desktop downloading a few torrents
+    HighThroughput,  // Seedboxes serving many torrents from fast disks
+    LowMemory        // Small machines where resident memory matters more than speed
+};
+
+/**
+ * @brief Named libtorrent tunings, applied on top of a session's settings
+ *
+ * Every profile sets the same keys: disk I/O and hashing threads, send
+ * buffer watermarks, max_queued_disk_bytes, file pool and checking memory,
+ * the choking algorithms and the active_* queue limits. Switching profiles
+ * at runtime therefore fully replaces the previous tuning through
+ * apply_settings(). Rate and connection limits are left to the caller.
+ *
+ * The disk backend is the exception: it is fixed when the session is
+ * created, so a switch between mmap and pread/pwrite storage only takes
+ * effect on the next session start.
+ *
+ * VERSION is bumped whenever a profile's values change, so logs show which
+ * tuning a session ran with.
+ */
+class TorrentProfiles {
+public:
+    static constexpr int VERSION = 1;
+
+    static QString name(TorrentPerformanceProfile profile);
+
+    // Unknown names fall back to Balanced
+    static TorrentPerformanceProfile fromName(const QString& name);
+
+    // The profile saved under torrent/performanceProfile
+    static TorrentPerformanceProfile configured();
+
+    // Name and version, e.g. "high-throughput/v1"
+    static QString id(TorrentPerformanceProfile profile);
+
+    static libtorrent::settings_pack settings(TorrentPerformanceProfile profile);
+
+    static bool usesMmapDiskBackend(TorrentPerformanceProfile profile);
+
+    // Picks the disk backend; sessions are created from settings(profile)
+    // plus their own values
+    static void applyDiskBackend(libtorrent::session_params& params, TorrentPerformanceProfile profile);
+};
+
+} // namespace Murmur
@@ -1,11 +1,20 @@
 #include "TorrentStateModel.hpp"
 #include "../common/Logger.hpp"
 
+#include <QtCore/QPair>
+#include <QtCore/QThread>
+
+#include <algorithm>
+
 namespace Murmur {
 
 TorrentStateModel::TorrentStateModel(QObject* parent)
     : QAbstractListModel(parent)
+    , flushTimer_(new QTimer(this))
 {
+    flushTimer_->setSingleShot(true);
+    flushTimer_->setInterval(COALESCE_INTERVAL_MS);
+    connect(flushTimer_, &QTimer::timeout, this, &TorrentStateModel::flushPendingChanges);
 }
 
 int TorrentStateModel::rowCount(const QModelIndex& parent) const {
@@ -43,8 +52,6 @@ QVariant TorrentStateModel::data(const QModelIndex& index, int role) const {
             return torrent.seeders;
         case LeechersRole:
             return torrent.leechers;
-        case FilesRole:
-            return torrent.files;
         case SavePathRole:
             return torrent.savePath;
         case MagnetUriRole:
@@ -75,7 +82,6 @@ QHash<int, QByteArray> TorrentStateModel::roleNames() const {
     roles[UploadSpeedRole] = "uploadSpeed";
     roles[SeedersRole] = "seeders";
     roles[LeechersRole] = "leechers";
-    roles[FilesRole] = "files";
     roles[SavePathRole] = "savePath";
     roles[MagnetUriRole] = "magnetUri";
     roles[IsSeedingRole] = "isSeeding";
@@ -85,6 +91,11 @@ QHash<int, QByteArray> TorrentStateModel::roleNames() const {
 }
 
 void TorrentStateModel::addTorrent(const TorrentEngine::TorrentInfo& info) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, info]() { addTorrent(info); }, Qt::QueuedConnection);
+        return;
+    }
+    
     // Check if torrent already exists
     if (torrentIndexMap_.contains(info.infoHash)) {
         updateTorrent(info);
@@ -93,7 +104,7 @@ void TorrentStateModel::addTorrent(const TorrentEngine::TorrentInfo& info) {
     
     beginInsertRows(QModelIndex(), torrents_.size(), torrents_.size());
     torrents_.append(info);
-    updateIndexMap();
+    torrentIndexMap_.insert(info.infoHash, torrents_.size() - 1);
     endInsertRows();
     
     emit torrentCountChanged();
@@ -102,28 +113,119 @@ void TorrentStateModel::addTorrent(const TorrentEngine::TorrentInfo& info) {
 }
 
 void TorrentStateModel::updateTorrent(const TorrentEngine::TorrentInfo& info) {
-    auto it = torrentIndexMap_.find(info.infoHash);
-    if (it == torrentIndexMap_.end()) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, info]() { updateTorrent(info); }, Qt::QueuedConnection);
+        return;
+    }
+    
+    if (!torrentIndexMap_.contains(info.infoHash)) {
         addTorrent(info);
         return;
     }
     
-    int index = it.value();
-    if (index >= 0 && index < torrents_.size()) {
-        torrents_[index] = info;
+    applyUpdate(info);
+}
+
+void TorrentStateModel::updateTorrents(const QList<TorrentEngine::TorrentInfo>& infos) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, infos]() { updateTorrents(infos); }, Qt::QueuedConnection);
+        return;
+    }
+    
+    for (const auto& info : infos) {
+        updateTorrent(info);
+    }
+}
+
+void TorrentStateModel::flushPendingChanges() {
+    flushTimer_->stop();
+    if (pendingRoles_.isEmpty()) {
+        return;
+    }
+    
+    QList<QPair<int, QList<int>>> rows;
+    rows.reserve(pendingRoles_.size());
+    QStringList updated;
+    updated.reserve(pendingRoles_.size());
+    
+    for (auto it = pendingRoles_.cbegin(); it != pendingRoles_.cend(); ++it) {
+        const int index = getTorrentIndex(it.key());
+        if (index < 0) {
+            continue;
+        }
         
-        QModelIndex modelIndex = createIndex(index, 0);
-        emit dataChanged(modelIndex, modelIndex);
-        emit torrentUpdated(info.infoHash);
+        QList<int> roles = it.value().values();
+        std::sort(roles.begin(), roles.end());
+        rows.append(qMakePair(index, roles));
+        updated.append(it.key());
+    }
+    pendingRoles_.clear();
+    
+    // Neighbouring rows with the same changed roles share one notification
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (int first = 0; first < rows.size();) {
+        int last = first;
+        while (last + 1 < rows.size() &&
+               rows[last + 1].first == rows[last].first + 1 &&
+               rows[last + 1].second == rows[first].second) {
+            ++last;
+        }
+        emit dataChanged(createIndex(rows[first].first, 0), createIndex(rows[last].first, 0), rows[first].second);
+        first = last + 1;
+    }
+    
+    for (const QString& infoHash : updated) {
+        emit torrentUpdated(infoHash);
+    }
+}
+
+TorrentFilesModel* TorrentStateModel::filesModel(const QString& infoHash) {
+    const int index = getTorrentIndex(infoHash);
+    if (index < 0) {
+        return nullptr;
+    }
+    
+    QPointer<TorrentFilesModel>& model = filesModels_[infoHash];
+    if (!model) {
+        model = new TorrentFilesModel(infoHash, this);
+        model->setFiles(torrents_.at(index).files);
+    }
+    return model;
+}
+
+void TorrentStateModel::setTorrentFiles(const QString& infoHash, const QStringList& files) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, infoHash, files]() { setTorrentFiles(infoHash, files); }, Qt::QueuedConnection);
+        return;
+    }
+    
+    const int index = getTorrentIndex(infoHash);
+    if (index < 0) {
+        return;
+    }
+    
+    torrents_[index].files = files;
+    if (auto model = filesModels_.value(infoHash)) {
+        model->setFiles(files);
     }
 }
 
 void TorrentStateModel::removeTorrent(const QString& infoHash) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, infoHash]() { removeTorrent(infoHash); }, Qt::QueuedConnection);
+        return;
+    }
+    
     auto it = torrentIndexMap_.find(infoHash);
     if (it == torrentIndexMap_.end()) {
         return;
     }
     
+    pendingRoles_.remove(infoHash);
+    if (auto files = filesModels_.take(infoHash)) {
+        files->deleteLater();
+    }
+    
     int index = it.value();
     if (index >= 0 && index < torrents_.size()) {
         beginRemoveRows(QModelIndex(), index, index);
@@ -138,10 +240,24 @@ void TorrentStateModel::removeTorrent(const QString& infoHash) {
 }
 
 void TorrentStateModel::clear() {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() { clear(); }, Qt::QueuedConnection);
+        return;
+    }
+    
     if (torrents_.isEmpty()) {
         return;
     }
     
+    pendingRoles_.clear();
+    flushTimer_->stop();
+    for (const auto& files : std::as_const(filesModels_)) {
+        if (files) {
+            files->deleteLater();
+        }
+    }
+    filesModels_.clear();
+    
     beginResetModel();
     torrents_.clear();
     torrentIndexMap_.clear();
@@ -193,6 +309,73 @@ int TorrentStateModel::downloadingTorrentsCount() const {
     return count;
 }
 
+void TorrentStateModel::applyUpdate(const TorrentEngine::TorrentInfo& info) {
+    const int index = getTorrentIndex(info.infoHash);
+    if (index < 0 || index >= torrents_.size()) {
+        return;
+    }
+    
+    TorrentEngine::TorrentInfo& row = torrents_[index];
+    const QSet<int> roles = changedRoles(row, info);
+    if (roles.isEmpty()) {
+        return;
+    }
+    
+    // Files only change through setTorrentFiles()
+    QStringList files = std::move(row.files);
+    row = info;
+    row.files = std::move(files);
+    pendingRoles_[info.infoHash].unite(roles);
+    if (!flushTimer_->isActive()) {
+        flushTimer_->start();
+    }
+}
+
+QSet<int> TorrentStateModel::changedRoles(const TorrentEngine::TorrentInfo& before,
+                                          const TorrentEngine::TorrentInfo& after) const {
+    QSet<int> roles;
+    if (before.name != after.name) {
+        roles << NameRole << Qt::DisplayRole;
+    }
+    if (before.size != after.size) {
+        roles << SizeRole;
+    }
+    if (before.progress != after.progress) {
+        roles << ProgressRole;
+    }
+    if (before.peers != after.peers) {
+        roles << PeersRole;
+    }
+    if (before.downloadRate != after.downloadRate) {
+        roles << DownloadRateRole << DownloadSpeedRole;
+    }
+    if (before.uploadRate != after.uploadRate) {
+        roles << UploadRateRole << UploadSpeedRole;
+    }
+    if (before.seeders != after.seeders) {
+        roles << SeedersRole;
+    }
+    if (before.leechers != after.leechers) {
+        roles << LeechersRole;
+    }
+    if (before.savePath != after.savePath) {
+        roles << SavePathRole;
+    }
+    if (before.magnetUri != after.magnetUri) {
+        roles << MagnetUriRole;
+    }
+    if (before.isSeeding != after.isSeeding) {
+        roles << IsSeedingRole;
+    }
+    if (before.isPaused != after.isPaused) {
+        roles << IsPausedRole;
+    }
+    if (before.status != after.status) {
+        roles << StatusRole;
+    }
+    return roles;
+}
+
 void TorrentStateModel::updateIndexMap() {
     torrentIndexMap_.clear();
     for (int i = 0; i < torrents_.size(); ++i) {
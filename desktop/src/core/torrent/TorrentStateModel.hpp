@@ -1,15 +1,37 @@
 #pragma once
 
 #include "TorrentEngine.hpp"
+#include "TorrentFilesModel.hpp"
 #include <QtCore/QAbstractListModel>
 #include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
 
 namespace Murmur {
 
+/**
+ * @brief List model of all torrents for QML
+ *
+ * Updates are compared with the stored row, and only the roles whose value
+ * changed are reported, so delegates re-evaluate just the bindings that
+ * depend on them. Changes are collected and announced at most once per
+ * COALESCE_INTERVAL_MS; neighbouring rows with the same changed roles share
+ * one dataChanged(). Rows always hold the newest state, so getTorrentInfo()
+ * is current even before the announcement.
+ *
+ * File lists live in per-torrent TorrentFilesModels created on demand.
+ *
+ * The mutators may be called from TorrentEngine's worker threads; such
+ * calls are queued to the model's thread, which owns the rows, the flush
+ * timer and the files models.
+ */
 class TorrentStateModel : public QAbstractListModel {
     Q_OBJECT
     
 public:
+    static constexpr int COALESCE_INTERVAL_MS = 16;  // One frame at 60 Hz
+    
     enum TorrentRole {
         InfoHashRole = Qt::UserRole + 1,
         NameRole,
@@ -22,7 +44,6 @@ public:
         UploadSpeedRole,
         SeedersRole,
         LeechersRole,
-        FilesRole,
         SavePathRole,
         MagnetUriRole,
         IsSeedingRole,
@@ -41,9 +62,20 @@ public:
     // Torrent management
     void addTorrent(const TorrentEngine::TorrentInfo& info);
     void updateTorrent(const TorrentEngine::TorrentInfo& info);
+    void updateTorrents(const QList<TorrentEngine::TorrentInfo>& infos);
     void removeTorrent(const QString& infoHash);
+    
+    // File lists are not part of the row roles; they change once, when
+    // metadata arrives, and are announced through the files model
+    void setTorrentFiles(const QString& infoHash, const QStringList& files);
     void clear();
     
+    // Announces collected changes now rather than on the next frame
+    void flushPendingChanges();
+    
+    // Created on first use and owned by this model; null for unknown torrents
+    Q_INVOKABLE Murmur::TorrentFilesModel* filesModel(const QString& infoHash);
+    
     // Convenience methods
     int getTorrentIndex(const QString& infoHash) const;
     TorrentEngine::TorrentInfo getTorrentInfo(int index) const;
@@ -62,6 +94,13 @@ private:
     QList<TorrentEngine::TorrentInfo> torrents_;
     QHash<QString, int> torrentIndexMap_;
     
+    // Roles changed per torrent since the last announcement
+    QHash<QString, QSet<int>> pendingRoles_;
+    QTimer* flushTimer_;
+    QHash<QString, QPointer<TorrentFilesModel>> filesModels_;
+    
+    void applyUpdate(const TorrentEngine::TorrentInfo& info);
+    QSet<int> changedRoles(const TorrentEngine::TorrentInfo& before, const TorrentEngine::TorrentInfo& after) const;
     void updateIndexMap();
     QString formatFileSize(qint64 bytes) const;
     QString formatSpeed(qint64 bytesPerSecond) const;
@@ -0,0 +1,374 @@
+#include "TorrentStream.hpp"
+#include "../common/Logger.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+
+#include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_status.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace Murmur {
+
+struct TorrentStream::TorrentStreamPrivate {
+    libtorrent::torrent_handle handle;
+    QString infoHash;
+    QString filePath;
+    QString fileName;
+
+    // Where the file sits in the torrent's byte stream
+    qint64 fileOffset = 0;
+    qint64 fileSize = 0;
+    qint64 pieceLength = 0;
+    int firstPiece = 0;
+    int lastPiece = 0;
+
+    mutable QMutex mutex;
+    QWaitCondition pieceArrived;
+    std::vector<bool> havePieces;  // Indexed from firstPiece
+    std::vector<bool> requested;   // Deadlines this stream set, indexed from firstPiece
+    int tailFirst = 0;             // Container index pieces, kept across seeks
+    bool aborted = false;
+    QFile file;
+
+    std::atomic<qint64> position{0};
+    qint64 bitrate = DEFAULT_BITRATE;
+    int windowPiece = -1;
+    int windowLast = -1;
+
+    int pieceAt(qint64 position) const {
+        return static_cast<int>((fileOffset + position) / pieceLength);
+    }
+
+    bool has(int piece) const {
+        return piece >= firstPiece && piece <= lastPiece && havePieces[piece - firstPiece];
+    }
+
+    int windowPieces() const {
+        const qint64 bytes = std::clamp(bitrate / 8 * READ_AHEAD_SECONDS, MIN_READ_AHEAD_BYTES, MAX_READ_AHEAD_BYTES);
+        return static_cast<int>((bytes + pieceLength - 1) / pieceLength);
+    }
+
+    // How long playback takes to get through one piece
+    int msPerPiece() const {
+        return static_cast<int>(std::max<qint64>(1, pieceLength * 8 * 1000 / bitrate));
+    }
+};
+
+TorrentStream::TorrentStream(const libtorrent::torrent_handle& handle, const QString& infoHash, int fileIndex,
+                             QObject* parent)
+    : QIODevice(parent)
+    , d(std::make_unique<TorrentStreamPrivate>()) {
+
+    d->handle = handle;
+    d->infoHash = infoHash;
+
+    auto torrentInfo = handle.torrent_file();
+    const libtorrent::file_storage& files = torrentInfo->files();
+    const libtorrent::file_index_t index(fileIndex);
+    const auto status = handle.status(libtorrent::torrent_handle::query_pieces | libtorrent::torrent_handle::query_save_path);
+
+    d->fileOffset = files.file_offset(index);
+    d->fileSize = files.file_size(index);
+    d->pieceLength = files.piece_length();
+    d->filePath = QDir(QString::fromStdString(status.save_path)).filePath(QString::fromStdString(files.file_path(index)));
+    d->fileName = QString::fromStdString(std::string(files.file_name(index)));
+    d->firstPiece = d->pieceAt(0);
+    d->lastPiece = d->pieceAt(std::max<qint64>(d->fileSize - 1, 0));
+
+    d->havePieces.resize(static_cast<size_t>(d->lastPiece - d->firstPiece + 1));
+    d->requested.resize(d->havePieces.size());
+    d->tailFirst = std::max(d->lastPiece - 1, d->firstPiece);
+    for (int piece = d->firstPiece; piece <= d->lastPiece; ++piece) {
+        const libtorrent::piece_index_t pieceIndex(piece);
+        d->havePieces[static_cast<size_t>(piece - d->firstPiece)] =
+            status.pieces.size() > piece && status.pieces.get_bit(pieceIndex);
+    }
+    d->file.setFileName(d->filePath);
+}
+
+TorrentStream::~TorrentStream() {
+    close();
+}
+
+Expected<TorrentStream*, TorrentError> TorrentStream::create(const libtorrent::torrent_handle& handle,
+                                                             const QString& infoHash, int fileIndex,
+                                                             QObject* parent) {
+    if (!handle.is_valid()) {
+        return makeUnexpected(TorrentError::TorrentNotFound);
+    }
+
+    auto torrentInfo = handle.torrent_file();
+    if (!torrentInfo) {
+        return makeUnexpected(TorrentError::MetadataPending);
+    }
+
+    const libtorrent::file_storage& files = torrentInfo->files();
+    if (fileIndex < 0) {
+        // The largest file is the video in almost every release
+        qint64 largestSize = -1;
+        for (int i = 0; i < files.num_files(); ++i) {
+            const qint64 fileSize = files.file_size(libtorrent::file_index_t(i));
+            if (fileSize > largestSize) {
+                largestSize = fileSize;
+                fileIndex = i;
+            }
+        }
+    }
+    if (fileIndex < 0 || fileIndex >= files.num_files()) {
+        return makeUnexpected(TorrentError::FileSystemError);
+    }
+
+    auto* stream = new TorrentStream(handle, infoHash, fileIndex, parent);
+    if (!stream->open(QIODevice::ReadOnly)) {
+        delete stream;
+        return makeUnexpected(TorrentError::FileSystemError);
+    }
+    return stream;
+}
+
+bool TorrentStream::open(OpenMode mode) {
+    if (mode & WriteOnly) {
+        setErrorString("Torrent streams are read-only");
+        return false;
+    }
+    if (!QIODevice::open(mode | Unbuffered)) {
+        return false;
+    }
+
+    QMutexLocker locker(&d->mutex);
+    d->aborted = false;
+    d->position = 0;
+    moveWindow(d->firstPiece);
+
+    // Container indexes are usually at the end; fetch them right after the
+    // first pieces so the player can start without seeking into a hole
+    try {
+        const int tailDeadline = d->msPerPiece() * 2;
+        for (int piece = std::max(d->tailFirst, d->windowLast + 1); piece <= d->lastPiece; ++piece) {
+            if (!d->has(piece)) {
+                requestPiece(piece, tailDeadline);
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger::instance().warn("TorrentStream: failed to request tail pieces: {}", e.what());
+    }
+    return true;
+}
+
+void TorrentStream::close() {
+    {
+        QMutexLocker locker(&d->mutex);
+        d->aborted = true;
+        d->pieceArrived.wakeAll();
+        d->file.close();
+
+        if (d->windowPiece >= 0) {
+            releasePieces(-1, -1);
+            d->windowPiece = -1;
+            d->windowLast = -1;
+        }
+    }
+    QIODevice::close();
+}
+
+bool TorrentStream::isSequential() const {
+    return false;
+}
+
+qint64 TorrentStream::size() const {
+    return d->fileSize;
+}
+
+bool TorrentStream::seek(qint64 position) {
+    if (position < 0 || position > d->fileSize || !QIODevice::seek(position)) {
+        return false;
+    }
+    d->position = position;
+
+    // Start fetching the seek target before the first read arrives
+    if (position < d->fileSize) {
+        QMutexLocker locker(&d->mutex);
+        moveWindow(d->pieceAt(position));
+    }
+    return true;
+}
+
+bool TorrentStream::atEnd() const {
+    return d->position >= d->fileSize;
+}
+
+qint64 TorrentStream::bytesAvailable() const {
+    QMutexLocker locker(&d->mutex);
+    return contiguousBytesFrom(d->position);
+}
+
+QString TorrentStream::infoHash() const {
+    return d->infoHash;
+}
+
+QString TorrentStream::fileName() const {
+    return d->fileName;
+}
+
+void TorrentStream::setBitrate(qint64 bitsPerSecond) {
+    if (bitsPerSecond <= 0) {
+        return;
+    }
+
+    QMutexLocker locker(&d->mutex);
+    d->bitrate = bitsPerSecond;
+
+    // Resize the current window around the same position
+    const int piece = d->windowPiece;
+    if (piece >= 0) {
+        d->windowPiece = -1;
+        moveWindow(piece);
+    }
+}
+
+qint64 TorrentStream::readData(char* data, qint64 maxSize) {
+    const qint64 position = d->position;
+    if (position >= d->fileSize) {
+        return 0;
+    }
+
+    QMutexLocker locker(&d->mutex);
+    const int piece = d->pieceAt(position);
+    moveWindow(piece);
+
+    while (!d->has(piece)) {
+        if (d->aborted) {
+            setErrorString("Stream closed");
+            return -1;
+        }
+        if (!d->pieceArrived.wait(&d->mutex, READ_TIMEOUT_MS)) {
+            Logger::instance().warn("TorrentStream: timed out waiting for piece {} of {}",
+                                    piece, d->fileName.toStdString());
+            setErrorString("Timed out waiting for torrent data");
+            return -1;
+        }
+    }
+
+    // The piece is only in the file once libtorrent has written it, which
+    // may be after the file was first looked for
+    if (!d->file.isOpen() && !d->file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        setErrorString(d->file.errorString());
+        return -1;
+    }
+
+    const qint64 length = std::min(maxSize, contiguousBytesFrom(position));
+    if (!d->file.seek(position)) {
+        setErrorString(d->file.errorString());
+        return -1;
+    }
+    const qint64 bytesRead = d->file.read(data, length);
+    if (bytesRead < 0) {
+        setErrorString(d->file.errorString());
+        return -1;
+    }
+
+    d->position = position + bytesRead;
+    return bytesRead;
+}
+
+qint64 TorrentStream::writeData(const char* data, qint64 maxSize) {
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+void TorrentStream::onPieceFinished(int piece) {
+    QMutexLocker locker(&d->mutex);
+    if (piece < d->firstPiece || piece > d->lastPiece) {
+        return;
+    }
+    d->havePieces[static_cast<size_t>(piece - d->firstPiece)] = true;
+    d->requested[static_cast<size_t>(piece - d->firstPiece)] = false;
+    d->pieceArrived.wakeAll();
+}
+
+void TorrentStream::onTorrentRemoved() {
+    QMutexLocker locker(&d->mutex);
+    d->aborted = true;
+    d->pieceArrived.wakeAll();
+}
+
+// Called with the mutex held
+void TorrentStream::moveWindow(int piece) {
+    if (piece == d->windowPiece || d->aborted) {
+        return;
+    }
+
+    // Pieces behind a seek are no longer urgent
+    const bool jumped = piece < d->windowPiece || piece > d->windowLast;
+    d->windowPiece = piece;
+    d->windowLast = std::min(piece + d->windowPieces() - 1, d->lastPiece);
+
+    if (jumped) {
+        releasePieces(piece, d->windowLast);
+    }
+
+    try {
+        const int step = d->msPerPiece();
+        for (int next = piece; next <= d->windowLast; ++next) {
+            if (!d->has(next)) {
+                requestPiece(next, (next - piece) * step);
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger::instance().warn("TorrentStream: failed to set piece deadlines: {}", e.what());
+    }
+}
+
+// Called with the mutex held
+void TorrentStream::requestPiece(int piece, int deadlineMs) {
+    d->handle.set_piece_deadline(libtorrent::piece_index_t(piece), deadlineMs);
+    d->requested[static_cast<size_t>(piece - d->firstPiece)] = true;
+}
+
+// Called with the mutex held. Resets the deadlines this stream set outside
+// keepFirst..keepLast and the tail; other streams of the torrent keep theirs.
+void TorrentStream::releasePieces(int keepFirst, int keepLast) {
+    const bool closing = keepFirst < 0;
+    try {
+        for (int piece = d->firstPiece; piece <= d->lastPiece; ++piece) {
+            const size_t slot = static_cast<size_t>(piece - d->firstPiece);
+            if (!d->requested[slot] || (piece >= keepFirst && piece <= keepLast) ||
+                (!closing && piece >= d->tailFirst)) {
+                continue;
+            }
+            d->handle.reset_piece_deadline(libtorrent::piece_index_t(piece));
+            d->requested[slot] = false;
+        }
+    } catch (const std::exception&) {
+        // The torrent is already gone
+        std::fill(d->requested.begin(), d->requested.end(), false);
+    }
+}
+
+// Called with the mutex held
+qint64 TorrentStream::contiguousBytesFrom(qint64 position) const {
+    if (position >= d->fileSize) {
+        return 0;
+    }
+
+    int piece = d->pieceAt(position);
+    while (d->has(piece)) {
+        ++piece;
+    }
+
+    // End of the last complete piece, in file coordinates
+    const qint64 end = std::min(static_cast<qint64>(piece) * d->pieceLength - d->fileOffset, d->fileSize);
+    return std::max<qint64>(0, end - position);
+}
+
+} // namespace Murmur
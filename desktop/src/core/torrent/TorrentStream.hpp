@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+
+#include "LibTorrentWrapper.hpp"
+
+namespace libtorrent {
+    class torrent_handle;
+}
+
+namespace Murmur {
+
+/**
+ * @brief Random-access reader over one file of a torrent that is still downloading
+ *
+ * Reads come from the partially written file on disk. A read of a piece
+ * that has not arrived blocks until it does, so the device must be read
+ * from a worker thread; QMediaPlayer's demuxer already does this.
+ *
+ * Every read or seek moves a window of piece deadlines to the current
+ * position: the piece being read is requested immediately and the ones
+ * after it at the rate playback will reach them. The window covers
+ * READ_AHEAD_SECONDS of playback at the stream's bitrate, so it grows for
+ * high-bitrate files. Opening also requests the last pieces of the file,
+ * where MP4 indexes and Matroska cues usually live. A stream only ever
+ * resets the deadlines it set itself, so several streams can play files of
+ * the same torrent.
+ *
+ * bytesAvailable() reports how much data is downloaded contiguously from
+ * the current position. Opened through TorrentEngine::openStream(), or
+ * LibTorrentWrapper::openStream() for sessions owned by the wrapper.
+ */
+class TorrentStream : public QIODevice {
+    Q_OBJECT
+
+public:
+    static constexpr int READ_AHEAD_SECONDS = 30;
+    static constexpr qint64 MIN_READ_AHEAD_BYTES = 4 * 1024 * 1024;
+    static constexpr qint64 MAX_READ_AHEAD_BYTES = 256 * 1024 * 1024;
+    static constexpr qint64 DEFAULT_BITRATE = 8 * 1000 * 1000;  // bits/sec, until the real one is known
+    static constexpr int READ_TIMEOUT_MS = 60000;
+
+    ~TorrentStream() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 size() const override;
+    bool seek(qint64 position) override;
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+
+    QString infoHash() const;
+    QString fileName() const;
+
+    // Sizes the read-ahead window; the player sets it once the duration is known
+    void setBitrate(qint64 bitsPerSecond);
+
+    // Opens fileIndex of the torrent, or its largest file for -1. Fails with
+    // MetadataPending until a magnet link's metadata has arrived.
+    static Expected<TorrentStream*, TorrentError> create(const libtorrent::torrent_handle& handle,
+                                                         const QString& infoHash, int fileIndex,
+                                                         QObject* parent = nullptr);
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    friend class LibTorrentWrapper;
+    friend class TorrentEngine;
+
+    TorrentStream(const libtorrent::torrent_handle& handle, const QString& infoHash, int fileIndex,
+                  QObject* parent = nullptr);
+
+    // Called by the owning session's alert handling
+    void onPieceFinished(int piece);
+    void onTorrentRemoved();
+
+    struct TorrentStreamPrivate;
+    std::unique_ptr<TorrentStreamPrivate> d;
+
+    void moveWindow(int piece);
+    void requestPiece(int piece, int deadlineMs);
+    void releasePieces(int keepFirst, int keepLast);
+    qint64 contiguousBytesFrom(qint64 position) const;
+};
+
+} // namespace Murmur
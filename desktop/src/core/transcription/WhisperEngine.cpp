@@ -27,6 +27,7 @@
 #include <QRegularExpression>
 #include <QTextStream>
 #include <QFile>
+#include <algorithm>
 #include <cmath>
 
 // Platform-specific includes for memory monitoring
@@ -313,9 +314,8 @@ QFuture<Expected<TranscriptionResult, TranscriptionError>> WhisperEngine::transc
         task->startTime = QDateTime::currentMSecsSinceEpoch();
         task->isCancelled = false;
         
-        // Get audio duration for progress calculation
-        auto durationResult = getAudioDuration(audioFilePath);
-        task->audioDuration = durationResult.hasValue() ? durationResult.value() : 0;
+        // Duration follows from the decoded 16kHz sample count
+        task->audioDuration = static_cast<qint64>(audioDataResult.value().size()) * 1000 / SAMPLE_RATE;
         
         {
             QMutexLocker tlocker(&tasksMutex_);
@@ -330,6 +330,10 @@ QFuture<Expected<TranscriptionResult, TranscriptionError>> WhisperEngine::transc
         config.temperature = settings.temperature;
         config.beamSize = settings.beamSize;
         config.nThreads = QThread::idealThreadCount();
+        config.parallelChunks = settings.maxParallelChunks > 0
+            ? settings.maxParallelChunks
+            : std::max(1, config.nThreads / MIN_THREADS_PER_CHUNK);
+        config.silenceSearchSeconds = settings.enableVAD ? config.silenceSearchSeconds : 0.0;
 
         // Emit initial progress
         updateTaskProgress(taskId, 0.0);
@@ -387,57 +391,9 @@ QFuture<Expected<TranscriptionResult, TranscriptionError>> WhisperEngine::transc
     const QString& videoFilePath,
     const TranscriptionSettings& settings) {
 
-    // Create a promise to handle the async operation properly
-    auto promise = std::make_shared<QPromise<Expected<TranscriptionResult, TranscriptionError>>>();
-    auto future = promise->future();
-    promise->start();
-
-    // First, extract audio from video asynchronously
-    QtConcurrent::run([this, videoFilePath, settings, promise]() {
-        if (!InputValidator::isValidMediaFile(videoFilePath)) {
-            promise->addResult(makeUnexpected(TranscriptionError::InvalidAudioFormat));
-            promise->finish();
-            return;
-        }
-
-        // Create temporary directory (this can be done synchronously as it's fast)
-        auto tempDirResult = createTempDirectory();
-        if (tempDirResult.hasError()) {
-            promise->addResult(makeUnexpected(tempDirResult.error()));
-            promise->finish();
-            return;
-        }
-
-        QString tempDir = tempDirResult.value();
-        QString audioPath = tempDir + "/extracted_audio.wav";
-
-        // Extract audio from video
-        auto extractResult = extractAudioFromVideo(videoFilePath, audioPath);
-        if (extractResult.hasError()) {
-            cleanupTempDirectory(tempDir);
-            promise->addResult(makeUnexpected(extractResult.error()));
-            promise->finish();
-            return;
-        }
-
-        // Now transcribe the extracted audio asynchronously without blocking
-        auto transcribeTask = transcribeAudio(audioPath, settings);
-        
-        // Create a watcher to handle completion
-        auto watcher = new QFutureWatcher<Expected<TranscriptionResult, TranscriptionError>>();
-        QObject::connect(watcher, &QFutureWatcher<Expected<TranscriptionResult, TranscriptionError>>::finished,
-                        [promise, tempDir, watcher, this]() {
-            auto result = watcher->result();
-            cleanupTempDirectory(tempDir);  // Clean up temp directory
-            promise->addResult(result);
-            promise->finish();
-            watcher->deleteLater();
-        });
-        
-        watcher->setFuture(transcribeTask);
-    });
-
-    return future;
+    // The audio track is decoded in-process straight from the container,
+    // so no extraction step or temporary WAV is needed.
+    return transcribeAudio(videoFilePath, settings);
 }
 
 void WhisperEngine::cancelTranscription(const QString& taskId) {
@@ -564,74 +520,6 @@ QStringList WhisperEngine::buildTranscriptionCommand(const TranscriptionTask& ta
     return args;
 }
 
-Expected<QString, TranscriptionError> WhisperEngine::preprocessAudio(
-    const QString& inputFile,
-    const QString& outputFile) {
-
-    QProcess ffmpegProcess;
-    QStringList args;
-
-    // Input file
-    args << "-i" << inputFile;
-
-    // Audio processing for Whisper (16kHz, mono, WAV)
-    args << "-ar" << QString::number(SAMPLE_RATE);
-    args << "-ac" << QString::number(CHANNELS);
-    args << "-c:a" << "pcm_s16le";
-
-    // Output file
-    args << "-y" << outputFile;
-
-    ffmpegProcess.start("ffmpeg", args);
-
-    if (!ffmpegProcess.waitForFinished(60000)) {  // 60 second timeout
-        ffmpegProcess.kill();
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    if (ffmpegProcess.exitCode() != 0) {
-        Logger::instance().error("WhisperEngine: Audio preprocessing failed: {}", ffmpegProcess.readAllStandardError().toStdString());
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    return outputFile;
-}
-
-Expected<qint64, TranscriptionError> WhisperEngine::getAudioDuration(const QString& audioFile) {
-    QProcess ffprobeProcess;
-    QStringList args;
-
-    args << "-v" << "quiet";
-    args << "-print_format" << "json";
-    args << "-show_format";
-    args << audioFile;
-
-    ffprobeProcess.start("ffprobe", args);
-
-    if (!ffprobeProcess.waitForFinished(10000)) {
-        ffprobeProcess.kill();
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    if (ffprobeProcess.exitCode() != 0) {
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    QString output = ffprobeProcess.readAllStandardOutput();
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8(), &error);
-
-    if (error.error != QJsonParseError::NoError) {
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    QJsonObject root = doc.object();
-    QJsonObject format = root["format"].toObject();
-    double duration = format["duration"].toString().toDouble();
-
-    return static_cast<qint64>(duration * 1000);  // Convert to milliseconds
-}
-
 Expected<bool, TranscriptionError> WhisperEngine::validateAudioFormat(const QString& audioFile) {
     QFileInfo fileInfo(audioFile);
 
@@ -810,35 +698,6 @@ void WhisperEngine::cleanupTempDirectory(const QString& tempDir) {
     }
 }
 
-Expected<bool, TranscriptionError> WhisperEngine::extractAudioFromVideo(
-    const QString& videoPath,
-    const QString& audioPath) {
-
-    QProcess ffmpegProcess;
-    QStringList args;
-
-    args << "-i" << videoPath;
-    args << "-vn";  // No video
-    args << "-ar" << QString::number(SAMPLE_RATE);
-    args << "-ac" << QString::number(CHANNELS);
-    args << "-c:a" << "pcm_s16le";
-    args << "-y" << audioPath;
-
-    ffmpegProcess.start("ffmpeg", args);
-
-    if (!ffmpegProcess.waitForFinished(120000)) { // 2 minute timeout
-        ffmpegProcess.kill();
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    if (ffmpegProcess.exitCode() != 0) {
-        Logger::instance().error("WhisperEngine: Audio extraction failed: {}", ffmpegProcess.readAllStandardError().toStdString());
-        return makeUnexpected(TranscriptionError::AudioProcessingFailed);
-    }
-
-    return true;
-}
-
 void WhisperEngine::onWhisperProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
     auto* process = qobject_cast<QProcess*>(sender());
     if (!process) return;
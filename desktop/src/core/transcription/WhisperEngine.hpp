@@ -42,6 +42,7 @@ struct TranscriptionSettings {
     int beamSize = 5;                   // Beam search size
     double temperature = 0.0;           // Sampling temperature
     bool enableGPU = true;              // Use GPU acceleration if available
+    int maxParallelChunks = 0;          // Concurrent decoder states for long audio (0 = auto, 1 = off)
 };
 
 struct TranscriptionProgress {
@@ -196,12 +197,7 @@ private:
     double calculateVolumeLevel(const QByteArray& audioData);
     bool shouldProcessSegment(RealtimeSession* session, qint64 currentTime);
     
-    // Audio preprocessing
-    Expected<QString, TranscriptionError> preprocessAudio(
-        const QString& inputFile, 
-        const QString& outputFile
-    );
-    Expected<qint64, TranscriptionError> getAudioDuration(const QString& audioFile);
+    // Audio validation
     Expected<bool, TranscriptionError> validateAudioFormat(const QString& audioFile);
     
     // Model management
@@ -237,10 +233,6 @@ private:
     // File utilities
     Expected<QString, TranscriptionError> createTempDirectory();
     void cleanupTempDirectory(const QString& tempDir);
-    Expected<bool, TranscriptionError> extractAudioFromVideo(
-        const QString& videoPath, 
-        const QString& audioPath
-    );
     
     // Configuration and state
     mutable QMutex tasksMutex_;
@@ -290,6 +282,7 @@ private:
     static const int MIN_AUDIO_LENGTH = 1000;          // Minimum audio length for processing (ms)
     static constexpr double SILENCE_THRESHOLD = 0.01;     // Volume threshold for silence detection
     static const int MAX_BUFFER_SIZE = 32 * 1024 * 1024; // Maximum audio buffer size (32MB)
+    static const int MIN_THREADS_PER_CHUNK = 4;        // Threads per decoder state in chunked transcription
     
     // Progress parsing patterns
     static const QString PROGRESS_PATTERN;
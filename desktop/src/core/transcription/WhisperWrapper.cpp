@@ -1,10 +1,9 @@
 #include "WhisperWrapper.hpp"
 #include "../common/Logger.hpp"
+#include "../media/FFmpegWrapper.hpp"
 
 #include <QFile>
 #include <QFileInfo>
-#include <QProcess>
-#include <QTemporaryFile>
 #include <QElapsedTimer>
 #include <QtEndian>
 #include <QDebug>
@@ -14,10 +13,28 @@
 #include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <limits>
+#include <mutex>
 #include <numeric>
+#include <thread>
 
 namespace Murmur {
 
+namespace {
+
+// Energy frame used to locate silence between chunks
+constexpr size_t VAD_FRAME_SAMPLES = WHISPER_SAMPLE_RATE * 30 / 1000; // 30ms
+// Audio used for one-off language detection before chunked decoding
+constexpr size_t LANGUAGE_PROBE_SAMPLES = WHISPER_SAMPLE_RATE * 30;
+
+// Per-chunk hooks for whisper.cpp's C callbacks
+struct ChunkWorker {
+    std::function<void(int)> onProgress;
+    std::function<bool()> shouldAbort;
+};
+
+} // namespace
+
 struct WhisperWrapper::WhisperWrapperPrivate {
     whisper_context* ctx = nullptr;
     bool isInitialized = false;
@@ -35,6 +52,9 @@ struct WhisperWrapper::WhisperWrapperPrivate {
     // Audio processing buffers
     std::vector<float> audioBuffer;
     
+    // In-process decoder used by loadAudioFile()
+    std::unique_ptr<FFmpegWrapper> audioDecoder = std::make_unique<FFmpegWrapper>();
+    
     // Performance tracking
     mutable size_t memoryUsage = 0;
 };
@@ -182,6 +202,10 @@ Expected<WhisperResult, WhisperError> WhisperWrapper::transcribe(
         return makeUnexpected(WhisperError::InvalidInput);
     }
 
+    if (config.parallelChunks > 1) {
+        return transcribeChunked(audioData, config, progressCallback);
+    }
+
     auto validateResult = validateAudioData(audioData);
     if (validateResult.hasError()) {
         return makeUnexpected(validateResult.error());
@@ -248,6 +272,254 @@ Expected<WhisperResult, WhisperError> WhisperWrapper::transcribe(
     return whisperResult;
 }
 
+Expected<WhisperResult, WhisperError> WhisperWrapper::transcribeChunked(
+    const std::vector<float>& audioData,
+    const WhisperConfig& config,
+    ProgressCallback progressCallback) {
+
+    if (!isModelLoaded()) {
+        Logger::instance().error("No model loaded for transcription");
+        return makeUnexpected(WhisperError::ModelLoadFailed);
+    }
+
+    auto validateResult = validateAudioData(audioData);
+    if (validateResult.hasError()) {
+        return makeUnexpected(validateResult.error());
+    }
+
+    const int parallelChunks = std::max(1, config.parallelChunks);
+    const size_t minChunkSamples = static_cast<size_t>(std::max(1.0, config.minChunkSeconds) * WHISPER_SAMPLE_RATE);
+    const size_t targetChunkSamples = std::max(minChunkSamples, audioData.size() / static_cast<size_t>(parallelChunks));
+    const size_t searchWindowSamples = static_cast<size_t>(std::max(0.0, config.silenceSearchSeconds) * WHISPER_SAMPLE_RATE);
+
+    const std::vector<size_t> boundaries = findChunkBoundaries(audioData, targetChunkSamples, searchWindowSamples);
+    const size_t chunkCount = boundaries.size() - 1;
+
+    // Too short to be worth splitting
+    if (chunkCount < 2) {
+        WhisperConfig singleConfig = config;
+        singleConfig.parallelChunks = 1;
+        return transcribe(audioData, singleConfig, progressCallback);
+    }
+
+    // Validate parameters once up front; workers rebuild them per chunk
+    whisper_full_params probeParams = whisper_full_default_params(WHISPER_SAMPLING_BEAM_SEARCH);
+    auto paramResult = initializeWhisperParams(probeParams, config);
+    if (paramResult.hasError()) {
+        return makeUnexpected(paramResult.error());
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // One state per worker; the model weights in d->ctx are shared read-only
+    const int workerTarget = std::min(parallelChunks, static_cast<int>(chunkCount));
+    std::vector<whisper_state*> states;
+    for (int i = 0; i < workerTarget; ++i) {
+        whisper_state* state = whisper_init_state(d->ctx);
+        if (!state) {
+            Logger::instance().warn("Could only allocate {} of {} whisper states", states.size(), workerTarget);
+            break;
+        }
+        states.push_back(state);
+    }
+
+    if (states.empty()) {
+        Logger::instance().error("Failed to allocate whisper state for chunked transcription");
+        return makeUnexpected(WhisperError::OutOfMemory);
+    }
+
+    const int workerCount = static_cast<int>(states.size());
+    const int threadsPerState = std::max(1, config.nThreads / workerCount);
+
+    d->progressCallback = progressCallback;
+    d->lastProgress = -1;
+    d->isCancelled.store(false);
+
+    // Detect the language once so every chunk decodes the same language
+    std::string language = config.language.toStdString();
+    if (config.language.isEmpty() || config.language == "auto") {
+        language = "auto";
+        size_t probeSamples = std::min(audioData.size(), LANGUAGE_PROBE_SAMPLES);
+        if (whisper_pcm_to_mel_with_state(d->ctx, states.front(), audioData.data(),
+                                          static_cast<int>(probeSamples), threadsPerState) == 0) {
+            int langId = whisper_lang_auto_detect_with_state(d->ctx, states.front(), 0, threadsPerState, nullptr);
+            const char* lang = langId >= 0 ? whisper_lang_str(langId) : nullptr;
+            if (lang) {
+                language = lang;
+            }
+        }
+    }
+
+    Logger::instance().info("Starting chunked transcription of {} samples: {} chunks on {} states x {} threads, language {}",
+                           audioData.size(), chunkCount, workerCount, threadsPerState, language);
+
+    std::vector<std::vector<WhisperSegment>> chunkSegments(chunkCount);
+    std::vector<int> chunkProgress(chunkCount, 0);
+    std::mutex progressMutex;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> aborted{false};
+    std::atomic<int> failureCode{0};
+
+    // Overall progress is each chunk's progress weighted by its length
+    auto reportProgress = [&](size_t chunk, int progress) {
+        if (!d->progressCallback) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(progressMutex);
+        chunkProgress[chunk] = progress;
+
+        double weighted = 0.0;
+        for (size_t i = 0; i < chunkCount; ++i) {
+            weighted += chunkProgress[i] * static_cast<double>(boundaries[i + 1] - boundaries[i]);
+        }
+        int overall = static_cast<int>(weighted / static_cast<double>(audioData.size()));
+        if (overall != d->lastProgress) {
+            d->lastProgress = overall;
+            d->progressCallback(overall);
+        }
+    };
+
+    auto runWorker = [&](whisper_state* state) {
+        while (!aborted.load()) {
+            size_t chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunkCount) {
+                return;
+            }
+
+            ChunkWorker worker;
+            worker.onProgress = [&, chunk](int progress) { reportProgress(chunk, progress); };
+            worker.shouldAbort = [&]() { return aborted.load() || d->isCancelled.load(); };
+
+            whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_BEAM_SEARCH);
+            initializeWhisperParams(params, config);
+            params.language = language.c_str();
+            params.n_threads = threadsPerState;
+            params.print_progress = false;
+            params.print_realtime = false;
+
+            params.progress_callback = [](struct whisper_context* /*ctx*/, struct whisper_state* /*state*/, int progress, void* user_data) {
+                static_cast<ChunkWorker*>(user_data)->onProgress(progress);
+            };
+            params.progress_callback_user_data = &worker;
+
+            params.encoder_begin_callback = [](struct whisper_context* /*ctx*/, struct whisper_state* /*state*/, void* user_data) -> bool {
+                return !static_cast<ChunkWorker*>(user_data)->shouldAbort();
+            };
+            params.encoder_begin_callback_user_data = &worker;
+
+            const size_t chunkStart = boundaries[chunk];
+            const int chunkSamples = static_cast<int>(boundaries[chunk + 1] - chunkStart);
+
+            int result = whisper_full_with_state(d->ctx, state, params, audioData.data() + chunkStart, chunkSamples);
+            if (result != 0 || worker.shouldAbort()) {
+                failureCode.store(result);
+                aborted.store(true);
+                return;
+            }
+
+            chunkSegments[chunk] = extractSegmentsFromState(state, config,
+                                                            static_cast<double>(chunkStart) / WHISPER_SAMPLE_RATE);
+            worker.onProgress(100);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(states.size());
+    for (whisper_state* state : states) {
+        workers.emplace_back(runWorker, state);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (whisper_state* state : states) {
+        whisper_free_state(state);
+    }
+
+    if (d->isCancelled.load()) {
+        Logger::instance().info("Chunked transcription was cancelled by user request.");
+        return makeUnexpected(WhisperError::Cancelled);
+    }
+    if (aborted.load()) {
+        QString errorMsg = translateWhisperError(failureCode.load());
+        Logger::instance().error("Chunked transcription failed: {}", errorMsg.toStdString());
+        return makeUnexpected(WhisperError::InferenceFailed);
+    }
+
+    // Stitch chunks back together in timeline order
+    WhisperResult whisperResult;
+    whisperResult.language = QString::fromStdString(language);
+
+    QString fullText;
+    float totalConfidence = 0.0f;
+    for (auto& segments : chunkSegments) {
+        for (auto& segment : segments) {
+            if (!segment.text.isEmpty()) {
+                fullText += segment.text + " ";
+            }
+            totalConfidence += segment.confidence;
+            whisperResult.segments.push_back(std::move(segment));
+        }
+    }
+
+    whisperResult.fullText = fullText.trimmed();
+    whisperResult.avgConfidence = whisperResult.segments.empty()
+        ? 0.0f : totalConfidence / static_cast<float>(whisperResult.segments.size());
+    whisperResult.processingTime = timer.elapsed() / 1000.0; // Convert to seconds
+
+    Logger::instance().info("Chunked transcription completed in {:.2f}s, {} segments from {} chunks",
+                           whisperResult.processingTime,
+                           whisperResult.segments.size(),
+                           chunkCount);
+
+    return whisperResult;
+}
+
+std::vector<size_t> WhisperWrapper::findChunkBoundaries(
+    const std::vector<float>& audioData,
+    size_t targetChunkSamples,
+    size_t searchWindowSamples) {
+
+    std::vector<size_t> boundaries{0};
+    const size_t totalSamples = audioData.size();
+
+    if (targetChunkSamples == 0 || totalSamples <= targetChunkSamples + VAD_FRAME_SAMPLES) {
+        boundaries.push_back(totalSamples);
+        return boundaries;
+    }
+
+    size_t position = 0;
+
+    // Stop once the remainder fits in one and a half chunks, so the tail is never tiny
+    while (totalSamples - position > targetChunkSamples + targetChunkSamples / 2) {
+        const size_t nominal = position + targetChunkSamples;
+        const size_t windowStart = std::max(position + VAD_FRAME_SAMPLES,
+                                            nominal > searchWindowSamples ? nominal - searchWindowSamples : 0);
+        const size_t windowEnd = std::min(nominal + searchWindowSamples, totalSamples - VAD_FRAME_SAMPLES);
+
+        // Quietest 30ms frame in the window; falls back to the nominal split
+        size_t split = nominal;
+        double quietestEnergy = std::numeric_limits<double>::max();
+        for (size_t frameStart = windowStart; frameStart + VAD_FRAME_SAMPLES <= windowEnd; frameStart += VAD_FRAME_SAMPLES) {
+            double energy = 0.0;
+            for (size_t i = frameStart; i < frameStart + VAD_FRAME_SAMPLES; ++i) {
+                energy += static_cast<double>(audioData[i]) * audioData[i];
+            }
+            if (energy < quietestEnergy) {
+                quietestEnergy = energy;
+                split = frameStart + VAD_FRAME_SAMPLES / 2;
+            }
+        }
+
+        boundaries.push_back(split);
+        position = split;
+    }
+
+    boundaries.push_back(totalSamples);
+    return boundaries;
+}
+
 Expected<WhisperResult, WhisperError> WhisperWrapper::transcribeFile(
     const QString& audioFilePath,
     const WhisperConfig& config,
@@ -269,32 +541,23 @@ Expected<WhisperResult, WhisperError> WhisperWrapper::transcribeFile(
 }
 
 Expected<std::vector<float>, WhisperError> WhisperWrapper::loadAudioFile(const QString& audioFilePath) {
-    QFileInfo fileInfo(audioFilePath);
-    QString suffix = fileInfo.suffix().toLower();
+    // Decode and resample in-process into the buffer transcribe() consumes.
+    // Works for any container FFmpeg can demux, video files included.
+    auto decodeResult = d->audioDecoder->decodeAudioSamples(audioFilePath, WHISPER_SAMPLE_RATE);
+    if (decodeResult.hasValue()) {
+        return std::move(decodeResult).value();
+    }
     
-    // If it's not a WAV file, convert it first
-    if (suffix != "wav") {
-        QTemporaryFile tempFile;
-        tempFile.setFileTemplate("whisper_XXXXXX.wav");
-        if (!tempFile.open()) {
-            Logger::instance().error("Failed to create temporary file");
-            return makeUnexpected(WhisperError::AudioProcessingFailed);
-        }
-        
-        QString tempPath = tempFile.fileName();
-        tempFile.close();
-        
-        auto convertResult = convertAudioFormat(audioFilePath, tempPath);
-        if (convertResult.hasError()) {
-            return makeUnexpected(convertResult.error());
-        }
-        
-        auto loadResult = loadWavFile(tempPath);
-        QFile::remove(tempPath); // Clean up temp file
-        return loadResult;
+    // Plain PCM WAV can still be read without the decoder
+    if (QFileInfo(audioFilePath).suffix().toLower() == "wav") {
+        Logger::instance().warn("FFmpeg decode failed, falling back to WAV reader: {}", audioFilePath.toStdString());
+        return loadWavFile(audioFilePath);
     }
     
-    return loadWavFile(audioFilePath);
+    if (decodeResult.error() == FFmpegError::InvalidFile) {
+        return makeUnexpected(WhisperError::InvalidInput);
+    }
+    return makeUnexpected(WhisperError::AudioProcessingFailed);
 }
 
 Expected<std::vector<float>, WhisperError> WhisperWrapper::loadWavFile(const QString& filePath) {
@@ -399,42 +662,6 @@ Expected<std::vector<float>, WhisperError> WhisperWrapper::loadWavFile(const QSt
     return audioData;
 }
 
-Expected<bool, WhisperError> WhisperWrapper::convertAudioFormat(
-    const QString& inputPath,
-    const QString& outputPath) {
-    
-    // Use FFmpeg to convert to 16kHz, 16-bit, mono WAV
-    QStringList arguments;
-    arguments << "-i" << inputPath
-              << "-ar" << "16000"    // 16kHz sample rate
-              << "-ac" << "1"        // Mono
-              << "-c:a" << "pcm_s16le" // 16-bit PCM
-              << "-y" << outputPath; // Overwrite output
-
-    QProcess ffmpeg;
-    ffmpeg.start("ffmpeg", arguments);
-    
-    if (!ffmpeg.waitForStarted()) {
-        Logger::instance().error("Failed to start FFmpeg for audio conversion");
-        return makeUnexpected(WhisperError::AudioProcessingFailed);
-    }
-
-    if (!ffmpeg.waitForFinished(60000)) { // 60 second timeout
-        ffmpeg.kill();
-        Logger::instance().error("FFmpeg conversion timeout");
-        return makeUnexpected(WhisperError::AudioProcessingFailed);
-    }
-
-    if (ffmpeg.exitCode() != 0) {
-        QString error = QString::fromUtf8(ffmpeg.readAllStandardError());
-        Logger::instance().error("FFmpeg conversion failed: {}", error.toStdString());
-        return makeUnexpected(WhisperError::AudioProcessingFailed);
-    }
-
-    Logger::instance().info("Audio format conversion completed: {}", outputPath.toStdString());
-    return true;
-}
-
 Expected<bool, WhisperError> WhisperWrapper::initializeWhisperParams(
     whisper_full_params& params,
     const WhisperConfig& config) {
@@ -556,6 +783,48 @@ WhisperResult WhisperWrapper::extractResult(const WhisperConfig& config) const {
     return result;
 }
 
+std::vector<WhisperSegment> WhisperWrapper::extractSegmentsFromState(
+    whisper_state* state,
+    const WhisperConfig& config,
+    double offsetSeconds) const {
+
+    std::vector<WhisperSegment> segments;
+    const int n_segments = whisper_full_n_segments_from_state(state);
+    segments.reserve(n_segments);
+
+    for (int i = 0; i < n_segments; ++i) {
+        WhisperSegment segment;
+
+        // Chunk-relative centiseconds onto the original timeline
+        segment.startTime = offsetSeconds + whisper_full_get_segment_t0_from_state(state, i) / 100.0;
+        segment.endTime = offsetSeconds + whisper_full_get_segment_t1_from_state(state, i) / 100.0;
+
+        const char* text = whisper_full_get_segment_text_from_state(state, i);
+        if (text) {
+            segment.text = QString::fromUtf8(text).trimmed();
+        }
+
+        const int n_tokens = whisper_full_n_tokens_from_state(state, i);
+        double segment_prob_sum = 0.0;
+
+        for (int j = 0; j < n_tokens; ++j) {
+            whisper_token_data token_data = whisper_full_get_token_data_from_state(state, i, j);
+            segment_prob_sum += token_data.p;
+            if (config.enableTokenTimestamps || config.enableWordTimestamps) {
+                const char* word = whisper_token_to_str(d->ctx, token_data.id);
+                if (word) {
+                    segment.words.emplace_back(QString::fromUtf8(word), token_data.p);
+                }
+            }
+        }
+        segment.confidence = n_tokens > 0 ? static_cast<float>(segment_prob_sum / n_tokens) : 0.0f;
+
+        segments.push_back(std::move(segment));
+    }
+
+    return segments;
+}
+
 void WhisperWrapper::progressCallbackWrapper(
     struct whisper_context* ctx,
     struct whisper_state* state,
@@ -65,6 +65,12 @@ struct WhisperConfig {
     bool printProgress = true;
     bool printRealtime = false;
     bool printTimestamps = true;
+    int parallelChunks = 1;             // >1 splits long audio across concurrent whisper states
+    // Shortest chunk worth its own state. Each split costs a decoder state
+    // and the text context across the cut, so audio under twice this length
+    // keeps the single-pass path.
+    double minChunkSeconds = 300.0;
+    double silenceSearchSeconds = 5.0;  // Window around each nominal split searched for silence (0 = split exactly)
 };
 
 // Progress callback function type
@@ -124,6 +130,38 @@ public:
         ProgressCallback progressCallback = nullptr
     );
 
+    /**
+     * @brief Transcribe long audio as concurrent chunks sharing one model
+     * 
+     * Audio is split at low-energy (silent) points near evenly spaced
+     * boundaries, each chunk runs whisper_full_with_state() on its own
+     * whisper_state, and segment timestamps are shifted back onto the
+     * original timeline. Language is detected once up front when set to
+     * "auto" so every chunk decodes the same language.
+     * @param audioData Raw PCM audio data (16kHz, float, mono)
+     * @param config Transcription configuration; nThreads is shared across chunks
+     * @param progressCallback Optional progress callback (called from worker threads)
+     * @return Merged transcription result or error
+     */
+    Expected<WhisperResult, WhisperError> transcribeChunked(
+        const std::vector<float>& audioData,
+        const WhisperConfig& config = WhisperConfig{},
+        ProgressCallback progressCallback = nullptr
+    );
+
+    /**
+     * @brief Pick chunk boundaries at the quietest point near each nominal split
+     * @param audioData Raw PCM audio data (16kHz, float, mono)
+     * @param targetChunkSamples Nominal chunk length in samples
+     * @param searchWindowSamples Distance either side of a nominal split searched for silence
+     * @return Sample offsets starting with 0 and ending with audioData.size()
+     */
+    static std::vector<size_t> findChunkBoundaries(
+        const std::vector<float>& audioData,
+        size_t targetChunkSamples,
+        size_t searchWindowSamples
+    );
+
     /**
      * @brief Transcribe audio from file
      * @param audioFilePath Path to audio file (will be converted to required format)
@@ -138,19 +176,8 @@ public:
     );
 
     /**
-     * @brief Convert audio file to required format (16kHz, 16-bit, mono PCM)
-     * @param inputPath Input audio file path
-     * @param outputPath Output WAV file path
-     * @return true if successful, false otherwise
-     */
-    Expected<bool, WhisperError> convertAudioFormat(
-        const QString& inputPath,
-        const QString& outputPath
-    );
-
-    /**
-     * @brief Load audio file and convert to float array
-     * @param audioFilePath Path to audio file
+     * @brief Decode audio (or the audio track of a video) to 16kHz mono float
+     * @param audioFilePath Path to audio or video file
      * @return Audio data as float array or error
      */
     Expected<std::vector<float>, WhisperError> loadAudioFile(const QString& audioFilePath);
@@ -218,6 +245,11 @@ private:
     );
     
     WhisperResult extractResult(const WhisperConfig& config) const;
+    std::vector<WhisperSegment> extractSegmentsFromState(
+        whisper_state* state,
+        const WhisperConfig& config,
+        double offsetSeconds
+    ) const;
     
     static void progressCallbackWrapper(
         struct whisper_context* ctx,
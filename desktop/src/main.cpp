@@ -104,6 +104,7 @@ int main(int argc, char *argv[])
         Murmur::Logger::instance().info("Setting TorrentEngine");
         if (appController->torrentEngine()) {
             torrentController->setTorrentEngine(appController->torrentEngine());
+            mediaController->setTorrentEngine(appController->torrentEngine());
             Murmur::Logger::instance().info("TorrentEngine connected successfully");
         } else {
             Murmur::Logger::instance().error("TorrentEngine is null");
@@ -145,6 +146,7 @@ int main(int argc, char *argv[])
         Murmur::Logger::instance().info("Setting FileManager");
         if (appController->fileManager()) {
             fileManagerController->setFileManager(appController->fileManager());
+            mediaController->setFileManager(appController->fileManager());
             Murmur::Logger::instance().info("FileManager connected successfully");
         } else {
             Murmur::Logger::instance().error("FileManager is null");
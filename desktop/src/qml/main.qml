@@ -21,7 +21,7 @@ ApplicationWindow {
     
     menuBar: MainMenuBar {
         id: mainMenuBar
-        hasActiveVideo: mediaCtrl.currentVideoSource.toString().length > 0
+        hasActiveVideo: mediaCtrl.currentVideoSource.toString().length > 0 || mediaCtrl.isStreaming
         hasTranscription: transcriptionCtrl.currentTranscription !== null
         
         onOpenFile: fileOpenDialog.open()
@@ -828,6 +828,9 @@ ApplicationWindow {
                     fullscreen: window.videoFullscreen
                     transcriptionController: transcriptionCtrl
                     
+                    // Torrent streams are attached to this player as a device
+                    Component.onCompleted: mediaCtrl.setOutputPlayer(player)
+                    
                     onVideoClicked: {
                         // Handle video click events
                     }
@@ -75,9 +75,32 @@ void MediaController::setStorageManager(StorageManager* storage) {
     Logger::instance().info("StorageManager set: {}", storageManager_ ? "valid" : "null");
 }
 
+void MediaController::setFileManager(FileManager* fileManager) {
+    fileManager_ = fileManager;
+}
+
+void MediaController::setTorrentEngine(TorrentEngine* engine) {
+    if (torrentEngine_ != engine) {
+        releaseTorrentStream();
+        torrentEngine_ = engine;
+    }
+}
+
+void MediaController::setOutputPlayer(QObject* player) {
+    outputPlayer_ = qobject_cast<QMediaPlayer*>(player);
+    if (player && !outputPlayer_) {
+        Logger::instance().warn("Output player is not a MediaPlayer; torrents will not stream");
+    }
+}
+
 void MediaController::loadTorrent(const QString& infoHash) {
     Logger::instance().info("Loading torrent for playback: {}", infoHash.toStdString());
     
+    // Torrents still downloading play straight from the session
+    if (playTorrentStream(infoHash)) {
+        return;
+    }
+    
     if (!storageManager_) {
         Logger::instance().error("StorageManager not available");
         return;
@@ -93,6 +116,7 @@ void MediaController::loadTorrent(const QString& infoHash) {
             // Update on main thread
             QMetaObject::invokeMethod(this, [this, fileUrl]() {
                 updateVideoSource(fileUrl);
+                releaseTorrentStream();
             }, Qt::QueuedConnection);
         } else {
             Logger::instance().warn("No media found for torrent: {}", infoHash.toStdString());
@@ -100,6 +124,52 @@ void MediaController::loadTorrent(const QString& infoHash) {
     });
 }
 
+bool MediaController::playTorrentStream(const QString& infoHash) {
+    if (!torrentEngine_ || !outputPlayer_) {
+        return false;
+    }
+    
+    // Finished torrents are played from their files like any other media
+    auto info = torrentEngine_->getTorrentInfo(infoHash);
+    if (info.hasError() || info.value().progress >= 1.0) {
+        return false;
+    }
+    
+    auto stream = torrentEngine_->openStream(infoHash, -1, this);
+    if (stream.hasError()) {
+        Logger::instance().warn("Cannot stream torrent {} yet: {}", infoHash.toStdString(),
+                                static_cast<int>(stream.error()));
+        return false;
+    }
+    
+    // There is no file to point the source binding at; clearing it first
+    // keeps the binding from replacing the device later
+    updateVideoSource(QUrl());
+    
+    // The name only helps the player detect the container format
+    outputPlayer_->setSourceDevice(stream.value(), QUrl(stream.value()->fileName()));
+    releaseTorrentStream();
+    torrentStream_ = stream.value();
+    emit streamingChanged();
+    
+    if (currentMediaFile_ != stream.value()->fileName()) {
+        currentMediaFile_ = stream.value()->fileName();
+        emit currentMediaFileChanged();
+    }
+    return true;
+}
+
+void MediaController::releaseTorrentStream() {
+    // The player has moved on to another source by now
+    if (!torrentStream_) {
+        return;
+    }
+    torrentStream_->close();
+    torrentStream_->deleteLater();
+    torrentStream_ = nullptr;
+    emit streamingChanged();
+}
+
 void MediaController::loadLocalFile(const QUrl& filePath) {
     Logger::instance().info("Loading local file: {}", filePath.toString().toStdString());
     
@@ -124,6 +194,7 @@ void MediaController::loadLocalFile(const QUrl& filePath) {
     
     if (videoPlayer_) {
         videoPlayer_->setSource(filePath);
+        releaseTorrentStream();
         Logger::instance().info("Video source set in player");
     } else {
         Logger::instance().warn("VideoPlayer not available");
@@ -169,6 +240,12 @@ void MediaController::loadLocalFile(const QUrl& filePath) {
                 media.audioCodec = info.audioCodec;
                 media.dateAdded = QDateTime::currentDateTime();
                 
+                // Lets results be shared between copies of the same content
+                const QString contentHash = fileManager_ ? fileManager_->contentHash(localPath) : QString();
+                if (!contentHash.isEmpty()) {
+                    media.metadata["contentHash"] = contentHash;
+                }
+                
                 storageManager_->addMedia(media);
             }
             
@@ -208,7 +285,7 @@ void MediaController::savePosition(qreal position) {
                 if (mediaResult.hasValue() && !mediaResult.value().isEmpty()) {
                     QString mediaId = mediaResult.value().first().id;
                     qint64 positionMs = static_cast<qint64>(position * 1000);
-                    storageManager_->updatePlaybackPosition(mediaId, positionMs);
+                    storageManager_->queuePlaybackPosition(mediaId, positionMs);
                 }
             });
         }
@@ -5,11 +5,16 @@
 #include <QtCore/QVariantMap>
 #include <QtCore/QUrl>
 #include <QtCore/QFuture>
+#include <QtCore/QPointer>
+#include <QMediaPlayer>
 #include <memory>
 #include "../../core/common/Expected.hpp"
 #include "../../core/media/MediaPipeline.hpp"
 #include "../../core/media/VideoPlayer.hpp"
 #include "../../core/storage/StorageManager.hpp"
+#include "../../core/storage/FileManager.hpp"
+#include "../../core/torrent/TorrentEngine.hpp"
+#include "../../core/torrent/TorrentStream.hpp"
 #include "../../core/common/Logger.hpp"
 
 namespace Murmur {
@@ -22,6 +27,7 @@ class MediaController : public QObject {
     Q_PROPERTY(QString currentMediaFile READ currentMediaFile NOTIFY currentMediaFileChanged)
     Q_PROPERTY(QString outputPath READ outputPath NOTIFY outputPathChanged)
     Q_PROPERTY(bool isReady READ isReady NOTIFY readyChanged)
+    Q_PROPERTY(bool isStreaming READ isStreaming NOTIFY streamingChanged)
     
 public:
 explicit MediaController(QObject* parent = nullptr);
@@ -33,12 +39,19 @@ void updateReadyState();
 Q_INVOKABLE void setMediaPipeline(MediaPipeline* pipeline);
     Q_INVOKABLE void setVideoPlayer(VideoPlayer* player);
     Q_INVOKABLE void setStorageManager(StorageManager* storage);
+    Q_INVOKABLE void setFileManager(FileManager* fileManager);
+    Q_INVOKABLE void setTorrentEngine(TorrentEngine* engine);
+    
+    // The QML MediaPlayer that renders; torrent streams are attached to it
+    // as a source device because QML cannot set one
+    Q_INVOKABLE void setOutputPlayer(QObject* player);
     
     QUrl currentVideoSource() const { return currentVideoSource_; }
     qreal playbackPosition() const { return playbackPosition_; }
     bool isProcessing() const { return isProcessing_; }
     QString currentMediaFile() const { return currentMediaFile_; }
     QString outputPath() const { return outputPath_; }
+    bool isStreaming() const { return torrentStream_ != nullptr; }
 bool isReady() const;
     
 public slots:
@@ -70,6 +83,7 @@ signals:
     void currentMediaFileChanged();
     void outputPathChanged();
     void readyChanged();
+    void streamingChanged();
     void conversionProgress(const QString& operationId, qreal progress);
     void conversionCompleted(const QString& operationId, const QString& outputPath);
     void conversionError(const QString& operationId, const QString& error);
@@ -97,6 +111,10 @@ private:
 MediaPipeline* mediaPipeline_ = nullptr;
 VideoPlayer* videoPlayer_ = nullptr;
 StorageManager* storageManager_ = nullptr;
+FileManager* fileManager_ = nullptr;
+TorrentEngine* torrentEngine_ = nullptr;
+QPointer<QMediaPlayer> outputPlayer_;
+QPointer<TorrentStream> torrentStream_;  // Source of outputPlayer_ while a torrent streams
 
 bool ready_ = false;
 
@@ -105,6 +123,8 @@ QVariantMap conversionSettings_;
 QString currentOperationId_;
     
     void setProcessing(bool processing);
+    bool playTorrentStream(const QString& infoHash);
+    void releaseTorrentStream();
     void updateVideoSource(const QUrl& source);
     void connectPipelineSignals();
 };
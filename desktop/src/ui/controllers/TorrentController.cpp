@@ -1,6 +1,7 @@
 #include "TorrentController.hpp"
 #include "../../core/torrent/TorrentStateModel.hpp"
 #include "../../core/common/Logger.hpp"
+#include "../../core/common/Config.hpp"
 #include <QtCore/QFutureWatcher>
 #include <QtCore/QFileInfo>
 
@@ -246,6 +247,19 @@ void TorrentController::configureSession(int maxConnections, int uploadRate, int
     }
 }
 
+void TorrentController::setPerformanceProfile(const QString& profileName) {
+    const TorrentPerformanceProfile profile = TorrentProfiles::fromName(profileName);
+    
+    auto settings = Config::instance().getTorrentSettings();
+    settings.performanceProfile = TorrentProfiles::name(profile);
+    Config::instance().setTorrentSettings(settings);
+    
+    if (torrentEngine_) {
+        torrentEngine_->setPerformanceProfile(profile);
+        emit operationCompleted("Performance profile updated");
+    }
+}
+
 void TorrentController::handleTorrentAdded(const QString& infoHash) {
     setBusy(false);
     
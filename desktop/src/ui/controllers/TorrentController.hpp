@@ -51,6 +51,7 @@ public slots:
     // Configuration
     void setDownloadPath(const QString& path);
     void configureSession(int maxConnections, int uploadRate, int downloadRate);
+    void setPerformanceProfile(const QString& profileName);
     
 signals:
     void readyChanged();
@@ -5,8 +5,16 @@
 #include "utils/TestUtils.hpp"
 #include "../src/core/media/FFmpegWrapper.hpp"
 #include "../src/core/media/MediaPipeline.hpp"
+#include "../src/core/media/MediaBufferPool.hpp"
 #include "../src/core/common/Expected.hpp"
 
+extern "C" {
+#include <libavutil/channel_layout.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include <libavutil/samplefmt.h>
+}
+
 using namespace Murmur;
 using namespace Murmur::Test;
 
@@ -29,7 +37,9 @@ private slots:
     void testVideoAnalysis();
     void testVideoConversion();
     void testAudioExtraction();
+    void testAudioDecodeToSamples();
     void testThumbnailGeneration();
+    void testFrameExtractionSinglePass();
     void testFormatValidation();
     
     // Error handling tests
@@ -44,6 +54,7 @@ private slots:
     void testCancellation();
     void testConcurrentOperations();
     void testMemoryUsage();
+    void testBufferPoolReuse();
     
     // Edge cases
     void testVeryShortVideos();
@@ -223,6 +234,40 @@ void TestFFmpegWrapper::testAudioExtraction() {
                          .arg(QFileInfo(outputPath).size()));
 }
 
+void TestFFmpegWrapper::testAudioDecodeToSamples() {
+    TEST_SCOPE("testAudioDecodeToSamples");
+    
+    // Decode the audio track of the 5s test video directly into memory
+    auto result = ffmpeg_->decodeAudioSamples(testVideoFile_, 16000);
+    if (result.hasError()) {
+        QFAIL(QString("Audio decode failed with error: %1").arg(static_cast<int>(result.error())).toUtf8());
+        return;
+    }
+    
+    const auto& samples = result.value();
+    
+    // ~5 seconds of 16kHz mono, allowing for encoder padding
+    QVERIFY(samples.size() > 16000 * 4);
+    QVERIFY(samples.size() < 16000 * 6);
+    
+    for (float sample : samples) {
+        QVERIFY(sample >= -1.0f && sample <= 1.0f);
+    }
+    
+    // Cancellation is honoured before any packet is decoded
+    std::atomic<bool> cancelled{true};
+    auto cancelledResult = ffmpeg_->decodeAudioSamples(testVideoFile_, 16000, &cancelled);
+    QVERIFY(cancelledResult.hasError());
+    QCOMPARE(cancelledResult.error(), FFmpegError::CancellationRequested);
+    
+    // Missing input is rejected
+    auto missingResult = ffmpeg_->decodeAudioSamples(tempDir_->path() + "/missing.mp4");
+    QVERIFY(missingResult.hasError());
+    QCOMPARE(missingResult.error(), FFmpegError::InvalidFile);
+    
+    TestUtils::logMessage(QString("Decoded %1 samples in-process").arg(samples.size()));
+}
+
 void TestFFmpegWrapper::testThumbnailGeneration() {
     TEST_SCOPE("testThumbnailGeneration");
     
@@ -250,6 +295,45 @@ void TestFFmpegWrapper::testThumbnailGeneration() {
                          .arg(QFileInfo(outputPath).size()));
 }
 
+void TestFFmpegWrapper::testFrameExtractionSinglePass() {
+    TEST_SCOPE("testFrameExtractionSinglePass");
+    
+    QString outputDir = tempDir_->path() + "/frames";
+    
+    FrameExtractionOptions options;
+    options.intervalSeconds = 1.0;
+    options.width = 320;
+    options.encoderThreads = 2;
+    options.framePoolSize = 2;
+    
+    auto future = ffmpeg_->extractFrames(testVideoFile_, outputDir, options);
+    auto result = TestUtils::waitForFuture(future);
+    if (!result.hasValue()) {
+        QFAIL(QString("Frame extraction failed: %1").arg(static_cast<int>(result.error())).toUtf8());
+        return;
+    }
+    
+    // One frame per second of the 5s test video, returned in time order
+    const QStringList frames = result.value();
+    QCOMPARE(frames.size(), 5);
+    for (int i = 0; i < frames.size(); ++i) {
+        QVERIFY(frames[i].endsWith(QString("frame_%1.jpg").arg(i, 6, 10, QChar('0'))));
+        QVERIFY(QFileInfo(frames[i]).size() > 0);
+    }
+    
+    // Interval longer than the clip still yields the first frame (seek path)
+    options.intervalSeconds = 60.0;
+    auto sparseResult = TestUtils::waitForFuture(ffmpeg_->extractFrames(testVideoFile_, outputDir + "/sparse", options));
+    QVERIFY(sparseResult.hasValue());
+    QCOMPARE(sparseResult.value().size(), 1);
+    
+    // Non-positive intervals are rejected
+    options.intervalSeconds = 0.0;
+    auto invalidResult = TestUtils::waitForFuture(ffmpeg_->extractFrames(testVideoFile_, outputDir, options));
+    QVERIFY(invalidResult.hasError());
+    QCOMPARE(invalidResult.error(), FFmpegError::InvalidParameters);
+}
+
 void TestFFmpegWrapper::testFormatValidation() {
     TEST_SCOPE("testFormatValidation");
     
@@ -787,6 +871,63 @@ void TestFFmpegWrapper::testInvalidOutputPaths() {
     QCOMPARE(result.error(), FFmpegError::IOError);
 }
 
+void TestFFmpegWrapper::testBufferPoolReuse() {
+    TEST_SCOPE("testBufferPoolReuse");
+    
+    MediaBufferPool pool;
+    
+    AVFrame* frame = pool.acquireVideoFrame(AV_PIX_FMT_YUV420P, 1280, 720);
+    QVERIFY(frame != nullptr);
+    QCOMPARE(frame->width, 1280);
+    QCOMPARE(frame->height, 720);
+    for (int plane = 0; plane < 3; ++plane) {
+        QVERIFY(frame->data[plane] != nullptr);
+        QCOMPARE(reinterpret_cast<uintptr_t>(frame->data[plane]) % MediaBufferPool::BUFFER_ALIGN, uintptr_t(0));
+        QCOMPARE(frame->linesize[plane] % MediaBufferPool::BUFFER_ALIGN, 0);
+    }
+    QCOMPARE(pool.buffersAllocated(), qint64(1));
+    
+    // The same geometry again reuses both the shell and the buffer
+    pool.releaseFrame(frame);
+    AVFrame* reused = pool.acquireVideoFrame(AV_PIX_FMT_YUV420P, 1280, 720);
+    QVERIFY(reused != nullptr);
+    QCOMPARE(reused, frame);
+    QCOMPARE(pool.buffersAllocated(), qint64(1));
+    
+    // Frames referencing the buffer keep it out of the pool until released
+    AVFrame* second = pool.acquireVideoFrame(AV_PIX_FMT_YUV420P, 1280, 720);
+    QVERIFY(second != nullptr);
+    QVERIFY(second->data[0] != reused->data[0]);
+    QCOMPARE(pool.buffersAllocated(), qint64(2));
+    pool.releaseFrame(second);
+    pool.releaseFrame(reused);
+    
+    AVChannelLayout stereo;
+    av_channel_layout_default(&stereo, 2);
+    for (int i = 0; i < 10; ++i) {
+        AVFrame* audio = pool.acquireAudioFrame(AV_SAMPLE_FMT_FLTP, &stereo, 48000, 1024);
+        QVERIFY(audio != nullptr);
+        QCOMPARE(audio->nb_samples, 1024);
+        QCOMPARE(audio->ch_layout.nb_channels, 2);
+        QVERIFY(audio->data[0] != nullptr && audio->data[1] != nullptr);
+        pool.releaseFrame(audio);
+    }
+    QCOMPARE(pool.buffersAllocated(), qint64(3));
+    
+    // Frame lengths in the same size class share a pool
+    AVFrame* shorter = pool.acquireAudioFrame(AV_SAMPLE_FMT_FLTP, &stereo, 44100, 1000);
+    QVERIFY(shorter != nullptr);
+    QCOMPARE(shorter->nb_samples, 1000);
+    pool.releaseFrame(shorter);
+    QCOMPARE(pool.buffersAllocated(), qint64(3));
+    
+    AVPacket* packet = pool.acquirePacket();
+    QVERIFY(packet != nullptr);
+    pool.releasePacket(packet);
+    QCOMPARE(pool.acquirePacket(), packet);
+    pool.releasePacket(packet);
+}
+
 void TestFFmpegWrapper::testVeryShortVideos() {
     TEST_SCOPE("testVeryShortVideos");
     
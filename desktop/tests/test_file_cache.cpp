@@ -0,0 +1,505 @@
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtConcurrent/QtConcurrent>
+#include <QFuture>
+
+#include "utils/TestUtils.hpp"
+#include "../src/core/storage/FileCache.hpp"
+
+using namespace Murmur;
+using namespace Murmur::Test;
+
+/**
+ * @brief Unit tests for FileCache
+ *
+ * Covers basic operations, eviction order for each policy, TTL expiry,
+ * limit changes, concurrent access across shards, the codec layer,
+ * memory-mapped segment storage and the on-disk index.
+ */
+class TestFileCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testPutGetRemove();
+    void testLeastRecentlyUsedEviction();
+    void testLeastFrequentlyUsedEviction();
+    void testFirstInFirstOutEviction();
+    void testTimeToLiveExpiry();
+    void testSetMaxEntriesEvictsToLimit();
+    void testConcurrentAccess();
+    void testCompressionCodecs();
+    void testAdaptiveCompressionSkip();
+    void testCompressionDictionary();
+    void testMappedSegmentViews();
+    void testMappedSegmentPersistenceAndCompaction();
+    void testSegmentChecksumOnFirstRead();
+    void testIndexWarmStart();
+    void testIndexJournalRecovery();
+
+private:
+    std::unique_ptr<QTemporaryDir> tempDir_;
+    std::unique_ptr<FileCache> cache_;
+
+    static QByteArray payload(int size, char fill = 'x') { return QByteArray(size, fill); }
+    std::unique_ptr<FileCache> createSegmentCache(bool persistent, const QString& name = "segmented") const;
+};
+
+void TestFileCache::initTestCase() {
+    TestUtils::initializeTestEnvironment();
+}
+
+void TestFileCache::cleanupTestCase() {
+    TestUtils::cleanupTestEnvironment();
+}
+
+void TestFileCache::init() {
+    tempDir_ = std::make_unique<QTemporaryDir>();
+    QVERIFY(tempDir_->isValid());
+
+    cache_ = std::make_unique<FileCache>();
+    cache_->setPersistentCacheEnabled(false);
+    cache_->setCompressionEnabled(false);
+    QVERIFY(cache_->initialize(tempDir_->path(), 1024 * 1024).hasValue());
+}
+
+void TestFileCache::cleanup() {
+    cache_.reset();
+    tempDir_.reset();
+}
+
+std::unique_ptr<FileCache> TestFileCache::createSegmentCache(bool persistent, const QString& name) const {
+    auto cache = std::make_unique<FileCache>();
+    cache->setPersistentCacheEnabled(persistent);
+    cache->setCompressionEnabled(false);
+    cache->setStorageMode(CacheStorageMode::MappedSegments);
+    if (!cache->initialize(QDir(tempDir_->path()).filePath(name), 16 * 1024 * 1024).hasValue()) {
+        return nullptr;
+    }
+    return cache;
+}
+
+void TestFileCache::testPutGetRemove() {
+    QVERIFY(cache_->put("thumb_1", payload(100)).hasValue());
+    QVERIFY(cache_->put("thumb_1", payload(200, 'y')).hasValue());
+
+    auto data = cache_->get("thumb_1");
+    QVERIFY(data.hasValue());
+    QCOMPARE(data.value(), payload(200, 'y'));
+    QCOMPARE(cache_->getSize().value(), qint64(200));
+    QCOMPARE(cache_->getEntryCount().value(), qint64(1));
+
+    QVERIFY(!cache_->get("missing").hasValue());
+    QVERIFY(cache_->remove("thumb_1").hasValue());
+    QVERIFY(!cache_->contains("thumb_1").value());
+
+    auto stats = cache_->getStats();
+    QVERIFY(stats.hasValue());
+    QCOMPARE(stats.value().hitCount, qint64(1));
+    QCOMPARE(stats.value().missCount, qint64(1));
+    QCOMPARE(stats.value().entryCount, qint64(0));
+    QCOMPARE(stats.value().totalSize, qint64(0));
+}
+
+void TestFileCache::testLeastRecentlyUsedEviction() {
+    QVERIFY(cache_->setMaxEntries(3).hasValue());
+
+    QVERIFY(cache_->put("a", payload(10)).hasValue());
+    QVERIFY(cache_->put("b", payload(10)).hasValue());
+    QVERIFY(cache_->put("c", payload(10)).hasValue());
+    QVERIFY(cache_->get("a").hasValue());
+
+    // "b" is now the least recently used, regardless of which shard holds it
+    QVERIFY(cache_->put("d", payload(10)).hasValue());
+    QCOMPARE(cache_->getEntryCount().value(), qint64(3));
+    QVERIFY(!cache_->contains("b").value());
+    QVERIFY(cache_->contains("a").value());
+    QVERIFY(cache_->contains("d").value());
+    QCOMPARE(cache_->getStats().value().evictionCount, qint64(1));
+}
+
+void TestFileCache::testLeastFrequentlyUsedEviction() {
+    QVERIFY(cache_->setCachePolicy(CachePolicy::LeastFrequentlyUsed).hasValue());
+    QVERIFY(cache_->setMaxEntries(3).hasValue());
+
+    QVERIFY(cache_->put("a", payload(10)).hasValue());
+    QVERIFY(cache_->put("b", payload(10)).hasValue());
+    QVERIFY(cache_->put("c", payload(10)).hasValue());
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(cache_->get("a").hasValue());
+        QVERIFY(cache_->get("c").hasValue());
+    }
+    QVERIFY(cache_->get("b").hasValue());
+
+    QVERIFY(cache_->put("d", payload(10)).hasValue());
+    QVERIFY(!cache_->contains("b").value());
+    QVERIFY(cache_->contains("a").value());
+    QVERIFY(cache_->contains("c").value());
+}
+
+void TestFileCache::testFirstInFirstOutEviction() {
+    QVERIFY(cache_->setCachePolicy(CachePolicy::FirstInFirstOut).hasValue());
+    QVERIFY(cache_->setMaxEntries(2).hasValue());
+
+    QVERIFY(cache_->put("a", payload(10)).hasValue());
+    QVERIFY(cache_->put("b", payload(10)).hasValue());
+    QVERIFY(cache_->get("a").hasValue()); // Access does not reorder FIFO
+
+    QVERIFY(cache_->put("c", payload(10)).hasValue());
+    QVERIFY(!cache_->contains("a").value());
+    QVERIFY(cache_->contains("b").value());
+}
+
+void TestFileCache::testTimeToLiveExpiry() {
+    QVERIFY(cache_->put("short", payload(10), 1).hasValue());
+    QVERIFY(cache_->put("forever", payload(10)).hasValue());
+
+    QTest::qWait(1100);
+
+    QVERIFY(cache_->cleanup().hasValue());
+    QCOMPARE(cache_->getEntryCount().value(), qint64(1));
+    QVERIFY(!cache_->get("short").hasValue());
+    QVERIFY(cache_->get("forever").hasValue());
+}
+
+void TestFileCache::testSetMaxEntriesEvictsToLimit() {
+    QSignalSpy evictionSpy(cache_.get(), &FileCache::evictionOccurred);
+
+    for (int i = 0; i < 200; ++i) {
+        QVERIFY(cache_->put(QString("entry_%1").arg(i), payload(16)).hasValue());
+    }
+    QVERIFY(cache_->setMaxEntries(50).hasValue());
+
+    QCOMPARE(cache_->getEntryCount().value(), qint64(50));
+    QCOMPARE(cache_->getSize().value(), qint64(50 * 16));
+    QCOMPARE(evictionSpy.count(), 150);
+
+    // The most recent entries survive
+    QVERIFY(cache_->contains("entry_199").value());
+    QVERIFY(!cache_->contains("entry_0").value());
+
+    QVERIFY(cache_->setMaxSize(10 * 16).hasValue());
+    QCOMPARE(cache_->getEntryCount().value(), qint64(10));
+}
+
+void TestFileCache::testConcurrentAccess() {
+    QVERIFY(cache_->setMaxEntries(256).hasValue());
+
+    const int threadCount = 8;
+    const int operationsPerThread = 500;
+
+    QList<QFuture<int>> futures;
+    for (int t = 0; t < threadCount; ++t) {
+        futures.append(QtConcurrent::run([this, t, operationsPerThread]() {
+            int failures = 0;
+            for (int i = 0; i < operationsPerThread; ++i) {
+                const QString key = QString("wave_%1_%2").arg(t).arg(i % 64);
+                const QByteArray data = payload(32, static_cast<char>('a' + t));
+                if (!cache_->put(key, data).hasValue()) {
+                    ++failures;
+                }
+                auto result = cache_->get(key);
+                // Another thread may evict the key in between, but never corrupt it
+                if (result.hasValue() && result.value() != data) {
+                    ++failures;
+                }
+            }
+            return failures;
+        }));
+    }
+
+    for (auto& future : futures) {
+        QCOMPARE(future.result(), 0);
+    }
+
+    auto stats = cache_->getStats();
+    QVERIFY(stats.hasValue());
+    QVERIFY(stats.value().entryCount <= 256);
+    QCOMPARE(stats.value().entryCount, cache_->getKeys().value().size());
+    QCOMPARE(stats.value().totalSize, stats.value().entryCount * 32);
+    QCOMPARE(stats.value().hitCount + stats.value().missCount,
+             qint64(threadCount * operationsPerThread));
+}
+
+void TestFileCache::testCompressionCodecs() {
+    QVERIFY(cache_->setCompressionEnabled(true).hasValue());
+
+    QByteArray text;
+    for (int i = 0; i < 200; ++i) {
+        text.append(QString("segment %1: the quick brown fox jumps over the lazy dog\n").arg(i).toUtf8());
+    }
+
+    const QList<CacheCodecId> codecs = {CacheCodecId::Lz4, CacheCodecId::Zstd, CacheCodecId::Zlib};
+    for (CacheCodecId codec : codecs) {
+        QVERIFY(cache_->setCompressionCodec(codec).hasValue());
+        const QString key = QString("text_%1").arg(static_cast<int>(codec));
+        QVERIFY(cache_->put(key, text).hasValue());
+
+        auto entry = cache_->getEntry(key);
+        QVERIFY(entry.hasValue());
+        QCOMPARE(entry.value().codec, codec);
+        QVERIFY(entry.value().compressed);
+        QVERIFY(entry.value().size < text.size());
+        QCOMPARE(entry.value().originalSize, qint64(text.size()));
+
+        auto data = cache_->get(key);
+        QVERIFY(data.hasValue());
+        QCOMPARE(data.value(), text);
+    }
+
+    // compact() recodes older entries into the current codec
+    QVERIFY(cache_->setCompressionCodec(CacheCodecId::Lz4).hasValue());
+    QVERIFY(cache_->compact().hasValue());
+    for (CacheCodecId codec : codecs) {
+        const QString key = QString("text_%1").arg(static_cast<int>(codec));
+        QCOMPARE(cache_->getEntry(key).value().codec, CacheCodecId::Lz4);
+        QCOMPARE(cache_->get(key).value(), text);
+    }
+}
+
+void TestFileCache::testAdaptiveCompressionSkip() {
+    QVERIFY(cache_->setCompressionEnabled(true).hasValue());
+
+    // Already-compressed formats are recognized by their magic bytes
+    QByteArray jpeg = QByteArray("\xFF\xD8\xFF\xE0", 4) + payload(4096);
+    QVERIFY(cache_->put("thumb_jpeg", jpeg).hasValue());
+    QCOMPARE(cache_->getEntry("thumb_jpeg").value().codec, CacheCodecId::None);
+    QCOMPARE(cache_->get("thumb_jpeg").value(), jpeg);
+
+    // Random data does not reach the minimum ratio and is stored raw
+    QByteArray noise(8192, Qt::Uninitialized);
+    QRandomGenerator generator(42);
+    generator.fillRange(reinterpret_cast<quint32*>(noise.data()), noise.size() / 4);
+    QVERIFY(cache_->put("noise", noise).hasValue());
+    QVERIFY(!cache_->getEntry("noise").value().compressed);
+    QCOMPARE(cache_->getEntry("noise").value().size, qint64(noise.size()));
+    QCOMPARE(cache_->get("noise").value(), noise);
+}
+
+void TestFileCache::testCompressionDictionary() {
+    QVERIFY(cache_->setCompressionEnabled(true).hasValue());
+    QVERIFY(cache_->setCompressionCodec(CacheCodecId::Zstd).hasValue());
+
+    auto metadata = [](int i) {
+        return QString(R"({"id":"media_%1","title":"Episode %1","duration":%2,"codec":"h264",)"
+                       R"("resolution":"1920x1080","audio":{"codec":"aac","channels":2,"sampleRate":48000},)"
+                       R"("tags":["lecture","transcribed","series_%3"],"padding":"%4"})")
+            .arg(i).arg(600 + i * 7).arg(i % 13).arg(QString(1100, QChar('a' + i % 26)))
+            .toUtf8();
+    };
+
+    QList<QByteArray> samples;
+    for (int i = 0; i < 500; ++i) {
+        samples.append(metadata(i));
+    }
+
+    auto dictionary = cache_->trainCompressionDictionary(samples, 8 * 1024);
+    QVERIFY(dictionary.hasValue());
+    QVERIFY(!dictionary.value().isEmpty());
+
+    const QByteArray value = metadata(5000);
+    QVERIFY(cache_->put("meta_5000", value).hasValue());
+
+    auto entry = cache_->getEntry("meta_5000");
+    QVERIFY(entry.hasValue());
+    QCOMPARE(entry.value().codec, CacheCodecId::Zstd);
+    QVERIFY(entry.value().dictionaryId != 0);
+    QCOMPARE(cache_->get("meta_5000").value(), value);
+}
+
+void TestFileCache::testMappedSegmentViews() {
+    auto cache = createSegmentCache(false);
+    QVERIFY(cache);
+    QVERIFY(!cache->setStorageMode(CacheStorageMode::InMemory).hasValue());
+
+    const QByteArray frame = payload(256 * 1024, 'f');
+    QVERIFY(cache->put("frame_1", frame).hasValue());
+
+    auto entry = cache->getEntry("frame_1");
+    QVERIFY(entry.hasValue());
+    QVERIFY(entry.value().segmentOffset >= 0);
+    QVERIFY(entry.value().data.isEmpty());
+
+    auto view = cache->getView("frame_1");
+    QVERIFY(view.hasValue());
+    QVERIFY(view.value().isMapped());
+    QCOMPARE(view.value().bytes(), frame);
+    QCOMPARE(cache->get("frame_1").value(), frame);
+
+    // The view keeps the old record readable after the entry is overwritten
+    QVERIFY(cache->put("frame_1", payload(1024, 'g')).hasValue());
+    QCOMPARE(view.value().bytes(), frame);
+    QCOMPARE(cache->get("frame_1").value(), payload(1024, 'g'));
+
+    // Compressed entries decode into a heap-backed view
+    QVERIFY(cache->setCompressionEnabled(true).hasValue());
+    const QByteArray text = QByteArray("transcript line\n").repeated(512);
+    QVERIFY(cache->put("transcript_1", text).hasValue());
+    auto textView = cache->getView("transcript_1");
+    QVERIFY(textView.hasValue());
+    QVERIFY(!textView.value().isMapped());
+    QCOMPARE(textView.value().bytes(), text);
+}
+
+void TestFileCache::testMappedSegmentPersistenceAndCompaction() {
+    const QString segmentDir = QDir(tempDir_->path()).filePath("segmented/segments");
+    auto segmentFiles = [segmentDir]() {
+        return QDir(segmentDir).entryList({"segment_*.seg"}, QDir::Files).size();
+    };
+
+    {
+        auto cache = createSegmentCache(true);
+        QVERIFY(cache);
+        for (int i = 0; i < 8; ++i) {
+            QVERIFY(cache->put(QString("chunk_%1").arg(i), payload(64 * 1024, char('a' + i))).hasValue());
+        }
+        QVERIFY(cache->shutdown().hasValue());
+    }
+    QCOMPARE(segmentFiles(), 1);
+
+    auto cache = createSegmentCache(true);
+    QVERIFY(cache);
+    QTRY_COMPARE(cache->getEntryCount().value(), qint64(8));
+    for (int i = 0; i < 8; ++i) {
+        auto view = cache->getView(QString("chunk_%1").arg(i));
+        QVERIFY(view.hasValue());
+        QVERIFY(view.value().isMapped());
+        QCOMPARE(view.value().bytes(), payload(64 * 1024, char('a' + i)));
+    }
+
+    // Dropping most entries leaves the reopened, sealed segment sparse;
+    // compaction moves the survivors and deletes it once no view is left
+    {
+        auto pinned = cache->getView("chunk_0");
+        QVERIFY(pinned.hasValue());
+        for (int i = 0; i < 6; ++i) {
+            QVERIFY(cache->remove(QString("chunk_%1").arg(i)).hasValue());
+        }
+        QVERIFY(cache->compact().hasValue());
+
+        QCOMPARE(pinned.value().bytes(), payload(64 * 1024, 'a'));
+        QCOMPARE(cache->get("chunk_6").value(), payload(64 * 1024, 'g'));
+        QCOMPARE(cache->get("chunk_7").value(), payload(64 * 1024, 'h'));
+    }
+    QTRY_COMPARE(segmentFiles(), 1);
+}
+
+void TestFileCache::testSegmentChecksumOnFirstRead() {
+    {
+        auto cache = createSegmentCache(true);
+        QVERIFY(cache);
+        QVERIFY(cache->put("intact", payload(4096, 'a')).hasValue());
+        QVERIFY(cache->put("damaged", payload(4096, 'b')).hasValue());
+        QVERIFY(cache->shutdown().hasValue());
+    }
+
+    // Flip one payload byte of the second record, as bit rot would
+    const QString segmentDir = QDir(tempDir_->path()).filePath("segmented/segments");
+    const QStringList segments = QDir(segmentDir).entryList({"segment_*.seg"}, QDir::Files);
+    QCOMPARE(segments.size(), 1);
+    QFile segment(QDir(segmentDir).filePath(segments.first()));
+    QVERIFY(segment.open(QIODevice::ReadWrite));
+    const qint64 damagedAt = segment.readAll().indexOf(payload(4096, 'b')) + 100;
+    QVERIFY(damagedAt > 100);
+    QVERIFY(segment.seek(damagedAt));
+    QVERIFY(segment.putChar('c'));
+    segment.close();
+
+    auto cache = createSegmentCache(true);
+    QVERIFY(cache);
+    QCOMPARE(cache->get("intact").value(), payload(4096, 'a'));
+    QVERIFY(!cache->get("damaged").hasValue());
+    QVERIFY(!cache->get("damaged").hasValue());
+    QCOMPARE(cache->get("intact").value(), payload(4096, 'a'));
+}
+
+void TestFileCache::testIndexWarmStart() {
+    const QString cacheDir = QDir(tempDir_->path()).filePath("persistent");
+    auto createCache = [cacheDir]() {
+        auto cache = std::make_unique<FileCache>();
+        cache->setCompressionEnabled(false);
+        if (!cache->initialize(cacheDir, 1024 * 1024).hasValue()) {
+            cache.reset();
+        }
+        return cache;
+    };
+
+    {
+        auto cache = createCache();
+        QVERIFY(cache);
+        for (int i = 0; i < 100; ++i) {
+            QVERIFY(cache->put(QString("meta_%1").arg(i), payload(100 + i, char('a' + i % 26))).hasValue());
+        }
+        QVERIFY(cache->remove("meta_0").hasValue());
+    }
+    QVERIFY(QFile::exists(QDir(cacheDir).filePath("cache_index.snapshot")));
+
+    // A key is served before the background load has necessarily finished
+    auto cache = createCache();
+    QVERIFY(cache);
+    QCOMPARE(cache->get("meta_42").value(), payload(142, char('a' + 42 % 26)));
+    QVERIFY(!cache->get("meta_0").hasValue());
+    QTRY_COMPARE(cache->getEntryCount().value(), qint64(99));
+    QCOMPARE(cache->get("meta_99").value(), payload(199, char('a' + 99 % 26)));
+    cache.reset();
+
+    // A damaged inline payload only loses its own entry when it is decoded
+    QFile snapshot(QDir(cacheDir).filePath("cache_index.snapshot"));
+    QVERIFY(snapshot.open(QIODevice::ReadWrite));
+    QVERIFY(snapshot.seek(snapshot.size() - 1));
+    char last = 0;
+    QVERIFY(snapshot.getChar(&last));
+    QVERIFY(snapshot.seek(snapshot.size() - 1));
+    QVERIFY(snapshot.putChar(char(last ^ 0x5a)));
+    snapshot.close();
+
+    cache = createCache();
+    QVERIFY(cache);
+    QTRY_COMPARE(cache->getEntryCount().value(), qint64(98));
+}
+
+void TestFileCache::testIndexJournalRecovery() {
+    const QString liveDir = QDir(tempDir_->path()).filePath("segmented");
+    const QString crashedDir = QDir(tempDir_->path()).filePath("crashed");
+
+    auto cache = createSegmentCache(true);
+    QVERIFY(cache);
+    QVERIFY(cache->put("frame_1", payload(4096, 'a')).hasValue());
+    QVERIFY(cache->put("frame_2", payload(4096, 'b')).hasValue());
+    QVERIFY(cache->put("frame_2", payload(2048, 'c')).hasValue());
+    QVERIFY(cache->remove("frame_1").hasValue());
+
+    // Copying the files of a cache that is still open is what a crash leaves
+    // behind: no snapshot, only segments and the journal
+    for (const QString& subdir : {QString(), QString("segments")}) {
+        QDir source(QDir(liveDir).filePath(subdir));
+        QVERIFY(QDir().mkpath(QDir(crashedDir).filePath(subdir)));
+        for (const QString& file : source.entryList(QDir::Files)) {
+            QVERIFY(QFile::copy(source.filePath(file), QDir(QDir(crashedDir).filePath(subdir)).filePath(file)));
+        }
+    }
+    QVERIFY(!QFile::exists(QDir(crashedDir).filePath("cache_index.snapshot")));
+
+    // A torn write at the end of the journal is cut off on open
+    QFile journal(QDir(crashedDir).filePath("cache_index.journal.0"));
+    QVERIFY(journal.open(QIODevice::Append));
+    journal.write("MJOP torn");
+    journal.close();
+
+    auto recovered = createSegmentCache(true, "crashed");
+    QVERIFY(recovered);
+    QCOMPARE(recovered->getEntryCount().value(), qint64(1));
+    QVERIFY(!recovered->get("frame_1").hasValue());
+    QCOMPARE(recovered->get("frame_2").value(), payload(2048, 'c'));
+}
+
+int runTestFileCache(int argc, char** argv) {
+    TestFileCache test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_file_cache.moc"
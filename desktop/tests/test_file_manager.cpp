@@ -0,0 +1,345 @@
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <QtCore/QDirIterator>
+#include <QSignalSpy>
+
+#include "utils/TestUtils.hpp"
+#include "../src/core/storage/FileManager.hpp"
+#include "../src/core/storage/DirectoryScanner.hpp"
+#include "../src/core/storage/ContentStore.hpp"
+
+using namespace Murmur;
+using namespace Murmur::Test;
+
+/**
+ * @brief Unit tests for FileManager
+ *
+ * Covers file copies, progress reporting, moves, directory scanning and
+ * content deduplication.
+ */
+class TestFileManager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testCopyFile();
+    void testCopyEmptyFile();
+    void testCopyMissingSource();
+    void testCopyProgressReported();
+    void testMoveFile();
+    void testAnalyzeDirectory();
+    void testIncrementalRescan();
+    void testContentStoreDeduplicates();
+
+private:
+    std::unique_ptr<QTemporaryDir> tempDir_;
+    std::unique_ptr<FileManager> fileManager_;
+
+    QString path(const QString& name) const { return QDir(tempDir_->path()).filePath(name); }
+    static QByteArray pattern(qint64 size);
+    static bool writeFile(const QString& filePath, const QByteArray& data);
+    static QByteArray readFile(const QString& filePath);
+};
+
+void TestFileManager::initTestCase() {
+    TestUtils::initializeTestEnvironment();
+}
+
+void TestFileManager::cleanupTestCase() {
+    TestUtils::cleanupTestEnvironment();
+}
+
+void TestFileManager::init() {
+    tempDir_ = std::make_unique<QTemporaryDir>();
+    QVERIFY(tempDir_->isValid());
+    fileManager_ = std::make_unique<FileManager>();
+}
+
+void TestFileManager::cleanup() {
+    fileManager_.reset();
+    tempDir_.reset();
+}
+
+QByteArray TestFileManager::pattern(qint64 size) {
+    QByteArray data(size, Qt::Uninitialized);
+    for (qint64 i = 0; i < size; ++i) {
+        data[i] = static_cast<char>((i * 31 + i / 4096) & 0xFF);
+    }
+    return data;
+}
+
+bool TestFileManager::writeFile(const QString& filePath, const QByteArray& data) {
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray TestFileManager::readFile(const QString& filePath) {
+    QFile file(filePath);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void TestFileManager::testCopyFile() {
+    TEST_SCOPE("testCopyFile");
+
+    // Not a multiple of any chunk size, so the last chunk is partial
+    const QByteArray data = pattern(9 * 1024 * 1024 + 4099);
+    QVERIFY(writeFile(path("source.mp4"), data));
+
+    auto result = TestUtils::waitForFuture(fileManager_->copyFile(path("source.mp4"), path("copy.mp4")));
+    QVERIFY(result.hasValue());
+    QCOMPARE(result.value(), path("copy.mp4"));
+    QCOMPARE(readFile(path("copy.mp4")), data);
+    QVERIFY(fileManager_->getActiveOperations().isEmpty());
+}
+
+void TestFileManager::testCopyEmptyFile() {
+    TEST_SCOPE("testCopyEmptyFile");
+
+    QVERIFY(writeFile(path("empty.mp4"), QByteArray()));
+
+    auto result = TestUtils::waitForFuture(fileManager_->copyFile(path("empty.mp4"), path("empty_copy.mp4")));
+    QVERIFY(result.hasValue());
+    QVERIFY(QFileInfo::exists(path("empty_copy.mp4")));
+    QCOMPARE(QFileInfo(path("empty_copy.mp4")).size(), qint64(0));
+}
+
+void TestFileManager::testCopyMissingSource() {
+    TEST_SCOPE("testCopyMissingSource");
+
+    auto result = TestUtils::waitForFuture(fileManager_->copyFile(path("missing.mp4"), path("copy.mp4")));
+    QVERIFY(result.hasError());
+    QCOMPARE(result.error(), FileError::NotFound);
+    QVERIFY(!QFileInfo::exists(path("copy.mp4")));
+}
+
+void TestFileManager::testCopyProgressReported() {
+    TEST_SCOPE("testCopyProgressReported");
+
+    const QByteArray data = pattern(2 * 1024 * 1024);
+    QVERIFY(writeFile(path("progress.mp4"), data));
+
+    QSignalSpy progressSpy(fileManager_.get(), &FileManager::operationProgress);
+    QSignalSpy completedSpy(fileManager_.get(), &FileManager::operationCompleted);
+
+    auto result = TestUtils::waitForFuture(fileManager_->copyFile(path("progress.mp4"), path("progress_copy.mp4")));
+    QVERIFY(result.hasValue());
+    QCOMPARE(completedSpy.count(), 1);
+
+    // Reports are throttled, but the final one always arrives
+    QVERIFY(progressSpy.count() >= 1);
+    const QList<QVariant> last = progressSpy.last();
+    QCOMPARE(last.at(1).toLongLong(), qint64(data.size()));
+    QCOMPARE(last.at(2).toLongLong(), qint64(data.size()));
+}
+
+void TestFileManager::testMoveFile() {
+    TEST_SCOPE("testMoveFile");
+
+    const QByteArray data = pattern(256 * 1024);
+    QVERIFY(writeFile(path("move_source.mp4"), data));
+
+    auto result = TestUtils::waitForFuture(fileManager_->moveFile(path("move_source.mp4"), path("moved.mp4")));
+    QVERIFY(result.hasValue());
+    QVERIFY(!QFileInfo::exists(path("move_source.mp4")));
+    QCOMPARE(readFile(path("moved.mp4")), data);
+}
+
+void TestFileManager::testAnalyzeDirectory() {
+    TEST_SCOPE("testAnalyzeDirectory");
+
+    QDir root(tempDir_->path());
+    QVERIFY(root.mkpath("library/season1"));
+    QVERIFY(root.mkpath("library/.hidden"));
+    QVERIFY(writeFile(path("library/movie.mkv"), pattern(1000)));
+    QVERIFY(writeFile(path("library/movie.srt"), pattern(10)));
+    QVERIFY(writeFile(path("library/season1/episode1.MP4"), pattern(2000)));
+    QVERIFY(writeFile(path("library/season1/theme.mp3"), pattern(300)));
+    QVERIFY(writeFile(path("library/.hidden/secret.mkv"), pattern(50)));
+
+    auto result = TestUtils::waitForFuture(fileManager_->analyzeDirectory(path("library")));
+    QVERIFY(result.hasValue());
+
+    const DirectoryInfo& info = result.value();
+    QCOMPARE(info.fileCount, 4);
+    QCOMPARE(info.dirCount, 1);
+    QCOMPARE(info.totalSize, qint64(3310));
+    QCOMPARE(info.videoFiles, QStringList({path("library/movie.mkv"), path("library/season1/episode1.MP4")}));
+    QCOMPARE(info.audioFiles, QStringList({path("library/season1/theme.mp3")}));
+    QCOMPARE(info.subtitleFiles, QStringList({path("library/movie.srt")}));
+
+    auto missing = TestUtils::waitForFuture(fileManager_->analyzeDirectory(path("missing")));
+    QVERIFY(missing.hasError());
+    QCOMPARE(missing.error(), FileError::NotFound);
+}
+
+void TestFileManager::testIncrementalRescan() {
+    TEST_SCOPE("testIncrementalRescan");
+
+    QDir root(tempDir_->path());
+    QVERIFY(root.mkpath("tree/a/deep"));
+    QVERIFY(root.mkpath("tree/b"));
+    QVERIFY(writeFile(path("tree/a/one.mkv"), pattern(10)));
+    QVERIFY(writeFile(path("tree/b/two.mkv"), pattern(20)));
+
+    const QString indexPath = path("index.bin");
+    {
+        DirectoryScanner scanner;
+        scanner.setIndexPath(indexPath);
+
+        auto first = scanner.scan(path("tree"));
+        QVERIFY(first.hasValue());
+        QCOMPARE(first.value().files.size(), 2);
+        QCOMPARE(first.value().directories.size(), 4);
+        QCOMPARE(first.value().directoriesRead, 4);
+
+        // Nothing changed, so every listing comes from the index
+        auto second = scanner.scan(path("tree"));
+        QVERIFY(second.hasValue());
+        QCOMPARE(second.value().files.size(), 2);
+        QCOMPARE(second.value().directoriesRead, 0);
+
+        // A new entry changes only its own directory's mtime
+        QVERIFY(writeFile(path("tree/b/three.mkv"), pattern(30)));
+        auto third = scanner.scan(path("tree"));
+        QVERIFY(third.hasValue());
+        QCOMPARE(third.value().files.size(), 3);
+        QCOMPARE(third.value().directoriesRead, 1);
+
+        scanner.invalidate(path("tree/a"));
+        auto fourth = scanner.scan(path("tree"));
+        QVERIFY(fourth.hasValue());
+        QCOMPARE(fourth.value().directoriesRead, 1);
+
+        // Growing a file in place leaves its directory's mtime alone, but
+        // the recorded file is stat'ed again
+        {
+            QFile file(path("tree/a/one.mkv"));
+            QVERIFY(file.open(QIODevice::Append));
+            QCOMPARE(file.write(pattern(5)), qint64(5));
+        }
+        auto fifth = scanner.scan(path("tree"));
+        QVERIFY(fifth.hasValue());
+        QCOMPARE(fifth.value().directoriesRead, 0);
+        qint64 grownSize = 0;
+        for (const ScannedFile& file : fifth.value().files) {
+            if (file.path == path("tree/a/one.mkv")) {
+                grownSize = file.size;
+            }
+        }
+        QCOMPARE(grownSize, qint64(15));
+
+        // A watched directory's listing is trusted until it is invalidated
+        scanner.setWatched(path("tree/a"), true);
+        {
+            QFile file(path("tree/a/one.mkv"));
+            QVERIFY(file.open(QIODevice::Append));
+            QCOMPARE(file.write(pattern(5)), qint64(5));
+        }
+        auto sixth = scanner.scan(path("tree"));
+        QVERIFY(sixth.hasValue());
+        for (const ScannedFile& file : sixth.value().files) {
+            if (file.path == path("tree/a/one.mkv")) {
+                QCOMPARE(file.size, qint64(15));
+            }
+        }
+        scanner.clearWatchedTree(path("tree"));
+
+        QVERIFY(scanner.saveIndex());
+    }
+
+    // A fresh scanner picks the listings up from the saved index
+    DirectoryScanner reloaded;
+    reloaded.setIndexPath(indexPath);
+    auto result = reloaded.scan(path("tree"));
+    QVERIFY(result.hasValue());
+    QCOMPARE(result.value().files.size(), 3);
+    QCOMPARE(result.value().directoriesRead, 0);
+    QCOMPARE(reloaded.indexedDirectoryCount(), qint64(4));
+}
+
+void TestFileManager::testContentStoreDeduplicates() {
+    TEST_SCOPE("testContentStoreDeduplicates");
+
+    ContentStore store;
+    store.setRoot(path("store"));
+
+    const QByteArray data = pattern(300 * 1024);
+    QVERIFY(writeFile(path("original.mkv"), data));
+    QVERIFY(writeFile(path("duplicate.mkv"), data));
+
+    auto added = store.add(path("original.mkv"));
+    QVERIFY(added.hasValue());
+    const QString key = added.value();
+    QCOMPARE(key.size(), 32);
+    QCOMPARE(store.keyForPath(path("original.mkv")), key);
+
+    // Sharing the fingerprint makes both sides compute their full hash
+    auto match = store.findDuplicate(path("duplicate.mkv"));
+    QVERIFY(match.hasValue());
+    QVERIFY(match.value().stored);
+    QCOMPARE(match.value().key, key);
+    QCOMPARE(match.value().hash, ContentStore::contentHash(path("original.mkv")).value());
+
+    QVERIFY(store.linkTo(key, path("linked.mkv")).hasValue());
+    QCOMPARE(readFile(path("linked.mkv")), data);
+    QCOMPARE(store.keyForPath(path("linked.mkv")), key);
+
+    // The journal carries the new entries into the next session
+    QVERIFY(store.saveIndex());
+    {
+        ContentStore reloaded;
+        reloaded.setRoot(path("store"));
+        QCOMPARE(reloaded.keyForPath(path("linked.mkv")), key);
+    }
+
+    // Differs outside the sampled blocks: only the full hash tells them apart
+    QByteArray altered = data;
+    altered[100 * 1024] = static_cast<char>(altered[100 * 1024] ^ 0xFF);
+    QVERIFY(writeFile(path("altered.mkv"), altered));
+    QCOMPARE(ContentStore::sampleFingerprint(path("altered.mkv")).value(),
+             ContentStore::sampleFingerprint(path("original.mkv")).value());
+
+    auto alteredMatch = store.findDuplicate(path("altered.mkv"));
+    QVERIFY(alteredMatch.hasValue());
+    QVERIFY(!alteredMatch.value().stored);
+    QVERIFY(!alteredMatch.value().hash.isEmpty());
+    QVERIFY(alteredMatch.value().hash != match.value().hash);
+
+    // The object goes once nothing refers to it
+    const QString objectsDir = path("store/objects");
+    auto objectCount = [&objectsDir]() {
+        QDirIterator it(objectsDir, QDir::Files, QDirIterator::Subdirectories);
+        int count = 0;
+        while (it.hasNext()) {
+            it.next();
+            ++count;
+        }
+        return count;
+    };
+    QCOMPARE(objectCount(), 1);
+
+    // A renamed library file keeps its reference
+    QVERIFY(QDir().rename(path("linked.mkv"), path("moved.mkv")));
+    store.move(path("linked.mkv"), path("moved.mkv"));
+    QCOMPARE(store.keyForPath(path("moved.mkv")), key);
+    QVERIFY(store.keyForPath(path("linked.mkv")).isEmpty());
+
+    store.remove(path("original.mkv"));
+    QCOMPARE(objectCount(), 1);
+    QVERIFY(QFile::remove(path("moved.mkv")));
+    store.removeTree(tempDir_->path());
+    QCOMPARE(objectCount(), 0);
+    QCOMPARE(readFile(path("original.mkv")), data);
+}
+
+int runTestFileManager(int argc, char** argv) {
+    TestFileManager test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_file_manager.moc"
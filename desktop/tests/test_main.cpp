@@ -17,6 +17,9 @@ extern int runTestWhisperEngine(int argc, char** argv);
 extern int runTestUIFlows(int argc, char** argv);
 extern int runTestFFmpegWrapper(int argc, char** argv);
 extern int runTestStorageManager(int argc, char** argv);
+extern int runTestFileCache(int argc, char** argv);
+extern int runTestMemoryManager(int argc, char** argv);
+extern int runTestFileManager(int argc, char** argv);
 extern int runTestSecurityComponents(int argc, char** argv);
 extern int runTestEndToEndIntegration(int argc, char** argv);
 
@@ -45,6 +48,9 @@ int main(int argc, char** argv) {
         // {"PerformanceBenchmarks", runTestPerformanceBenchmarks},
         {"WhisperEngine", runTestWhisperEngine},
         {"StorageManager", runTestStorageManager},
+        {"FileCache", runTestFileCache},
+        {"MemoryManager", runTestMemoryManager},
+        {"FileManager", runTestFileManager},
         {"SecurityComponents", runTestSecurityComponents},
         {"FFmpegWrapper", runTestFFmpegWrapper},
         // {"UIFlows", runTestUIFlows},
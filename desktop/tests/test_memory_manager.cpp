@@ -0,0 +1,305 @@
+#include <QtTest/QtTest>
+#include <QtConcurrent/QtConcurrent>
+
+#include "utils/TestUtils.hpp"
+#include "../src/core/storage/MemoryManager.hpp"
+#include "../src/core/storage/MemoryResource.hpp"
+
+#include <list>
+
+using namespace Murmur;
+using namespace Murmur::Test;
+
+/**
+ * @brief Unit tests for MemoryManager
+ *
+ * Covers slab-backed allocation and release, size-class reuse, large page
+ * runs, reallocation, pool accounting, per-thread caches and the
+ * allocator adapters.
+ */
+class TestMemoryManager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void testAllocateAndFree();
+    void testInvalidAndDoubleFree();
+    void testSizeClassReuse();
+    void testLargeFrameRuns();
+    void testReallocatePreservesData();
+    void testPoolExhaustionAndRecovery();
+    void testConcurrentAllocation();
+    void testPmrContainers();
+    void testTypedAllocator();
+    void testTaskArenaRelease();
+
+private:
+    static constexpr size_t MEMORY_LIMIT = 64 * 1024 * 1024;
+
+    std::unique_ptr<MemoryManager> manager_;
+};
+
+void TestMemoryManager::initTestCase() {
+    TestUtils::initializeTestEnvironment();
+}
+
+void TestMemoryManager::cleanupTestCase() {
+    TestUtils::cleanupTestEnvironment();
+}
+
+void TestMemoryManager::init() {
+    manager_ = std::make_unique<MemoryManager>();
+    QVERIFY(manager_->initialize(MEMORY_LIMIT).hasValue());
+}
+
+void TestMemoryManager::cleanup() {
+    manager_.reset();
+}
+
+void TestMemoryManager::testAllocateAndFree() {
+    auto block = manager_->allocate(100, 64, MemoryPoolType::Audio, "test");
+    QVERIFY(block.hasValue());
+    QCOMPARE(reinterpret_cast<quintptr>(block.value()) % 64, quintptr(0));
+
+    // 100 bytes at 64-byte alignment rounds up to the 128-byte class
+    auto poolStats = manager_->getPoolStats(MemoryPoolType::Audio);
+    QVERIFY(poolStats.hasValue());
+    QCOMPARE(poolStats.value().currentUsage, size_t(128));
+    QCOMPARE(poolStats.value().activeBlocks, size_t(1));
+    QVERIFY(manager_->memorySet(block.value(), 0x5A, 100).hasValue());
+
+    QVERIFY(manager_->deallocate(block.value()).hasValue());
+    QCOMPARE(manager_->getPoolStats(MemoryPoolType::Audio).value().currentUsage, size_t(0));
+    QCOMPARE(manager_->getStats().value().activeBlocks, size_t(0));
+    QVERIFY(manager_->validateMemory().hasValue());
+}
+
+void TestMemoryManager::testInvalidAndDoubleFree() {
+    int local = 0;
+    auto foreign = manager_->deallocate(&local);
+    QVERIFY(!foreign.hasValue());
+    QCOMPARE(foreign.error(), MemoryError::InvalidPointer);
+
+    auto block = manager_->allocate(256, 16, MemoryPoolType::General);
+    QVERIFY(block.hasValue());
+    QVERIFY(manager_->deallocate(block.value()).hasValue());
+
+    auto again = manager_->deallocate(block.value());
+    QVERIFY(!again.hasValue());
+    QCOMPARE(again.error(), MemoryError::DoubleFreePrevention);
+
+    auto misaligned = manager_->allocate(64, 2 * SlabAllocator::PAGE_SIZE, MemoryPoolType::General);
+    QVERIFY(!misaligned.hasValue());
+    QCOMPARE(misaligned.error(), MemoryError::InvalidAlignment);
+}
+
+void TestMemoryManager::testSizeClassReuse() {
+    // A freed block is the next one handed out for its size class
+    auto first = manager_->allocate(4000, 16, MemoryPoolType::Audio);
+    QVERIFY(first.hasValue());
+    QVERIFY(manager_->deallocate(first.value()).hasValue());
+
+    auto second = manager_->allocate(3900, 16, MemoryPoolType::Audio);
+    QVERIFY(second.hasValue());
+    QCOMPARE(second.value(), first.value());
+
+    // Many blocks of one class share slabs instead of separate allocations
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        auto block = manager_->allocate(48, 16, MemoryPoolType::Audio);
+        QVERIFY(block.hasValue());
+        blocks.push_back(block.value());
+    }
+    QCOMPARE(manager_->getActiveBlocks().value().size(), size_t(1001));
+
+    for (void* block : blocks) {
+        QVERIFY(manager_->deallocate(block).hasValue());
+    }
+    QVERIFY(manager_->deallocate(second.value()).hasValue());
+    QVERIFY(manager_->validateMemory().hasValue());
+}
+
+void TestMemoryManager::testLargeFrameRuns() {
+    const size_t frameSize = 1920 * 1080 * 3 / 2;
+
+    auto frame = manager_->allocate(frameSize, 64, MemoryPoolType::Video, "decoder");
+    QVERIFY(frame.hasValue());
+    QVERIFY(manager_->memorySet(frame.value(), 0, frameSize).hasValue());
+    QVERIFY(manager_->deallocate(frame.value()).hasValue());
+
+    // The released run is coalesced and reused for the next frame
+    auto next = manager_->allocate(frameSize, 64, MemoryPoolType::Video, "decoder");
+    QVERIFY(next.hasValue());
+    QCOMPARE(next.value(), frame.value());
+    QVERIFY(manager_->deallocate(next.value()).hasValue());
+
+    QVERIFY(manager_->compactMemory().hasValue());
+    QCOMPARE(manager_->getFragmentationRatio().value(), 0.0);
+}
+
+void TestMemoryManager::testReallocatePreservesData() {
+    auto block = manager_->allocate(64, 16, MemoryPoolType::Transcription);
+    QVERIFY(block.hasValue());
+    std::memset(block.value(), 0x3C, 64);
+
+    // Growing within the size class keeps the block in place
+    auto same = manager_->reallocate(block.value(), 60);
+    QVERIFY(same.hasValue());
+    QCOMPARE(same.value(), block.value());
+
+    auto grown = manager_->reallocate(block.value(), 100000);
+    QVERIFY(grown.hasValue());
+    QVERIFY(grown.value() != block.value());
+    QCOMPARE(QByteArray(static_cast<const char*>(grown.value()), 64), QByteArray(64, 0x3C));
+
+    QVERIFY(manager_->deallocate(grown.value()).hasValue());
+    QCOMPARE(manager_->getStats().value().currentUsage, size_t(0));
+}
+
+void TestMemoryManager::testPoolExhaustionAndRecovery() {
+    const size_t blockSize = 2 * SlabAllocator::MAX_SMALL_SIZE;
+    QVERIFY(manager_->setPoolLimit(MemoryPoolType::Temporary, 4 * blockSize).hasValue());
+
+    std::vector<void*> blocks;
+    while (true) {
+        auto block = manager_->allocate(blockSize, 16, MemoryPoolType::Temporary);
+        if (!block.hasValue()) {
+            QCOMPARE(block.error(), MemoryError::PoolExhausted);
+            break;
+        }
+        blocks.push_back(block.value());
+    }
+    QCOMPARE(blocks.size(), size_t(4));
+
+    QVERIFY(manager_->clearPool(MemoryPoolType::Temporary).hasValue());
+    QCOMPARE(manager_->getStats().value().currentUsage, size_t(0));
+    QVERIFY(manager_->allocate(blockSize, 16, MemoryPoolType::Temporary).hasValue());
+}
+
+void TestMemoryManager::testConcurrentAllocation() {
+    const int threadCount = 8;
+    const int operationsPerThread = 5000;
+
+    QList<QFuture<QList<void*>>> futures;
+    for (int t = 0; t < threadCount; ++t) {
+        futures.append(QtConcurrent::run([this, t, operationsPerThread]() {
+            QList<void*> kept;
+            for (int i = 0; i < operationsPerThread; ++i) {
+                const size_t size = 16 + (i * 37 + t * 101) % 5000;
+                auto block = manager_->allocate(size, 16, i % 3 ? MemoryPoolType::Audio : MemoryPoolType::Video);
+                if (!block.hasValue()) {
+                    return QList<void*>();
+                }
+                std::memset(block.value(), t, 16);
+                kept.append(block.value());
+
+                if (kept.size() > 200) {
+                    for (int k = 0; k < 100; ++k) {
+                        manager_->deallocate(kept.takeFirst());
+                    }
+                }
+            }
+            return kept;
+        }));
+    }
+
+    QList<QList<void*>> kept;
+    for (auto& future : futures) {
+        kept.append(future.result());
+        QVERIFY(!kept.last().isEmpty());
+    }
+
+    // Blocks freed on another thread than the one that allocated them
+    QList<QFuture<int>> frees;
+    for (int t = 0; t < threadCount; ++t) {
+        frees.append(QtConcurrent::run([this, blocks = kept[(t + 1) % threadCount]]() {
+            int failures = 0;
+            for (void* block : blocks) {
+                if (!manager_->deallocate(block).hasValue()) {
+                    ++failures;
+                }
+            }
+            return failures;
+        }));
+    }
+    for (auto& future : frees) {
+        QCOMPARE(future.result(), 0);
+    }
+
+    // Counters kept per thread add up once merged
+    auto stats = manager_->getStats();
+    QVERIFY(stats.hasValue());
+    QCOMPARE(stats.value().allocationCount, size_t(threadCount * operationsPerThread));
+    QCOMPARE(stats.value().freeCount, stats.value().allocationCount);
+    QCOMPARE(stats.value().currentUsage, size_t(0));
+    QVERIFY(manager_->validateMemory().hasValue());
+}
+
+void TestMemoryManager::testPmrContainers() {
+    PoolMemoryResource resource(*manager_, MemoryPoolType::Audio, "whisper");
+    {
+        std::pmr::vector<float> samples(&resource);
+        for (int i = 0; i < 16000; ++i) {
+            samples.push_back(static_cast<float>(i));
+        }
+        QCOMPARE(samples[15999], 15999.0f);
+        QVERIFY(resource.bytesAllocated() >= 16000 * sizeof(float));
+        QVERIFY(manager_->getPoolStats(MemoryPoolType::Audio).value().currentUsage >= 16000 * sizeof(float));
+
+        std::pmr::string label("a label long enough to need its own buffer", &resource);
+        QVERIFY(label.get_allocator().resource()->is_equal(resource));
+    }
+
+    QCOMPARE(resource.bytesAllocated(), size_t(0));
+    QCOMPARE(manager_->getPoolStats(MemoryPoolType::Audio).value().currentUsage, size_t(0));
+}
+
+void TestMemoryManager::testTypedAllocator() {
+    PoolAllocator<int> allocator(*manager_, MemoryPoolType::Transcription);
+    {
+        std::vector<int, PoolAllocator<int>> values(allocator);
+        values.assign(1000, 7);
+
+        // Rebound copies draw from the same pool
+        std::list<int, PoolAllocator<int>> nodes(allocator);
+        nodes.assign(values.begin(), values.begin() + 100);
+        QVERIFY(nodes.get_allocator() == allocator);
+
+        QCOMPARE(manager_->getPoolStats(MemoryPoolType::Transcription).value().activeBlocks, size_t(101));
+    }
+
+    QCOMPARE(manager_->getPoolStats(MemoryPoolType::Transcription).value().activeBlocks, size_t(0));
+}
+
+void TestMemoryManager::testTaskArenaRelease() {
+    TaskArena arena(*manager_, MemoryPoolType::Transcription);
+
+    // Thousands of small allocations come out of a handful of chunks
+    {
+        std::pmr::vector<std::pmr::string> segments(arena.allocator<std::pmr::string>());
+        for (int i = 0; i < 5000; ++i) {
+            segments.emplace_back(QString("segment %1 with some transcribed text").arg(i).toStdString());
+        }
+        QCOMPARE(segments.back(), std::pmr::string("segment 4999 with some transcribed text"));
+
+        auto stats = manager_->getPoolStats(MemoryPoolType::Transcription);
+        QVERIFY(stats.value().activeBlocks < 32);
+    }
+
+    // Destroying the containers frees nothing; releasing the arena frees all
+    QVERIFY(arena.bytesReserved() > 0);
+    arena.release();
+    QCOMPARE(arena.bytesReserved(), size_t(0));
+    QCOMPARE(manager_->getPoolStats(MemoryPoolType::Transcription).value().currentUsage, size_t(0));
+}
+
+int runTestMemoryManager(int argc, char** argv) {
+    TestMemoryManager test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_memory_manager.moc"
@@ -3,6 +3,9 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QJsonArray>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 #include <QtConcurrent/QtConcurrent>
 #include <QFuture>
 #include <atomic>
@@ -51,22 +54,27 @@ private slots:
     void testSorting();
     void testFiltering();
     void testFullTextSearch();
+    void testTranscriptionSearchIndex();
     
     // Transaction tests
     void testTransactionSupport();
     void testRollbackBehavior();
     void testConcurrentAccess();
+    void testReaderConnections();
     void testDeadlockHandling();
     
     // Migration and schema tests
     void testDatabaseMigration();
     void testSchemaVersioning();
+    void testInitializeUpgradesOldDatabase();
+    void testPreparedStatementCache();
     void testBackupAndRestore();
     void testCorruptionRecovery();
     
     // Performance tests
     void testLargeDatasets();
     void testBulkOperations();
+    void testWriteBehindCoalescing();
     void testIndexPerformance();
     void testMemoryUsage();
     
@@ -94,6 +102,9 @@ private:
     bool isDatabaseEmpty();
     void simulateDiskFull();
     void simulateCorruption();
+    
+    // Run SQL on the test database through a separate connection
+    QVariant queryDatabaseFile(const QString& sql);
 };
 
 void TestStorageManager::initTestCase() {
@@ -622,6 +633,24 @@ void TestStorageManager::verifyDatabaseConsistency() {
     // Implementation would depend on specific database schema
 }
 
+QVariant TestStorageManager::queryDatabaseFile(const QString& sql) {
+    const QString connectionName = "test_storage_direct";
+    QVariant result;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(dbPath_);
+        if (database.open()) {
+            QSqlQuery query(database);
+            if (query.exec(sql) && query.next()) {
+                result = query.value(0);
+            }
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return result;
+}
+
 bool TestStorageManager::isDatabaseEmpty() {
     auto result = storage_->getAllTorrents();
     return result.hasValue() && result.value().isEmpty();
@@ -661,6 +690,35 @@ void TestStorageManager::testPagination() {
     QVERIFY(page1.first().infoHash != page2.first().infoHash);
     QVERIFY(page2.first().infoHash != page3.first().infoHash);
     
+    // Keyset pages walk the same order without gaps or repeats
+    QStringList pagedHashes;
+    PageCursor cursor;
+    int pageCount = 0;
+    while (true) {
+        auto pageResult = storage_->getTorrentSummaries(cursor, 10);
+        QVERIFY(pageResult.hasValue());
+        for (const auto& summary : pageResult.value().items) {
+            pagedHashes.append(summary.infoHash);
+        }
+        ++pageCount;
+        if (!pageResult.value().hasMore) {
+            break;
+        }
+        cursor = pageResult.value().next;
+    }
+    QCOMPARE(pageCount, 3);
+    QCOMPARE(pagedHashes.size(), 25);
+    QCOMPARE(QSet<QString>(pagedHashes.begin(), pagedHashes.end()).size(), 25);
+    
+    auto mediaPage = storage_->getMediaSummaries({}, 20);
+    QVERIFY(mediaPage.hasValue());
+    QCOMPARE(mediaPage.value().items.size(), 20);
+    QVERIFY(mediaPage.value().hasMore);
+    auto lastMediaPage = storage_->getMediaPage(mediaPage.value().next, 20);
+    QVERIFY(lastMediaPage.hasValue());
+    QCOMPARE(lastMediaPage.value().items.size(), 5);
+    QVERIFY(!lastMediaPage.value().hasMore);
+    
     TestUtils::logMessage("Pagination simulation completed successfully");
 }
 
@@ -807,6 +865,66 @@ void TestStorageManager::testFullTextSearch() {
     TestUtils::logMessage("Full-text search simulation completed successfully");
 }
 
+void TestStorageManager::testTranscriptionSearchIndex() {
+    TEST_SCOPE("testTranscriptionSearchIndex");
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    if (!storage_->isSearchIndexAvailable()) {
+        QSKIP("SQLite build lacks FTS5");
+    }
+    
+    auto torrent = createValidTorrentRecord("fts");
+    QVERIFY(storage_->addTorrent(torrent).hasValue());
+    auto media = createValidMediaRecord(torrent.infoHash);
+    QVERIFY(storage_->addMedia(media).hasValue());
+    
+    auto transcription = createValidTranscriptionRecord(media.id);
+    transcription.fullText = "Welcome to the show. Today we discuss penguins in Antarctica.";
+    QJsonArray segments;
+    segments.append(QJsonObject{{"startTime", 0}, {"endTime", 2000}, {"text", "Welcome to the show."}});
+    segments.append(QJsonObject{{"startTime", 2000}, {"endTime", 6000}, {"text", "Today we discuss penguins in Antarctica."}});
+    transcription.timestamps["segments"] = segments;
+    QVERIFY(storage_->addTranscription(transcription).hasValue());
+    
+    // Prefix match, ranked hit with snippet and segment location
+    auto hitsResult = storage_->searchTranscriptionsRanked("pengu");
+    QVERIFY(hitsResult.hasValue());
+    QCOMPARE(hitsResult.value().size(), 1);
+    const auto& hit = hitsResult.value().first();
+    QCOMPARE(hit.transcription.id, transcription.id);
+    QVERIFY(hit.snippet.contains("<b>penguins</b>"));
+    QCOMPARE(hit.matchOffset, static_cast<int>(transcription.fullText.indexOf("penguins")));
+    QCOMPARE(hit.segmentIndex, 1);
+    QCOMPARE(hit.segmentStart, qint64(2000));
+    
+    // Triggers keep the index in sync with updates
+    transcription.fullText = "Nothing about birds here.";
+    QVERIFY(storage_->updateTranscription(transcription).hasValue());
+    QVERIFY(storage_->searchTranscriptions("penguins").value().isEmpty());
+    QCOMPARE(storage_->searchTranscriptions("birds").value().size(), 1);
+    
+    // Media and torrent searches go through the index too
+    QCOMPARE(storage_->searchMedia("test_media").value().size(), 1);
+    QCOMPARE(storage_->searchTorrents("TestTorrentfts").value().size(), 1);
+    
+    // Progress writes leave the indexed name alone
+    QVERIFY(storage_->updateTorrentProgress(torrent.infoHash, 0.5).hasValue());
+    QCOMPARE(storage_->searchTorrents("TestTorrentfts").value().size(), 1);
+    
+    QVERIFY(storage_->rebuildSearchIndex().hasValue());
+    QVERIFY(storage_->optimizeSearchIndex().hasValue());
+    QCOMPARE(storage_->searchTranscriptions("birds").value().size(), 1);
+    
+    // Index rows follow rowids across VACUUM
+    QVERIFY(storage_->vacuum().hasValue());
+    QCOMPARE(storage_->searchTranscriptions("birds").value().size(), 1);
+    QCOMPARE(storage_->searchMedia("test_media").value().size(), 1);
+    
+    // Deleting the media cascades to the transcription and its index row
+    QVERIFY(storage_->removeMedia(media.id).hasValue());
+    QVERIFY(storage_->searchTranscriptions("birds").value().isEmpty());
+}
+
 void TestStorageManager::testRollbackBehavior() {
     TEST_SCOPE("testRollbackBehavior");
     
@@ -887,6 +1005,48 @@ void TestStorageManager::testConcurrentAccess() {
     TestUtils::logMessage("Concurrent access test completed successfully");
 }
 
+void TestStorageManager::testReaderConnections() {
+    TEST_SCOPE("testReaderConnections");
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    
+    auto torrent = createValidTorrentRecord("reader");
+    QVERIFY(storage_->addTorrent(torrent).hasValue());
+    
+    // Reads on a worker thread get their own connection and still see
+    // everything the writer committed before them
+    auto future = QtConcurrent::run([this, hash = torrent.infoHash]() -> double {
+        if (storage_->getTorrent(hash).hasError() || storage_->updateTorrentProgress(hash, 0.75).hasError()) {
+            return -1.0;
+        }
+        auto reread = storage_->getTorrent(hash);
+        return reread.hasValue() ? reread.value().progress : -1.0;
+    });
+    QCOMPARE(future.result(), 0.75);
+    QVERIFY(storage_->readerConnectionCount() >= 1);
+    
+    QVERIFY(storage_->updateTorrentProgress(torrent.infoHash, 0.25).hasValue());
+    QCOMPARE(storage_->getTorrent(torrent.infoHash).value().progress, 0.25);
+    
+    // Inside an explicit transaction reads go to the writer and see its changes
+    QVERIFY(storage_->beginTransaction().hasValue());
+    QVERIFY(storage_->updateTorrentProgress(torrent.infoHash, 0.5).hasValue());
+    QCOMPARE(storage_->getTorrent(torrent.infoHash).value().progress, 0.5);
+    QVERIFY(storage_->rollbackTransaction().hasValue());
+    QCOMPARE(storage_->getTorrent(torrent.infoHash).value().progress, 0.25);
+    
+    storage_->close();
+    QCOMPARE(storage_->readerConnectionCount(), 0);
+    
+    // Readers left behind on worker threads are replaced on their next read
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    auto reopened = QtConcurrent::run([this, hash = torrent.infoHash]() {
+        return storage_->getTorrent(hash).hasValue();
+    });
+    QVERIFY(reopened.result());
+    QVERIFY(storage_->readerConnectionCount() >= 1);
+}
+
 void TestStorageManager::testDeadlockHandling() {
     TEST_SCOPE("testDeadlockHandling");
     
@@ -986,6 +1146,58 @@ void TestStorageManager::testSchemaVersioning() {
     TestUtils::logMessage("Schema versioning test completed successfully");
 }
 
+void TestStorageManager::testInitializeUpgradesOldDatabase() {
+    TEST_SCOPE("testInitializeUpgradesOldDatabase");
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    const int currentVersion = queryDatabaseFile("PRAGMA user_version").toInt();
+    QVERIFY(currentVersion > 2);
+    
+    auto torrent = createValidTorrentRecord("upgrade_test");
+    QVERIFY(storage_->addTorrent(torrent).hasValue());
+    auto media = createValidMediaRecord(torrent.infoHash);
+    QVERIFY(storage_->addMedia(media).hasValue());
+    QVERIFY(storage_->addTranscription(createValidTranscriptionRecord(media.id)).hasValue());
+    storage_.reset();
+    
+    // Make the file look like one written by a version 2 release
+    queryDatabaseFile("UPDATE transcriptions SET date_created = NULL");
+    queryDatabaseFile("PRAGMA user_version = 2");
+    
+    storage_ = std::make_unique<StorageManager>();
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    storage_.reset();
+    
+    QCOMPARE(queryDatabaseFile("PRAGMA user_version").toInt(), currentVersion);
+    QCOMPARE(queryDatabaseFile("SELECT COUNT(*) FROM transcriptions WHERE date_created IS NULL").toInt(), 0);
+}
+
+void TestStorageManager::testPreparedStatementCache() {
+    TEST_SCOPE("testPreparedStatementCache");
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    
+    auto torrent = createValidTorrentRecord("statement_cache");
+    QVERIFY(storage_->addTorrent(torrent).hasValue());
+    
+    auto before = storage_->getStatementCacheStats();
+    for (int i = 1; i <= 10; ++i) {
+        QVERIFY(storage_->updateTorrentProgress(torrent.infoHash, i / 10.0).hasValue());
+    }
+    auto after = storage_->getStatementCacheStats();
+    
+    // One compile for the first call, reuse for the rest
+    QVERIFY(after.misses - before.misses <= 1);
+    QVERIFY(after.hits - before.hits >= 9);
+    QCOMPARE(storage_->getTorrent(torrent.infoHash).value().progress, 1.0);
+    
+    // Migrations drop statements compiled against the old schema
+    queryDatabaseFile("PRAGMA user_version = 3");
+    QVERIFY(storage_->testMigrateDatabase().hasValue());
+    QCOMPARE(storage_->getStatementCacheStats().cachedStatements, 0);
+    QVERIFY(storage_->getTorrent(torrent.infoHash).hasValue());
+}
+
 void TestStorageManager::testBackupAndRestore() {
     TEST_SCOPE("testBackupAndRestore");
     
@@ -1147,6 +1359,69 @@ void TestStorageManager::testBulkOperations() {
     QVERIFY(bulkTime < 5000);
     
     TestUtils::logMessage(QString("Bulk operations completed in %1ms").arg(bulkTime));
+    
+    // Batched updates and media upserts commit in one transaction each
+    for (auto& torrent : bulkTorrents) {
+        torrent.progress = 0.5;
+        torrent.status = "seeding";
+    }
+    QVERIFY(storage_->updateTorrentsBulk(bulkTorrents).hasValue());
+    QCOMPARE(storage_->getTorrent(bulkTorrents.last().infoHash).value().status, QString("seeding"));
+    
+    QList<MediaRecord> mediaBatch;
+    for (int i = 0; i < 5; ++i) {
+        mediaBatch.append(createValidMediaRecord(bulkTorrents[i].infoHash));
+    }
+    auto upsertResult = storage_->upsertMediaBatch(mediaBatch);
+    QVERIFY(upsertResult.hasValue());
+    QCOMPARE(upsertResult.value().size(), 5);
+    
+    mediaBatch[0].playbackPosition = 4242;
+    QVERIFY(storage_->upsertMediaBatch({mediaBatch[0]}).hasValue());
+    QCOMPARE(storage_->getMedia(mediaBatch[0].id).value().playbackPosition, qint64(4242));
+    QCOMPARE(storage_->getMediaByTorrent(bulkTorrents[0].infoHash).value().size(), 1);
+}
+
+void TestStorageManager::testWriteBehindCoalescing() {
+    TEST_SCOPE("testWriteBehindCoalescing");
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    storage_->setWriteBehindWindow(60000);
+    
+    auto torrent = createValidTorrentRecord("write_behind");
+    QVERIFY(storage_->addTorrent(torrent).hasValue());
+    auto media = createValidMediaRecord(torrent.infoHash);
+    QVERIFY(storage_->addMedia(media).hasValue());
+    
+    // Repeated writes to one key collapse into a single pending write
+    for (int i = 1; i <= 100; ++i) {
+        storage_->queueTorrentProgress(torrent.infoHash, i / 100.0);
+        storage_->queuePlaybackPosition(media.id, i * 1000);
+    }
+    QCOMPARE(storage_->pendingWriteCount(), 2);
+    
+    QVERIFY(storage_->flushPendingWrites().hasValue());
+    QCOMPARE(storage_->pendingWriteCount(), 0);
+    QCOMPARE(storage_->getTorrent(torrent.infoHash).value().progress, 1.0);
+    QCOMPARE(storage_->getMedia(media.id).value().playbackPosition, qint64(100000));
+    
+    // close() flushes whatever is still queued
+    storage_->queuePlaybackPosition(media.id, 123456);
+    storage_->close();
+    
+    QVERIFY(storage_->initialize(dbPath_).hasValue());
+    QCOMPARE(storage_->getMedia(media.id).value().playbackPosition, qint64(123456));
+    
+    // Writes queued on other threads are flushed on the owning thread
+    storage_->setWriteBehindWindow(0);
+    QSignalSpy savedSpy(storage_.get(), &StorageManager::playbackPositionSaved);
+    QtConcurrent::run([this, mediaId = media.id]() {
+        storage_->queuePlaybackPosition(mediaId, 654321);
+    }).waitForFinished();
+    QTRY_COMPARE(savedSpy.count(), 1);
+    QCOMPARE(savedSpy.first().at(0).toString(), media.id);
+    QCOMPARE(storage_->pendingWriteCount(), 0);
+    QCOMPARE(storage_->getMedia(media.id).value().playbackPosition, qint64(654321));
 }
 
 void TestStorageManager::testIndexPerformance() {
@@ -7,6 +7,8 @@
 #include "../src/core/torrent/TorrentEngine.hpp"
 #include "../src/core/torrent/LibTorrentWrapper.hpp"
 #include "../src/core/torrent/TorrentStateModel.hpp"
+#include "../src/core/torrent/ResumeDataStore.hpp"
+#include "../src/core/torrent/TorrentFilesModel.hpp"
 #include "utils/TestUtils.hpp"
 #include "utils/TestDatabase.hpp"
 
@@ -161,6 +163,14 @@ private slots:
         QCOMPARE(result.error(), TorrentError::InvalidTorrentFile);
     }
     
+    void testOpenStreamUnknownTorrent() {
+        engine_->startSession();
+        
+        auto stream = engine_->openStream(QString(40, QLatin1Char('0')));
+        QVERIFY(stream.hasError());
+        QCOMPARE(stream.error(), TorrentError::TorrentNotFound);
+    }
+    
     void testSessionConfiguration() {
         engine_->configureSession(100, 1000, 2000);
         
@@ -305,6 +315,106 @@ private slots:
         QVERIFY(!engine_->hasTorrent(fakeHash));
     }
     
+    void testResumeDataStoreRoundTrip() {
+        QTemporaryDir storeDir;
+        QVERIFY(storeDir.isValid());
+        ResumeDataStore store(storeDir.path());
+        
+        QHash<QString, QByteArray> entries;
+        entries.insert("0123456789abcdef0123456789abcdef01234567", QByteArray("d4:infod6:lengthi1eee"));
+        entries.insert("1234567890abcdef1234567890abcdef12345678", QByteArray("d4:infod6:lengthi2eee"));
+        QCOMPARE(store.save(entries), 2);
+        QCOMPARE(store.loadAll(), entries);
+        
+        // Saving again only replaces the given torrent
+        QHash<QString, QByteArray> changed;
+        changed.insert("0123456789abcdef0123456789abcdef01234567", QByteArray("d4:infod6:lengthi3eee"));
+        QCOMPARE(store.save(changed), 1);
+        entries.insert("0123456789abcdef0123456789abcdef01234567", QByteArray("d4:infod6:lengthi3eee"));
+        QCOMPARE(store.loadAll(), entries);
+        
+        store.remove("1234567890abcdef1234567890abcdef12345678");
+        entries.remove("1234567890abcdef1234567890abcdef12345678");
+        QCOMPARE(store.loadAll(), entries);
+    }
+    
+    void testPerformanceProfiles() {
+        for (auto profile : {TorrentPerformanceProfile::Balanced,
+                             TorrentPerformanceProfile::HighThroughput,
+                             TorrentPerformanceProfile::LowMemory}) {
+            QCOMPARE(TorrentProfiles::fromName(TorrentProfiles::name(profile)), profile);
+        }
+        QCOMPARE(TorrentProfiles::fromName("no-such-profile"), TorrentPerformanceProfile::Balanced);
+        QVERIFY(!TorrentProfiles::usesMmapDiskBackend(TorrentPerformanceProfile::LowMemory));
+        
+        engine_->setPerformanceProfile(TorrentPerformanceProfile::HighThroughput);
+        QCOMPARE(engine_->performanceProfile(), TorrentPerformanceProfile::HighThroughput);
+    }
+    
+    void testTorrentStateModelDiffsAndCoalesces() {
+        TorrentStateModel model;
+        TorrentEngine::TorrentInfo first;
+        first.infoHash = "0123456789abcdef0123456789abcdef01234567";
+        first.name = "First";
+        TorrentEngine::TorrentInfo second = first;
+        second.infoHash = "1234567890abcdef1234567890abcdef12345678";
+        second.name = "Second";
+        model.addTorrent(first);
+        model.addTorrent(second);
+        
+        QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+        
+        // Unchanged state is not announced
+        model.updateTorrents({first, second});
+        model.flushPendingChanges();
+        QCOMPARE(changedSpy.count(), 0);
+        
+        // Several updates within a frame become one notification per row range
+        first.progress = 0.5;
+        second.progress = 0.25;
+        model.updateTorrent(first);
+        model.updateTorrent(second);
+        first.progress = 0.75;
+        model.updateTorrent(first);
+        QCOMPARE(model.getTorrentInfo(first.infoHash).progress, 0.75);
+        QCOMPARE(changedSpy.count(), 0);
+        
+        QTRY_COMPARE(changedSpy.count(), 1);
+        const auto arguments = changedSpy.takeFirst();
+        QCOMPARE(arguments.at(0).value<QModelIndex>().row(), 0);
+        QCOMPARE(arguments.at(1).value<QModelIndex>().row(), 1);
+        QCOMPARE(arguments.at(2).value<QList<int>>(), QList<int>{TorrentStateModel::ProgressRole});
+        
+        // File lists are served by a lazily created sub-model
+        TorrentFilesModel* files = model.filesModel(first.infoHash);
+        QVERIFY(files != nullptr);
+        QCOMPARE(files->rowCount(), 0);
+        changedSpy.clear();
+        first.files = QStringList{"dir/a.mkv", "dir/b.srt"};
+        model.setTorrentFiles(first.infoHash, first.files);
+        QCOMPARE(files->rowCount(), 2);
+        QCOMPARE(model.getTorrentInfo(first.infoHash).files, first.files);
+        QCOMPARE(files->data(files->index(1), TorrentFilesModel::NameRole).toString(), QString("b.srt"));
+        QCOMPARE(model.filesModel(first.infoHash), files);
+        QVERIFY(model.filesModel("ffffffffffffffffffffffffffffffffffffffff") == nullptr);
+        
+        // Row updates neither compare nor announce file lists
+        first.files.append("dir/c.nfo");
+        model.updateTorrent(first);
+        model.flushPendingChanges();
+        QCOMPARE(changedSpy.count(), 0);
+        QCOMPARE(files->rowCount(), 2);
+        QCOMPARE(model.getTorrentInfo(first.infoHash).files.size(), 2);
+
+        // Updates from engine workers are applied on the model's thread
+        changedSpy.clear();
+        second.progress = 1.0;
+        QtConcurrent::run([&model, second]() { model.updateTorrent(second); }).waitForFinished();
+        QCOMPARE(model.getTorrentInfo(second.infoHash).progress, 0.25);
+        QTRY_COMPARE(model.getTorrentInfo(second.infoHash).progress, 1.0);
+        QTRY_COMPARE(changedSpy.count(), 1);
+    }
+    
 private:
     std::unique_ptr<QTemporaryDir> tempDir_;
     std::unique_ptr<TorrentEngine> engine_;
@@ -4,6 +4,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QTimer>
 #include "../../../src/core/transcription/WhisperEngine.hpp"
+#include "../../../src/core/transcription/WhisperWrapper.hpp"
 #include "../../utils/TestUtils.hpp"
 #include "../../utils/MockComponents.hpp"
 
@@ -58,6 +59,7 @@ private slots:
     // Performance and resource tests
     void testConcurrentTranscriptions();
     void testTranscriptionCancellation();
+    void testChunkBoundariesPreferSilence();
     
     // Language detection tests
     void testLanguageDetectionAccuracy();
@@ -404,6 +406,28 @@ void TestWhisperEngine::testTranscriptionCancellation() {
     QVERIFY(newResult.hasValue());
 }
 
+void TestWhisperEngine::testChunkBoundariesPreferSilence() {
+    const size_t sampleRate = 16000;
+    const size_t totalSamples = sampleRate * 100;
+
+    // Constant tone with a half-second gap at 52s
+    std::vector<float> audio(totalSamples, 0.5f);
+    const size_t gapStart = sampleRate * 52;
+    std::fill(audio.begin() + gapStart, audio.begin() + gapStart + sampleRate / 2, 0.0f);
+
+    auto boundaries = WhisperWrapper::findChunkBoundaries(audio, sampleRate * 50, sampleRate * 5);
+
+    QCOMPARE(boundaries.size(), size_t(3));
+    QCOMPARE(boundaries.front(), size_t(0));
+    QCOMPARE(boundaries.back(), totalSamples);
+    QVERIFY(boundaries[1] >= gapStart);
+    QVERIFY(boundaries[1] < gapStart + sampleRate / 2);
+
+    // Audio shorter than one chunk is never split
+    auto single = WhisperWrapper::findChunkBoundaries(audio, totalSamples, sampleRate * 5);
+    QCOMPARE(single.size(), size_t(2));
+}
+
 void TestWhisperEngine::testLanguageDetectionAccuracy() {
     TranscriptionSettings settings = createBasicSettings();
     settings.language = "auto";